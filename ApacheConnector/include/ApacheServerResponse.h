@@ -71,6 +71,22 @@ public:
 		/// cannot be found, or an OpenFileException if
 		/// the file cannot be opened.
 		
+	void sendFileRange(const std::string& path, const std::string& mediaType);
+		/// Sends the response header to the client, followed
+		/// by the content of the given file, honoring a byte
+		/// range given in the request's Range header.
+		///
+		/// Range and If-Range headers are handled by Apache's
+		/// byterange filter, which also adds the "Accept-Ranges"
+		/// header, so this is the same as sendFile().
+		///
+		/// Must not be called after send(), sendBuffer() 
+		/// or redirect() has been called.
+		///
+		/// Throws a FileNotFoundException if the file
+		/// cannot be found, or an OpenFileException if
+		/// the file cannot be opened.
+		
 	void sendBuffer(const void* pBuffer, std::size_t length);
 		/// Sends the response header to the client, followed
 		/// by the contents of the given buffer.
@@ -90,6 +90,13 @@ void ApacheServerResponse::sendFile(const std::string& path, const std::string&
 }
 
 
+void ApacheServerResponse::sendFileRange(const std::string& path, const std::string& mediaType)
+{
+	// Apache's byterange filter applies the request's Range header
+	sendFile(path, mediaType);
+}
+
+
 void ApacheServerResponse::sendBuffer(const void* pBuffer, std::size_t length)
 {
 	poco_assert (!_pStream);
@@ -156,13 +156,14 @@ public:
 
 	AbstractEvent(): 
 		_executeAsync(this, &AbstractEvent::executeAsyncImpl),
+		_pStrategy(new TStrategy),
 		_enabled(true)
 	{
 	}
 
 	AbstractEvent(const TStrategy& strat): 
 		_executeAsync(this, &AbstractEvent::executeAsyncImpl),
-		_strategy(strat),
+		_pStrategy(new TStrategy(strat)),
 		_enabled(true)
 	{	
 	}
@@ -177,7 +178,7 @@ public:
 		/// Exact behavior is determined by the TStrategy.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		_strategy.add(aDelegate);
+		strategy().add(aDelegate);
 	}
 	
 	void operator -= (const TDelegate& aDelegate)
@@ -186,7 +187,7 @@ public:
 		/// If the delegate is not found, this function does nothing.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		_strategy.remove(aDelegate);
+		strategy().remove(aDelegate);
 	}
 	
 	DelegateHandle add(const TDelegate& aDelegate)
@@ -198,7 +199,7 @@ public:
 		/// remove() to remove the delegate.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		return _strategy.add(aDelegate);
+		return strategy().add(aDelegate);
 	}
 	
 	void remove(DelegateHandle delegateHandle)
@@ -208,7 +209,7 @@ public:
 		/// If the delegate is not found, this function does nothing.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		_strategy.remove(delegateHandle);
+		strategy().remove(delegateHandle);
 	}
 		
 	void operator () (const void* pSender, TArgs& args)
@@ -239,15 +240,19 @@ public:
 		if (!_enabled) return;
 		
 		// thread-safeness: 
-		// copy should be faster and safer than blocking until
-		// execution ends
-		TStrategy strategy(_strategy);
+		// the delegates are invoked without holding the lock, using
+		// the current snapshot of the strategy, which is never modified
+		// while in use (see strategy())
+		SharedPtr<TStrategy> pStrategy(_pStrategy);
 		lock.unlock();
-		strategy.notify(pSender, args);
+		pStrategy->notify(pSender, args);
 	}
 
-	bool hasDelegates() const {
-		return !(_strategy.empty());
+	bool hasDelegates() const
+		/// Returns true if any delegates are registered.
+	{
+		typename TMutex::ScopedLock lock(_mutex);
+		return !_pStrategy->empty();
 	}
 
 	ActiveResult<TArgs> notifyAsync(const void* pSender, const TArgs& args)
@@ -267,12 +272,10 @@ public:
 			typename TMutex::ScopedLock lock(_mutex);
 
 			// thread-safeness: 
-			// copy should be faster and safer than blocking until
-			// execution ends
-			// make a copy of the strategy here to guarantee that
+			// hold on to the current snapshot of the strategy to guarantee that
 			// between notifyAsync and the execution of the method no changes can occur
 				
-			params.ptrStrat = SharedPtr<TStrategy>(new TStrategy(_strategy));
+			params.ptrStrat = _pStrategy;
 			params.enabled  = _enabled;
 		}
 		ActiveResult<TArgs> result = _executeAsync(params);
@@ -304,14 +307,14 @@ public:
 		/// Removes all delegates.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		_strategy.clear();
+		strategy().clear();
 	}
 	
 	bool empty() const
 		/// Checks if any delegates are registered at the delegate.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		return _strategy.empty();
+		return _pStrategy->empty();
 	}
 
 protected:
@@ -343,7 +346,22 @@ protected:
 		return retArgs;
 	}
 
-	TStrategy _strategy; /// The strategy used to notify observers.
+	TStrategy& strategy()
+		/// Returns the strategy for modification. The mutex must be locked.
+		///
+		/// The strategy is copied on write: if a notification currently uses
+		/// the strategy, it is copied first, and the copy replaces it. Thus,
+		/// notify() only has to take a reference to the current strategy
+		/// instead of copying it.
+	{
+		if (_pStrategy.referenceCount() > 1)
+		{
+			_pStrategy = new TStrategy(*_pStrategy);
+		}
+		return *_pStrategy;
+	}
+
+	SharedPtr<TStrategy> _pStrategy; /// The strategy used to notify observers.
 	bool      _enabled;  /// Stores if an event is enabled. Notfies on disabled events have no effect
 	                     /// but it is possible to change the observers.
 	mutable TMutex _mutex;
@@ -362,13 +380,14 @@ public:
 
 	AbstractEvent(): 
 		_executeAsync(this, &AbstractEvent::executeAsyncImpl),
+		_pStrategy(new TStrategy),
 		_enabled(true)
 	{
 	}
 
 	AbstractEvent(const TStrategy& strat): 
 		_executeAsync(this, &AbstractEvent::executeAsyncImpl),
-		_strategy(strat),
+		_pStrategy(new TStrategy(strat)),
 		_enabled(true)
 	{	
 	}
@@ -383,7 +402,7 @@ public:
 		/// Exact behavior is determined by the TStrategy.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		_strategy.add(aDelegate);
+		strategy().add(aDelegate);
 	}
 	
 	void operator -= (const TDelegate& aDelegate)
@@ -392,7 +411,7 @@ public:
 		/// If the delegate is not found, this function does nothing.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		_strategy.remove(aDelegate);
+		strategy().remove(aDelegate);
 	}
 
 	DelegateHandle add(const TDelegate& aDelegate)
@@ -404,7 +423,7 @@ public:
 		/// remove() to remove the delegate.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		return _strategy.add(aDelegate);
+		return strategy().add(aDelegate);
 	}
 	
 	void remove(DelegateHandle delegateHandle)
@@ -414,7 +433,7 @@ public:
 		/// If the delegate is not found, this function does nothing.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		_strategy.remove(delegateHandle);
+		strategy().remove(delegateHandle);
 	}
 	
 	void operator () (const void* pSender)
@@ -445,11 +464,12 @@ public:
 		if (!_enabled) return;
 		
 		// thread-safeness: 
-		// copy should be faster and safer than blocking until
-		// execution ends
-		TStrategy strategy(_strategy);
+		// the delegates are invoked without holding the lock, using
+		// the current snapshot of the strategy, which is never modified
+		// while in use (see strategy())
+		SharedPtr<TStrategy> pStrategy(_pStrategy);
 		lock.unlock();
-		strategy.notify(pSender);
+		pStrategy->notify(pSender);
 	}
 
 	ActiveResult<void> notifyAsync(const void* pSender)
@@ -469,12 +489,10 @@ public:
 			typename TMutex::ScopedLock lock(_mutex);
 
 			// thread-safeness: 
-			// copy should be faster and safer than blocking until
-			// execution ends
-			// make a copy of the strategy here to guarantee that
+			// hold on to the current snapshot of the strategy to guarantee that
 			// between notifyAsync and the execution of the method no changes can occur
 				
-			params.ptrStrat = SharedPtr<TStrategy>(new TStrategy(_strategy));
+			params.ptrStrat = _pStrategy;
 			params.enabled  = _enabled;
 		}
 		ActiveResult<void> result = _executeAsync(params);
@@ -506,14 +524,14 @@ public:
 		/// Removes all delegates.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		_strategy.clear();
+		strategy().clear();
 	}
 	
 	bool empty() const
 		/// Checks if any delegates are registered at the delegate.
 	{
 		typename TMutex::ScopedLock lock(_mutex);
-		return _strategy.empty();
+		return _pStrategy->empty();
 	}
 
 protected:
@@ -543,7 +561,22 @@ protected:
 		return;
 	}
 
-	TStrategy _strategy; /// The strategy used to notify observers.
+	TStrategy& strategy()
+		/// Returns the strategy for modification. The mutex must be locked.
+		///
+		/// The strategy is copied on write: if a notification currently uses
+		/// the strategy, it is copied first, and the copy replaces it. Thus,
+		/// notify() only has to take a reference to the current strategy
+		/// instead of copying it.
+	{
+		if (_pStrategy.referenceCount() > 1)
+		{
+			_pStrategy = new TStrategy(*_pStrategy);
+		}
+		return *_pStrategy;
+	}
+
+	SharedPtr<TStrategy> _pStrategy; /// The strategy used to notify observers.
 	bool      _enabled;  /// Stores if an event is enabled. Notfies on disabled events have no effect
 	                     /// but it is possible to change the observers.
 	mutable TMutex _mutex;
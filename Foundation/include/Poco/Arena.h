@@ -0,0 +1,275 @@
+//
+// Arena.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/Arena.h#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  Arena
+//
+// Definition of the Arena class and the ArenaAllocator class template.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_Arena_INCLUDED
+#define Foundation_Arena_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include <cstddef>
+#include <new>
+
+
+namespace Poco {
+
+
+class Foundation_API Arena
+	/// An Arena is a monotonic memory allocator for objects
+	/// that all have the same lifetime, e.g. the objects
+	/// created while handling a single request.
+	///
+	/// Memory is taken from chunks of a fixed size by simply
+	/// advancing a pointer. Individual allocations are never
+	/// freed; instead, reset() releases all memory allocated
+	/// from the Arena at once. The chunks are kept for reuse,
+	/// so an Arena that is reset after every request does not
+	/// allocate any memory from the system once it has grown
+	/// to the size needed by a request. Allocations larger
+	/// than a chunk get a chunk of their own, which is freed
+	/// by reset().
+	///
+	/// The Arena never calls destructors. Objects with non-trivial
+	/// destructors created in an Arena must be destroyed explicitly
+	/// before the Arena is reset.
+	///
+	/// An Arena is not thread-safe.
+{
+public:
+	enum
+	{
+		DEFAULT_CHUNK_SIZE = 4096,
+		DEFAULT_ALIGNMENT  = 2*sizeof(void*)
+	};
+
+	explicit Arena(std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+		/// Creates the Arena, using chunks of the given size.
+		/// No memory is allocated until the first call to
+		/// allocate().
+
+	~Arena();
+		/// Destroys the Arena and frees all chunks.
+
+	void* allocate(std::size_t size, std::size_t alignment = DEFAULT_ALIGNMENT);
+		/// Allocates size bytes, aligned to the given
+		/// alignment, which must be a power of two.
+
+	void reset();
+		/// Releases all memory allocated from the Arena.
+		/// The chunks are kept for reuse, except those
+		/// that have been allocated for a single large
+		/// allocation.
+
+	void clear();
+		/// Releases all memory allocated from the Arena,
+		/// and frees all chunks.
+
+	std::size_t chunkSize() const;
+		/// Returns the chunk size.
+
+	std::size_t bytesUsed() const;
+		/// Returns the number of bytes allocated since
+		/// the last reset(), including alignment padding.
+
+	std::size_t capacity() const;
+		/// Returns the number of bytes in all chunks
+		/// owned by the Arena.
+
+	UInt64 allocations() const;
+		/// Returns the total number of calls to allocate().
+
+	UInt64 chunkAllocations() const;
+		/// Returns the total number of chunks allocated
+		/// from the system.
+
+private:
+	Arena(const Arena&);
+	Arena& operator = (const Arena&);
+
+	struct Chunk
+	{
+		Chunk*      pNext;
+		std::size_t size;
+	};
+
+	Chunk* newChunk(std::size_t size);
+	void* grow(std::size_t size, std::size_t alignment);
+	static void freeChunks(Chunk* pChunk);
+	static char* data(Chunk* pChunk);
+
+	std::size_t _chunkSize;
+	Chunk*      _pUsed;    // chunks in use, current chunk first
+	Chunk*      _pFree;    // chunks kept for reuse
+	Chunk*      _pLarge;   // chunks for single large allocations
+	char*       _pPos;
+	char*       _pEnd;
+	std::size_t _bytesUsed;
+	std::size_t _capacity;
+	UInt64      _allocations;
+	UInt64      _chunkAllocations;
+};
+
+
+template <class T>
+class ArenaAllocator
+	/// A standard library allocator that allocates
+	/// memory from an Arena. Deallocation does nothing;
+	/// the memory is released when the Arena is reset.
+	///
+	/// Example:
+	///     typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+	///     ArenaAllocator<char> alloc(arena);
+	///     ArenaString s(alloc);
+{
+public:
+	typedef T              value_type;
+	typedef T*             pointer;
+	typedef const T*       const_pointer;
+	typedef T&             reference;
+	typedef const T&       const_reference;
+	typedef std::size_t    size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	template <class U>
+	struct rebind
+	{
+		typedef ArenaAllocator<U> other;
+	};
+
+	explicit ArenaAllocator(Arena& arena):
+		_pArena(&arena)
+	{
+	}
+
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U>& other):
+		_pArena(&other.arena())
+	{
+	}
+
+	pointer address(reference value) const
+	{
+		return &value;
+	}
+
+	const_pointer address(const_reference value) const
+	{
+		return &value;
+	}
+
+	pointer allocate(size_type n, const void* = 0)
+	{
+		std::size_t alignment = 1;
+		while (alignment < sizeof(T) && alignment < Arena::DEFAULT_ALIGNMENT) alignment *= 2;
+		return static_cast<pointer>(_pArena->allocate(n*sizeof(T), alignment));
+	}
+
+	void deallocate(pointer, size_type)
+	{
+	}
+
+	size_type max_size() const
+	{
+		return static_cast<size_type>(-1)/sizeof(T);
+	}
+
+	void construct(pointer p, const T& value)
+	{
+		new (static_cast<void*>(p)) T(value);
+	}
+
+	void destroy(pointer p)
+	{
+		p->~T();
+	}
+
+	Arena& arena() const
+	{
+		return *_pArena;
+	}
+
+private:
+	Arena* _pArena;
+};
+
+
+template <class T, class U>
+inline bool operator == (const ArenaAllocator<T>& a1, const ArenaAllocator<U>& a2)
+{
+	return &a1.arena() == &a2.arena();
+}
+
+
+template <class T, class U>
+inline bool operator != (const ArenaAllocator<T>& a1, const ArenaAllocator<U>& a2)
+{
+	return &a1.arena() != &a2.arena();
+}
+
+
+//
+// inlines
+//
+inline void* Arena::allocate(std::size_t size, std::size_t alignment)
+{
+	++_allocations;
+	std::size_t padding = (alignment - reinterpret_cast<std::size_t>(_pPos)) & (alignment - 1);
+	if (_pPos && padding + size <= static_cast<std::size_t>(_pEnd - _pPos))
+	{
+		char* ptr = _pPos + padding;
+		_pPos = ptr + size;
+		_bytesUsed += padding + size;
+		return ptr;
+	}
+	return grow(size, alignment);
+}
+
+
+inline std::size_t Arena::chunkSize() const
+{
+	return _chunkSize;
+}
+
+
+inline std::size_t Arena::bytesUsed() const
+{
+	return _bytesUsed;
+}
+
+
+inline std::size_t Arena::capacity() const
+{
+	return _capacity;
+}
+
+
+inline UInt64 Arena::allocations() const
+{
+	return _allocations;
+}
+
+
+inline UInt64 Arena::chunkAllocations() const
+{
+	return _chunkAllocations;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_Arena_INCLUDED
@@ -26,6 +26,7 @@
 #include "Poco/Mutex.h"
 #include "Poco/Runnable.h"
 #include "Poco/NotificationQueue.h"
+#include "Poco/BoundedNotificationQueue.h"
 
 
 namespace Poco {
@@ -40,11 +41,21 @@ class Foundation_API AsyncChannel: public Channel, public Runnable
 	///
 	/// All log messages are put into a queue and this queue is
 	/// then processed by a separate thread.
+	///
+	/// By default, the queue is unbounded. If a queue size is
+	/// given, a BoundedNotificationQueue with (at least) that
+	/// capacity is used instead. Messages are then enqueued without
+	/// taking a lock, but if the queue is full, log() waits until
+	/// the logging thread has caught up.
 {
 public:
-	AsyncChannel(Channel* pChannel = 0, Thread::Priority prio = Thread::PRIO_NORMAL);
+	AsyncChannel(Channel* pChannel = 0, Thread::Priority prio = Thread::PRIO_NORMAL, int queueSize = 0);
 		/// Creates the AsyncChannel and connects it to
 		/// the given channel.
+		///
+		/// If queueSize is greater than zero, the message queue
+		/// is bounded to (at least) queueSize messages. Otherwise,
+		/// the queue is unbounded.
 
 	void setChannel(Channel* pChannel);
 		/// Connects the AsyncChannel to the given target channel.
@@ -81,11 +92,21 @@ public:
 		///    * highest
 		///
 		/// The "priority" property is set-only.
+		///
+		/// The "queueSize" property sets the maximum number of
+		/// queued messages. The value "none" or 0 (default) selects an
+		/// unbounded queue. The queue size can only be changed while
+		/// the channel is closed; otherwise, an IllegalStateException
+		/// is thrown.
+
+	std::string getProperty(const std::string& name) const;
+		/// Returns the value of the "queueSize" property.
 
 protected:
 	~AsyncChannel();
 	void run();
 	void setPriority(const std::string& value);
+	void setQueueSize(const std::string& value);
 		
 private:
 	Channel*  _pChannel;
@@ -93,6 +114,7 @@ private:
 	FastMutex _threadMutex;
 	FastMutex _channelMutex;
 	NotificationQueue _queue;
+	BoundedNotificationQueue* _pBoundedQueue;
 };
 
 
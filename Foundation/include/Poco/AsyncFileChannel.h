@@ -0,0 +1,194 @@
+//
+// AsyncFileChannel.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/AsyncFileChannel.h#1 $
+//
+// Library: Foundation
+// Package: Logging
+// Module:  AsyncFileChannel
+//
+// Definition of the AsyncFileChannel class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_AsyncFileChannel_INCLUDED
+#define Foundation_AsyncFileChannel_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/FileChannel.h"
+#include "Poco/Formatter.h"
+#include "Poco/BoundedNotificationQueue.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+
+
+namespace Poco {
+
+
+class Foundation_API AsyncFileChannel: public FileChannel, public Runnable
+	/// A FileChannel that writes to the log file in a
+	/// separate thread, for applications that produce
+	/// huge amounts of log messages.
+	///
+	/// Unlike an AsyncChannel, the AsyncFileChannel does not copy
+	/// messages to the heap. log() copies the message into a record
+	/// taken from a pool of preallocated records, and puts the record
+	/// into a queue. Both the pool and the queue are BoundedNotificationQueue
+	/// objects, so log() neither locks a mutex nor allocates memory, unless
+	/// it has to wait for a free record.
+	///
+	/// A record has room for the message's source and thread name
+	/// (see MAX_SOURCE_LENGTH and MAX_THREAD_LENGTH) and for a text
+	/// of limited length (see the maxTextLength property); longer
+	/// strings are truncated. The priority, time, thread and process
+	/// ids and the source file location are kept as well. A message
+	/// that has named parameters is copied to the heap as a whole,
+	/// so that its parameters are available to the formatter;
+	/// its text is not truncated.
+	///
+	/// The background thread formats the messages (by default, with a
+	/// PatternFormatter) and collects the formatted lines until there
+	/// are no more messages in the queue, or the batch size is reached.
+	/// Then, all lines are written to the file at once. Rotation,
+	/// archiving and purging work as with a FileChannel, except that
+	/// the rotation strategy is consulted only once per batch.
+	///
+	/// If all records are in use, log() either waits until the
+	/// background thread has caught up, or discards the message,
+	/// depending on the overflow policy. The number of discarded
+	/// messages is counted.
+	///
+	/// In addition to the properties supported by FileChannel,
+	/// the following properties are supported:
+	///   * capacity:  The number of records (default 1024). Can only be
+	///                changed while the channel is closed.
+	///   * maxTextLength: The maximum length of a message text kept
+	///                in a record (default 1024). Longer texts are
+	///                truncated. Can only be changed while the channel
+	///                is closed.
+	///   * overflow:  What to do if all records are in use: "block" (wait
+	///                until a record becomes free, default) or "drop"
+	///                (discard the message).
+	///   * batchSize: The number of bytes after which collected lines are
+	///                written to the file (default 65536).
+	///   * pattern:   The pattern of the PatternFormatter used to format
+	///                messages (default "%Y-%m-%d %H:%M:%S.%i [%p] %s: %t").
+	///   * dropped:   The number of discarded messages (read-only).
+{
+public:
+	enum
+	{
+		DEFAULT_CAPACITY    = 1024,
+		DEFAULT_BATCH_SIZE  = 65536,
+		DEFAULT_MAX_TEXT_LENGTH = 1024,
+		MAX_SOURCE_LENGTH   = 64,
+		MAX_THREAD_LENGTH   = 64
+	};
+
+	enum OverflowPolicy
+	{
+		OVERFLOW_BLOCK, /// log() waits until a record becomes free.
+		OVERFLOW_DROP   /// log() discards the message.
+	};
+
+	AsyncFileChannel();
+		/// Creates the AsyncFileChannel.
+
+	AsyncFileChannel(const std::string& path);
+		/// Creates the AsyncFileChannel for a file with the given path.
+
+	void open();
+		/// Opens the log file and starts the background thread.
+
+	void close();
+		/// Writes all queued messages, stops the background
+		/// thread and closes the log file.
+
+	void log(const Message& msg);
+		/// Queues the message for writing by the background thread.
+
+	void setFormatter(Formatter* pFormatter);
+		/// Sets the Formatter used to format messages.
+
+	Formatter* getFormatter() const;
+		/// Returns the Formatter used to format messages.
+
+	void setOverflowPolicy(OverflowPolicy policy);
+		/// Sets the overflow policy.
+
+	OverflowPolicy getOverflowPolicy() const;
+		/// Returns the overflow policy.
+
+	int dropped() const;
+		/// Returns the number of discarded messages.
+
+	void setProperty(const std::string& name, const std::string& value);
+		/// Sets the property with the given name.
+		///
+		/// See the class documentation for the supported properties.
+
+	std::string getProperty(const std::string& name) const;
+		/// Returns the value of the property with the given name.
+
+	static const std::string PROP_CAPACITY;
+	static const std::string PROP_MAXTEXTLENGTH;
+	static const std::string PROP_OVERFLOW;
+	static const std::string PROP_BATCHSIZE;
+	static const std::string PROP_PATTERN;
+	static const std::string PROP_DROPPED;
+
+protected:
+	~AsyncFileChannel();
+	void run();
+	void setCapacity(int capacity);
+	void setMaxTextLength(int maxTextLength);
+	void writeBatch(std::string& batch);
+
+private:
+	void init(int capacity, int maxTextLength);
+
+	typedef SharedPtr<BoundedNotificationQueue> QueuePtr;
+
+	QueuePtr                _pFree;
+	QueuePtr                _pPending;
+	int                     _capacity;
+	int                     _maxTextLength;
+	OverflowPolicy          _overflow;
+	std::size_t             _batchSize;
+	Formatter*              _pFormatter;
+	AtomicCounter           _dropped;
+	volatile bool           _running;
+	Thread                  _thread;
+	FastMutex               _threadMutex;
+	mutable FastMutex       _formatterMutex;
+};
+
+
+//
+// inlines
+//
+inline AsyncFileChannel::OverflowPolicy AsyncFileChannel::getOverflowPolicy() const
+{
+	return _overflow;
+}
+
+
+inline int AsyncFileChannel::dropped() const
+{
+	return _dropped.value();
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_AsyncFileChannel_INCLUDED
@@ -0,0 +1,187 @@
+//
+// BinaryLogChannel.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/BinaryLogChannel.h#1 $
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BinaryLogChannel
+//
+// Definition of the BinaryLogChannel class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_BinaryLogChannel_INCLUDED
+#define Foundation_BinaryLogChannel_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Channel.h"
+#include "Poco/SharedMemory.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Mutex.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+class RotateStrategy;
+class PurgeStrategy;
+
+
+class Foundation_API BinaryLogChannel: public Channel
+	/// A Channel that writes log messages in a structured
+	/// binary format to memory-mapped segment files.
+	///
+	/// Messages are not formatted when they are logged. Instead,
+	/// the time, priority, source, thread name, thread and process
+	/// ids, text and all parameters of a message are copied into a
+	/// length-prefixed record, which is appended to the current
+	/// segment. Use a BinaryLogReader to read the records back and
+	/// a Formatter to format them.
+	///
+	/// The segments of a log with the path <path> are named
+	/// <path>.0, <path>.1, <path>.2, etc. Every time the channel
+	/// is opened, a new segment following the existing ones is
+	/// started. A segment file is created with its full size
+	/// (see the segmentSize property) and mapped into memory, so
+	/// logging a message does not require a system call. When a
+	/// segment is full or must be rotated, the next segment is
+	/// started. Segment files are never shrunk, as a reader may
+	/// have mapped them, but on most file systems the unused part
+	/// of a segment does not occupy any disk space.
+	///
+	/// Every segment starts with a header that contains a sparse
+	/// index of record timestamps, which a BinaryLogReader uses to
+	/// find the records for a given time quickly. Records are
+	/// stored in host byte order; a reader refuses segments written
+	/// on a machine with a different byte order.
+	///
+	/// The BinaryLogChannel supports the following properties:
+	///   * path:        The base path of the segment files.
+	///   * segmentSize: The size of a segment file in bytes (default 8 MB).
+	///                  A suffix K or M can be given for kilo- or megabytes.
+	///   * rotation:    Additional rotation of segments, specified as
+	///                  for a FileChannel ("never", <n> [K|M], <n> seconds,
+	///                  minutes, hours, days, weeks, months, daily,
+	///                  weekly, monthly, or [day,][hh]:mm). Only the
+	///                  built-in RotateStrategy classes can be used, as
+	///                  they can decide without a LogFile.
+	///   * times:       Whether [day,][hh]:mm rotation times are in "utc"
+	///                  (default) or "local" time.
+	///   * purgeAge:    Maximum age of segment files, as for a FileChannel.
+	///   * purgeCount:  Maximum number of segment files. When a new segment
+	///                  is started, the segments with the lowest numbers
+	///                  are deleted.
+{
+public:
+	enum
+	{
+		SEGMENT_MAGIC        = 0x474C4250, /// "PBLG"
+		SEGMENT_VERSION      = 1,
+		BYTE_ORDER_MARK      = 0xFEFF,
+		HEADER_SIZE          = 4096,
+		INDEX_OFFSET         = 32,
+		INDEX_ENTRY_SIZE     = 16,
+		INDEX_CAPACITY       = (HEADER_SIZE - INDEX_OFFSET)/INDEX_ENTRY_SIZE,
+		RECORD_HEADER_SIZE   = 32,
+		RECORD_ALIGNMENT     = 8,
+		DEFAULT_SEGMENT_SIZE = 8*1024*1024
+	};
+
+	BinaryLogChannel();
+		/// Creates the BinaryLogChannel.
+
+	BinaryLogChannel(const std::string& path);
+		/// Creates the BinaryLogChannel with the given base path.
+
+	void open();
+		/// Starts a new segment.
+
+	void close();
+		/// Closes the current segment.
+
+	void log(const Message& msg);
+		/// Appends the message to the current segment.
+
+	void setProperty(const std::string& name, const std::string& value);
+		/// Sets the property with the given name.
+		///
+		/// See the class documentation for the supported properties.
+
+	std::string getProperty(const std::string& name) const;
+		/// Returns the value of the property with the given name.
+
+	const std::string& path() const;
+		/// Returns the base path of the segment files.
+
+	std::string segmentPath() const;
+		/// Returns the path of the current segment file,
+		/// or an empty string if the channel is not open.
+
+	static std::string segmentPath(const std::string& path, unsigned number);
+		/// Returns the path of the segment with the given number.
+
+	static void listSegments(const std::string& path, std::vector<unsigned>& numbers);
+		/// Fills numbers with the numbers of all existing segments
+		/// of the log with the given base path, in ascending order.
+
+	static const std::string PROP_PATH;
+	static const std::string PROP_SEGMENTSIZE;
+	static const std::string PROP_ROTATION;
+	static const std::string PROP_TIMES;
+	static const std::string PROP_PURGEAGE;
+	static const std::string PROP_PURGECOUNT;
+
+protected:
+	~BinaryLogChannel();
+	void openSegment(std::size_t minSize);
+	void closeSegment();
+	void setRotation(const std::string& rotation);
+	void setPurgeAge(const std::string& age);
+	void setPurgeCount(const std::string& count);
+	void purge();
+
+	static std::size_t recordSize(const Message& msg);
+
+private:
+	std::string     _path;
+	std::string     _times;
+	std::string     _rotation;
+	std::string     _purgeAge;
+	std::string     _purgeCount;
+	std::size_t     _segmentSize;
+	RotateStrategy* _pRotateStrategy;
+	PurgeStrategy*  _pPurgeStrategy;
+	std::size_t     _maxSegments;
+	SharedMemory    _segment;
+	unsigned        _segmentNumber;
+	std::size_t     _writePos;
+	unsigned        _indexCount;
+	std::size_t     _nextIndexPos;
+	std::size_t     _indexInterval;
+	Timestamp       _creationDate;
+	bool            _isOpen;
+	FastMutex       _mutex;
+};
+
+
+//
+// inlines
+//
+inline const std::string& BinaryLogChannel::path() const
+{
+	return _path;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_BinaryLogChannel_INCLUDED
@@ -0,0 +1,131 @@
+//
+// BinaryLogReader.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/BinaryLogReader.h#1 $
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BinaryLogChannel
+//
+// Definition of the BinaryLogReader class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_BinaryLogReader_INCLUDED
+#define Foundation_BinaryLogReader_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/SharedMemory.h"
+#include "Poco/Timestamp.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+class Message;
+
+
+class Foundation_API BinaryLogReader
+	/// This class reads the log messages written by a
+	/// BinaryLogChannel.
+	///
+	/// The reader iterates over the records of all segments
+	/// that existed when it was created, in the order in which
+	/// they have been written. Each segment is mapped into memory
+	/// while it is being read. A segment that is still being
+	/// written by a BinaryLogChannel can be read as well; records
+	/// appended to the current segment after the reader has
+	/// reached its end are returned by subsequent calls to read().
+	///
+	/// seek() uses the sparse index in the segment headers to
+	/// find the first record with a given timestamp or later
+	/// without reading all records before it. This assumes that
+	/// records have been logged in chronological order, which
+	/// is true as long as messages are logged immediately after
+	/// they have been created.
+	///
+	/// Usage example:
+	///     BinaryLogReader reader("app.blog");
+	///     reader.seek(start);
+	///     Message msg;
+	///     std::string text;
+	///     while (reader.read(msg))
+	///     {
+	///         text.clear();
+	///         formatter.format(msg, text);
+	///         std::cout << text << std::endl;
+	///     }
+{
+public:
+	BinaryLogReader(const std::string& path);
+		/// Creates the BinaryLogReader for the log with the
+		/// given base path (see BinaryLogChannel).
+
+	~BinaryLogReader();
+		/// Destroys the BinaryLogReader.
+
+	bool read(Message& msg);
+		/// Reads the next record into msg. Parameters that msg
+		/// had before and that are not in the record are removed.
+		///
+		/// Returns false if there are no more records.
+		///
+		/// Throws a DataFormatException if a segment is not
+		/// a valid segment of a binary log, or if a string length
+		/// or the parameter count of the record exceeds the
+		/// record's length.
+
+	void seek(const Timestamp& time);
+		/// Positions the reader at the first record whose
+		/// timestamp is not earlier than the given time.
+
+	void rewind();
+		/// Positions the reader at the first record.
+
+	std::size_t segments() const;
+		/// Returns the number of segments.
+
+protected:
+	const char* current();
+		/// Returns a pointer to the current record, moving to the
+		/// next segment if necessary, or null if there are no more
+		/// records.
+
+	void openSegment(std::size_t index);
+	void closeSegment();
+
+private:
+	BinaryLogReader();
+	BinaryLogReader(const BinaryLogReader&);
+	BinaryLogReader& operator = (const BinaryLogReader&);
+
+	std::string           _path;
+	std::vector<unsigned> _segments;
+	std::size_t           _next;
+	SharedMemory          _segment;
+	std::size_t           _size;
+	std::size_t           _pos;
+	std::string           _buffer;
+};
+
+
+//
+// inlines
+//
+inline std::size_t BinaryLogReader::segments() const
+{
+	return _segments.size();
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_BinaryLogReader_INCLUDED
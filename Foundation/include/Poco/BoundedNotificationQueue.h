@@ -0,0 +1,216 @@
+//
+// BoundedNotificationQueue.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/BoundedNotificationQueue.h#1 $
+//
+// Library: Foundation
+// Package: Notifications
+// Module:  BoundedNotificationQueue
+//
+// Definition of the BoundedNotificationQueue class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_BoundedNotificationQueue_INCLUDED
+#define Foundation_BoundedNotificationQueue_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Notification.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Condition.h"
+#include "Poco/Mutex.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+class NotificationCenter;
+
+
+class Foundation_API BoundedNotificationQueue
+	/// A BoundedNotificationQueue is a NotificationQueue with a
+	/// fixed capacity, for use by many producer and consumer threads.
+	///
+	/// The notifications are stored in a ring buffer. On platforms with
+	/// atomic compare-and-swap operations (see AtomicCounter), enqueueing
+	/// and dequeueing notifications is lock-free. Threads only block if
+	/// they have to wait because the queue is empty (or full). On Linux,
+	/// waiting threads are parked on a futex; on other platforms, a
+	/// Condition is used.
+	///
+	/// The interface is the same as the one of NotificationQueue, except
+	/// that there are no urgent notifications, and enqueueNotification()
+	/// waits until there is room in the queue if the queue is full.
+	/// tryEnqueueNotification() can be used to enqueue a notification
+	/// without waiting.
+	///
+	/// The same shut down sequence as for a NotificationQueue should be
+	/// used (see NotificationQueue).
+{
+public:
+	enum
+	{
+		DEFAULT_CAPACITY = 1024
+	};
+
+	explicit BoundedNotificationQueue(int capacity = DEFAULT_CAPACITY);
+		/// Creates the BoundedNotificationQueue. The capacity is
+		/// rounded up to the next power of two.
+
+	~BoundedNotificationQueue();
+		/// Destroys the BoundedNotificationQueue.
+
+	void enqueueNotification(Notification::Ptr pNotification);
+		/// Enqueues the given notification by adding it to
+		/// the end of the queue (FIFO). If the queue is full,
+		/// waits until there is room in the queue.
+		/// The queue takes ownership of the notification, thus
+		/// a call like
+		///     notificationQueue.enqueueNotification(new MyNotification);
+		/// does not result in a memory leak.
+
+	bool tryEnqueueNotification(Notification::Ptr pNotification);
+		/// Enqueues the given notification by adding it to
+		/// the end of the queue (FIFO), if the queue is not full.
+		///
+		/// Returns true if the notification has been enqueued,
+		/// or false if the queue is full.
+
+	Notification* dequeueNotification();
+		/// Dequeues the next pending notification.
+		/// Returns 0 (null) if no notification is available.
+		/// The caller gains ownership of the notification and
+		/// is expected to release it when done with it.
+		///
+		/// It is highly recommended that the result is immediately
+		/// assigned to a Notification::Ptr, to avoid potential
+		/// memory management issues.
+
+	Notification* waitDequeueNotification();
+		/// Dequeues the next pending notification.
+		/// If no notification is available, waits for a notification
+		/// to be enqueued.
+		/// The caller gains ownership of the notification and
+		/// is expected to release it when done with it.
+		/// This method returns 0 (null) if wakeUpAll()
+		/// has been called by another thread.
+		///
+		/// It is highly recommended that the result is immediately
+		/// assigned to a Notification::Ptr, to avoid potential
+		/// memory management issues.
+
+	Notification* waitDequeueNotification(long milliseconds);
+		/// Dequeues the next pending notification.
+		/// If no notification is available, waits for a notification
+		/// to be enqueued up to the specified time.
+		/// Returns 0 (null) if no notification is available.
+		/// The caller gains ownership of the notification and
+		/// is expected to release it when done with it.
+		///
+		/// It is highly recommended that the result is immediately
+		/// assigned to a Notification::Ptr, to avoid potential
+		/// memory management issues.
+
+	void dispatch(NotificationCenter& notificationCenter);
+		/// Dispatches all queued notifications to the given
+		/// notification center.
+
+	void wakeUpAll();
+		/// Wakes up all threads that wait for a notification.
+
+	bool empty() const;
+		/// Returns true iff the queue is empty.
+
+	int size() const;
+		/// Returns the number of notifications in the queue.
+		/// The result is only a snapshot if other threads
+		/// use the queue at the same time.
+
+	int capacity() const;
+		/// Returns the maximum number of notifications in the queue.
+
+	void clear();
+		/// Removes all notifications from the queue.
+
+	bool hasIdleThreads() const;
+		/// Returns true if the queue has at least one thread waiting
+		/// for a notification.
+
+protected:
+	struct WaitList
+		/// The threads waiting until the queue is not empty
+		/// (or not full).
+		///
+		/// Bit 0 of state is set while threads are waiting, the
+		/// other bits count the wake-ups. Waking up the waiting
+		/// threads is therefore only expensive if a thread has
+		/// started to wait since the last wake-up.
+	{
+		WaitList();
+
+		volatile UInt32 state;
+		Mutex           mutex;    // used where futexes are not available
+		Condition       condition;
+	};
+
+	bool push(Notification* pNotification);
+	Notification* pop();
+	Notification* waitPop(long milliseconds);
+	UInt32 prepareWait(WaitList& waitList);
+	void wait(WaitList& waitList, UInt32 state, long milliseconds);
+	void wakeUp(WaitList& waitList);
+
+private:
+	BoundedNotificationQueue(const BoundedNotificationQueue&);
+	BoundedNotificationQueue& operator = (const BoundedNotificationQueue&);
+
+	struct Cell
+	{
+		volatile UInt32 sequence;
+		Notification*   pNotification;
+	};
+
+	enum
+	{
+		CACHE_LINE_SIZE = 64
+	};
+
+	std::vector<Cell> _cells;
+	UInt32            _mask;
+	char              _pad1[CACHE_LINE_SIZE];
+	volatile UInt32   _enqueuePos;
+	char              _pad2[CACHE_LINE_SIZE];
+	volatile UInt32   _dequeuePos;
+	char              _pad3[CACHE_LINE_SIZE];
+	AtomicCounter     _wakeUps;
+	WaitList          _notEmpty;
+	WaitList          _notFull;
+};
+
+
+//
+// inlines
+//
+inline int BoundedNotificationQueue::capacity() const
+{
+	return static_cast<int>(_cells.size());
+}
+
+
+inline bool BoundedNotificationQueue::hasIdleThreads() const
+{
+	return (_notEmpty.state & 1) != 0;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_BoundedNotificationQueue_INCLUDED
@@ -0,0 +1,98 @@
+//
+// Deflater.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/Deflater.h#1 $
+//
+// Library: Foundation
+// Package: Streams
+// Module:  ZLibStream
+//
+// Definition of the Deflater class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_Deflater_INCLUDED
+#define Foundation_Deflater_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include <cstddef>
+
+
+namespace Poco {
+
+
+class DeflaterImpl;
+
+
+class Foundation_API Deflater
+	/// Deflater compresses data in memory, using zlib
+	/// (see http://zlib.net), without going through a stream.
+	///
+	/// In contrast to DeflatingStreamBuf, the caller decides when
+	/// pending output is flushed, and the compression context can
+	/// be kept from one flush to the next. This is needed for
+	/// protocols that compress individual messages with a shared
+	/// context, like the WebSocket permessage-deflate extension.
+	///
+	/// Input is given with setInput() and consumed by deflate(),
+	/// which must be called until inputAvailable() returns zero.
+{
+public:
+	enum FlushMode
+	{
+		FLUSH_NONE,  /// Let zlib decide how much output to produce.
+		FLUSH_SYNC,  /// Flush all pending output to a byte boundary (Z_SYNC_FLUSH).
+		FLUSH_FINISH /// Complete the stream (Z_FINISH).
+	};
+
+	Deflater(int windowBits, int level);
+		/// Creates a Deflater.
+		///
+		/// Please refer to the zlib documentation of deflateInit2() for a description
+		/// of the windowBits parameter. A negative value selects a raw deflate
+		/// stream without header and checksum.
+		///
+		/// Throws an IOException if zlib cannot be initialized.
+
+	~Deflater();
+		/// Destroys the Deflater.
+
+	void setInput(const char* data, std::size_t length);
+		/// Sets the data to compress with the next calls to deflate().
+		/// The data must stay valid until it has been consumed.
+
+	std::size_t inputAvailable() const;
+		/// Returns the number of input bytes not yet consumed by deflate().
+
+	std::size_t deflate(char* buffer, std::size_t length, FlushMode flush);
+		/// Compresses input and stores up to length bytes of
+		/// compressed data in buffer. Returns the number of bytes
+		/// stored.
+		///
+		/// If the returned value equals length, more output may be
+		/// pending, and deflate() must be called again with the same
+		/// flush mode.
+
+	void reset();
+		/// Discards the compression context, so that the following
+		/// data is compressed independently of the preceding data.
+
+private:
+	Deflater();
+	Deflater(const Deflater&);
+	Deflater& operator = (const Deflater&);
+
+	DeflaterImpl* _pImpl;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_Deflater_INCLUDED
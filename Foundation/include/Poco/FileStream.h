@@ -73,6 +73,13 @@ public:
 	FileStreamBuf* rdbuf();
 		/// Returns a pointer to the underlying streambuf.
 
+	FileStreamBuf::NativeHandle nativeHandle() const;
+		/// Returns the native file handle (file descriptor
+		/// on POSIX platforms) of the open file.
+		///
+		/// The handle is owned by the stream and must not
+		/// be closed by the caller.
+
 protected:
 	FileStreamBuf _buf;
 	std::ios::openmode _defaultMode;
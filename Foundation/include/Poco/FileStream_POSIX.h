@@ -33,6 +33,8 @@ class Foundation_API FileStreamBuf: public BufferedBidirectionalStreamBuf
 	/// This stream buffer handles Fileio
 {
 public:
+	typedef int NativeHandle;
+
 	FileStreamBuf();
 		/// Creates a FileStreamBuf.
 		
@@ -52,6 +54,10 @@ public:
 	std::streampos seekpos(std::streampos pos, std::ios::openmode mode = std::ios::in | std::ios::out);
 		/// Change to specified position, according to mode.
 
+	NativeHandle nativeHandle() const;
+		/// Returns the file descriptor of the open file,
+		/// or -1 if no file is open.
+
 protected:
 	enum
 	{
@@ -68,6 +74,15 @@ private:
 };
 
 
+//
+// inlines
+//
+inline FileStreamBuf::NativeHandle FileStreamBuf::nativeHandle() const
+{
+	return _fd;
+}
+
+
 } // namespace Poco
 
 
@@ -32,6 +32,8 @@ class Foundation_API FileStreamBuf: public BufferedBidirectionalStreamBuf
 	/// This stream buffer handles Fileio
 {
 public:
+	typedef HANDLE NativeHandle;
+
 	FileStreamBuf();
 		/// Creates a FileStreamBuf.
 
@@ -51,6 +53,10 @@ public:
 	std::streampos seekpos(std::streampos pos, std::ios::openmode mode = std::ios::in | std::ios::out);
 		/// change to specified position, according to mode
 
+	NativeHandle nativeHandle() const;
+		/// Returns the file handle of the open file, or
+		/// INVALID_HANDLE_VALUE if no file is open.
+
 protected:
 	enum
 	{
@@ -67,6 +73,15 @@ private:
 };
 
 
+//
+// inlines
+//
+inline FileStreamBuf::NativeHandle FileStreamBuf::nativeHandle() const
+{
+	return _handle;
+}
+
+
 } // namespace Poco
 
 
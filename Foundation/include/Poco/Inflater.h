@@ -0,0 +1,90 @@
+//
+// Inflater.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/Inflater.h#1 $
+//
+// Library: Foundation
+// Package: Streams
+// Module:  ZLibStream
+//
+// Definition of the Inflater class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_Inflater_INCLUDED
+#define Foundation_Inflater_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include <cstddef>
+
+
+namespace Poco {
+
+
+class InflaterImpl;
+
+
+class Foundation_API Inflater
+	/// Inflater decompresses data in memory, using zlib
+	/// (see http://zlib.net), without going through a stream.
+	///
+	/// This is the counterpart of Deflater. Input is given with
+	/// setInput() and consumed by inflate().
+{
+public:
+	enum Status
+	{
+		INFLATE_OK,          /// Progress has been made.
+		INFLATE_STREAM_END,  /// The end of the compressed stream has been reached.
+		INFLATE_NO_PROGRESS  /// No progress was possible, because the output buffer is full or no input is available.
+	};
+
+	Inflater(int windowBits);
+		/// Creates an Inflater.
+		///
+		/// Please refer to the zlib documentation of inflateInit2() for a description
+		/// of the windowBits parameter. A negative value selects a raw deflate
+		/// stream without header and checksum.
+		///
+		/// Throws an IOException if zlib cannot be initialized.
+
+	~Inflater();
+		/// Destroys the Inflater.
+
+	void setInput(const char* data, std::size_t length);
+		/// Sets the data to decompress with the next calls to inflate().
+		/// The data must stay valid until it has been consumed.
+
+	std::size_t inputAvailable() const;
+		/// Returns the number of input bytes not yet consumed by inflate().
+
+	Status inflate(char* buffer, std::size_t length, std::size_t& written);
+		/// Decompresses input, flushing as much output as possible,
+		/// and stores up to length bytes of decompressed data in
+		/// buffer. The number of bytes stored is returned in written.
+		///
+		/// Throws a DataFormatException if the compressed data is invalid.
+
+	void reset();
+		/// Resets the Inflater, so that a new compressed stream
+		/// can be decompressed. Input not yet consumed is kept.
+
+private:
+	Inflater();
+	Inflater(const Inflater&);
+	Inflater& operator = (const Inflater&);
+
+	InflaterImpl* _pImpl;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_Inflater_INCLUDED
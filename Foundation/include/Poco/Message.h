@@ -186,9 +186,14 @@ public:
 		/// If the parameter does not exist, it is created with an
 		/// empty string value.
 
+	typedef std::map<std::string, std::string> StringMap;
+
+	const StringMap& getAll() const;
+		/// Returns a const reference to a map containing
+		/// all parameters.
+
 protected:
 	void init();
-	typedef std::map<std::string, std::string> StringMap;
 
 private:	
 	std::string _source;
@@ -22,6 +22,8 @@
 
 #include "Poco/Foundation.h"
 #include "Poco/Formatter.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Mutex.h"
 #include "Poco/Message.h"
 
 #include <vector>
@@ -29,6 +31,9 @@
 namespace Poco {
 
 
+class DateTime;
+
+
 class Foundation_API PatternFormatter: public Formatter
 	/// This Formatter allows for custom formatting of
 	/// log messages based on format patterns.
@@ -75,7 +80,23 @@ class Foundation_API PatternFormatter: public Formatter
 	///   * %E - epoch time (UTC, seconds since midnight, January 1, 1970)
 	///   * %v[width] - the message source (%s) but text length is padded/cropped to 'width'
 	///   * %[name] - the value of the message parameter with the given name
+	///   * %K - all message parameters as space-separated name=value pairs
+	///     (values containing spaces, quotes or equal signs are quoted)
 	///   * %% - percent sign
+	///
+	/// The format pattern is parsed only once, when it is set. Date and time
+	/// fields that are adjacent in the pattern (together with the text between
+	/// them) are formatted together, and the result is cached until the time of
+	/// a message is in a different second (or, if the fields include %i or %c,
+	/// in a different millisecond). The time zone differential is also only
+	/// determined once per second, so formatting a message with the
+	/// same timestamp resolution as the previous one does not require
+	/// any date/time calculations.
+	///
+	/// The cached text is protected by a sequence lock, so threads
+	/// sharing a PatternFormatter do not lock a mutex for cache hits.
+	/// A thread that finds the cache being updated by another thread
+	/// formats the date/time fields itself.
 
 {
 public:
@@ -119,11 +140,15 @@ public:
 protected:
 	static const std::string& getPriorityName(int);
 		/// Returns a string for the given priority value.
+
+	static void appendParameters(const Message& msg, std::string& text);
+		/// Appends all parameters of the message as
+		/// name=value pairs to text.
 	
 private:
 	struct PatternAction
 	{
-		PatternAction(): key(0), length(0) 
+		PatternAction(): key(0), length(0), cache(-1), count(0)
 		{
 		}
 
@@ -131,16 +156,64 @@ private:
 		int length;
 		std::string property;
 		std::string prepend;
+		int cache;  /// index of the TimeCache if this action starts a run of date/time fields, otherwise -1
+		int count;  /// number of actions in the run of date/time fields
+	};
+
+	struct TimeCache
+	{
+		enum
+		{
+			MAX_TEXT_LENGTH = 64 /// longer runs are not cached
+		};
+
+		TimeCache(): resolution(Timestamp::resolution()), sequence(0), time(0), localTime(false), valid(false), length(0)
+		{
+		}
+
+		Timestamp::TimeDiff resolution;
+		volatile UInt32     sequence;  /// odd while the cache is being updated
+		Timestamp::TimeVal  time;
+		bool                localTime;
+		bool                valid;
+		std::size_t         length;
+		char                text[MAX_TEXT_LENGTH];
 	};
 
 	void parsePattern();
 		/// Will parse the _pattern string into the vector of PatternActions,
 		/// which contains the message key, any text that needs to be written first
 		/// a proprety in case of %[] and required length.
+		///
+		/// Adjacent date/time fields are grouped into runs, each of
+		/// which gets a TimeCache.
+
+	void appendTimeRun(std::size_t index, const Timestamp& time, bool localTime, std::string& text);
+		/// Appends the run of date/time fields starting at the
+		/// given action, using the cached text if possible.
+
+	void formatTimeRun(std::size_t index, const Timestamp& time, bool localTime, std::string& text);
+		/// Formats the run of date/time fields starting at the
+		/// given action and appends it to text.
+
+	void appendTime(char key, const Timestamp& time, const DateTime& dateTime, int tzd, std::string& text);
+		/// Appends the given date/time field.
+
+	int timezoneDifferential(const Timestamp& time);
+		/// Returns Timezone::tzd(), which is determined at most
+		/// once per second.
+
+	static bool isTimeKey(char key);
+	static bool isMillisecondKey(char key);
 
 	std::vector<PatternAction> _patternActions;
+	std::vector<TimeCache> _timeCaches;
 	bool _localTime;
 	std::string _pattern;
+	std::string _nodeName;
+	Timestamp::TimeVal _tzdTime;
+	int _tzd;
+	FastMutex _mutex;
 };
 
 
@@ -36,6 +36,11 @@ namespace Poco {
 class Foundation_API RotateStrategy
 	/// The RotateStrategy is used by LogFile to determine when
 	/// a file must be rotated.
+	///
+	/// Subclasses only have to implement mustRotate(LogFile*) to
+	/// be used with a FileChannel. Channels that do not write through
+	/// a LogFile call mustRotate(const Timestamp&, UInt64) instead,
+	/// which all strategies in this file implement.
 {
 public:
 	RotateStrategy();
@@ -44,6 +49,21 @@ public:
 	virtual bool mustRotate(LogFile* pFile) = 0;
 		/// Returns true if the given log file must
 		/// be rotated, false otherwise.
+
+	virtual bool mustRotate(const Timestamp& creationDate, UInt64 size);
+		/// Returns true if a log file with the given creation
+		/// date and size must be rotated, false otherwise.
+		///
+		/// This is used by channels that do not write through
+		/// a LogFile, like the BinaryLogChannel. The default
+		/// implementation returns false, so a strategy that
+		/// does not override it never rotates such a file.
+		///
+		/// The BinaryLogChannel only creates the strategies
+		/// defined in this file, from its "rotation" property,
+		/// and rejects any other value with an
+		/// InvalidArgumentException, so a custom strategy
+		/// cannot be passed to it.
 		
 private:
 	RotateStrategy(const RotateStrategy&);
@@ -104,6 +124,11 @@ public:
 		return false;
 	}
 
+	bool mustRotate(const Timestamp& /*creationDate*/, UInt64 /*size*/)
+	{
+		return mustRotate(static_cast<LogFile*>(0));
+	}
+
 private:
 	void getNextRollover()
 	{
@@ -139,6 +164,7 @@ public:
 	RotateByIntervalStrategy(const Timespan& span);
 	~RotateByIntervalStrategy();
 	bool mustRotate(LogFile* pFile);
+	bool mustRotate(const Timestamp& creationDate, UInt64 size);
 
 private:
 	Timespan _span;
@@ -155,6 +181,7 @@ public:
 	RotateBySizeStrategy(UInt64 size);
 	~RotateBySizeStrategy();
 	bool mustRotate(LogFile* pFile);
+	bool mustRotate(const Timestamp& creationDate, UInt64 size);
 
 private:
 	UInt64 _size;
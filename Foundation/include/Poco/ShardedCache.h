@@ -0,0 +1,527 @@
+//
+// ShardedCache.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/ShardedCache.h#1 $
+//
+// Library: Foundation
+// Package: Cache
+// Module:  ShardedCache
+//
+// Definition of the ShardedCache class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_ShardedCache_INCLUDED
+#define Foundation_ShardedCache_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/HashMap.h"
+#include "Poco/Hash.h"
+#include "Poco/Mutex.h"
+#include "Poco/Clock.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <set>
+#include <cstddef>
+
+
+namespace Poco {
+
+
+template <class TKey, class TValue>
+struct CacheEntryCount
+	/// The default size function for a ShardedCache.
+	/// Every entry has the size 1, so the capacity
+	/// of the cache is the maximum number of entries.
+{
+	std::size_t operator () (const TKey&, const TValue&) const
+	{
+		return 1;
+	}
+};
+
+
+template <
+	class TKey,
+	class TValue,
+	class TSizeOf = CacheEntryCount<TKey, TValue>,
+	class THash   = Hash<TKey>,
+	class TMutex  = FastMutex
+>
+class ShardedCache
+	/// A ShardedCache is a cache for use by many threads at the same time.
+	///
+	/// Unlike AbstractCache, the ShardedCache does not use a strategy
+	/// object and does not fire events. The entries are distributed among
+	/// a number of shards by the hash value of their key, and every shard
+	/// has its own mutex and hash table. Threads accessing keys in
+	/// different shards therefore do not have to wait for each other.
+	///
+	/// If the total size of the entries in a shard would exceed the
+	/// shard's share of the capacity, entries are evicted using the
+	/// CLOCK algorithm, an approximation of LRU: every entry has a
+	/// reference bit, which is set by get(). When an entry has to be
+	/// evicted, the clock hand sweeps over the entries, clearing the
+	/// reference bits it finds set and evicting the first entry whose
+	/// reference bit is already clear. Unlike LRUStrategy, a cache hit
+	/// only sets a flag and never changes a list.
+	///
+	/// The size of an entry is given by the TSizeOf function object, which
+	/// is called with the key and the value. By default, every entry has the
+	/// size 1, so that the capacity is the maximum number of entries. To
+	/// bound the memory used by the cache, a TSizeOf returning the size of
+	/// an entry in bytes can be given instead.
+	///
+	/// Entries can also expire after a fixed time, either after they
+	/// have been added (like with ExpireStrategy), or after they have last
+	/// been accessed (like with AccessExpireStrategy). Expired entries
+	/// are removed when they are accessed, when the clock hand reaches
+	/// them, or when forceReplace() is called.
+	///
+	/// Like AbstractCache, the ShardedCache returns values as SharedPtr, which
+	/// remain valid after the entry has been removed from the cache.
+{
+public:
+	enum Expiration
+	{
+		EXPIRE_NEVER,        /// Entries never expire.
+		EXPIRE_AFTER_ADD,    /// Entries expire a fixed time after they have been added or updated.
+		EXPIRE_AFTER_ACCESS  /// Entries expire a fixed time after they have last been added, updated or read.
+	};
+
+	struct Statistics
+		/// Usage statistics of a ShardedCache.
+	{
+		UInt64      hits;        /// Number of successful calls to get().
+		UInt64      misses;      /// Number of unsuccessful calls to get().
+		UInt64      evictions;   /// Number of entries removed to make room for new entries.
+		UInt64      expirations; /// Number of entries removed because they have expired.
+		std::size_t entries;     /// Number of entries in the cache.
+		std::size_t size;        /// Total size of the entries in the cache.
+	};
+
+	enum
+	{
+		DEFAULT_SHARDS = 16
+	};
+
+	explicit ShardedCache(std::size_t capacity, int shards = DEFAULT_SHARDS, const TSizeOf& sizeOf = TSizeOf()):
+		_sizeOf(sizeOf),
+		_capacity(capacity),
+		_expiration(EXPIRE_NEVER),
+		_expireTime(0)
+		/// Creates a ShardedCache with the given capacity and number
+		/// of shards, which is rounded up to a power of two.
+		/// Entries never expire.
+		///
+		/// The number of shards is reduced if necessary, so that
+		/// every shard has a capacity of at least 1. Throws an
+		/// InvalidArgumentException if the capacity is 0.
+	{
+		init(shards);
+	}
+
+	ShardedCache(std::size_t capacity, Expiration expiration, Timestamp::TimeDiff expireTimeInMilliSec, int shards = DEFAULT_SHARDS, const TSizeOf& sizeOf = TSizeOf()):
+		_sizeOf(sizeOf),
+		_capacity(capacity),
+		_expiration(expiration),
+		_expireTime(expireTimeInMilliSec*1000)
+		/// Creates a ShardedCache with the given capacity and number
+		/// of shards, whose entries expire after the given time.
+		/// As with ExpireStrategy, the smallest allowed expiration
+		/// time is 25 ms.
+		///
+		/// As above, the number of shards is reduced for small
+		/// capacities.
+	{
+		if (_expiration != EXPIRE_NEVER && _expireTime < 25000) throw InvalidArgumentException("expireTime must be at least 25 ms");
+		init(shards);
+	}
+
+	~ShardedCache()
+		/// Destroys the ShardedCache.
+	{
+		for (typename ShardVec::iterator it = _shards.begin(); it != _shards.end(); ++it)
+		{
+			delete *it;
+		}
+	}
+
+	void add(const TKey& key, const TValue& val)
+		/// Adds the key value pair to the cache.
+		/// If for the key already an entry exists, it will be overwritten.
+	{
+		add(key, SharedPtr<TValue>(new TValue(val)));
+	}
+
+	void add(const TKey& key, SharedPtr<TValue> val)
+		/// Adds the key value pair to the cache. Note that adding a NULL SharedPtr will fail!
+		/// If for the key already an entry exists, it will be overwritten.
+		///
+		/// If the size of the entry exceeds the capacity of
+		/// its shard, the entry is not added.
+	{
+		poco_check_ptr (val.get());
+
+		std::size_t size = _sizeOf(key, *val);
+		Shard& shard = shardFor(key);
+		typename TMutex::ScopedLock lock(shard.mutex);
+
+		typename Index::Iterator it = shard.index.find(key);
+		if (it != shard.index.end())
+		{
+			std::size_t slot = it->second;
+			Entry& entry = shard.entries[slot];
+			shard.size -= entry.size;
+			entry.pValue     = val;
+			entry.size       = size;
+			entry.referenced = true;
+			entry.expires    = expiresAt();
+			shard.size += size;
+			if (shard.size > shard.capacity) makeRoom(shard, 0, slot);
+			if (shard.size > shard.capacity) remove(shard, slot);
+		}
+		else
+		{
+			if (size > shard.capacity) return;
+			if (shard.size + size > shard.capacity) makeRoom(shard, size, shard.entries.size());
+			std::size_t slot;
+			if (shard.freeSlots.empty())
+			{
+				slot = shard.entries.size();
+				shard.entries.push_back(Entry());
+			}
+			else
+			{
+				slot = shard.freeSlots.back();
+				shard.freeSlots.pop_back();
+			}
+			Entry& entry = shard.entries[slot];
+			entry.key        = key;
+			entry.pValue     = val;
+			entry.size       = size;
+			entry.referenced = false;
+			entry.used       = true;
+			entry.expires    = expiresAt();
+			shard.index.insert(typename Index::ValueType(key, slot));
+			shard.size += size;
+			++shard.entryCount;
+		}
+	}
+
+	void update(const TKey& key, const TValue& val)
+		/// Same as add(), for compatibility with AbstractCache.
+	{
+		add(key, val);
+	}
+
+	void update(const TKey& key, SharedPtr<TValue> val)
+		/// Same as add(), for compatibility with AbstractCache.
+	{
+		add(key, val);
+	}
+
+	SharedPtr<TValue> get(const TKey& key)
+		/// Returns a SharedPtr of the value. The SharedPointer will remain valid
+		/// even when cache replacement removes the element.
+		/// If for the key no value exists, an empty SharedPtr is returned.
+	{
+		Shard& shard = shardFor(key);
+		typename TMutex::ScopedLock lock(shard.mutex);
+
+		typename Index::Iterator it = shard.index.find(key);
+		if (it != shard.index.end())
+		{
+			Entry& entry = shard.entries[it->second];
+			if (!isExpired(entry))
+			{
+				entry.referenced = true;
+				if (_expiration == EXPIRE_AFTER_ACCESS) entry.expires = expiresAt();
+				++shard.hits;
+				return entry.pValue;
+			}
+			remove(shard, it->second);
+			++shard.expirations;
+		}
+		++shard.misses;
+		return SharedPtr<TValue>();
+	}
+
+	bool has(const TKey& key)
+		/// Returns true if the cache contains a value for the key.
+	{
+		Shard& shard = shardFor(key);
+		typename TMutex::ScopedLock lock(shard.mutex);
+
+		typename Index::Iterator it = shard.index.find(key);
+		return it != shard.index.end() && !isExpired(shard.entries[it->second]);
+	}
+
+	void remove(const TKey& key)
+		/// Removes an entry from the cache. If the entry is not found,
+		/// the remove is ignored.
+	{
+		Shard& shard = shardFor(key);
+		typename TMutex::ScopedLock lock(shard.mutex);
+
+		typename Index::Iterator it = shard.index.find(key);
+		if (it != shard.index.end()) remove(shard, it->second);
+	}
+
+	void clear()
+		/// Removes all elements from the cache.
+	{
+		for (typename ShardVec::iterator it = _shards.begin(); it != _shards.end(); ++it)
+		{
+			Shard& shard = **it;
+			typename TMutex::ScopedLock lock(shard.mutex);
+
+			shard.index.clear();
+			shard.entries.clear();
+			shard.freeSlots.clear();
+			shard.hand       = 0;
+			shard.size       = 0;
+			shard.entryCount = 0;
+		}
+	}
+
+	std::size_t size()
+		/// Returns the number of cached elements.
+	{
+		std::size_t n = 0;
+		for (typename ShardVec::iterator it = _shards.begin(); it != _shards.end(); ++it)
+		{
+			typename TMutex::ScopedLock lock((*it)->mutex);
+			n += (*it)->entryCount;
+		}
+		return n;
+	}
+
+	std::size_t capacity() const
+		/// Returns the capacity of the cache.
+	{
+		return _capacity;
+	}
+
+	int shards() const
+		/// Returns the number of shards.
+	{
+		return static_cast<int>(_shards.size());
+	}
+
+	void forceReplace()
+		/// Removes all expired entries.
+	{
+		if (_expiration == EXPIRE_NEVER) return;
+
+		for (typename ShardVec::iterator it = _shards.begin(); it != _shards.end(); ++it)
+		{
+			Shard& shard = **it;
+			typename TMutex::ScopedLock lock(shard.mutex);
+
+			for (std::size_t slot = 0; slot < shard.entries.size(); ++slot)
+			{
+				if (shard.entries[slot].used && isExpired(shard.entries[slot]))
+				{
+					remove(shard, slot);
+					++shard.expirations;
+				}
+			}
+		}
+	}
+
+	std::set<TKey> getAllKeys()
+		/// Returns a copy of all keys stored in the cache.
+	{
+		std::set<TKey> keys;
+		for (typename ShardVec::iterator it = _shards.begin(); it != _shards.end(); ++it)
+		{
+			Shard& shard = **it;
+			typename TMutex::ScopedLock lock(shard.mutex);
+
+			for (typename std::vector<Entry>::const_iterator itE = shard.entries.begin(); itE != shard.entries.end(); ++itE)
+			{
+				if (itE->used && !isExpired(*itE)) keys.insert(itE->key);
+			}
+		}
+		return keys;
+	}
+
+	Statistics statistics()
+		/// Returns the usage statistics of the cache.
+	{
+		Statistics stats = {0, 0, 0, 0, 0, 0};
+		for (typename ShardVec::iterator it = _shards.begin(); it != _shards.end(); ++it)
+		{
+			Shard& shard = **it;
+			typename TMutex::ScopedLock lock(shard.mutex);
+
+			stats.hits        += shard.hits;
+			stats.misses      += shard.misses;
+			stats.evictions   += shard.evictions;
+			stats.expirations += shard.expirations;
+			stats.entries     += shard.entryCount;
+			stats.size        += shard.size;
+		}
+		return stats;
+	}
+
+protected:
+	struct Entry
+	{
+		Entry():
+			size(0),
+			referenced(false),
+			used(false),
+			expires(0)
+		{
+		}
+
+		TKey              key;
+		SharedPtr<TValue> pValue;
+		std::size_t       size;
+		bool              referenced;
+		bool              used;
+		Clock             expires;
+	};
+
+	typedef HashMap<TKey, std::size_t, THash> Index;
+
+	struct Shard
+	{
+		Shard():
+			hand(0),
+			capacity(0),
+			size(0),
+			entryCount(0),
+			hits(0),
+			misses(0),
+			evictions(0),
+			expirations(0)
+		{
+		}
+
+		TMutex                   mutex;
+		Index                    index;
+		std::vector<Entry>       entries;
+		std::vector<std::size_t> freeSlots;
+		std::size_t              hand;
+		std::size_t              capacity;
+		std::size_t              size;
+		std::size_t              entryCount;
+		UInt64                   hits;
+		UInt64                   misses;
+		UInt64                   evictions;
+		UInt64                   expirations;
+	};
+
+	typedef std::vector<Shard*> ShardVec;
+
+	void init(int shards)
+	{
+		poco_assert (shards > 0);
+
+		if (_capacity == 0) throw InvalidArgumentException("capacity must be > 0");
+		std::size_t n = 1;
+		while (n < static_cast<std::size_t>(shards)) n *= 2;
+		// every shard must be able to hold at least one entry
+		while (n > _capacity) n /= 2;
+		_shardMask = n - 1;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			Shard* pShard = new Shard;
+			// the first shards get the remainder
+			pShard->capacity = _capacity/n + (i < _capacity % n ? 1 : 0);
+			_shards.push_back(pShard);
+		}
+	}
+
+	Shard& shardFor(const TKey& key)
+	{
+		std::size_t h = _hash(key);
+		// use other bits of the hash value than the shard's hash table
+		h ^= (h >> 15) ^ (h >> 7);
+		return *_shards[(h >> 3) & _shardMask];
+	}
+
+	Clock expiresAt() const
+	{
+		if (_expiration == EXPIRE_NEVER) return Clock(0);
+		Clock expires;
+		expires += _expireTime;
+		return expires;
+	}
+
+	bool isExpired(const Entry& entry) const
+	{
+		return _expiration != EXPIRE_NEVER && entry.expires.isElapsed(0);
+	}
+
+	void makeRoom(Shard& shard, std::size_t size, std::size_t keep)
+		/// Evicts entries, except the one in slot keep, until
+		/// an entry of the given size fits into the shard.
+	{
+		std::size_t n = shard.entries.size();
+		for (std::size_t i = 0; i < 2*n && shard.entryCount > 0 && shard.size + size > shard.capacity; ++i)
+		{
+			if (shard.hand >= n) shard.hand = 0;
+			std::size_t slot = shard.hand++;
+			Entry& entry = shard.entries[slot];
+			if (!entry.used || slot == keep) continue;
+			if (isExpired(entry))
+			{
+				remove(shard, slot);
+				++shard.expirations;
+			}
+			else if (entry.referenced)
+			{
+				entry.referenced = false;
+			}
+			else
+			{
+				remove(shard, slot);
+				++shard.evictions;
+			}
+		}
+	}
+
+	void remove(Shard& shard, std::size_t slot)
+	{
+		Entry& entry = shard.entries[slot];
+		shard.index.erase(entry.key);
+		shard.size -= entry.size;
+		--shard.entryCount;
+		entry.key        = TKey();
+		entry.pValue     = SharedPtr<TValue>();
+		entry.size       = 0;
+		entry.referenced = false;
+		entry.used       = false;
+		shard.freeSlots.push_back(slot);
+	}
+
+private:
+	ShardedCache(const ShardedCache&);
+	ShardedCache& operator = (const ShardedCache&);
+
+	THash               _hash;
+	TSizeOf             _sizeOf;
+	std::size_t         _capacity;
+	Expiration          _expiration;
+	Timestamp::TimeDiff _expireTime;
+	std::size_t         _shardMask;
+	ShardVec            _shards;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_ShardedCache_INCLUDED
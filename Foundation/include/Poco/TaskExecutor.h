@@ -0,0 +1,279 @@
+//
+// TaskExecutor.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/TaskExecutor.h#1 $
+//
+// Library: Foundation
+// Package: Threading
+// Module:  TaskExecutor
+//
+// Definition of the TaskExecutor class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_TaskExecutor_INCLUDED
+#define Foundation_TaskExecutor_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/ActiveResult.h"
+#include "Poco/ActiveRunnable.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Condition.h"
+#include "Poco/Mutex.h"
+#include "Poco/Thread.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+class Runnable;
+class TaskExecutorWorker;
+
+
+class Foundation_API TaskExecutor
+	/// A TaskExecutor executes many small tasks (Runnable objects)
+	/// on a fixed number of worker threads.
+	///
+	/// Unlike a ThreadPool, which needs a thread for every Runnable
+	/// started, a TaskExecutor queues tasks until a worker thread
+	/// becomes available. This makes it suitable for splitting
+	/// work into many fine-grained tasks.
+	///
+	/// Every worker thread has its own double-ended queue of tasks.
+	/// Tasks scheduled from within a task running on a worker thread
+	/// are pushed onto that worker's queue, from which the worker
+	/// takes tasks in LIFO order, without any locking. A worker that
+	/// runs out of tasks steals tasks from the other end of another
+	/// worker's queue. On platforms with atomic compare-and-swap
+	/// operations (see AtomicCounter), these queues are lock-free.
+	///
+	/// Tasks scheduled by other threads are placed in the bounded
+	/// submission queues of the workers, in round-robin fashion.
+	/// If all submission queues are full, execute() blocks until
+	/// the workers have caught up. If the queue of a worker thread
+	/// is full, a task scheduled from a task running on that
+	/// worker is run immediately.
+	///
+	/// Tasks that are no longer needed by the caller after they
+	/// have been scheduled can use the auto-release pattern of
+	/// ActiveRunnableBase. submit() returns an ActiveResult for
+	/// obtaining the result of a method executed as a task. The
+	/// TaskExecutorStarter class can be used to run ActiveMethod
+	/// objects on the default TaskExecutor.
+	///
+	/// A task must not block waiting for another task scheduled
+	/// after it, as this may deadlock the TaskExecutor if all
+	/// worker threads are blocked.
+{
+public:
+	enum
+	{
+		DEFAULT_QUEUE_CAPACITY = 1024
+	};
+
+	explicit TaskExecutor(int workers = 0, int queueCapacity = DEFAULT_QUEUE_CAPACITY, int stackSize = POCO_THREAD_STACK_SIZE);
+		/// Creates a TaskExecutor with the given number of worker
+		/// threads, or one worker thread per processor if workers
+		/// is 0.
+		///
+		/// queueCapacity is the capacity of each worker's task queue
+		/// and submission queue, and is rounded up to the next power
+		/// of two.
+
+	TaskExecutor(const std::string& name, int workers = 0, int queueCapacity = DEFAULT_QUEUE_CAPACITY, int stackSize = POCO_THREAD_STACK_SIZE);
+		/// Creates a TaskExecutor with the given name and number of
+		/// worker threads. The name is used for the worker threads.
+
+	~TaskExecutor();
+		/// Shuts down the TaskExecutor, after running all
+		/// scheduled tasks.
+
+	void execute(Runnable& target);
+		/// Schedules the given target for execution by a worker thread.
+		///
+		/// If called from a worker thread, the target is placed in
+		/// the worker's task queue, or run immediately if the task
+		/// queue is full. Otherwise, the target is placed in a
+		/// submission queue. If all submission queues are full,
+		/// waits until there is room.
+		///
+		/// Throws an IllegalStateException if the TaskExecutor has
+		/// been shut down.
+
+	bool tryExecute(Runnable& target);
+		/// Schedules the given target for execution by a worker thread,
+		/// like execute(), without waiting if all submission queues
+		/// are full.
+		///
+		/// Returns true if the target has been scheduled (or run
+		/// immediately), or false if all submission queues are full.
+
+	bool tryExecute(Runnable& target, long milliseconds);
+		/// Schedules the given target for execution by a worker thread,
+		/// like execute(), waiting up to the given number of milliseconds
+		/// if all submission queues are full.
+		///
+		/// Returns true if the target has been scheduled (or run
+		/// immediately), or false if all submission queues are
+		/// still full.
+
+	template <class ResultType, class OwnerType>
+	ActiveResult<ResultType> submit(OwnerType* pOwner, ResultType (OwnerType::*method)())
+		/// Executes the given method of the given object as a task.
+		/// The returned ActiveResult can be used to wait for the
+		/// task to complete and to obtain the method's result.
+	{
+		ActiveResult<ResultType> result(new ActiveResultHolder<ResultType>());
+		ActiveRunnableBase::Ptr pRunnable(new ActiveRunnable<ResultType, void, OwnerType>(pOwner, method, result));
+		start(pRunnable);
+		return result;
+	}
+
+	template <class ResultType, class ArgType, class OwnerType>
+	ActiveResult<ResultType> submit(OwnerType* pOwner, ResultType (OwnerType::*method)(const ArgType&), const ArgType& arg)
+		/// Executes the given method of the given object as a task,
+		/// passing the given argument to the method.
+		/// The returned ActiveResult can be used to wait for the
+		/// task to complete and to obtain the method's result.
+	{
+		ActiveResult<ResultType> result(new ActiveResultHolder<ResultType>());
+		ActiveRunnableBase::Ptr pRunnable(new ActiveRunnable<ResultType, ArgType, OwnerType>(pOwner, method, arg, result));
+		start(pRunnable);
+		return result;
+	}
+
+	void start(ActiveRunnableBase::Ptr pRunnable);
+		/// Schedules the given ActiveRunnable for execution.
+		/// The runnable releases itself when done.
+
+	void joinAll();
+		/// Waits until all scheduled tasks have been completed.
+
+	void shutdown();
+		/// Waits until all scheduled tasks have been completed,
+		/// and stops the worker threads.
+		///
+		/// No more tasks can be scheduled after shutdown()
+		/// has been called.
+
+	const std::string& name() const;
+		/// Returns the name of the TaskExecutor.
+
+	int workers() const;
+		/// Returns the number of worker threads.
+
+	int queueCapacity() const;
+		/// Returns the capacity of each worker's task queue
+		/// and submission queue.
+
+	int pending() const;
+		/// Returns the number of scheduled tasks that have
+		/// not been completed yet.
+
+	int steals() const;
+		/// Returns the number of tasks that have been stolen
+		/// by a worker thread from another worker's task queue.
+
+	bool isWorkerThread() const;
+		/// Returns true if the calling thread is one of the
+		/// TaskExecutor's worker threads.
+
+	static TaskExecutor& defaultExecutor();
+		/// Returns a reference to the default TaskExecutor,
+		/// which has one worker thread per processor.
+
+protected:
+	TaskExecutorWorker* currentWorker() const;
+	bool schedule(Runnable* pTarget, long milliseconds);
+	Runnable* findTask(TaskExecutorWorker* pWorker);
+	void taskDone();
+	void waitForTask();
+	void wakeUpWorkers();
+	bool stopped() const;
+
+private:
+	TaskExecutor(const TaskExecutor&);
+	TaskExecutor& operator = (const TaskExecutor&);
+
+	void init(int workers, int stackSize);
+
+	typedef std::vector<TaskExecutorWorker*> WorkerVec;
+
+	std::string   _name;
+	int           _queueCapacity;
+	WorkerVec     _workers;
+	AtomicCounter _nextWorker;
+	AtomicCounter _queued;
+	AtomicCounter _pending;
+	AtomicCounter _sleeping;
+	AtomicCounter _blocked;
+	AtomicCounter _steals;
+	bool          _stopped;
+	Condition     _workAvailable;
+	Condition     _spaceAvailable;
+	Condition     _done;
+	mutable Mutex _mutex;
+
+	friend class TaskExecutorWorker;
+};
+
+
+template <class OwnerType>
+class TaskExecutorStarter
+	/// A StarterType policy for ActiveMethod that runs the
+	/// method as a task on the default TaskExecutor.
+	///
+	///     ActiveMethod<std::string, std::string, ActiveObject, TaskExecutorStarter<ActiveObject> > exampleActiveMethod;
+{
+public:
+	static void start(OwnerType* /*pOwner*/, ActiveRunnableBase::Ptr pRunnable)
+	{
+		TaskExecutor::defaultExecutor().start(pRunnable);
+	}
+};
+
+
+//
+// inlines
+//
+inline const std::string& TaskExecutor::name() const
+{
+	return _name;
+}
+
+
+inline int TaskExecutor::workers() const
+{
+	return static_cast<int>(_workers.size());
+}
+
+
+inline int TaskExecutor::queueCapacity() const
+{
+	return _queueCapacity;
+}
+
+
+inline int TaskExecutor::pending() const
+{
+	return _pending.value();
+}
+
+
+inline int TaskExecutor::steals() const
+{
+	return _steals.value();
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_TaskExecutor_INCLUDED
@@ -34,6 +34,7 @@ namespace Poco {
 
 class Notification;
 class ThreadPool;
+class TaskExecutor;
 class Exception;
 
 
@@ -60,12 +61,20 @@ public:
 		/// Creates the TaskManager, using the
 		/// given ThreadPool.
 
+	TaskManager(TaskExecutor& executor);
+		/// Creates the TaskManager, using the
+		/// given TaskExecutor.
+		///
+		/// Tasks are queued by the TaskExecutor until
+		/// a worker thread becomes available.
+
 	~TaskManager();
 		/// Destroys the TaskManager.
 
 	void start(Task* pTask);
 		/// Starts the given task in a thread obtained
-		/// from the thread pool.
+		/// from the thread pool, or schedules it for
+		/// execution by the TaskExecutor.
 		///
 		/// The TaskManager takes ownership of the Task object
 		/// and deletes it when it it finished.
@@ -75,7 +84,8 @@ public:
 		
 	void joinAll();
 		/// Waits for the completion of all the threads
-		/// in the TaskManager's thread pool.
+		/// in the TaskManager's thread pool, or of all
+		/// tasks scheduled with the TaskExecutor.
 		///
 		/// Note: joinAll() will wait for ALL tasks in the
 		/// TaskManager's ThreadPool to complete. If the
@@ -112,7 +122,8 @@ protected:
 	void taskFailed(Task* pTask, const Exception& exc);
 
 private:
-	ThreadPool&        _threadPool;
+	ThreadPool*        _pThreadPool;
+	TaskExecutor*      _pExecutor;
 	TaskList           _taskList;
 	Timestamp          _lastProgressNotification;
 	NotificationCenter _nc;
@@ -0,0 +1,193 @@
+//
+// ThreadCachingMemoryPool.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/ThreadCachingMemoryPool.h#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  MemoryPool
+//
+// Definition of the ThreadCachingMemoryPool class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_ThreadCachingMemoryPool_INCLUDED
+#define Foundation_ThreadCachingMemoryPool_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/ThreadLocal.h"
+#include <ios>
+#include <cstddef>
+
+
+namespace Poco {
+
+
+class Foundation_API ThreadCachingMemoryPool
+	/// A pool for memory blocks of different sizes, for use
+	/// by many threads at the same time.
+	///
+	/// Requested sizes are rounded up to a size class (a power of two
+	/// between MIN_BLOCK_SIZE and the maximum block size given to the
+	/// constructor). Every size class has a central free list, protected
+	/// by a mutex. In addition, every thread started by Poco::Thread
+	/// caches a small number of blocks of each size class. Blocks are
+	/// taken from and returned to the calling thread's cache without any
+	/// locking, and are moved between the thread's cache and the central
+	/// free list in batches. Threads not started by Poco::Thread (e.g.,
+	/// the main thread) use the central free lists directly. Blocks
+	/// larger than the maximum block size are allocated and freed
+	/// with new and delete.
+	///
+	/// Like MemoryPool, the pool retains all blocks for future use.
+	/// The total number of bytes obtained from the system can be
+	/// limited. Note that blocks cached by other threads are not
+	/// available to the calling thread, so the limit may be
+	/// reached before all blocks are in use.
+	///
+	/// A thread's cached blocks are returned to the central free
+	/// lists when the thread terminates, or when it calls flush().
+	///
+	/// The pool can be used with BasicBufferedStreamBuf by means of
+	/// the PooledBufferAllocator template, and with FIFOBuffer and
+	/// Buffer by passing a block obtained from the pool to the
+	/// constructor taking a pointer to external memory.
+{
+public:
+	struct Statistics
+		/// Usage statistics of a ThreadCachingMemoryPool.
+	{
+		UInt64 hits;             /// Number of blocks taken from a thread's cache.
+		UInt64 misses;           /// Number of blocks taken from the central free lists, or from the system.
+		UInt64 bytesAllocated;   /// Number of bytes obtained from the system.
+		UInt64 bytesOutstanding; /// Number of bytes handed out and not yet released.
+	};
+
+	enum
+	{
+		MIN_BLOCK_SIZE         = 16,
+		DEFAULT_MAX_BLOCK_SIZE = 65536
+	};
+
+	explicit ThreadCachingMemoryPool(std::size_t maxBlockSize = DEFAULT_MAX_BLOCK_SIZE, std::size_t maxBytes = 0);
+		/// Creates a ThreadCachingMemoryPool for blocks of up to
+		/// maxBlockSize bytes, which is rounded up to a power of two.
+		///
+		/// If maxBytes is not zero, no more than maxBytes bytes are
+		/// obtained from the system.
+
+	~ThreadCachingMemoryPool();
+		/// Destroys the ThreadCachingMemoryPool.
+		///
+		/// All blocks must have been released. Blocks still cached by
+		/// other threads are freed when these threads terminate.
+
+	void* get(std::size_t size);
+		/// Returns a memory block of at least the given size.
+		///
+		/// If the limit given to the constructor would be exceeded,
+		/// an OutOfMemoryException is thrown.
+
+	void release(void* ptr, std::size_t size);
+		/// Releases a memory block and returns it to the pool.
+		/// The size must be the one given to get().
+
+	void flush();
+		/// Returns all blocks cached by the calling thread
+		/// to the central free lists.
+
+	std::size_t blockSize(std::size_t size) const;
+		/// Returns the size of the blocks returned by get(size).
+
+	std::size_t maxBlockSize() const;
+		/// Returns the maximum block size.
+
+	std::size_t maxBytes() const;
+		/// Returns the maximum number of bytes obtained from
+		/// the system, or zero if unlimited.
+
+	Statistics statistics() const;
+		/// Returns the usage statistics of the pool. The result
+		/// is only a snapshot if other threads use the pool
+		/// at the same time.
+		///
+		/// The counters of other threads' caches are approximate:
+		/// to keep get() and release() free of locks, each thread
+		/// publishes its counters only every few hundred calls,
+		/// when its cache is flushed, and when the thread calls
+		/// statistics() itself. The counters of threads that have
+		/// terminated are exact.
+
+	static ThreadCachingMemoryPool& defaultPool();
+		/// Returns a reference to the default ThreadCachingMemoryPool,
+		/// which is used by PooledBufferAllocator.
+
+protected:
+	class Central;
+	class Cache;
+
+	Cache* cache();
+		/// Returns the calling thread's cache, or null if the
+		/// calling thread has not been started by Poco::Thread.
+
+	int sizeClass(std::size_t size) const;
+		/// Returns the size class for the given size, or -1 if
+		/// the size is larger than the maximum block size.
+
+private:
+	ThreadCachingMemoryPool(const ThreadCachingMemoryPool&);
+	ThreadCachingMemoryPool& operator = (const ThreadCachingMemoryPool&);
+
+	std::size_t        _maxBlockSize;
+	AutoPtr<Central>   _pCentral;
+	ThreadLocal<Cache> _caches;
+};
+
+
+template <typename ch>
+class PooledBufferAllocator
+	/// A BufferAllocator for BasicBufferedStreamBuf that takes
+	/// its buffers from ThreadCachingMemoryPool::defaultPool().
+{
+public:
+	typedef ch char_type;
+
+	static char_type* allocate(std::streamsize size)
+	{
+		return static_cast<char_type*>(ThreadCachingMemoryPool::defaultPool().get(static_cast<std::size_t>(size)*sizeof(char_type)));
+	}
+
+	static void deallocate(char_type* ptr, std::streamsize size) throw()
+	{
+		try
+		{
+			ThreadCachingMemoryPool::defaultPool().release(ptr, static_cast<std::size_t>(size)*sizeof(char_type));
+		}
+		catch (...)
+		{
+			poco_unexpected();
+		}
+	}
+};
+
+
+//
+// inlines
+//
+inline std::size_t ThreadCachingMemoryPool::maxBlockSize() const
+{
+	return _maxBlockSize;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_ThreadCachingMemoryPool_INCLUDED
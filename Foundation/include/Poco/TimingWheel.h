@@ -0,0 +1,209 @@
+//
+// TimingWheel.h
+//
+// $Id: //poco/1.4/Foundation/include/Poco/TimingWheel.h#1 $
+//
+// Library: Foundation
+// Package: Threading
+// Module:  TimingWheel
+//
+// Definition of the TimingWheel class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_TimingWheel_INCLUDED
+#define Foundation_TimingWheel_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Clock.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+class Foundation_API TimingWheel
+	/// A TimingWheel keeps track of a large number of timeouts,
+	/// most of which are typically cancelled before they expire
+	/// (e.g., idle timeouts of network connections).
+	///
+	/// The TimingWheel is a hierarchical timing wheel, as described
+	/// by Varghese and Lauck ("Hashed and Hierarchical Timing Wheels",
+	/// 1987). Time is divided into ticks of a given resolution. Every
+	/// one of the four levels of the wheel has 256 slots; a slot in the
+	/// first level holds the entries expiring in a single tick, a slot in
+	/// the second level the entries expiring in 256 ticks, and so on.
+	/// Entries are linked into the slots' lists, so that scheduling and
+	/// cancelling an entry takes constant time and never allocates memory.
+	/// When the first level has gone round, the entries of the next slot
+	/// of the second level are redistributed among the slots of the
+	/// first level, and so on.
+	///
+	/// Entries expire with the resolution of the TimingWheel, and never
+	/// before their expiration time. Entries due for more than 2^32 ticks
+	/// are redistributed until they are due within 2^32 ticks.
+	///
+	/// The TimingWheel does not own its entries, and is not thread-safe.
+{
+public:
+	class Foundation_API Entry
+		/// Base class for objects that can be scheduled on a TimingWheel.
+		///
+		/// An Entry can be scheduled on at most one TimingWheel at a time.
+		/// A scheduled Entry is cancelled when it is destroyed.
+	{
+	public:
+		Entry();
+			/// Creates the Entry.
+
+		virtual ~Entry();
+			/// Destroys the Entry, cancelling it if it is scheduled.
+
+		bool isScheduled() const;
+			/// Returns true iff the Entry is scheduled on a TimingWheel.
+
+		const Clock& expiration() const;
+			/// Returns the time the Entry has been scheduled for.
+
+	private:
+		Entry(const Entry&);
+		Entry& operator = (const Entry&);
+
+		Entry*       _pPrev;
+		Entry*       _pNext;
+		TimingWheel* _pWheel;
+		int          _slot;
+		Int64        _tick;
+		Clock        _expiration;
+
+		friend class TimingWheel;
+	};
+
+	typedef std::vector<Entry*> EntryVec;
+
+	enum
+	{
+		LEVELS     = 4,
+		SLOT_BITS  = 8,
+		SLOTS      = 1 << SLOT_BITS,
+		SLOT_MASK  = SLOTS - 1
+	};
+
+	explicit TimingWheel(Clock::ClockDiff resolution = 1000);
+		/// Creates the TimingWheel, using the given resolution
+		/// (duration of a tick) in microseconds.
+
+	~TimingWheel();
+		/// Destroys the TimingWheel. All entries are cancelled.
+
+	void schedule(Entry& entry, const Clock& expiration);
+		/// Schedules the given entry to expire at the given time.
+		///
+		/// If the entry is already scheduled, it is rescheduled.
+		/// If the expiration time lies in the past, the entry
+		/// expires with the next call to advance().
+
+	bool cancel(Entry& entry);
+		/// Cancels the given entry. Returns true if the entry
+		/// had been scheduled on this TimingWheel.
+
+	std::size_t advance(const Clock& now, EntryVec& expired);
+		/// Advances the wheel to the given time, and appends all
+		/// entries that have expired to expired, in order of
+		/// their expiration tick. The expired entries are no
+		/// longer scheduled.
+		///
+		/// Returns the number of expired entries.
+
+	bool nextExpiration(Clock& clock) const;
+		/// If entries are scheduled, stores a time not later
+		/// than the expiration time of the next entry to expire
+		/// in clock and returns true. Otherwise, returns false.
+		///
+		/// The time returned is exact if the next entry is due within
+		/// SLOTS ticks. Otherwise, it is the time when the entry will
+		/// be moved to a lower level of the wheel, and advance() should
+		/// be called at this time to get a more accurate result.
+
+	void clear();
+		/// Cancels all entries.
+
+	void clear(EntryVec& cancelled);
+		/// Cancels all entries, and appends them to cancelled.
+
+	std::size_t size() const;
+		/// Returns the number of scheduled entries.
+
+	bool empty() const;
+		/// Returns true iff no entries are scheduled.
+
+	Clock::ClockDiff resolution() const;
+		/// Returns the duration of a tick in microseconds.
+
+protected:
+	void insert(Entry& entry);
+	void unlink(Entry& entry);
+	void cascade(int level);
+	std::size_t expire(int slot, EntryVec& expired);
+	Int64 nextTick() const;
+		/// Returns the next tick at which entries expire, or
+		/// at which entries are moved to a lower level.
+
+	Int64 toTick(const Clock& clock) const;
+
+private:
+	TimingWheel(const TimingWheel&);
+	TimingWheel& operator = (const TimingWheel&);
+
+	Clock::ClockDiff _resolution;
+	Clock            _start;
+	Int64            _currentTick;
+	std::size_t      _size;
+	std::size_t      _levelSize[LEVELS + 1];
+	Entry*           _slots[LEVELS*SLOTS + 1]; // the last slot holds past-due entries
+};
+
+
+//
+// inlines
+//
+inline bool TimingWheel::Entry::isScheduled() const
+{
+	return _pWheel != 0;
+}
+
+
+inline const Clock& TimingWheel::Entry::expiration() const
+{
+	return _expiration;
+}
+
+
+inline std::size_t TimingWheel::size() const
+{
+	return _size;
+}
+
+
+inline bool TimingWheel::empty() const
+{
+	return _size == 0;
+}
+
+
+inline Clock::ClockDiff TimingWheel::resolution() const
+{
+	return _resolution;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_TimingWheel_INCLUDED
@@ -0,0 +1,154 @@
+//
+// NotificationQueueBenchmark.cpp
+//
+// $Id: //poco/1.4/Foundation/samples/NotificationQueueBenchmark/src/NotificationQueueBenchmark.cpp#1 $
+//
+// This sample compares the throughput of the NotificationQueue and
+// BoundedNotificationQueue classes with many producer and consumer
+// threads.
+//
+// Usage: NotificationQueueBenchmark [<threads> [<notifications> [<capacity>]]]
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Notification.h"
+#include "Poco/NotificationQueue.h"
+#include "Poco/BoundedNotificationQueue.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+
+using Poco::Notification;
+using Poco::NotificationQueue;
+using Poco::BoundedNotificationQueue;
+using Poco::Thread;
+using Poco::Runnable;
+using Poco::AtomicCounter;
+using Poco::Stopwatch;
+using Poco::NumberParser;
+
+
+template <class Queue>
+class Producer: public Runnable
+{
+public:
+	Producer(Queue& queue, int count):
+		_queue(queue),
+		_count(count)
+	{
+	}
+
+	void run()
+	{
+		for (int i = 0; i < _count; ++i)
+		{
+			_queue.enqueueNotification(new Notification);
+		}
+	}
+
+private:
+	Queue& _queue;
+	int    _count;
+};
+
+
+template <class Queue>
+class Consumer: public Runnable
+{
+public:
+	Consumer(Queue& queue, AtomicCounter& received):
+		_queue(queue),
+		_received(received)
+	{
+	}
+
+	void run()
+	{
+		Notification::Ptr pNf(_queue.waitDequeueNotification());
+		while (pNf)
+		{
+			++_received;
+			pNf = _queue.waitDequeueNotification();
+		}
+	}
+
+private:
+	Queue&         _queue;
+	AtomicCounter& _received;
+};
+
+
+template <class Queue>
+double run(Queue& queue, int threads, int count)
+	/// Runs the given number of producer and consumer threads,
+	/// and returns the number of notifications per second.
+{
+	AtomicCounter received;
+	Producer<Queue> producer(queue, count);
+	Consumer<Queue> consumer(queue, received);
+	std::vector<Thread*> consumers;
+	std::vector<Thread*> producers;
+	for (int i = 0; i < threads; ++i)
+	{
+		consumers.push_back(new Thread);
+		consumers.back()->start(consumer);
+	}
+
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < threads; ++i)
+	{
+		producers.push_back(new Thread);
+		producers.back()->start(producer);
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		producers[i]->join();
+		delete producers[i];
+	}
+	while (received.value() < threads*count) Thread::yield();
+	sw.stop();
+
+	for (int i = 0; i < threads; ++i)
+	{
+		while (!consumers[i]->tryJoin(10)) queue.wakeUpAll();
+		delete consumers[i];
+	}
+	return (double) threads*count*sw.resolution()/sw.elapsed();
+}
+
+
+int main(int argc, char** argv)
+{
+	int threads  = 16;
+	int count    = 100000;
+	int capacity = BoundedNotificationQueue::DEFAULT_CAPACITY;
+	if (argc > 1) threads  = NumberParser::parse(argv[1]);
+	if (argc > 2) count    = NumberParser::parse(argv[2]);
+	if (argc > 3) capacity = NumberParser::parse(argv[3]);
+
+	std::cout << threads << " producers, " << threads << " consumers, "
+	          << count << " notifications per producer" << std::endl;
+
+	NotificationQueue queue;
+	double rate = run(queue, threads, count);
+	std::cout << std::setw(28) << std::left << "NotificationQueue:" << std::fixed << std::setprecision(0) << rate << " notifications/s" << std::endl;
+
+	BoundedNotificationQueue boundedQueue(capacity);
+	double boundedRate = run(boundedQueue, threads, count);
+	std::cout << std::setw(28) << std::left << "BoundedNotificationQueue:" << std::fixed << std::setprecision(0) << boundedRate << " notifications/s"
+	          << " (capacity " << boundedQueue.capacity() << ")" << std::endl;
+
+	return 0;
+}
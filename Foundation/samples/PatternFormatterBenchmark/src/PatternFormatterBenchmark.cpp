@@ -0,0 +1,125 @@
+//
+// PatternFormatterBenchmark.cpp
+//
+// $Id: //poco/1.4/Foundation/samples/PatternFormatterBenchmark/src/PatternFormatterBenchmark.cpp#1 $
+//
+// This sample measures how many log messages per second a
+// PatternFormatter formats, with and without cache hits for the
+// date/time fields, and with several threads sharing the formatter.
+//
+// Usage: PatternFormatterBenchmark [<messages> [<threads>]]
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/PatternFormatter.h"
+#include "Poco/Message.h"
+#include "Poco/DateTime.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+
+using Poco::PatternFormatter;
+using Poco::Message;
+using Poco::DateTime;
+using Poco::Timestamp;
+using Poco::Thread;
+using Poco::Runnable;
+using Poco::Stopwatch;
+using Poco::NumberParser;
+using Poco::NumberFormatter;
+
+
+class FormatRunnable: public Runnable
+{
+public:
+	FormatRunnable(PatternFormatter& formatter, int count, Timestamp::TimeDiff step):
+		_formatter(formatter),
+		_count(count),
+		_step(step)
+	{
+	}
+
+	void run()
+	{
+		Message msg("Benchmark", "The quick brown fox jumps over the lazy dog", Message::PRIO_INFORMATION);
+		Timestamp::TimeVal start = DateTime(2015, 1, 1).timestamp().epochMicroseconds();
+		std::string text;
+		text.reserve(256);
+		for (int i = 0; i < _count; ++i)
+		{
+			msg.setTime(Timestamp(start + i*_step));
+			text.clear();
+			_formatter.format(msg, text);
+		}
+	}
+
+private:
+	PatternFormatter&   _formatter;
+	int                 _count;
+	Timestamp::TimeDiff _step;
+};
+
+
+double run(int threads, int count, Timestamp::TimeDiff step)
+	/// Formats count messages in each of the given number of
+	/// threads, with all threads sharing one PatternFormatter,
+	/// and returns the number of messages per second.
+{
+	PatternFormatter formatter("%Y-%m-%d %H:%M:%S.%i [%p] %s: %t");
+	FormatRunnable runnable(formatter, count, step);
+	std::vector<Thread*> workers;
+
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < threads; ++i)
+	{
+		workers.push_back(new Thread);
+		workers.back()->start(runnable);
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		workers[i]->join();
+		delete workers[i];
+	}
+	sw.stop();
+	return (double) threads*count*sw.resolution()/sw.elapsed();
+}
+
+
+void print(const std::string& label, double rate)
+{
+	std::cout << std::setw(32) << std::left << label << std::fixed << std::setprecision(0) << rate << " messages/s" << std::endl;
+}
+
+
+int main(int argc, char** argv)
+{
+	int count   = 1000000;
+	int threads = 4;
+	if (argc > 1) count   = NumberParser::parse(argv[1]);
+	if (argc > 2) threads = NumberParser::parse(argv[2]);
+
+	std::cout << count << " messages per thread" << std::endl;
+
+	// every message is in a different second, so the
+	// date/time fields have to be formatted every time
+	print("uncached, 1 thread:", run(1, count, Timestamp::resolution()));
+	// ten messages per millisecond
+	print("cached, 1 thread:", run(1, count, 100));
+	print("uncached, " + NumberFormatter::format(threads) + " threads:", run(threads, count, Timestamp::resolution()));
+	print("cached, " + NumberFormatter::format(threads) + " threads:", run(threads, count, 100));
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+//
+// Arena.cpp
+//
+// $Id: //poco/1.4/Foundation/src/Arena.cpp#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  Arena
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Arena.h"
+
+
+namespace Poco {
+
+
+Arena::Arena(std::size_t chunkSize):
+	_chunkSize(chunkSize),
+	_pUsed(0),
+	_pFree(0),
+	_pLarge(0),
+	_pPos(0),
+	_pEnd(0),
+	_bytesUsed(0),
+	_capacity(0),
+	_allocations(0),
+	_chunkAllocations(0)
+{
+	poco_assert (chunkSize > 0);
+}
+
+
+Arena::~Arena()
+{
+	freeChunks(_pUsed);
+	freeChunks(_pFree);
+	freeChunks(_pLarge);
+}
+
+
+void Arena::reset()
+{
+	while (_pUsed)
+	{
+		Chunk* pChunk = _pUsed;
+		_pUsed = pChunk->pNext;
+		pChunk->pNext = _pFree;
+		_pFree = pChunk;
+	}
+	for (Chunk* pChunk = _pLarge; pChunk; pChunk = pChunk->pNext)
+	{
+		_capacity -= pChunk->size;
+	}
+	freeChunks(_pLarge);
+	_pLarge    = 0;
+	_pPos      = 0;
+	_pEnd      = 0;
+	_bytesUsed = 0;
+}
+
+
+void Arena::clear()
+{
+	reset();
+	freeChunks(_pFree);
+	_pFree    = 0;
+	_capacity = 0;
+}
+
+
+Arena::Chunk* Arena::newChunk(std::size_t size)
+{
+	Chunk* pChunk = reinterpret_cast<Chunk*>(new char[sizeof(Chunk) + size]);
+	pChunk->pNext = 0;
+	pChunk->size  = size;
+	_capacity += size;
+	++_chunkAllocations;
+	return pChunk;
+}
+
+
+void* Arena::grow(std::size_t size, std::size_t alignment)
+{
+	poco_assert_dbg (alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	Chunk* pChunk;
+	if (size + alignment > _chunkSize)
+	{
+		pChunk = newChunk(size + alignment);
+		pChunk->pNext = _pLarge;
+		_pLarge = pChunk;
+		char* ptr = data(pChunk);
+		ptr += (alignment - reinterpret_cast<std::size_t>(ptr)) & (alignment - 1);
+		_bytesUsed += size;
+		return ptr;
+	}
+
+	if (_pFree)
+	{
+		pChunk = _pFree;
+		_pFree = pChunk->pNext;
+	}
+	else pChunk = newChunk(_chunkSize);
+	pChunk->pNext = _pUsed;
+	_pUsed = pChunk;
+	_pPos  = data(pChunk);
+	_pEnd  = _pPos + pChunk->size;
+
+	std::size_t padding = (alignment - reinterpret_cast<std::size_t>(_pPos)) & (alignment - 1);
+	char* ptr = _pPos + padding;
+	_pPos = ptr + size;
+	_bytesUsed += padding + size;
+	return ptr;
+}
+
+
+void Arena::freeChunks(Chunk* pChunk)
+{
+	while (pChunk)
+	{
+		Chunk* pNext = pChunk->pNext;
+		delete [] reinterpret_cast<char*>(pChunk);
+		pChunk = pNext;
+	}
+}
+
+
+char* Arena::data(Chunk* pChunk)
+{
+	return reinterpret_cast<char*>(pChunk + 1);
+}
+
+
+} // namespace Poco
@@ -20,6 +20,8 @@
 #include "Poco/Formatter.h"
 #include "Poco/AutoPtr.h"
 #include "Poco/LoggingRegistry.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
 #include "Poco/Exception.h"
 
 
@@ -48,9 +50,10 @@ private:
 };
 
 
-AsyncChannel::AsyncChannel(Channel* pChannel, Thread::Priority prio): 
+AsyncChannel::AsyncChannel(Channel* pChannel, Thread::Priority prio, int queueSize): 
 	_pChannel(pChannel), 
-	_thread("AsyncChannel")
+	_thread("AsyncChannel"),
+	_pBoundedQueue(queueSize > 0 ? new BoundedNotificationQueue(queueSize) : 0)
 {
 	if (_pChannel) _pChannel->duplicate();
 	_thread.setPriority(prio);
@@ -63,6 +66,7 @@ AsyncChannel::~AsyncChannel()
 	{
 		close();
 		if (_pChannel) _pChannel->release();
+		delete _pBoundedQueue;
 	}
 	catch (...)
 	{
@@ -100,13 +104,26 @@ void AsyncChannel::close()
 {
 	if (_thread.isRunning())
 	{
-		while (!_queue.empty()) Thread::sleep(100);
-		
-		do 
+		if (_pBoundedQueue)
 		{
-			_queue.wakeUpAll(); 
+			while (!_pBoundedQueue->empty()) Thread::sleep(100);
+
+			do 
+			{
+				_pBoundedQueue->wakeUpAll(); 
+			}
+			while (!_thread.tryJoin(100));
+		}
+		else
+		{
+			while (!_queue.empty()) Thread::sleep(100);
+		
+			do 
+			{
+				_queue.wakeUpAll(); 
+			}
+			while (!_thread.tryJoin(100));
 		}
-		while (!_thread.tryJoin(100));
 	}
 }
 
@@ -115,7 +132,10 @@ void AsyncChannel::log(const Message& msg)
 {
 	open();
 
-	_queue.enqueueNotification(new MessageNotification(msg));
+	if (_pBoundedQueue)
+		_pBoundedQueue->enqueueNotification(new MessageNotification(msg));
+	else
+		_queue.enqueueNotification(new MessageNotification(msg));
 }
 
 
@@ -125,14 +145,25 @@ void AsyncChannel::setProperty(const std::string& name, const std::string& value
 		setChannel(LoggingRegistry::defaultRegistry().channelForName(value));
 	else if (name == "priority")
 		setPriority(value);
+	else if (name == "queueSize")
+		setQueueSize(value);
 	else
 		Channel::setProperty(name, value);
 }
 
 
+std::string AsyncChannel::getProperty(const std::string& name) const
+{
+	if (name == "queueSize")
+		return _pBoundedQueue ? NumberFormatter::format(_pBoundedQueue->capacity()) : std::string("none");
+	else
+		return Channel::getProperty(name);
+}
+
+
 void AsyncChannel::run()
 {
-	AutoPtr<Notification> nf = _queue.waitDequeueNotification();
+	AutoPtr<Notification> nf = _pBoundedQueue ? _pBoundedQueue->waitDequeueNotification() : _queue.waitDequeueNotification();
 	while (nf)
 	{
 		MessageNotification* pNf = dynamic_cast<MessageNotification*>(nf.get());
@@ -141,7 +172,7 @@ void AsyncChannel::run()
 
 			if (pNf && _pChannel) _pChannel->log(pNf->message());
 		}
-		nf = _queue.waitDequeueNotification();
+		nf = _pBoundedQueue ? _pBoundedQueue->waitDequeueNotification() : _queue.waitDequeueNotification();
 	}
 }
 		
@@ -167,4 +198,18 @@ void AsyncChannel::setPriority(const std::string& value)
 }
 
 
+void AsyncChannel::setQueueSize(const std::string& value)
+{
+	int queueSize = 0;
+	if (value != "none" && !NumberParser::tryParse(value, queueSize))
+		throw InvalidArgumentException("queue size", value);
+
+	FastMutex::ScopedLock lock(_threadMutex);
+
+	if (_thread.isRunning()) throw IllegalStateException("Cannot change the queue size of an open AsyncChannel");
+	delete _pBoundedQueue;
+	_pBoundedQueue = queueSize > 0 ? new BoundedNotificationQueue(queueSize) : 0;
+}
+
+
 } // namespace Poco
@@ -0,0 +1,430 @@
+//
+// AsyncFileChannel.cpp
+//
+// $Id: //poco/1.4/Foundation/src/AsyncFileChannel.cpp#1 $
+//
+// Library: Foundation
+// Package: Logging
+// Module:  AsyncFileChannel
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/AsyncFileChannel.h"
+#include "Poco/PatternFormatter.h"
+#include "Poco/Notification.h"
+#include "Poco/Message.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Exception.h"
+#include <cstring>
+
+
+namespace Poco {
+
+
+class LogRecord: public Notification
+	/// A preallocated slot for a log message.
+{
+public:
+	LogRecord(std::size_t maxTextLength):
+		_stop(false),
+		_pMessage(0),
+		_prio(Message::PRIO_INFORMATION),
+		_tid(0),
+		_pid(0),
+		_file(0),
+		_line(0),
+		_sourceLength(0),
+		_threadLength(0),
+		_textLength(0),
+		_maxTextLength(maxTextLength),
+		_text(new char[maxTextLength])
+	{
+	}
+
+	void assign(const Message& msg)
+	{
+		_stop = false;
+		if (!msg.getAll().empty())
+		{
+			// parameters are rare; keep them by copying the whole message
+			_pMessage = new Message(msg);
+			return;
+		}
+		_prio = msg.getPriority();
+		_time = msg.getTime();
+		_tid  = msg.getTid();
+		_pid  = msg.getPid();
+		_file = msg.getSourceFile();
+		_line = msg.getSourceLine();
+		_sourceLength = copy(msg.getSource(), _source, AsyncFileChannel::MAX_SOURCE_LENGTH);
+		_threadLength = copy(msg.getThread(), _thread, AsyncFileChannel::MAX_THREAD_LENGTH);
+		_textLength   = copy(msg.getText(), _text, _maxTextLength);
+	}
+
+	void extract(Message& msg, std::string& buffer)
+	{
+		if (_pMessage)
+		{
+			msg.swap(*_pMessage);
+			delete _pMessage;
+			_pMessage = 0;
+			return;
+		}
+		if (!msg.getAll().empty()) msg = Message();
+		msg.setPriority(_prio);
+		msg.setTime(_time);
+		msg.setTid(_tid);
+		msg.setPid(_pid);
+		msg.setSourceFile(_file);
+		msg.setSourceLine(_line);
+		buffer.assign(_source, _sourceLength);
+		msg.setSource(buffer);
+		buffer.assign(_thread, _threadLength);
+		msg.setThread(buffer);
+		buffer.assign(_text, _textLength);
+		msg.setText(buffer);
+	}
+
+	void setStop()
+	{
+		_stop = true;
+	}
+
+	bool isStop() const
+	{
+		return _stop;
+	}
+
+protected:
+	~LogRecord()
+	{
+		delete _pMessage;
+		delete [] _text;
+	}
+
+	static std::size_t copy(const std::string& str, char* buffer, std::size_t size)
+	{
+		std::size_t n = str.size() < size ? str.size() : size;
+		std::memcpy(buffer, str.data(), n);
+		return n;
+	}
+
+private:
+	LogRecord(const LogRecord&);
+	LogRecord& operator = (const LogRecord&);
+
+	bool              _stop;
+	Message*          _pMessage;
+	Message::Priority _prio;
+	Timestamp         _time;
+	long              _tid;
+	long              _pid;
+	const char*       _file;
+	int               _line;
+	std::size_t       _sourceLength;
+	std::size_t       _threadLength;
+	std::size_t       _textLength;
+	std::size_t       _maxTextLength;
+	char              _source[AsyncFileChannel::MAX_SOURCE_LENGTH];
+	char              _thread[AsyncFileChannel::MAX_THREAD_LENGTH];
+	char*             _text;
+};
+
+
+const std::string AsyncFileChannel::PROP_CAPACITY  = "capacity";
+const std::string AsyncFileChannel::PROP_MAXTEXTLENGTH = "maxTextLength";
+const std::string AsyncFileChannel::PROP_OVERFLOW  = "overflow";
+const std::string AsyncFileChannel::PROP_BATCHSIZE = "batchSize";
+const std::string AsyncFileChannel::PROP_PATTERN   = "pattern";
+const std::string AsyncFileChannel::PROP_DROPPED   = "dropped";
+
+
+AsyncFileChannel::AsyncFileChannel():
+	_overflow(OVERFLOW_BLOCK),
+	_batchSize(DEFAULT_BATCH_SIZE),
+	_pFormatter(new PatternFormatter("%Y-%m-%d %H:%M:%S.%i [%p] %s: %t")),
+	_running(false),
+	_thread("AsyncFileChannel")
+{
+	init(DEFAULT_CAPACITY, DEFAULT_MAX_TEXT_LENGTH);
+}
+
+
+AsyncFileChannel::AsyncFileChannel(const std::string& path):
+	FileChannel(path),
+	_overflow(OVERFLOW_BLOCK),
+	_batchSize(DEFAULT_BATCH_SIZE),
+	_pFormatter(new PatternFormatter("%Y-%m-%d %H:%M:%S.%i [%p] %s: %t")),
+	_running(false),
+	_thread("AsyncFileChannel")
+{
+	init(DEFAULT_CAPACITY, DEFAULT_MAX_TEXT_LENGTH);
+}
+
+
+AsyncFileChannel::~AsyncFileChannel()
+{
+	try
+	{
+		close();
+		_pFormatter->release();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void AsyncFileChannel::open()
+{
+	FileChannel::open();
+
+	if (!_running)
+	{
+		FastMutex::ScopedLock lock(_threadMutex);
+
+		if (!_running)
+		{
+			_thread.start(*this);
+			_running = true;
+		}
+	}
+}
+
+
+void AsyncFileChannel::close()
+{
+	{
+		FastMutex::ScopedLock lock(_threadMutex);
+
+		if (_running)
+		{
+			// the stop record is queued after all messages
+			// logged so far, which are thus written first
+			AutoPtr<LogRecord> pStop = static_cast<LogRecord*>(_pFree->waitDequeueNotification());
+			pStop->setStop();
+			_pPending->enqueueNotification(pStop);
+			_thread.join();
+			_running = false;
+		}
+	}
+	FileChannel::close();
+}
+
+
+void AsyncFileChannel::log(const Message& msg)
+{
+	if (!_running) open();
+
+	Notification* pNf;
+	if (_overflow == OVERFLOW_DROP)
+		pNf = _pFree->dequeueNotification();
+	else
+		pNf = _pFree->waitDequeueNotification();
+	if (pNf)
+	{
+		AutoPtr<LogRecord> pRecord = static_cast<LogRecord*>(pNf);
+		pRecord->assign(msg);
+		_pPending->enqueueNotification(pRecord);
+	}
+	else ++_dropped;
+}
+
+
+void AsyncFileChannel::setFormatter(Formatter* pFormatter)
+{
+	poco_check_ptr (pFormatter);
+
+	FastMutex::ScopedLock lock(_formatterMutex);
+	_pFormatter->release();
+	_pFormatter = pFormatter;
+	_pFormatter->duplicate();
+}
+
+
+Formatter* AsyncFileChannel::getFormatter() const
+{
+	FastMutex::ScopedLock lock(_formatterMutex);
+	return _pFormatter;
+}
+
+
+void AsyncFileChannel::setOverflowPolicy(OverflowPolicy policy)
+{
+	_overflow = policy;
+}
+
+
+void AsyncFileChannel::setProperty(const std::string& name, const std::string& value)
+{
+	if (name == PROP_CAPACITY)
+	{
+		setCapacity(NumberParser::parse(value));
+	}
+	else if (name == PROP_MAXTEXTLENGTH)
+	{
+		setMaxTextLength(NumberParser::parse(value));
+	}
+	else if (name == PROP_OVERFLOW)
+	{
+		if (value == "block")
+			setOverflowPolicy(OVERFLOW_BLOCK);
+		else if (value == "drop")
+			setOverflowPolicy(OVERFLOW_DROP);
+		else
+			throw InvalidArgumentException("overflow", value);
+	}
+	else if (name == PROP_BATCHSIZE)
+	{
+		int batchSize = NumberParser::parse(value);
+		if (batchSize <= 0) throw InvalidArgumentException("batchSize", value);
+		_batchSize = batchSize;
+	}
+	else if (name == PROP_PATTERN)
+	{
+		AutoPtr<Formatter> pFormatter = new PatternFormatter(value);
+		setFormatter(pFormatter);
+	}
+	else if (name == PROP_DROPPED)
+	{
+		throw PropertyNotSupportedException("dropped is read-only");
+	}
+	else FileChannel::setProperty(name, value);
+}
+
+
+std::string AsyncFileChannel::getProperty(const std::string& name) const
+{
+	if (name == PROP_CAPACITY)
+	{
+		return NumberFormatter::format(_capacity);
+	}
+	else if (name == PROP_MAXTEXTLENGTH)
+	{
+		return NumberFormatter::format(_maxTextLength);
+	}
+	else if (name == PROP_OVERFLOW)
+	{
+		return _overflow == OVERFLOW_DROP ? "drop" : "block";
+	}
+	else if (name == PROP_BATCHSIZE)
+	{
+		return NumberFormatter::format(_batchSize);
+	}
+	else if (name == PROP_PATTERN)
+	{
+		FastMutex::ScopedLock lock(_formatterMutex);
+		return _pFormatter->getProperty(PROP_PATTERN);
+	}
+	else if (name == PROP_DROPPED)
+	{
+		return NumberFormatter::format(dropped());
+	}
+	else return FileChannel::getProperty(name);
+}
+
+
+void AsyncFileChannel::run()
+{
+	Message msg;
+	std::string buffer;
+	std::string batch;
+	batch.reserve(_batchSize + _maxTextLength);
+	bool stop = false;
+	while (!stop)
+	{
+		AutoPtr<Notification> pNf = _pPending->waitDequeueNotification();
+		{
+			FastMutex::ScopedLock lock(_formatterMutex);
+
+			while (pNf)
+			{
+				LogRecord* pRecord = static_cast<LogRecord*>(pNf.get());
+				if (pRecord->isStop())
+				{
+					stop = true;
+				}
+				else
+				{
+					pRecord->extract(msg, buffer);
+					try
+					{
+						_pFormatter->format(msg, batch);
+					}
+					catch (Exception& exc)
+					{
+						ErrorHandler::handle(exc);
+					}
+					batch += '\n';
+				}
+				_pFree->enqueueNotification(pNf);
+				if (stop || batch.size() >= _batchSize) break;
+				pNf = _pPending->dequeueNotification();
+			}
+		}
+		writeBatch(batch);
+	}
+}
+
+
+void AsyncFileChannel::setCapacity(int capacity)
+{
+	FastMutex::ScopedLock lock(_threadMutex);
+
+	if (_running) throw IllegalStateException("Cannot change the capacity of an open AsyncFileChannel");
+	if (capacity <= 0) throw InvalidArgumentException("capacity must be greater than zero");
+	init(capacity, _maxTextLength);
+}
+
+
+void AsyncFileChannel::setMaxTextLength(int maxTextLength)
+{
+	FastMutex::ScopedLock lock(_threadMutex);
+
+	if (_running) throw IllegalStateException("Cannot change the maximum text length of an open AsyncFileChannel");
+	if (maxTextLength <= 0) throw InvalidArgumentException("maxTextLength must be greater than zero");
+	init(_capacity, maxTextLength);
+}
+
+
+void AsyncFileChannel::writeBatch(std::string& batch)
+{
+	if (batch.empty()) return;
+
+	// FileChannel appends the final newline
+	batch.resize(batch.size() - 1);
+	try
+	{
+		FileChannel::log(Message(std::string(), batch, Message::PRIO_INFORMATION));
+	}
+	catch (Exception& exc)
+	{
+		ErrorHandler::handle(exc);
+	}
+	batch.clear();
+}
+
+
+void AsyncFileChannel::init(int capacity, int maxTextLength)
+{
+	_pFree    = new BoundedNotificationQueue(capacity);
+	_pPending = new BoundedNotificationQueue(capacity);
+	_capacity = _pFree->capacity();
+	_maxTextLength = maxTextLength;
+	for (int i = 0; i < _capacity; ++i)
+	{
+		_pFree->enqueueNotification(new LogRecord(maxTextLength));
+	}
+}
+
+
+} // namespace Poco
@@ -0,0 +1,98 @@
+//
+// AtomicOperations.h
+//
+// $Id: //poco/1.4/Foundation/src/AtomicOperations.h#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  AtomicOperations
+//
+// Definition of internal atomic operations.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_AtomicOperations_INCLUDED
+#define Foundation_AtomicOperations_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
+
+
+namespace Poco {
+namespace Impl {
+
+
+//
+// Atomic compare-and-swap and full memory barrier, for the
+// lock-free structures in Foundation. The platforms are the
+// same as for AtomicCounter. This header is internal to
+// Foundation and is not installed.
+//
+#if POCO_OS == POCO_OS_WINDOWS_NT
+inline bool compareAndSwap(volatile UInt32* pValue, UInt32 expected, UInt32 desired)
+{
+	return InterlockedCompareExchange(reinterpret_cast<volatile LONG*>(pValue), static_cast<LONG>(desired), static_cast<LONG>(expected)) == static_cast<LONG>(expected);
+}
+
+
+inline void memoryBarrier()
+{
+	MemoryBarrier();
+}
+#elif POCO_OS == POCO_OS_MAC_OS_X
+inline bool compareAndSwap(volatile UInt32* pValue, UInt32 expected, UInt32 desired)
+{
+	return OSAtomicCompareAndSwap32Barrier(static_cast<int32_t>(expected), static_cast<int32_t>(desired), reinterpret_cast<volatile int32_t*>(pValue));
+}
+
+
+inline void memoryBarrier()
+{
+	OSMemoryBarrier();
+}
+#elif defined(POCO_HAVE_GCC_ATOMICS)
+inline bool compareAndSwap(volatile UInt32* pValue, UInt32 expected, UInt32 desired)
+{
+	return __sync_bool_compare_and_swap(pValue, expected, desired);
+}
+
+
+inline void memoryBarrier()
+{
+	__sync_synchronize();
+}
+#else
+inline FastMutex& atomicMutex()
+{
+	static FastMutex mutex;
+	return mutex;
+}
+
+
+inline bool compareAndSwap(volatile UInt32* pValue, UInt32 expected, UInt32 desired)
+{
+	FastMutex::ScopedLock lock(atomicMutex());
+	if (*pValue != expected) return false;
+	*pValue = desired;
+	return true;
+}
+
+
+inline void memoryBarrier()
+{
+	FastMutex::ScopedLock lock(atomicMutex());
+}
+#endif
+
+
+} } // namespace Poco::Impl
+
+
+#endif // Foundation_AtomicOperations_INCLUDED
@@ -0,0 +1,521 @@
+//
+// BinaryLogChannel.cpp
+//
+// $Id: //poco/1.4/Foundation/src/BinaryLogChannel.cpp#1 $
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BinaryLogChannel
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/BinaryLogChannel.h"
+#include "Poco/RotateStrategy.h"
+#include "Poco/PurgeStrategy.h"
+#include "Poco/Message.h"
+#include "Poco/File.h"
+#include "Poco/Path.h"
+#include "Poco/DirectoryIterator.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/DateTime.h"
+#include "Poco/LocalDateTime.h"
+#include "Poco/Timespan.h"
+#include "Poco/String.h"
+#include "Poco/Ascii.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <cstring>
+
+
+//
+// Segment layout (all values in host byte order):
+//
+//   0  UInt32  magic ("PBLG")
+//   4  UInt16  version
+//   6  UInt16  byte order mark (0xFEFF)
+//   8  UInt32  header size
+//  12  UInt32  number of index entries
+//  16  Int64   creation date (UTC, microseconds since the epoch)
+//  24  UInt32  index interval (bytes)
+//  28  UInt32  reserved
+//  32  index entries, each an Int64 timestamp and a UInt64
+//      offset of the first record written at or after an
+//      index interval boundary
+//
+// Records start at the header size, aligned to 8 bytes:
+//
+//   0  UInt32  record length, including padding (0 = end of data)
+//   4  UInt8   priority
+//   5  UInt8   reserved
+//   6  UInt16  number of parameters
+//   8  Int64   timestamp (UTC, microseconds since the epoch)
+//  16  Int64   thread id
+//  24  Int32   process id
+//  28  UInt32  reserved
+//  32  source, thread name, text, and parameter names and
+//      values, each as a UInt32 length followed by the characters
+//
+
+
+namespace Poco {
+
+
+namespace
+{
+	template <typename T>
+	inline void put(char* pDest, T value)
+	{
+		std::memcpy(pDest, &value, sizeof(value));
+	}
+
+	inline char* putString(char* pDest, const std::string& str)
+	{
+		put(pDest, static_cast<UInt32>(str.size()));
+		pDest += sizeof(UInt32);
+		std::memcpy(pDest, str.data(), str.size());
+		return pDest + str.size();
+	}
+
+	inline std::size_t align(std::size_t size)
+	{
+		return (size + BinaryLogChannel::RECORD_ALIGNMENT - 1) & ~std::size_t(BinaryLogChannel::RECORD_ALIGNMENT - 1);
+	}
+}
+
+
+const std::string BinaryLogChannel::PROP_PATH        = "path";
+const std::string BinaryLogChannel::PROP_SEGMENTSIZE = "segmentSize";
+const std::string BinaryLogChannel::PROP_ROTATION    = "rotation";
+const std::string BinaryLogChannel::PROP_TIMES       = "times";
+const std::string BinaryLogChannel::PROP_PURGEAGE    = "purgeAge";
+const std::string BinaryLogChannel::PROP_PURGECOUNT  = "purgeCount";
+
+
+BinaryLogChannel::BinaryLogChannel():
+	_times("utc"),
+	_segmentSize(DEFAULT_SEGMENT_SIZE),
+	_pRotateStrategy(0),
+	_pPurgeStrategy(0),
+	_maxSegments(0),
+	_segmentNumber(0),
+	_writePos(0),
+	_indexCount(0),
+	_nextIndexPos(0),
+	_indexInterval(0),
+	_isOpen(false)
+{
+}
+
+
+BinaryLogChannel::BinaryLogChannel(const std::string& path):
+	_path(path),
+	_times("utc"),
+	_segmentSize(DEFAULT_SEGMENT_SIZE),
+	_pRotateStrategy(0),
+	_pPurgeStrategy(0),
+	_maxSegments(0),
+	_segmentNumber(0),
+	_writePos(0),
+	_indexCount(0),
+	_nextIndexPos(0),
+	_indexInterval(0),
+	_isOpen(false)
+{
+}
+
+
+BinaryLogChannel::~BinaryLogChannel()
+{
+	try
+	{
+		close();
+		delete _pRotateStrategy;
+		delete _pPurgeStrategy;
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void BinaryLogChannel::open()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (!_isOpen)
+	{
+		std::vector<unsigned> numbers;
+		listSegments(_path, numbers);
+		_segmentNumber = numbers.empty() ? 0 : numbers.back() + 1;
+		openSegment(0);
+		purge();
+		_isOpen = true;
+	}
+}
+
+
+void BinaryLogChannel::close()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (_isOpen)
+	{
+		closeSegment();
+		_isOpen = false;
+	}
+}
+
+
+void BinaryLogChannel::log(const Message& msg)
+{
+	open();
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	std::size_t size = recordSize(msg);
+	if (_writePos + size > static_cast<std::size_t>(_segment.end() - _segment.begin()) ||
+	    (_pRotateStrategy && _pRotateStrategy->mustRotate(_creationDate, _writePos - HEADER_SIZE)))
+	{
+		closeSegment();
+		++_segmentNumber;
+		openSegment(size);
+		purge();
+	}
+
+	char* pRecord = _segment.begin() + _writePos;
+	Int64 time = msg.getTime().epochMicroseconds();
+	put(pRecord + 4, static_cast<UInt8>(msg.getPriority()));
+	put(pRecord + 6, static_cast<UInt16>(msg.getAll().size()));
+	put(pRecord + 8, time);
+	put(pRecord + 16, static_cast<Int64>(msg.getTid()));
+	put(pRecord + 24, static_cast<Int32>(msg.getPid()));
+	char* pData = pRecord + RECORD_HEADER_SIZE;
+	pData = putString(pData, msg.getSource());
+	pData = putString(pData, msg.getThread());
+	pData = putString(pData, msg.getText());
+	const Message::StringMap& params = msg.getAll();
+	for (Message::StringMap::const_iterator it = params.begin(); it != params.end(); ++it)
+	{
+		pData = putString(pData, it->first);
+		pData = putString(pData, it->second);
+	}
+	// the length is written last, so that a reader never
+	// sees the length of an incomplete record
+	put(pRecord, static_cast<UInt32>(size));
+
+	if (_writePos >= _nextIndexPos && _indexCount < INDEX_CAPACITY)
+	{
+		char* pEntry = _segment.begin() + INDEX_OFFSET + _indexCount*INDEX_ENTRY_SIZE;
+		put(pEntry, time);
+		put(pEntry + 8, static_cast<UInt64>(_writePos));
+		put(_segment.begin() + 12, static_cast<UInt32>(++_indexCount));
+		_nextIndexPos = _writePos + _indexInterval;
+	}
+	_writePos += size;
+}
+
+
+void BinaryLogChannel::setProperty(const std::string& name, const std::string& value)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (name == PROP_TIMES)
+	{
+		if (value != "utc" && value != "local")
+			throw PropertyNotSupportedException("times", value);
+		_times = value;
+
+		if (!_rotation.empty())
+			setRotation(_rotation);
+	}
+	else if (name == PROP_PATH)
+		_path = value;
+	else if (name == PROP_SEGMENTSIZE)
+	{
+		std::string::const_iterator it  = value.begin();
+		std::string::const_iterator end = value.end();
+		std::size_t n = 0;
+		while (it != end && Ascii::isSpace(*it)) ++it;
+		while (it != end && Ascii::isDigit(*it)) { n *= 10; n += *it++ - '0'; }
+		while (it != end && Ascii::isSpace(*it)) ++it;
+		if (it != end && *it == 'K')
+			n *= 1024;
+		else if (it != end && *it == 'M')
+			n *= 1024*1024;
+		else if (it != end)
+			throw InvalidArgumentException("segmentSize", value);
+		if (n <= HEADER_SIZE)
+			throw InvalidArgumentException("segmentSize must be greater than the segment header size", value);
+		_segmentSize = n;
+	}
+	else if (name == PROP_ROTATION)
+		setRotation(value);
+	else if (name == PROP_PURGEAGE)
+		setPurgeAge(value);
+	else if (name == PROP_PURGECOUNT)
+		setPurgeCount(value);
+	else
+		Channel::setProperty(name, value);
+}
+
+
+std::string BinaryLogChannel::getProperty(const std::string& name) const
+{
+	if (name == PROP_TIMES)
+		return _times;
+	else if (name == PROP_PATH)
+		return _path;
+	else if (name == PROP_SEGMENTSIZE)
+		return NumberFormatter::format(_segmentSize);
+	else if (name == PROP_ROTATION)
+		return _rotation;
+	else if (name == PROP_PURGEAGE)
+		return _purgeAge;
+	else if (name == PROP_PURGECOUNT)
+		return _purgeCount;
+	else
+		return Channel::getProperty(name);
+}
+
+
+std::string BinaryLogChannel::segmentPath() const
+{
+	if (_isOpen)
+		return segmentPath(_path, _segmentNumber);
+	else
+		return std::string();
+}
+
+
+std::string BinaryLogChannel::segmentPath(const std::string& path, unsigned number)
+{
+	std::string result(path);
+	result += '.';
+	NumberFormatter::append(result, number);
+	return result;
+}
+
+
+void BinaryLogChannel::listSegments(const std::string& path, std::vector<unsigned>& numbers)
+{
+	Path p(path);
+	p.makeAbsolute();
+	Path parent = p.parent();
+	std::string baseName = p.getFileName();
+	baseName.append(".");
+
+	numbers.clear();
+	File dir(parent);
+	if (!dir.exists()) return;
+
+	DirectoryIterator it(parent);
+	DirectoryIterator end;
+	while (it != end)
+	{
+		const std::string& name = it.name();
+		unsigned number;
+		if (name.size() > baseName.size() &&
+		    name.compare(0, baseName.size(), baseName) == 0 &&
+		    Ascii::isDigit(name[baseName.size()]) &&
+		    NumberParser::tryParseUnsigned(name.substr(baseName.size()), number))
+		{
+			numbers.push_back(number);
+		}
+		++it;
+	}
+	std::sort(numbers.begin(), numbers.end());
+}
+
+
+void BinaryLogChannel::openSegment(std::size_t minSize)
+{
+	std::size_t size = std::max(_segmentSize, HEADER_SIZE + minSize);
+	File file(segmentPath(_path, _segmentNumber));
+	file.createFile();
+	file.setSize(size);
+	SharedMemory segment(file, SharedMemory::AM_WRITE);
+	_segment.swap(segment);
+
+	_creationDate.update();
+	_writePos      = HEADER_SIZE;
+	_indexCount    = 0;
+	_nextIndexPos  = HEADER_SIZE;
+	_indexInterval = align((size - HEADER_SIZE + INDEX_CAPACITY - 1)/INDEX_CAPACITY);
+
+	char* pHeader = _segment.begin();
+	put(pHeader, static_cast<UInt32>(SEGMENT_MAGIC));
+	put(pHeader + 4, static_cast<UInt16>(SEGMENT_VERSION));
+	put(pHeader + 6, static_cast<UInt16>(BYTE_ORDER_MARK));
+	put(pHeader + 8, static_cast<UInt32>(HEADER_SIZE));
+	put(pHeader + 12, static_cast<UInt32>(0));
+	put(pHeader + 16, static_cast<Int64>(_creationDate.epochMicroseconds()));
+	put(pHeader + 24, static_cast<UInt32>(_indexInterval));
+}
+
+
+void BinaryLogChannel::closeSegment()
+{
+	SharedMemory segment;
+	_segment.swap(segment);
+}
+
+
+std::size_t BinaryLogChannel::recordSize(const Message& msg)
+{
+	std::size_t size = RECORD_HEADER_SIZE + 3*sizeof(UInt32);
+	size += msg.getSource().size() + msg.getThread().size() + msg.getText().size();
+	const Message::StringMap& params = msg.getAll();
+	for (Message::StringMap::const_iterator it = params.begin(); it != params.end(); ++it)
+	{
+		size += 2*sizeof(UInt32) + it->first.size() + it->second.size();
+	}
+	return align(size);
+}
+
+
+void BinaryLogChannel::setRotation(const std::string& rotation)
+{
+	std::string::const_iterator it  = rotation.begin();
+	std::string::const_iterator end = rotation.end();
+	int n = 0;
+	while (it != end && Ascii::isSpace(*it)) ++it;
+	while (it != end && Ascii::isDigit(*it)) { n *= 10; n += *it++ - '0'; }
+	while (it != end && Ascii::isSpace(*it)) ++it;
+	std::string unit;
+	while (it != end && Ascii::isAlpha(*it)) unit += *it++;
+
+	RotateStrategy* pStrategy = 0;
+	if ((rotation.find(',') != std::string::npos) || (rotation.find(':') != std::string::npos))
+	{
+		if (_times == "utc")
+			pStrategy = new RotateAtTimeStrategy<DateTime>(rotation);
+		else
+			pStrategy = new RotateAtTimeStrategy<LocalDateTime>(rotation);
+	}
+	else if (unit == "daily")
+		pStrategy = new RotateByIntervalStrategy(Timespan(1*Timespan::DAYS));
+	else if (unit == "weekly")
+		pStrategy = new RotateByIntervalStrategy(Timespan(7*Timespan::DAYS));
+	else if (unit == "monthly")
+		pStrategy = new RotateByIntervalStrategy(Timespan(30*Timespan::DAYS));
+	else if (unit == "seconds") // for testing only
+		pStrategy = new RotateByIntervalStrategy(Timespan(n*Timespan::SECONDS));
+	else if (unit == "minutes")
+		pStrategy = new RotateByIntervalStrategy(Timespan(n*Timespan::MINUTES));
+	else if (unit == "hours")
+		pStrategy = new RotateByIntervalStrategy(Timespan(n*Timespan::HOURS));
+	else if (unit == "days")
+		pStrategy = new RotateByIntervalStrategy(Timespan(n*Timespan::DAYS));
+	else if (unit == "weeks")
+		pStrategy = new RotateByIntervalStrategy(Timespan(n*7*Timespan::DAYS));
+	else if (unit == "months")
+		pStrategy = new RotateByIntervalStrategy(Timespan(n*30*Timespan::DAYS));
+	else if (unit == "K")
+		pStrategy = new RotateBySizeStrategy(n*1024);
+	else if (unit == "M")
+		pStrategy = new RotateBySizeStrategy(n*1024*1024);
+	else if (unit.empty())
+		pStrategy = new RotateBySizeStrategy(n);
+	else if (unit != "never")
+		throw InvalidArgumentException("rotation", rotation);
+	delete _pRotateStrategy;
+	_pRotateStrategy = pStrategy;
+	_rotation = rotation;
+}
+
+
+void BinaryLogChannel::setPurgeAge(const std::string& age)
+{
+	delete _pPurgeStrategy;
+	_pPurgeStrategy = 0;
+	_maxSegments = 0;
+	_purgeAge = "none";
+
+	if (age.empty() || 0 == icompare(age, "none"))
+		return;
+
+	std::string::const_iterator it  = age.begin();
+	std::string::const_iterator end = age.end();
+	int n = 0;
+	while (it != end && Ascii::isSpace(*it)) ++it;
+	while (it != end && Ascii::isDigit(*it)) { n *= 10; n += *it++ - '0'; }
+	if (0 == n)
+		throw InvalidArgumentException("Zero is not valid purge age.");
+
+	while (it != end && Ascii::isSpace(*it)) ++it;
+
+	std::string unit;
+	while (it != end && Ascii::isAlpha(*it)) unit += *it++;
+
+	Timespan::TimeDiff factor = Timespan::SECONDS;
+	if (unit == "minutes")
+		factor = Timespan::MINUTES;
+	else if (unit == "hours")
+		factor = Timespan::HOURS;
+	else if (unit == "days")
+		factor = Timespan::DAYS;
+	else if (unit == "weeks")
+		factor = 7*Timespan::DAYS;
+	else if (unit == "months")
+		factor = 30*Timespan::DAYS;
+	else if (unit != "seconds")
+		throw InvalidArgumentException("purgeAge", age);
+
+	_pPurgeStrategy = new PurgeByAgeStrategy(Timespan(factor*n));
+	_purgeAge = age;
+}
+
+
+void BinaryLogChannel::setPurgeCount(const std::string& count)
+{
+	delete _pPurgeStrategy;
+	_pPurgeStrategy = 0;
+	_maxSegments = 0;
+	_purgeCount = "none";
+
+	if (count.empty() || 0 == icompare(count, "none"))
+		return;
+
+	int n = NumberParser::parse(trim(count));
+	if (n <= 0)
+		throw InvalidArgumentException("Zero is not valid purge count.");
+
+	_maxSegments = n;
+	_purgeCount = count;
+}
+
+
+void BinaryLogChannel::purge()
+{
+	try
+	{
+		if (_pPurgeStrategy)
+		{
+			_pPurgeStrategy->purge(_path);
+		}
+		else if (_maxSegments > 0)
+		{
+			// segments are ordered by their numbers, which
+			// is more reliable than their modification times
+			std::vector<unsigned> numbers;
+			listSegments(_path, numbers);
+			for (std::size_t i = 0; i + _maxSegments < numbers.size(); ++i)
+			{
+				File(segmentPath(_path, numbers[i])).remove();
+			}
+		}
+	}
+	catch (...)
+	{
+	}
+}
+
+
+} // namespace Poco
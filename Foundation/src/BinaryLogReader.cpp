@@ -0,0 +1,209 @@
+//
+// BinaryLogReader.cpp
+//
+// $Id: //poco/1.4/Foundation/src/BinaryLogReader.cpp#1 $
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BinaryLogChannel
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/BinaryLogReader.h"
+#include "Poco/BinaryLogChannel.h"
+#include "Poco/Message.h"
+#include "Poco/File.h"
+#include "Poco/Exception.h"
+#include <cstring>
+#include <cstddef>
+
+
+namespace Poco {
+
+
+namespace
+{
+	template <typename T>
+	inline T get(const char* pSrc)
+	{
+		T value;
+		std::memcpy(&value, pSrc, sizeof(value));
+		return value;
+	}
+
+	inline const char* getString(const char* pSrc, const char* pEnd, std::string& str)
+		/// Reads a string, which must end at or before pEnd.
+	{
+		if (pEnd - pSrc < static_cast<std::ptrdiff_t>(sizeof(UInt32)))
+			throw DataFormatException("Truncated binary log record");
+		UInt32 length = get<UInt32>(pSrc);
+		pSrc += sizeof(UInt32);
+		if (static_cast<std::size_t>(pEnd - pSrc) < length)
+			throw DataFormatException("Invalid string length in binary log record");
+		str.assign(pSrc, length);
+		return pSrc + length;
+	}
+}
+
+
+BinaryLogReader::BinaryLogReader(const std::string& path):
+	_path(path),
+	_next(0),
+	_size(0),
+	_pos(0)
+{
+	BinaryLogChannel::listSegments(_path, _segments);
+}
+
+
+BinaryLogReader::~BinaryLogReader()
+{
+}
+
+
+bool BinaryLogReader::read(Message& msg)
+{
+	const char* pRecord = current();
+	if (!pRecord) return false;
+
+	if (!msg.getAll().empty()) msg = Message();
+	msg.setPriority(static_cast<Message::Priority>(get<UInt8>(pRecord + 4)));
+	msg.setTime(Timestamp(get<Int64>(pRecord + 8)));
+	msg.setTid(static_cast<long>(get<Int64>(pRecord + 16)));
+	msg.setPid(get<Int32>(pRecord + 24));
+	// current() guarantees that the record lies within the segment
+	const char* pEnd  = pRecord + get<UInt32>(pRecord);
+	const char* pData = pRecord + BinaryLogChannel::RECORD_HEADER_SIZE;
+	pData = getString(pData, pEnd, _buffer);
+	msg.setSource(_buffer);
+	pData = getString(pData, pEnd, _buffer);
+	msg.setThread(_buffer);
+	pData = getString(pData, pEnd, _buffer);
+	msg.setText(_buffer);
+	std::string name;
+	for (UInt16 n = get<UInt16>(pRecord + 6); n > 0; --n)
+	{
+		// every parameter takes at least two string lengths
+		if (static_cast<std::size_t>(pEnd - pData) < n*2*sizeof(UInt32))
+			throw DataFormatException("Invalid parameter count in binary log record");
+		pData = getString(pData, pEnd, name);
+		pData = getString(pData, pEnd, msg[name]);
+	}
+	_pos += get<UInt32>(pRecord);
+	return true;
+}
+
+
+void BinaryLogReader::seek(const Timestamp& time)
+{
+	Int64 t = time.epochMicroseconds();
+
+	// find the last segment that starts at or before
+	// the given time, according to its first index entry
+	std::size_t index = _segments.size();
+	while (index > 0)
+	{
+		openSegment(--index);
+		if (_size > 0)
+		{
+			const char* pHeader = _segment.begin();
+			if (get<UInt32>(pHeader + 12) > 0 && get<Int64>(pHeader + BinaryLogChannel::INDEX_OFFSET) <= t)
+				break;
+		}
+	}
+	if (_size > 0)
+	{
+		// binary search for the last index entry before the given time
+		const char* pIndex = _segment.begin() + BinaryLogChannel::INDEX_OFFSET;
+		std::size_t lo = 0;
+		std::size_t hi = get<UInt32>(_segment.begin() + 12);
+		if (hi > BinaryLogChannel::INDEX_CAPACITY) hi = BinaryLogChannel::INDEX_CAPACITY;
+		while (lo < hi)
+		{
+			std::size_t mid = lo + (hi - lo)/2;
+			if (get<Int64>(pIndex + mid*BinaryLogChannel::INDEX_ENTRY_SIZE) < t)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		if (lo > 0)
+		{
+			UInt64 pos = get<UInt64>(pIndex + (lo - 1)*BinaryLogChannel::INDEX_ENTRY_SIZE + 8);
+			if (pos < _size) _pos = static_cast<std::size_t>(pos);
+		}
+	}
+
+	const char* pRecord;
+	while ((pRecord = current()) && get<Int64>(pRecord + 8) < t)
+	{
+		_pos += get<UInt32>(pRecord);
+	}
+}
+
+
+void BinaryLogReader::rewind()
+{
+	closeSegment();
+	_next = 0;
+}
+
+
+const char* BinaryLogReader::current()
+{
+	for (;;)
+	{
+		if (_pos + sizeof(UInt32) <= _size)
+		{
+			const char* pRecord = _segment.begin() + _pos;
+			UInt32 length = get<UInt32>(pRecord);
+			if (length >= BinaryLogChannel::RECORD_HEADER_SIZE && _pos + length <= _size)
+				return pRecord;
+		}
+		if (_next >= _segments.size()) return 0;
+		openSegment(_next);
+	}
+}
+
+
+void BinaryLogReader::openSegment(std::size_t index)
+{
+	closeSegment();
+	_next = index + 1;
+
+	File file(BinaryLogChannel::segmentPath(_path, _segments[index]));
+	if (!file.exists() || file.getSize() < BinaryLogChannel::HEADER_SIZE) return;
+
+	SharedMemory segment(file, SharedMemory::AM_READ);
+	const char* pHeader = segment.begin();
+	if (get<UInt32>(pHeader) != BinaryLogChannel::SEGMENT_MAGIC)
+		throw DataFormatException("Not a binary log segment", file.path());
+	if (get<UInt16>(pHeader + 6) != BinaryLogChannel::BYTE_ORDER_MARK)
+		throw DataFormatException("Binary log segment has a different byte order", file.path());
+	if (get<UInt16>(pHeader + 4) != BinaryLogChannel::SEGMENT_VERSION)
+		throw DataFormatException("Unsupported binary log segment version", file.path());
+
+	UInt32 pos = get<UInt32>(pHeader + 8);
+	if (pos < BinaryLogChannel::HEADER_SIZE)
+		throw DataFormatException("Invalid record offset in binary log segment", file.path());
+
+	_segment.swap(segment);
+	_size = _segment.end() - _segment.begin();
+	_pos  = pos;
+}
+
+
+void BinaryLogReader::closeSegment()
+{
+	SharedMemory segment;
+	_segment.swap(segment);
+	_size = 0;
+	_pos  = 0;
+}
+
+
+} // namespace Poco
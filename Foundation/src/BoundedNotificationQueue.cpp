@@ -0,0 +1,329 @@
+//
+// BoundedNotificationQueue.cpp
+//
+// $Id: //poco/1.4/Foundation/src/BoundedNotificationQueue.cpp#1 $
+//
+// Library: Foundation
+// Package: Notifications
+// Module:  BoundedNotificationQueue
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/BoundedNotificationQueue.h"
+#include "Poco/NotificationCenter.h"
+#include "Poco/Timestamp.h"
+#include "AtomicOperations.h"
+#if POCO_OS == POCO_OS_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <climits>
+#endif
+
+
+namespace Poco {
+
+
+using Impl::compareAndSwap;
+using Impl::memoryBarrier;
+
+
+namespace
+{
+#if POCO_OS == POCO_OS_LINUX
+	inline void futexWait(volatile UInt32* pValue, UInt32 expected, long milliseconds)
+	{
+		struct timespec ts;
+		ts.tv_sec  = milliseconds/1000;
+		ts.tv_nsec = (milliseconds % 1000)*1000000;
+		syscall(SYS_futex, pValue, FUTEX_WAIT_PRIVATE, expected, milliseconds < 0 ? 0 : &ts, 0, 0);
+	}
+
+	inline void futexWakeAll(volatile UInt32* pValue)
+	{
+		syscall(SYS_futex, pValue, FUTEX_WAKE_PRIVATE, INT_MAX, 0, 0, 0);
+	}
+#endif
+}
+
+
+BoundedNotificationQueue::WaitList::WaitList():
+	state(0)
+{
+}
+
+
+BoundedNotificationQueue::BoundedNotificationQueue(int capacity):
+	_enqueuePos(0),
+	_dequeuePos(0)
+{
+	poco_assert (capacity > 0);
+
+	UInt32 n = 2;
+	while (n < static_cast<UInt32>(capacity)) n *= 2;
+	_cells.resize(n);
+	for (UInt32 i = 0; i < n; ++i)
+	{
+		_cells[i].sequence      = i;
+		_cells[i].pNotification = 0;
+	}
+	_mask = n - 1;
+}
+
+
+BoundedNotificationQueue::~BoundedNotificationQueue()
+{
+	try
+	{
+		clear();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void BoundedNotificationQueue::enqueueNotification(Notification::Ptr pNotification)
+{
+	poco_check_ptr (pNotification);
+	Notification* pNf = pNotification.duplicate();
+	while (!push(pNf))
+	{
+		UInt32 state = prepareWait(_notFull);
+		// the queue may have been emptied before we
+		// announced that we are waiting
+		if (push(pNf)) break;
+		wait(_notFull, state, -1);
+	}
+	wakeUp(_notEmpty);
+}
+
+
+bool BoundedNotificationQueue::tryEnqueueNotification(Notification::Ptr pNotification)
+{
+	poco_check_ptr (pNotification);
+	Notification* pNf = pNotification.duplicate();
+	if (push(pNf))
+	{
+		wakeUp(_notEmpty);
+		return true;
+	}
+	pNf->release();
+	return false;
+}
+
+
+Notification* BoundedNotificationQueue::dequeueNotification()
+{
+	Notification* pNf = pop();
+	if (pNf) wakeUp(_notFull);
+	return pNf;
+}
+
+
+Notification* BoundedNotificationQueue::waitDequeueNotification()
+{
+	return waitPop(-1);
+}
+
+
+Notification* BoundedNotificationQueue::waitDequeueNotification(long milliseconds)
+{
+	return waitPop(milliseconds);
+}
+
+
+void BoundedNotificationQueue::dispatch(NotificationCenter& notificationCenter)
+{
+	Notification::Ptr pNf = dequeueNotification();
+	while (pNf)
+	{
+		notificationCenter.postNotification(pNf);
+		pNf = dequeueNotification();
+	}
+}
+
+
+void BoundedNotificationQueue::wakeUpAll()
+{
+	++_wakeUps;
+	wakeUp(_notEmpty);
+}
+
+
+bool BoundedNotificationQueue::empty() const
+{
+	return size() == 0;
+}
+
+
+int BoundedNotificationQueue::size() const
+{
+	memoryBarrier();
+	UInt32 dequeuePos = _dequeuePos;
+	UInt32 enqueuePos = _enqueuePos;
+	Int32 n = static_cast<Int32>(enqueuePos - dequeuePos);
+	if (n < 0) return 0;
+	if (n > capacity()) return capacity();
+	return n;
+}
+
+
+void BoundedNotificationQueue::clear()
+{
+	Notification* pNf = pop();
+	while (pNf)
+	{
+		pNf->release();
+		pNf = pop();
+	}
+	wakeUp(_notFull);
+}
+
+
+bool BoundedNotificationQueue::push(Notification* pNotification)
+{
+	Cell* pCell;
+	UInt32 pos = _enqueuePos;
+	for (;;)
+	{
+		pCell = &_cells[pos & _mask];
+		UInt32 seq = pCell->sequence;
+		memoryBarrier();
+		Int32 diff = static_cast<Int32>(seq - pos);
+		if (diff == 0)
+		{
+			if (compareAndSwap(&_enqueuePos, pos, pos + 1)) break;
+			pos = _enqueuePos;
+		}
+		else if (diff < 0)
+		{
+			return false; // the cell has not been dequeued yet, so the queue is full
+		}
+		else pos = _enqueuePos;
+	}
+	pCell->pNotification = pNotification;
+	memoryBarrier(); // the notification must be visible before the new sequence number
+	pCell->sequence = pos + 1;
+	return true;
+}
+
+
+Notification* BoundedNotificationQueue::pop()
+{
+	Cell* pCell;
+	UInt32 pos = _dequeuePos;
+	for (;;)
+	{
+		pCell = &_cells[pos & _mask];
+		UInt32 seq = pCell->sequence;
+		memoryBarrier();
+		Int32 diff = static_cast<Int32>(seq - (pos + 1));
+		if (diff == 0)
+		{
+			if (compareAndSwap(&_dequeuePos, pos, pos + 1)) break;
+			pos = _dequeuePos;
+		}
+		else if (diff < 0)
+		{
+			return 0; // the cell has not been enqueued yet, so the queue is empty
+		}
+		else pos = _dequeuePos;
+	}
+	Notification* pNf = pCell->pNotification;
+	pCell->pNotification = 0;
+	memoryBarrier();
+	pCell->sequence = pos + _mask + 1;
+	return pNf;
+}
+
+
+Notification* BoundedNotificationQueue::waitPop(long milliseconds)
+{
+	int wakeUps = _wakeUps.value();
+	Timestamp start;
+	for (;;)
+	{
+		Notification* pNf = pop();
+		if (!pNf)
+		{
+			long remaining = -1;
+			if (milliseconds >= 0)
+			{
+				remaining = milliseconds - static_cast<long>(start.elapsed()/1000);
+				if (remaining <= 0) return 0;
+			}
+			UInt32 state = prepareWait(_notEmpty);
+			// a notification may have been enqueued before
+			// we announced that we are waiting
+			pNf = pop();
+			if (!pNf && _wakeUps.value() == wakeUps)
+			{
+				wait(_notEmpty, state, remaining);
+			}
+		}
+		if (pNf)
+		{
+			wakeUp(_notFull);
+			return pNf;
+		}
+		if (_wakeUps.value() != wakeUps) return 0;
+	}
+}
+
+
+UInt32 BoundedNotificationQueue::prepareWait(WaitList& waitList)
+{
+	UInt32 state = waitList.state;
+	while (!compareAndSwap(&waitList.state, state, state | 1)) state = waitList.state;
+	return state | 1;
+}
+
+
+void BoundedNotificationQueue::wait(WaitList& waitList, UInt32 state, long milliseconds)
+{
+#if POCO_OS == POCO_OS_LINUX
+	futexWait(&waitList.state, state, milliseconds);
+#else
+	Mutex::ScopedLock lock(waitList.mutex);
+	if (waitList.state == state)
+	{
+		if (milliseconds < 0)
+			waitList.condition.wait(waitList.mutex);
+		else
+			waitList.condition.tryWait(waitList.mutex, milliseconds);
+	}
+#endif
+}
+
+
+void BoundedNotificationQueue::wakeUp(WaitList& waitList)
+{
+	// pairs with prepareWait() by a thread about to wait
+	memoryBarrier();
+	UInt32 state = waitList.state;
+	if ((state & 1) == 0) return;
+#if POCO_OS != POCO_OS_LINUX
+	Mutex::ScopedLock lock(waitList.mutex);
+#endif
+	while (!compareAndSwap(&waitList.state, state, (state & ~1u) + 2))
+	{
+		state = waitList.state;
+		if ((state & 1) == 0) return;
+	}
+#if POCO_OS == POCO_OS_LINUX
+	futexWakeAll(&waitList.state);
+#else
+	waitList.condition.broadcast();
+#endif
+}
+
+
+} // namespace Poco
@@ -0,0 +1,102 @@
+//
+// Deflater.cpp
+//
+// $Id: //poco/1.4/Foundation/src/Deflater.cpp#1 $
+//
+// Library: Foundation
+// Package: Streams
+// Module:  ZLibStream
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Deflater.h"
+#include "Poco/Exception.h"
+#if defined(POCO_UNBUNDLED)
+#include <zlib.h>
+#else
+#include "Poco/zlib.h"
+#endif
+
+
+namespace Poco {
+
+
+class DeflaterImpl
+	/// Holds the zlib stream, so that zlib.h
+	/// need not be included by Deflater.h.
+{
+public:
+	z_stream zstr;
+};
+
+
+Deflater::Deflater(int windowBits, int level):
+	_pImpl(new DeflaterImpl)
+{
+	_pImpl->zstr.zalloc    = Z_NULL;
+	_pImpl->zstr.zfree     = Z_NULL;
+	_pImpl->zstr.opaque    = Z_NULL;
+	_pImpl->zstr.next_in   = 0;
+	_pImpl->zstr.avail_in  = 0;
+	_pImpl->zstr.next_out  = 0;
+	_pImpl->zstr.avail_out = 0;
+
+	int rc = deflateInit2(&_pImpl->zstr, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+	if (rc != Z_OK)
+	{
+		delete _pImpl;
+		throw IOException(zError(rc));
+	}
+}
+
+
+Deflater::~Deflater()
+{
+	deflateEnd(&_pImpl->zstr);
+	delete _pImpl;
+}
+
+
+void Deflater::setInput(const char* data, std::size_t length)
+{
+	_pImpl->zstr.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	_pImpl->zstr.avail_in = static_cast<uInt>(length);
+}
+
+
+std::size_t Deflater::deflate(char* buffer, std::size_t length, FlushMode flush)
+{
+	int zflush = Z_NO_FLUSH;
+	if (flush == FLUSH_SYNC)
+		zflush = Z_SYNC_FLUSH;
+	else if (flush == FLUSH_FINISH)
+		zflush = Z_FINISH;
+
+	_pImpl->zstr.next_out  = reinterpret_cast<Bytef*>(buffer);
+	_pImpl->zstr.avail_out = static_cast<uInt>(length);
+	int rc = ::deflate(&_pImpl->zstr, zflush);
+	// Z_BUF_ERROR only means that no progress was possible
+	if (rc != Z_OK && rc != Z_STREAM_END && rc != Z_BUF_ERROR) throw IOException(zError(rc));
+	return length - _pImpl->zstr.avail_out;
+}
+
+
+std::size_t Deflater::inputAvailable() const
+{
+	return _pImpl->zstr.avail_in;
+}
+
+
+void Deflater::reset()
+{
+	int rc = deflateReset(&_pImpl->zstr);
+	if (rc != Z_OK) throw IOException(zError(rc));
+}
+
+
+} // namespace Poco
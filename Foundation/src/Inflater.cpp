@@ -0,0 +1,107 @@
+//
+// Inflater.cpp
+//
+// $Id: //poco/1.4/Foundation/src/Inflater.cpp#1 $
+//
+// Library: Foundation
+// Package: Streams
+// Module:  ZLibStream
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Inflater.h"
+#include "Poco/Exception.h"
+#if defined(POCO_UNBUNDLED)
+#include <zlib.h>
+#else
+#include "Poco/zlib.h"
+#endif
+
+
+namespace Poco {
+
+
+class InflaterImpl
+	/// Holds the zlib stream, so that zlib.h
+	/// need not be included by Inflater.h.
+{
+public:
+	z_stream zstr;
+};
+
+
+Inflater::Inflater(int windowBits):
+	_pImpl(new InflaterImpl)
+{
+	_pImpl->zstr.zalloc    = Z_NULL;
+	_pImpl->zstr.zfree     = Z_NULL;
+	_pImpl->zstr.opaque    = Z_NULL;
+	_pImpl->zstr.next_in   = 0;
+	_pImpl->zstr.avail_in  = 0;
+	_pImpl->zstr.next_out  = 0;
+	_pImpl->zstr.avail_out = 0;
+
+	int rc = inflateInit2(&_pImpl->zstr, windowBits);
+	if (rc != Z_OK)
+	{
+		delete _pImpl;
+		throw IOException(zError(rc));
+	}
+}
+
+
+Inflater::~Inflater()
+{
+	inflateEnd(&_pImpl->zstr);
+	delete _pImpl;
+}
+
+
+void Inflater::setInput(const char* data, std::size_t length)
+{
+	_pImpl->zstr.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	_pImpl->zstr.avail_in = static_cast<uInt>(length);
+}
+
+
+Inflater::Status Inflater::inflate(char* buffer, std::size_t length, std::size_t& written)
+{
+	_pImpl->zstr.next_out  = reinterpret_cast<Bytef*>(buffer);
+	_pImpl->zstr.avail_out = static_cast<uInt>(length);
+	int rc = ::inflate(&_pImpl->zstr, Z_SYNC_FLUSH);
+	written = length - _pImpl->zstr.avail_out;
+	switch (rc)
+	{
+	case Z_OK:
+		return INFLATE_OK;
+	case Z_STREAM_END:
+		return INFLATE_STREAM_END;
+	case Z_BUF_ERROR:
+		return INFLATE_NO_PROGRESS;
+	case Z_MEM_ERROR:
+		throw OutOfMemoryException(zError(rc));
+	default:
+		throw DataFormatException(zError(rc));
+	}
+}
+
+
+std::size_t Inflater::inputAvailable() const
+{
+	return _pImpl->zstr.avail_in;
+}
+
+
+void Inflater::reset()
+{
+	int rc = inflateReset(&_pImpl->zstr);
+	if (rc != Z_OK) throw IOException(zError(rc));
+}
+
+
+} // namespace Poco
@@ -209,6 +209,14 @@ bool Message::has(const std::string& param) const
 }
 
 
+const Message::StringMap& Message::getAll() const
+{
+	static const StringMap empty;
+
+	return _pMap ? *_pMap : empty;
+}
+
+
 const std::string& Message::get(const std::string& param) const
 {
 	if (_pMap)
@@ -24,6 +24,8 @@
 #include "Poco/Timezone.h"
 #include "Poco/Environment.h"
 #include "Poco/NumberParser.h"
+#include "AtomicOperations.h"
+#include <cstring>
 
 
 namespace Poco {
@@ -34,14 +36,18 @@ const std::string PatternFormatter::PROP_TIMES   = "times";
 
 
 PatternFormatter::PatternFormatter():
-	_localTime(false)
+	_localTime(false),
+	_tzdTime(0),
+	_tzd(0)
 {
 }
 
 
 PatternFormatter::PatternFormatter(const std::string& format):
 	_localTime(false),
-	_pattern(format)
+	_pattern(format),
+	_tzdTime(0),
+	_tzd(0)
 {
 	parsePattern();
 }
@@ -54,18 +60,19 @@ PatternFormatter::~PatternFormatter()
 
 void PatternFormatter::format(const Message& msg, std::string& text)
 {
-	Timestamp timestamp = msg.getTime();
 	bool localTime = _localTime;
-	if (localTime)
-	{
-		timestamp += Timezone::utcOffset()*Timestamp::resolution();
-		timestamp += Timezone::dst()*Timestamp::resolution();
-	}
-	DateTime dateTime = timestamp;
-	for (std::vector<PatternAction>::iterator ip = _patternActions.begin(); ip != _patternActions.end(); ++ip)
+	std::size_t index = 0;
+	while (index < _patternActions.size())
 	{
-		text.append(ip->prepend);
-		switch (ip->key)
+		const PatternAction& act = _patternActions[index];
+		if (act.cache >= 0)
+		{
+			appendTimeRun(index, msg.getTime(), localTime, text);
+			index += act.count;
+			continue;
+		}
+		text.append(act.prepend);
+		switch (act.key)
 		{
 		case 's': text.append(msg.getSource()); break;
 		case 't': text.append(msg.getText()); break;
@@ -75,60 +82,199 @@ void PatternFormatter::format(const Message& msg, std::string& text)
 		case 'P': NumberFormatter::append(text, msg.getPid()); break;
 		case 'T': text.append(msg.getThread()); break;
 		case 'I': NumberFormatter::append(text, msg.getTid()); break;
-		case 'N': text.append(Environment::nodeName()); break;
+		case 'N': text.append(_nodeName); break;
 		case 'U': text.append(msg.getSourceFile() ? msg.getSourceFile() : ""); break;
 		case 'u': NumberFormatter::append(text, msg.getSourceLine()); break;
-		case 'w': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()], 0, 3); break;
-		case 'W': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()]); break;
-		case 'b': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1], 0, 3); break;
-		case 'B': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1]); break;
-		case 'd': NumberFormatter::append0(text, dateTime.day(), 2); break;
-		case 'e': NumberFormatter::append(text, dateTime.day()); break;
-		case 'f': NumberFormatter::append(text, dateTime.day(), 2); break;
-		case 'm': NumberFormatter::append0(text, dateTime.month(), 2); break;
-		case 'n': NumberFormatter::append(text, dateTime.month()); break;
-		case 'o': NumberFormatter::append(text, dateTime.month(), 2); break;
-		case 'y': NumberFormatter::append0(text, dateTime.year() % 100, 2); break;
-		case 'Y': NumberFormatter::append0(text, dateTime.year(), 4); break;
-		case 'H': NumberFormatter::append0(text, dateTime.hour(), 2); break;
-		case 'h': NumberFormatter::append0(text, dateTime.hourAMPM(), 2); break;
-		case 'a': text.append(dateTime.isAM() ? "am" : "pm"); break;
-		case 'A': text.append(dateTime.isAM() ? "AM" : "PM"); break;
-		case 'M': NumberFormatter::append0(text, dateTime.minute(), 2); break;
-		case 'S': NumberFormatter::append0(text, dateTime.second(), 2); break;
-		case 'i': NumberFormatter::append0(text, dateTime.millisecond(), 3); break;
-		case 'c': NumberFormatter::append(text, dateTime.millisecond()/100); break;
-		case 'F': NumberFormatter::append0(text, dateTime.millisecond()*1000 + dateTime.microsecond(), 6); break;
-		case 'z': text.append(DateTimeFormatter::tzdISO(localTime ? Timezone::tzd() : DateTimeFormatter::UTC)); break;
-		case 'Z': text.append(DateTimeFormatter::tzdRFC(localTime ? Timezone::tzd() : DateTimeFormatter::UTC)); break;
-		case 'E': NumberFormatter::append(text, msg.getTime().epochTime()); break;
+		case 'F':
+			{
+				Timestamp timestamp = msg.getTime();
+				if (localTime)
+				{
+					timestamp += timezoneDifferential(msg.getTime())*Timestamp::resolution();
+				}
+				DateTime dateTime = timestamp;
+				NumberFormatter::append0(text, dateTime.millisecond()*1000 + dateTime.microsecond(), 6);
+			}
+			break;
 		case 'v':
-			if (ip->length > msg.getSource().length())	//append spaces
-				text.append(msg.getSource()).append(ip->length - msg.getSource().length(), ' ');
-			else if (ip->length && ip->length < msg.getSource().length()) // crop
-				text.append(msg.getSource(), msg.getSource().length()-ip->length, ip->length);
-			else
-				text.append(msg.getSource());
+			{
+				std::size_t length = act.length > 0 ? static_cast<std::size_t>(act.length) : 0;
+				if (length > msg.getSource().length())	//append spaces
+					text.append(msg.getSource()).append(length - msg.getSource().length(), ' ');
+				else if (length && length < msg.getSource().length()) // crop
+					text.append(msg.getSource(), msg.getSource().length()-length, length);
+				else
+					text.append(msg.getSource());
+			}
 			break;
 		case 'x':
 			try
 			{
-				text.append(msg[ip->property]);
+				text.append(msg[act.property]);
 			}
 			catch (...)
 			{
 			}
 			break;
+		case 'K':
+			appendParameters(msg, text);
+			break;
 		case 'L':
-			if (!localTime)
+			localTime = true;
+			break;
+		}
+		++index;
+	}
+}
+
+
+void PatternFormatter::appendTimeRun(std::size_t index, const Timestamp& time, bool localTime, std::string& text)
+{
+	TimeCache& cache = _timeCaches[_patternActions[index].cache];
+	Timestamp::TimeVal cacheTime = time.epochMicroseconds();
+	cacheTime -= cacheTime % cache.resolution;
+
+	// The cache is protected by a sequence lock: the sequence number
+	// is odd while a thread updates the cache, and a reader's copy is
+	// only valid if the sequence number did not change while copying.
+	UInt32 sequence = cache.sequence;
+	Impl::memoryBarrier();
+	if ((sequence & 1) == 0 && cache.valid && cache.time == cacheTime && cache.localTime == localTime)
+	{
+		char buffer[TimeCache::MAX_TEXT_LENGTH];
+		std::size_t length = cache.length;
+		if (length > sizeof(buffer)) length = sizeof(buffer);
+		std::memcpy(buffer, cache.text, length);
+		Impl::memoryBarrier();
+		if (cache.sequence == sequence)
+		{
+			text.append(buffer, length);
+			return;
+		}
+	}
+
+	std::size_t pos = text.size();
+	formatTimeRun(index, time, localTime, text);
+	std::size_t length = text.size() - pos;
+	// If another thread is updating the cache, leave it alone.
+	if ((sequence & 1) == 0 && length <= sizeof(cache.text) && Impl::compareAndSwap(&cache.sequence, sequence, sequence + 1))
+	{
+		std::memcpy(cache.text, text.data() + pos, length);
+		cache.length    = length;
+		cache.time      = cacheTime;
+		cache.localTime = localTime;
+		cache.valid     = true;
+		Impl::memoryBarrier();
+		cache.sequence  = sequence + 2;
+	}
+}
+
+
+void PatternFormatter::formatTimeRun(std::size_t index, const Timestamp& time, bool localTime, std::string& text)
+{
+	const PatternAction& first = _patternActions[index];
+	Timestamp timestamp = time;
+	int tzd = DateTimeFormatter::UTC;
+	if (localTime)
+	{
+		tzd = timezoneDifferential(time);
+		timestamp += tzd*Timestamp::resolution();
+	}
+	DateTime dateTime = timestamp;
+	for (std::size_t i = index; i < index + first.count; ++i)
+	{
+		text.append(_patternActions[i].prepend);
+		appendTime(_patternActions[i].key, time, dateTime, tzd, text);
+	}
+}
+
+
+void PatternFormatter::appendTime(char key, const Timestamp& time, const DateTime& dateTime, int tzd, std::string& text)
+{
+	switch (key)
+	{
+	case 'w': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()], 0, 3); break;
+	case 'W': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()]); break;
+	case 'b': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1], 0, 3); break;
+	case 'B': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1]); break;
+	case 'd': NumberFormatter::append0(text, dateTime.day(), 2); break;
+	case 'e': NumberFormatter::append(text, dateTime.day()); break;
+	case 'f': NumberFormatter::append(text, dateTime.day(), 2); break;
+	case 'm': NumberFormatter::append0(text, dateTime.month(), 2); break;
+	case 'n': NumberFormatter::append(text, dateTime.month()); break;
+	case 'o': NumberFormatter::append(text, dateTime.month(), 2); break;
+	case 'y': NumberFormatter::append0(text, dateTime.year() % 100, 2); break;
+	case 'Y': NumberFormatter::append0(text, dateTime.year(), 4); break;
+	case 'H': NumberFormatter::append0(text, dateTime.hour(), 2); break;
+	case 'h': NumberFormatter::append0(text, dateTime.hourAMPM(), 2); break;
+	case 'a': text.append(dateTime.isAM() ? "am" : "pm"); break;
+	case 'A': text.append(dateTime.isAM() ? "AM" : "PM"); break;
+	case 'M': NumberFormatter::append0(text, dateTime.minute(), 2); break;
+	case 'S': NumberFormatter::append0(text, dateTime.second(), 2); break;
+	case 'i': NumberFormatter::append0(text, dateTime.millisecond(), 3); break;
+	case 'c': NumberFormatter::append(text, dateTime.millisecond()/100); break;
+	case 'z': text.append(DateTimeFormatter::tzdISO(tzd)); break;
+	case 'Z': text.append(DateTimeFormatter::tzdRFC(tzd)); break;
+	case 'E': NumberFormatter::append(text, time.epochTime()); break;
+	}
+}
+
+
+int PatternFormatter::timezoneDifferential(const Timestamp& time)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	Timestamp::TimeVal second = time.epochMicroseconds();
+	second -= second % Timestamp::resolution();
+	if (second != _tzdTime || _tzdTime == 0)
+	{
+		_tzd     = Timezone::utcOffset() + Timezone::dst();
+		_tzdTime = second;
+	}
+	return _tzd;
+}
+
+
+bool PatternFormatter::isTimeKey(char key)
+{
+	switch (key)
+	{
+	case 'w': case 'W': case 'b': case 'B': case 'd': case 'e': case 'f':
+	case 'm': case 'n': case 'o': case 'y': case 'Y': case 'H': case 'h':
+	case 'a': case 'A': case 'M': case 'S': case 'i': case 'c': case 'z':
+	case 'Z': case 'E':
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+bool PatternFormatter::isMillisecondKey(char key)
+{
+	return key == 'i' || key == 'c';
+}
+
+
+void PatternFormatter::appendParameters(const Message& msg, std::string& text)
+{
+	const Message::StringMap& params = msg.getAll();
+	for (Message::StringMap::const_iterator it = params.begin(); it != params.end(); ++it)
+	{
+		if (it != params.begin()) text += ' ';
+		text.append(it->first);
+		text += '=';
+		if (it->second.empty() || it->second.find_first_of(" \t\"=") != std::string::npos)
+		{
+			text += '"';
+			for (std::string::const_iterator itc = it->second.begin(); itc != it->second.end(); ++itc)
 			{
-				localTime = true;
-				timestamp += Timezone::utcOffset()*Timestamp::resolution();
-				timestamp += Timezone::dst()*Timestamp::resolution();
-				dateTime = timestamp;
+				if (*itc == '"' || *itc == '\\') text += '\\';
+				text += *itc;
 			}
-			break;
+			text += '"';
 		}
+		else text.append(it->second);
 	}
 }
 
@@ -189,6 +335,31 @@ void PatternFormatter::parsePattern()
 	{
 		_patternActions.push_back(endAct);
 	}
+
+	_timeCaches.clear();
+	_nodeName.clear();
+	std::size_t i = 0;
+	while (i < _patternActions.size())
+	{
+		if (_patternActions[i].key == 'N' && _nodeName.empty())
+		{
+			_nodeName = Environment::nodeName();
+		}
+		if (isTimeKey(_patternActions[i].key))
+		{
+			TimeCache cache;
+			std::size_t first = i;
+			while (i < _patternActions.size() && isTimeKey(_patternActions[i].key))
+			{
+				if (isMillisecondKey(_patternActions[i].key)) cache.resolution = 1000;
+				++i;
+			}
+			_patternActions[first].cache = static_cast<int>(_timeCaches.size());
+			_patternActions[first].count = static_cast<int>(i - first);
+			_timeCaches.push_back(cache);
+		}
+		else ++i;
+	}
 }
 
 	
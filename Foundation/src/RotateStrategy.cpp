@@ -39,6 +39,12 @@ RotateStrategy::~RotateStrategy()
 }
 
 
+bool RotateStrategy::mustRotate(const Timestamp& /*creationDate*/, UInt64 /*size*/)
+{
+	return false;
+}
+
+
 //
 // RotateByIntervalStrategy
 //
@@ -90,6 +96,13 @@ bool RotateByIntervalStrategy::mustRotate(LogFile* pFile)
 }
 
 
+bool RotateByIntervalStrategy::mustRotate(const Timestamp& creationDate, UInt64 /*size*/)
+{
+	Timestamp now;
+	return _span <= now - creationDate;
+}
+
+
 //
 // RotateBySizeStrategy
 //
@@ -112,4 +125,10 @@ bool RotateBySizeStrategy::mustRotate(LogFile* pFile)
 }
 
 
+bool RotateBySizeStrategy::mustRotate(const Timestamp& /*creationDate*/, UInt64 size)
+{
+	return size >= _size;
+}
+
+
 } // namespace Poco
@@ -0,0 +1,501 @@
+//
+// TaskExecutor.cpp
+//
+// $Id: //poco/1.4/Foundation/src/TaskExecutor.cpp#1 $
+//
+// Library: Foundation
+// Package: Threading
+// Module:  TaskExecutor
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/TaskExecutor.h"
+#include "Poco/Runnable.h"
+#include "Poco/Environment.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/Exception.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/Timestamp.h"
+#include "AtomicOperations.h"
+#include <deque>
+#include <sstream>
+
+
+namespace Poco {
+
+
+using Impl::compareAndSwap;
+using Impl::memoryBarrier;
+
+
+class TaskExecutorWorker: public Runnable
+	/// A worker thread of a TaskExecutor.
+	///
+	/// The worker's task queue is the work-stealing deque described
+	/// by Chase and Lev ("Dynamic Circular Work-Stealing Deque", 2005),
+	/// with a fixed capacity. Only the worker thread pushes and pops
+	/// tasks at the bottom of the queue; other workers steal tasks
+	/// from the top of the queue. Indexes wrap around, so their
+	/// difference is always computed modulo 2^32.
+{
+public:
+	TaskExecutorWorker(TaskExecutor& executor, int index, int capacity, const std::string& name, int stackSize):
+		_executor(executor),
+		_index(index),
+		_tasks(capacity),
+		_mask(static_cast<UInt32>(capacity - 1)),
+		_top(0),
+		_bottom(0),
+		_capacity(capacity),
+		_thread(name)
+	{
+		_thread.setStackSize(stackSize);
+	}
+
+	void start()
+	{
+		_thread.start(*this);
+	}
+
+	void join()
+	{
+		_thread.join();
+	}
+
+	int index() const
+	{
+		return _index;
+	}
+
+	bool isCurrent() const
+	{
+		return Thread::current() == &_thread;
+	}
+
+	bool push(Runnable* pTask)
+		/// Pushes a task onto the bottom of the queue.
+		/// Must only be called by the worker thread.
+	{
+		UInt32 b = _bottom;
+		UInt32 t = _top;
+		if (b - t >= static_cast<UInt32>(_capacity)) return false;
+		_tasks[b & _mask] = pTask;
+		memoryBarrier(); // the task must be visible before the new bottom
+		_bottom = b + 1;
+		return true;
+	}
+
+	Runnable* pop()
+		/// Pops a task from the bottom of the queue.
+		/// Must only be called by the worker thread.
+	{
+		UInt32 b = _bottom - 1;
+		_bottom = b;
+		memoryBarrier();
+		UInt32 t = _top;
+		if (static_cast<Int32>(b - t) < 0)
+		{
+			_bottom = t;
+			return 0;
+		}
+		Runnable* pTask = _tasks[b & _mask];
+		if (b != t) return pTask;
+		// last task - race against thieves
+		if (!compareAndSwap(&_top, t, t + 1)) pTask = 0;
+		_bottom = t + 1;
+		return pTask;
+	}
+
+	Runnable* steal()
+		/// Steals a task from the top of the queue.
+		/// Returns null if the queue is empty, or if another
+		/// thread has taken the task first.
+	{
+		UInt32 t = _top;
+		memoryBarrier();
+		UInt32 b = _bottom;
+		if (static_cast<Int32>(b - t) <= 0) return 0;
+		Runnable* pTask = _tasks[t & _mask];
+		if (!compareAndSwap(&_top, t, t + 1)) return 0;
+		return pTask;
+	}
+
+	bool submit(Runnable* pTask)
+		/// Appends a task to the worker's submission queue.
+	{
+		FastMutex::ScopedLock lock(_submitMutex);
+
+		if (static_cast<int>(_submitted.size()) >= _capacity) return false;
+		_submitted.push_back(pTask);
+		return true;
+	}
+
+	Runnable* takeSubmitted()
+		/// Takes the first task from the worker's submission queue.
+	{
+		FastMutex::ScopedLock lock(_submitMutex);
+
+		if (_submitted.empty()) return 0;
+		Runnable* pTask = _submitted.front();
+		_submitted.pop_front();
+		return pTask;
+	}
+
+	void runTask(Runnable* pTask)
+	{
+		try
+		{
+			pTask->run();
+		}
+		catch (Exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			ErrorHandler::handle();
+		}
+		_executor.taskDone();
+	}
+
+	void run()
+	{
+		for (;;)
+		{
+			Runnable* pTask = _executor.findTask(this);
+			if (pTask)
+				runTask(pTask);
+			else if (_executor.stopped() && _executor.pending() == 0)
+				break;
+			else
+				_executor.waitForTask();
+		}
+	}
+
+private:
+	TaskExecutorWorker();
+	TaskExecutorWorker(const TaskExecutorWorker&);
+	TaskExecutorWorker& operator = (const TaskExecutorWorker&);
+
+	TaskExecutor&          _executor;
+	int                    _index;
+	std::vector<Runnable*> _tasks;
+	UInt32                 _mask;
+	volatile UInt32        _top;
+	volatile UInt32        _bottom;
+	int                    _capacity;
+	std::deque<Runnable*>  _submitted;
+	FastMutex              _submitMutex;
+	Thread                 _thread;
+};
+
+
+TaskExecutor::TaskExecutor(int workers, int queueCapacity, int stackSize):
+	_queueCapacity(1),
+	_stopped(false)
+{
+	while (_queueCapacity < queueCapacity) _queueCapacity *= 2;
+	init(workers, stackSize);
+}
+
+
+TaskExecutor::TaskExecutor(const std::string& name, int workers, int queueCapacity, int stackSize):
+	_name(name),
+	_queueCapacity(1),
+	_stopped(false)
+{
+	while (_queueCapacity < queueCapacity) _queueCapacity *= 2;
+	init(workers, stackSize);
+}
+
+
+TaskExecutor::~TaskExecutor()
+{
+	try
+	{
+		shutdown();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+	for (WorkerVec::iterator it = _workers.begin(); it != _workers.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+
+void TaskExecutor::init(int workers, int stackSize)
+{
+	poco_assert (workers >= 0 && _queueCapacity > 0);
+
+	if (workers == 0) workers = static_cast<int>(Environment::processorCount());
+	if (workers == 0) workers = 1;
+	for (int i = 0; i < workers; ++i)
+	{
+		std::ostringstream name;
+		name << _name << "[#" << i << "]";
+		_workers.push_back(new TaskExecutorWorker(*this, i, _queueCapacity, name.str(), stackSize));
+	}
+	for (WorkerVec::iterator it = _workers.begin(); it != _workers.end(); ++it)
+	{
+		(*it)->start();
+	}
+}
+
+
+void TaskExecutor::execute(Runnable& target)
+{
+	schedule(&target, -1);
+}
+
+
+bool TaskExecutor::tryExecute(Runnable& target)
+{
+	return schedule(&target, 0);
+}
+
+
+bool TaskExecutor::tryExecute(Runnable& target, long milliseconds)
+{
+	return schedule(&target, milliseconds);
+}
+
+
+void TaskExecutor::start(ActiveRunnableBase::Ptr pRunnable)
+{
+	pRunnable->duplicate(); // The runnable will release itself.
+	try
+	{
+		execute(*pRunnable);
+	}
+	catch (...)
+	{
+		pRunnable->release();
+		throw;
+	}
+}
+
+
+void TaskExecutor::joinAll()
+{
+	poco_assert (!isWorkerThread());
+
+	Mutex::ScopedLock lock(_mutex);
+	while (_pending.value() > 0)
+	{
+		_done.wait(_mutex);
+	}
+}
+
+
+void TaskExecutor::shutdown()
+{
+	{
+		Mutex::ScopedLock lock(_mutex);
+
+		if (_stopped) return;
+		_stopped = true;
+		_workAvailable.broadcast();
+	}
+	for (WorkerVec::iterator it = _workers.begin(); it != _workers.end(); ++it)
+	{
+		(*it)->join();
+	}
+}
+
+
+bool TaskExecutor::isWorkerThread() const
+{
+	return currentWorker() != 0;
+}
+
+
+TaskExecutorWorker* TaskExecutor::currentWorker() const
+{
+	for (WorkerVec::const_iterator it = _workers.begin(); it != _workers.end(); ++it)
+	{
+		if ((*it)->isCurrent()) return *it;
+	}
+	return 0;
+}
+
+
+bool TaskExecutor::schedule(Runnable* pTarget, long milliseconds)
+{
+	TaskExecutorWorker* pWorker = currentWorker();
+	if (pWorker)
+	{
+		++_pending;
+		++_queued;
+		if (pWorker->push(pTarget))
+		{
+			wakeUpWorkers();
+		}
+		else
+		{
+			--_queued;
+			pWorker->runTask(pTarget);
+		}
+		return true;
+	}
+
+	// the workers do not stop before all pending tasks are done
+	++_pending;
+	if (stopped())
+	{
+		taskDone();
+		throw IllegalStateException("TaskExecutor has been shut down", _name);
+	}
+	++_queued;
+	const int n = workers();
+	Timestamp start;
+	for (;;)
+	{
+		UInt32 first = static_cast<UInt32>(_nextWorker++);
+		for (int i = 0; i < n; ++i)
+		{
+			if (_workers[(first + i) % n]->submit(pTarget))
+			{
+				wakeUpWorkers();
+				return true;
+			}
+		}
+		if (milliseconds == 0) break;
+
+		Mutex::ScopedLock lock(_mutex);
+		++_blocked;
+		// a worker may have made room before it could
+		// see that we are waiting
+		bool submitted = false;
+		for (int i = 0; i < n && !submitted; ++i)
+		{
+			submitted = _workers[(first + i) % n]->submit(pTarget);
+		}
+		if (submitted)
+		{
+			--_blocked;
+			_workAvailable.signal();
+			return true;
+		}
+		bool timedOut = false;
+		if (milliseconds < 0)
+		{
+			_spaceAvailable.wait(_mutex);
+		}
+		else
+		{
+			long remaining = milliseconds - static_cast<long>(start.elapsed()/1000);
+			timedOut = remaining <= 0 || !_spaceAvailable.tryWait(_mutex, remaining);
+		}
+		--_blocked;
+		if (timedOut) break;
+	}
+	--_queued;
+	taskDone();
+	return false;
+}
+
+
+Runnable* TaskExecutor::findTask(TaskExecutorWorker* pWorker)
+{
+	Runnable* pTask = pWorker->pop();
+	bool submitted = false;
+	if (!pTask)
+	{
+		pTask = pWorker->takeSubmitted();
+		submitted = pTask != 0;
+	}
+	const int n = workers();
+	for (int i = 1; i < n && !pTask; ++i)
+	{
+		TaskExecutorWorker* pVictim = _workers[(pWorker->index() + i) % n];
+		pTask = pVictim->steal();
+		if (pTask)
+		{
+			++_steals;
+		}
+		else
+		{
+			pTask = pVictim->takeSubmitted();
+			submitted = pTask != 0;
+		}
+	}
+	if (pTask)
+	{
+		--_queued;
+		if (submitted && _blocked.value() > 0)
+		{
+			Mutex::ScopedLock lock(_mutex);
+			_spaceAvailable.broadcast();
+		}
+	}
+	return pTask;
+}
+
+
+void TaskExecutor::taskDone()
+{
+	if (--_pending == 0)
+	{
+		Mutex::ScopedLock lock(_mutex);
+		_done.broadcast();
+		if (_stopped) _workAvailable.broadcast();
+	}
+}
+
+
+void TaskExecutor::waitForTask()
+{
+	Mutex::ScopedLock lock(_mutex);
+	++_sleeping;
+	// the check must be done after announcing that we are
+	// sleeping, so that wakeUpWorkers() cannot miss us
+	if (_queued.value() <= 0 && !(_stopped && _pending.value() == 0))
+	{
+		_workAvailable.tryWait(_mutex, 1000);
+	}
+	--_sleeping;
+}
+
+
+void TaskExecutor::wakeUpWorkers()
+{
+	if (_sleeping.value() > 0)
+	{
+		Mutex::ScopedLock lock(_mutex);
+		_workAvailable.signal();
+	}
+}
+
+
+bool TaskExecutor::stopped() const
+{
+	Mutex::ScopedLock lock(_mutex);
+	return _stopped;
+}
+
+
+namespace
+{
+	static SingletonHolder<TaskExecutor> sh;
+}
+
+
+TaskExecutor& TaskExecutor::defaultExecutor()
+{
+	return *sh.get();
+}
+
+
+} // namespace Poco
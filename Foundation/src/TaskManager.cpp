@@ -17,6 +17,7 @@
 #include "Poco/TaskManager.h"
 #include "Poco/TaskNotification.h"
 #include "Poco/ThreadPool.h"
+#include "Poco/TaskExecutor.h"
 
 
 namespace Poco {
@@ -26,13 +27,22 @@ const int TaskManager::MIN_PROGRESS_NOTIFICATION_INTERVAL = 100000; // 100 milli
 
 
 TaskManager::TaskManager():
-	_threadPool(ThreadPool::defaultPool())
+	_pThreadPool(&ThreadPool::defaultPool()),
+	_pExecutor(0)
 {
 }
 
 
 TaskManager::TaskManager(ThreadPool& pool):
-	_threadPool(pool)
+	_pThreadPool(&pool),
+	_pExecutor(0)
+{
+}
+
+
+TaskManager::TaskManager(TaskExecutor& executor):
+	_pThreadPool(0),
+	_pExecutor(&executor)
 {
 }
 
@@ -45,21 +55,39 @@ TaskManager::~TaskManager()
 void TaskManager::start(Task* pTask)
 {
 	TaskPtr pAutoTask(pTask); // take ownership immediately
-	FastMutex::ScopedLock lock(_mutex);
+	{
+		FastMutex::ScopedLock lock(_mutex);
 
-	pAutoTask->setOwner(this);
-	pAutoTask->setState(Task::TASK_STARTING);
-	_taskList.push_back(pAutoTask);
+		pAutoTask->setOwner(this);
+		pAutoTask->setState(Task::TASK_STARTING);
+		_taskList.push_back(pAutoTask);
+		if (_pThreadPool)
+		{
+			try
+			{
+				_pThreadPool->start(*pAutoTask, pAutoTask->name());
+			}
+			catch (...)
+			{
+				// Make sure that we don't act like we own the task since
+				// we never started it.  If we leave the task on our task
+				// list, the size of the list is incorrect.
+				_taskList.pop_back();
+				throw;
+			}
+			return;
+		}
+	}
+	// The TaskExecutor may have to wait until there is room in its
+	// queues, so we must not hold the lock, which finishing tasks need.
 	try
 	{
-		_threadPool.start(*pAutoTask, pAutoTask->name());
+		_pExecutor->execute(*pAutoTask);
 	}
 	catch (...)
 	{
-		// Make sure that we don't act like we own the task since
-		// we never started it.  If we leave the task on our task
-		// list, the size of the list is incorrect.
-		_taskList.pop_back();
+		FastMutex::ScopedLock lock(_mutex);
+		_taskList.remove(pAutoTask);
 		throw;
 	}
 }
@@ -78,7 +106,10 @@ void TaskManager::cancelAll()
 
 void TaskManager::joinAll()
 {
-	_threadPool.joinAll();
+	if (_pThreadPool)
+		_pThreadPool->joinAll();
+	else
+		_pExecutor->joinAll();
 }
 
 
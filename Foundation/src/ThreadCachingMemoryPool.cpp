@@ -0,0 +1,597 @@
+//
+// ThreadCachingMemoryPool.cpp
+//
+// $Id: //poco/1.4/Foundation/src/ThreadCachingMemoryPool.cpp#1 $
+//
+// Library: Foundation
+// Package: Core
+// Module:  MemoryPool
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/ThreadCachingMemoryPool.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <algorithm>
+
+
+namespace Poco {
+
+
+//
+// ThreadCachingMemoryPool::Central
+//
+
+
+class ThreadCachingMemoryPool::Central: public RefCountedObject
+	/// The central free lists, shared by the pool and
+	/// the threads' caches.
+{
+public:
+	typedef std::vector<void*> BlockVec;
+
+	struct Counters
+		/// The usage counters of a thread's cache.
+	{
+		Counters();
+
+		UInt64 hits;
+		UInt64 misses;
+		UInt64 cachedBytes;
+	};
+
+	Central(std::size_t maxBlockSize, std::size_t maxBytes);
+	int classes() const;
+	std::size_t blockSize(int sizeClass) const;
+	std::size_t batchSize(int sizeClass) const;
+	std::size_t maxBytes() const;
+	void* getBlock(int sizeClass);
+	void releaseBlock(int sizeClass, void* ptr);
+	void fetch(int sizeClass, BlockVec& blocks);
+		/// Moves a batch of blocks to blocks.
+	void putBack(int sizeClass, BlockVec& blocks, std::size_t n);
+		/// Moves the last n blocks of blocks to the free list.
+	void* allocate(std::size_t size);
+	void deallocate(void* ptr, std::size_t size);
+	void attach(Cache* pCache);
+	void detach(Cache* pCache);
+	void publish(Counters& published, const Counters& counters);
+		/// Copies a cache's counters to published, which is
+		/// only accessed with the mutex locked.
+	Statistics statistics() const;
+
+protected:
+	~Central();
+
+private:
+	struct SizeClass
+	{
+		std::size_t blockSize;
+		std::size_t batchSize;
+		BlockVec    blocks;
+		UInt64      misses;
+		FastMutex   mutex;
+	};
+
+	enum
+	{
+		BATCH_BYTES   = 65536,
+		MAX_BATCH     = 32
+	};
+
+	typedef std::vector<SizeClass*> SizeClassVec;
+	typedef std::vector<Cache*> CacheVec;
+
+	SizeClassVec      _classes;
+	std::size_t       _maxBytes;
+	UInt64            _bytesAllocated;
+	UInt64            _hits;
+	UInt64            _misses;
+	CacheVec          _caches;
+	mutable FastMutex _mutex;
+};
+
+
+//
+// ThreadCachingMemoryPool::Cache
+//
+
+
+class ThreadCachingMemoryPool::Cache
+	/// The blocks cached by a thread.
+{
+public:
+	Cache();
+	~Cache();
+	const Central* central() const;
+	void attach(Central* pCentral);
+	void detach();
+	void* get(int sizeClass);
+	void release(int sizeClass, void* ptr);
+	void flush();
+	void publish();
+		/// Makes the cache's counters visible to Central::statistics().
+	const Central::Counters& published() const;
+		/// Returns the counters last published. Must only be
+		/// called with the Central's mutex locked.
+
+private:
+	Cache(const Cache&);
+	Cache& operator = (const Cache&);
+
+	enum
+	{
+		PUBLISH_INTERVAL = 256
+	};
+
+	typedef std::vector<Central::BlockVec> BlockVecVec;
+
+	AutoPtr<Central>  _pCentral;
+	BlockVecVec       _blocks;
+	Central::Counters _counters;  // only accessed by the owning thread
+	Central::Counters _published; // guarded by the Central's mutex
+	int               _unpublished;
+};
+
+
+ThreadCachingMemoryPool::Central::Counters::Counters():
+	hits(0),
+	misses(0),
+	cachedBytes(0)
+{
+}
+
+
+ThreadCachingMemoryPool::Central::Central(std::size_t maxBlockSize, std::size_t maxBytes):
+	_maxBytes(maxBytes),
+	_bytesAllocated(0),
+	_hits(0),
+	_misses(0)
+{
+	for (std::size_t size = MIN_BLOCK_SIZE; size <= maxBlockSize; size *= 2)
+	{
+		SizeClass* pClass = new SizeClass;
+		pClass->blockSize = size;
+		pClass->batchSize = std::max<std::size_t>(2, std::min<std::size_t>(MAX_BATCH, BATCH_BYTES/size));
+		pClass->misses    = 0;
+		_classes.push_back(pClass);
+	}
+}
+
+
+ThreadCachingMemoryPool::Central::~Central()
+{
+	for (SizeClassVec::iterator it = _classes.begin(); it != _classes.end(); ++it)
+	{
+		for (BlockVec::iterator itb = (*it)->blocks.begin(); itb != (*it)->blocks.end(); ++itb)
+		{
+			delete [] reinterpret_cast<char*>(*itb);
+		}
+		delete *it;
+	}
+}
+
+
+inline int ThreadCachingMemoryPool::Central::classes() const
+{
+	return static_cast<int>(_classes.size());
+}
+
+
+inline std::size_t ThreadCachingMemoryPool::Central::blockSize(int sizeClass) const
+{
+	return _classes[sizeClass]->blockSize;
+}
+
+
+inline std::size_t ThreadCachingMemoryPool::Central::batchSize(int sizeClass) const
+{
+	return _classes[sizeClass]->batchSize;
+}
+
+
+inline std::size_t ThreadCachingMemoryPool::Central::maxBytes() const
+{
+	return _maxBytes;
+}
+
+
+void* ThreadCachingMemoryPool::Central::getBlock(int sizeClass)
+{
+	SizeClass& sc = *_classes[sizeClass];
+	{
+		FastMutex::ScopedLock lock(sc.mutex);
+
+		++sc.misses;
+		if (!sc.blocks.empty())
+		{
+			void* ptr = sc.blocks.back();
+			sc.blocks.pop_back();
+			return ptr;
+		}
+	}
+	return allocate(sc.blockSize);
+}
+
+
+void ThreadCachingMemoryPool::Central::releaseBlock(int sizeClass, void* ptr)
+{
+	SizeClass& sc = *_classes[sizeClass];
+	FastMutex::ScopedLock lock(sc.mutex);
+
+	sc.blocks.push_back(ptr);
+}
+
+
+void ThreadCachingMemoryPool::Central::fetch(int sizeClass, BlockVec& blocks)
+{
+	SizeClass& sc = *_classes[sizeClass];
+	{
+		FastMutex::ScopedLock lock(sc.mutex);
+
+		std::size_t n = std::min(sc.batchSize, sc.blocks.size());
+		if (n > 0)
+		{
+			blocks.insert(blocks.end(), sc.blocks.end() - n, sc.blocks.end());
+			sc.blocks.resize(sc.blocks.size() - n);
+			return;
+		}
+	}
+	blocks.push_back(allocate(sc.blockSize));
+}
+
+
+void ThreadCachingMemoryPool::Central::putBack(int sizeClass, BlockVec& blocks, std::size_t n)
+{
+	SizeClass& sc = *_classes[sizeClass];
+	{
+		FastMutex::ScopedLock lock(sc.mutex);
+
+		sc.blocks.insert(sc.blocks.end(), blocks.end() - n, blocks.end());
+	}
+	blocks.resize(blocks.size() - n);
+}
+
+
+void* ThreadCachingMemoryPool::Central::allocate(std::size_t size)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (_maxBytes > 0 && _bytesAllocated + size > _maxBytes)
+		throw OutOfMemoryException("ThreadCachingMemoryPool exhausted");
+
+	void* ptr = new char[size];
+	_bytesAllocated += size;
+	return ptr;
+}
+
+
+void ThreadCachingMemoryPool::Central::deallocate(void* ptr, std::size_t size)
+{
+	delete [] reinterpret_cast<char*>(ptr);
+
+	FastMutex::ScopedLock lock(_mutex);
+	_bytesAllocated -= size;
+}
+
+
+void ThreadCachingMemoryPool::Central::attach(Cache* pCache)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	_caches.push_back(pCache);
+}
+
+
+void ThreadCachingMemoryPool::Central::detach(Cache* pCache)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	CacheVec::iterator it = std::find(_caches.begin(), _caches.end(), pCache);
+	if (it != _caches.end())
+	{
+		_hits   += pCache->published().hits;
+		_misses += pCache->published().misses;
+		_caches.erase(it);
+	}
+}
+
+
+void ThreadCachingMemoryPool::Central::publish(Counters& published, const Counters& counters)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	published = counters;
+}
+
+
+ThreadCachingMemoryPool::Statistics ThreadCachingMemoryPool::Central::statistics() const
+{
+	Statistics stats;
+	UInt64 cachedBytes = 0;
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	stats.hits           = _hits;
+	stats.misses         = _misses;
+	stats.bytesAllocated = _bytesAllocated;
+	for (CacheVec::const_iterator it = _caches.begin(); it != _caches.end(); ++it)
+	{
+		const Counters& counters = (*it)->published();
+		stats.hits   += counters.hits;
+		stats.misses += counters.misses;
+		cachedBytes  += counters.cachedBytes;
+	}
+	for (SizeClassVec::const_iterator it = _classes.begin(); it != _classes.end(); ++it)
+	{
+		FastMutex::ScopedLock classLock((*it)->mutex);
+
+		stats.misses += (*it)->misses;
+		cachedBytes  += (*it)->blocks.size()*(*it)->blockSize;
+	}
+	stats.bytesOutstanding = cachedBytes < stats.bytesAllocated ? stats.bytesAllocated - cachedBytes : 0;
+	return stats;
+}
+
+
+ThreadCachingMemoryPool::Cache::Cache():
+	_unpublished(PUBLISH_INTERVAL)
+{
+}
+
+
+ThreadCachingMemoryPool::Cache::~Cache()
+{
+	try
+	{
+		detach();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+inline const ThreadCachingMemoryPool::Central* ThreadCachingMemoryPool::Cache::central() const
+{
+	return _pCentral.get();
+}
+
+
+void ThreadCachingMemoryPool::Cache::attach(Central* pCentral)
+{
+	poco_assert (!_pCentral);
+
+	_blocks.resize(pCentral->classes());
+	for (int i = 0; i < pCentral->classes(); ++i)
+	{
+		// release() never has to grow the vectors
+		_blocks[i].reserve(2*pCentral->batchSize(i) + 1);
+	}
+	_pCentral = AutoPtr<Central>(pCentral, true);
+	_pCentral->attach(this);
+}
+
+
+void ThreadCachingMemoryPool::Cache::detach()
+{
+	if (_pCentral)
+	{
+		flush();
+		_pCentral->detach(this);
+		_pCentral = 0;
+		_blocks.clear();
+		_counters  = Central::Counters();
+		_published = Central::Counters();
+	}
+}
+
+
+inline void* ThreadCachingMemoryPool::Cache::get(int sizeClass)
+{
+	Central::BlockVec& blocks = _blocks[sizeClass];
+	std::size_t blockSize = _pCentral->blockSize(sizeClass);
+	if (blocks.empty())
+	{
+		std::size_t n = blocks.size();
+		_pCentral->fetch(sizeClass, blocks);
+		_counters.cachedBytes += (blocks.size() - n)*blockSize;
+		++_counters.misses;
+	}
+	else ++_counters.hits;
+	void* ptr = blocks.back();
+	blocks.pop_back();
+	_counters.cachedBytes -= blockSize;
+	if (--_unpublished == 0) publish();
+	return ptr;
+}
+
+
+inline void ThreadCachingMemoryPool::Cache::release(int sizeClass, void* ptr)
+{
+	Central::BlockVec& blocks = _blocks[sizeClass];
+	std::size_t blockSize = _pCentral->blockSize(sizeClass);
+	blocks.push_back(ptr);
+	_counters.cachedBytes += blockSize;
+	std::size_t batchSize = _pCentral->batchSize(sizeClass);
+	if (blocks.size() > 2*batchSize)
+	{
+		_pCentral->putBack(sizeClass, blocks, batchSize);
+		_counters.cachedBytes -= batchSize*blockSize;
+	}
+	if (--_unpublished == 0) publish();
+}
+
+
+void ThreadCachingMemoryPool::Cache::flush()
+{
+	for (std::size_t i = 0; i < _blocks.size(); ++i)
+	{
+		std::size_t n = _blocks[i].size();
+		if (n > 0)
+		{
+			_pCentral->putBack(static_cast<int>(i), _blocks[i], n);
+		}
+	}
+	_counters.cachedBytes = 0;
+	publish();
+}
+
+
+void ThreadCachingMemoryPool::Cache::publish()
+{
+	_pCentral->publish(_published, _counters);
+	_unpublished = PUBLISH_INTERVAL;
+}
+
+
+inline const ThreadCachingMemoryPool::Central::Counters& ThreadCachingMemoryPool::Cache::published() const
+{
+	return _published;
+}
+
+
+//
+// ThreadCachingMemoryPool
+//
+
+
+ThreadCachingMemoryPool::ThreadCachingMemoryPool(std::size_t maxBlockSize, std::size_t maxBytes):
+	_maxBlockSize(MIN_BLOCK_SIZE)
+{
+	while (_maxBlockSize < maxBlockSize) _maxBlockSize *= 2;
+	_pCentral = new Central(_maxBlockSize, maxBytes);
+}
+
+
+ThreadCachingMemoryPool::~ThreadCachingMemoryPool()
+{
+	try
+	{
+		Cache* pCache = cache();
+		if (pCache) pCache->detach();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void* ThreadCachingMemoryPool::get(std::size_t size)
+{
+	int sc = sizeClass(size);
+	if (sc < 0) return _pCentral->allocate(size);
+
+	Cache* pCache = cache();
+	if (pCache)
+		return pCache->get(sc);
+	else
+		return _pCentral->getBlock(sc);
+}
+
+
+void ThreadCachingMemoryPool::release(void* ptr, std::size_t size)
+{
+	int sc = sizeClass(size);
+	if (sc < 0)
+	{
+		_pCentral->deallocate(ptr, size);
+		return;
+	}
+
+	Cache* pCache = cache();
+	if (pCache)
+		pCache->release(sc, ptr);
+	else
+		_pCentral->releaseBlock(sc, ptr);
+}
+
+
+void ThreadCachingMemoryPool::flush()
+{
+	Cache* pCache = cache();
+	if (pCache) pCache->flush();
+}
+
+
+std::size_t ThreadCachingMemoryPool::blockSize(std::size_t size) const
+{
+	int sc = sizeClass(size);
+	return sc < 0 ? size : _pCentral->blockSize(sc);
+}
+
+
+std::size_t ThreadCachingMemoryPool::maxBytes() const
+{
+	return _pCentral->maxBytes();
+}
+
+
+ThreadCachingMemoryPool::Statistics ThreadCachingMemoryPool::statistics() const
+{
+	if (Thread::current())
+	{
+		// the calling thread's own counters are always up to date
+		Cache& cache = const_cast<ThreadLocal<Cache>&>(_caches).get();
+		if (cache.central() == _pCentral.get()) cache.publish();
+	}
+	return _pCentral->statistics();
+}
+
+
+namespace
+{
+	static SingletonHolder<ThreadCachingMemoryPool> sh;
+}
+
+
+ThreadCachingMemoryPool& ThreadCachingMemoryPool::defaultPool()
+{
+	return *sh.get();
+}
+
+
+ThreadCachingMemoryPool::Cache* ThreadCachingMemoryPool::cache()
+{
+	// The main thread's ThreadLocalStorage is shared by all
+	// threads not started by Poco::Thread.
+	if (!Thread::current()) return 0;
+
+	Cache& cache = _caches.get();
+	if (cache.central() != _pCentral.get())
+	{
+		// left behind by a pool that has been destroyed
+		cache.detach();
+		cache.attach(_pCentral);
+	}
+	return &cache;
+}
+
+
+int ThreadCachingMemoryPool::sizeClass(std::size_t size) const
+{
+	if (size > _maxBlockSize) return -1;
+
+	int sc = 0;
+	std::size_t blockSize = MIN_BLOCK_SIZE;
+	while (blockSize < size)
+	{
+		blockSize *= 2;
+		++sc;
+	}
+	return sc;
+}
+
+
+} // namespace Poco
@@ -0,0 +1,290 @@
+//
+// TimingWheel.cpp
+//
+// $Id: //poco/1.4/Foundation/src/TimingWheel.cpp#1 $
+//
+// Library: Foundation
+// Package: Threading
+// Module:  TimingWheel
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/TimingWheel.h"
+#include "Poco/Bugcheck.h"
+
+
+namespace Poco {
+
+
+//
+// TimingWheel::Entry
+//
+
+
+TimingWheel::Entry::Entry():
+	_pPrev(0),
+	_pNext(0),
+	_pWheel(0),
+	_slot(0),
+	_tick(0),
+	_expiration(0)
+{
+}
+
+
+TimingWheel::Entry::~Entry()
+{
+	if (_pWheel) _pWheel->cancel(*this);
+}
+
+
+//
+// TimingWheel
+//
+
+
+TimingWheel::TimingWheel(Clock::ClockDiff resolution):
+	_resolution(resolution),
+	_currentTick(0),
+	_size(0)
+{
+	poco_assert (resolution > 0);
+
+	for (int i = 0; i <= LEVELS; ++i) _levelSize[i] = 0;
+	for (int i = 0; i <= LEVELS*SLOTS; ++i) _slots[i] = 0;
+}
+
+
+TimingWheel::~TimingWheel()
+{
+	clear();
+}
+
+
+void TimingWheel::schedule(Entry& entry, const Clock& expiration)
+{
+	if (entry._pWheel) entry._pWheel->cancel(entry);
+	entry._expiration = expiration;
+	entry._tick       = toTick(expiration);
+	entry._pWheel     = this;
+	insert(entry);
+	++_size;
+}
+
+
+bool TimingWheel::cancel(Entry& entry)
+{
+	if (entry._pWheel != this) return false;
+	unlink(entry);
+	entry._pWheel = 0;
+	--_size;
+	return true;
+}
+
+
+std::size_t TimingWheel::advance(const Clock& now, EntryVec& expired)
+{
+	Clock::ClockDiff elapsed = now - _start;
+	if (elapsed < 0) return 0;
+	Int64 nowTick = elapsed/_resolution;
+
+	std::size_t n = expire(LEVELS*SLOTS, expired);
+	while (_currentTick <= nowTick)
+	{
+		// skip the ticks in which nothing happens
+		Int64 tick = _size > 0 ? nextTick() : nowTick + 1;
+		if (tick > nowTick)
+		{
+			_currentTick = nowTick + 1;
+			break;
+		}
+		_currentTick = tick;
+
+		int index = static_cast<int>(_currentTick & SLOT_MASK);
+		if (index == 0)
+		{
+			for (int level = 1; level < LEVELS; ++level)
+			{
+				cascade(level);
+				if (((_currentTick >> (level*SLOT_BITS)) & SLOT_MASK) != 0) break;
+			}
+		}
+		n += expire(index, expired);
+		++_currentTick;
+	}
+	return n;
+}
+
+
+bool TimingWheel::nextExpiration(Clock& clock) const
+{
+	if (_size == 0) return false;
+	clock = _start + nextTick()*_resolution;
+	return true;
+}
+
+
+void TimingWheel::clear()
+{
+	EntryVec cancelled;
+	clear(cancelled);
+}
+
+
+void TimingWheel::clear(EntryVec& cancelled)
+{
+	cancelled.reserve(cancelled.size() + _size);
+	for (int i = 0; i <= LEVELS*SLOTS; ++i)
+	{
+		Entry* pEntry = _slots[i];
+		while (pEntry)
+		{
+			Entry* pNext = pEntry->_pNext;
+			pEntry->_pPrev  = 0;
+			pEntry->_pNext  = 0;
+			pEntry->_pWheel = 0;
+			cancelled.push_back(pEntry);
+			pEntry = pNext;
+		}
+		_slots[i] = 0;
+	}
+	for (int i = 0; i <= LEVELS; ++i) _levelSize[i] = 0;
+	_size = 0;
+}
+
+
+void TimingWheel::insert(Entry& entry)
+{
+	Int64 tick  = entry._tick;
+	Int64 delta = tick - _currentTick;
+	int level = 0;
+	if (delta < 0)
+	{
+		// the tick has already been processed
+		entry._slot  = LEVELS*SLOTS;
+		entry._pPrev = 0;
+		entry._pNext = _slots[LEVELS*SLOTS];
+		if (entry._pNext) entry._pNext->_pPrev = &entry;
+		_slots[LEVELS*SLOTS] = &entry;
+		++_levelSize[LEVELS];
+		return;
+	}
+	else if (delta >= SLOTS)
+	{
+		const Int64 maxDelta = (Int64(1) << (LEVELS*SLOT_BITS)) - 1;
+		if (delta > maxDelta)
+		{
+			// will be redistributed when its slot comes round
+			delta = maxDelta;
+			tick  = _currentTick + maxDelta;
+		}
+		level = 1;
+		while (level < LEVELS - 1 && delta >= (Int64(1) << ((level + 1)*SLOT_BITS))) ++level;
+	}
+	int slot = level*SLOTS + static_cast<int>((tick >> (level*SLOT_BITS)) & SLOT_MASK);
+	entry._slot  = slot;
+	entry._pPrev = 0;
+	entry._pNext = _slots[slot];
+	if (entry._pNext) entry._pNext->_pPrev = &entry;
+	_slots[slot] = &entry;
+	++_levelSize[level];
+}
+
+
+void TimingWheel::unlink(Entry& entry)
+{
+	if (entry._pPrev)
+		entry._pPrev->_pNext = entry._pNext;
+	else
+		_slots[entry._slot] = entry._pNext;
+	if (entry._pNext) entry._pNext->_pPrev = entry._pPrev;
+	entry._pPrev = 0;
+	entry._pNext = 0;
+	--_levelSize[entry._slot/SLOTS];
+}
+
+
+std::size_t TimingWheel::expire(int slot, EntryVec& expired)
+{
+	std::size_t n = 0;
+	Entry* pEntry = _slots[slot];
+	while (pEntry)
+	{
+		Entry* pNext = pEntry->_pNext;
+		unlink(*pEntry);
+		pEntry->_pWheel = 0;
+		--_size;
+		expired.push_back(pEntry);
+		++n;
+		pEntry = pNext;
+	}
+	return n;
+}
+
+
+void TimingWheel::cascade(int level)
+{
+	int slot = level*SLOTS + static_cast<int>((_currentTick >> (level*SLOT_BITS)) & SLOT_MASK);
+	Entry* pEntry = _slots[slot];
+	_slots[slot] = 0;
+	while (pEntry)
+	{
+		Entry* pNext = pEntry->_pNext;
+		--_levelSize[level];
+		insert(*pEntry);
+		pEntry = pNext;
+	}
+}
+
+
+Int64 TimingWheel::nextTick() const
+{
+	if (_levelSize[LEVELS] > 0) return _currentTick - 1;
+
+	Int64 next = _currentTick + (Int64(1) << (LEVELS*SLOT_BITS));
+	if (_levelSize[0] > 0)
+	{
+		for (Int64 tick = _currentTick; tick < _currentTick + SLOTS; ++tick)
+		{
+			if (_slots[tick & SLOT_MASK])
+			{
+				next = tick;
+				break;
+			}
+		}
+	}
+	for (int level = 1; level < LEVELS; ++level)
+	{
+		if (_levelSize[level] == 0) continue;
+		int shift = level*SLOT_BITS;
+		Int64 base = _currentTick >> shift;
+		for (Int64 i = base; i <= base + SLOTS; ++i)
+		{
+			Int64 tick = i << shift;
+			if (tick < _currentTick) continue;
+			if (tick >= next) break;
+			if (_slots[level*SLOTS + static_cast<int>(i & SLOT_MASK)])
+			{
+				next = tick;
+				break;
+			}
+		}
+	}
+	return next;
+}
+
+
+Int64 TimingWheel::toTick(const Clock& clock) const
+{
+	Clock::ClockDiff diff = clock - _start;
+	if (diff <= 0) return 0;
+	return (diff + _resolution - 1)/_resolution;
+}
+
+
+} // namespace Poco
@@ -0,0 +1,187 @@
+//
+// ArenaTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/ArenaTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "ArenaTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Arena.h"
+#include <vector>
+#include <map>
+#include <string>
+#include <cstring>
+
+
+using Poco::Arena;
+using Poco::ArenaAllocator;
+
+
+ArenaTest::ArenaTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+ArenaTest::~ArenaTest()
+{
+}
+
+
+void ArenaTest::testAllocate()
+{
+	Arena arena(1024);
+	assert (arena.chunkSize() == 1024);
+	assert (arena.capacity() == 0);
+	assert (arena.chunkAllocations() == 0);
+
+	char* p1 = static_cast<char*>(arena.allocate(100, 1));
+	char* p2 = static_cast<char*>(arena.allocate(100, 1));
+	assert (p2 == p1 + 100);
+	assert (arena.bytesUsed() == 200);
+	assert (arena.allocations() == 2);
+	assert (arena.chunkAllocations() == 1);
+	assert (arena.capacity() == 1024);
+
+	std::memset(p1, 'a', 100);
+	std::memset(p2, 'b', 100);
+	assert (p1[99] == 'a');
+
+	for (int i = 0; i < 8; ++i)
+	{
+		arena.allocate(100, 1);
+	}
+	assert (arena.chunkAllocations() == 1);
+	arena.allocate(100, 1);
+	assert (arena.chunkAllocations() == 2);
+	assert (arena.capacity() == 2048);
+	assert (arena.allocations() == 11);
+}
+
+
+void ArenaTest::testAlignment()
+{
+	Arena arena;
+	arena.allocate(1, 1);
+	void* p = arena.allocate(8, 8);
+	assert ((reinterpret_cast<std::size_t>(p) & 7) == 0);
+	arena.allocate(3, 1);
+	p = arena.allocate(16);
+	assert ((reinterpret_cast<std::size_t>(p) & (Arena::DEFAULT_ALIGNMENT - 1)) == 0);
+	p = arena.allocate(10000, 64);
+	assert ((reinterpret_cast<std::size_t>(p) & 63) == 0);
+}
+
+
+void ArenaTest::testReset()
+{
+	Arena arena(1024);
+	for (int round = 0; round < 10; ++round)
+	{
+		for (int i = 0; i < 50; ++i)
+		{
+			std::memset(arena.allocate(100), 0, 100);
+		}
+		assert (arena.bytesUsed() >= 5000);
+		arena.reset();
+		assert (arena.bytesUsed() == 0);
+	}
+	// the chunks allocated in the first round are reused
+	assert (arena.chunkAllocations() <= 7);
+	assert (arena.capacity() == arena.chunkAllocations()*1024);
+}
+
+
+void ArenaTest::testLargeAllocation()
+{
+	Arena arena(1024);
+	arena.allocate(10);
+	void* p = arena.allocate(5000);
+	std::memset(p, 0, 5000);
+	assert (arena.chunkAllocations() == 2);
+	assert (arena.capacity() > 1024 + 5000);
+
+	// the current chunk is still used
+	char* p1 = static_cast<char*>(arena.allocate(10, 1));
+	char* p2 = static_cast<char*>(arena.allocate(10, 1));
+	assert (p2 == p1 + 10);
+	assert (arena.chunkAllocations() == 2);
+
+	arena.reset();
+	assert (arena.capacity() == 1024);
+}
+
+
+void ArenaTest::testClear()
+{
+	Arena arena(1024);
+	arena.allocate(1000);
+	arena.allocate(1000);
+	assert (arena.capacity() == 2048);
+	arena.clear();
+	assert (arena.capacity() == 0);
+	assert (arena.bytesUsed() == 0);
+	arena.allocate(10);
+	assert (arena.chunkAllocations() == 3);
+}
+
+
+void ArenaTest::testAllocator()
+{
+	typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+	typedef std::map<int, int, std::less<int>, ArenaAllocator<std::pair<const int, int> > > ArenaMap;
+
+	Arena arena;
+	{
+		ArenaAllocator<int> alloc(arena);
+		std::vector<int, ArenaAllocator<int> > vec(alloc);
+		for (int i = 0; i < 1000; ++i) vec.push_back(i);
+		for (int i = 0; i < 1000; ++i) assert (vec[i] == i);
+
+		ArenaAllocator<char> charAlloc(alloc);
+		ArenaString str(charAlloc);
+		str.append(1000, 'x');
+		str += "abc";
+		assert (str.size() == 1003);
+		assert (str.compare(1000, 3, "abc") == 0);
+
+		ArenaMap map(std::less<int>(), alloc);
+		for (int i = 0; i < 100; ++i) map[i] = 2*i;
+		assert (map.size() == 100);
+		assert (map[50] == 100);
+		assert (charAlloc == alloc);
+	}
+	assert (arena.allocations() > 100);
+	arena.reset();
+}
+
+
+void ArenaTest::setUp()
+{
+}
+
+
+void ArenaTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ArenaTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ArenaTest");
+
+	CppUnit_addTest(pSuite, ArenaTest, testAllocate);
+	CppUnit_addTest(pSuite, ArenaTest, testAlignment);
+	CppUnit_addTest(pSuite, ArenaTest, testReset);
+	CppUnit_addTest(pSuite, ArenaTest, testLargeAllocation);
+	CppUnit_addTest(pSuite, ArenaTest, testClear);
+	CppUnit_addTest(pSuite, ArenaTest, testAllocator);
+
+	return pSuite;
+}
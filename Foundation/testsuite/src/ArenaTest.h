@@ -0,0 +1,45 @@
+//
+// ArenaTest.h
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/ArenaTest.h#1 $
+//
+// Definition of the ArenaTest class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef ArenaTest_INCLUDED
+#define ArenaTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+
+
+class ArenaTest: public CppUnit::TestCase
+{
+public:
+	ArenaTest(const std::string& name);
+	~ArenaTest();
+
+	void testAllocate();
+	void testAlignment();
+	void testReset();
+	void testLargeAllocation();
+	void testClear();
+	void testAllocator();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // ArenaTest_INCLUDED
@@ -0,0 +1,318 @@
+//
+// AsyncFileChannelTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/AsyncFileChannelTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "AsyncFileChannelTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/AsyncFileChannel.h"
+#include "Poco/Message.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/File.h"
+#include "Poco/Path.h"
+#include "Poco/FileStream.h"
+#include "Poco/Timestamp.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/DirectoryIterator.h"
+#include "Poco/Exception.h"
+#include <vector>
+
+
+using Poco::AsyncFileChannel;
+using Poco::FileChannel;
+using Poco::Message;
+using Poco::AutoPtr;
+using Poco::File;
+using Poco::Path;
+using Poco::FileInputStream;
+using Poco::Timestamp;
+using Poco::DateTimeFormatter;
+using Poco::NumberFormatter;
+using Poco::DirectoryIterator;
+
+
+namespace
+{
+	std::vector<std::string> readLines(const std::string& path)
+	{
+		std::vector<std::string> lines;
+		FileInputStream istr(path);
+		std::string line;
+		while (std::getline(istr, line)) lines.push_back(line);
+		return lines;
+	}
+}
+
+
+AsyncFileChannelTest::AsyncFileChannelTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+AsyncFileChannelTest::~AsyncFileChannelTest()
+{
+}
+
+
+void AsyncFileChannelTest::testWrite()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(AsyncFileChannel::PROP_PATTERN, "%s|%p|%t");
+		pChannel->open();
+		for (int i = 0; i < 1000; ++i)
+		{
+			pChannel->log(Message("source", "entry " + NumberFormatter::format(i), Message::PRIO_WARNING));
+		}
+		pChannel->close();
+
+		std::vector<std::string> lines = readLines(name);
+		assert (lines.size() == 1000);
+		for (int i = 0; i < 1000; ++i)
+		{
+			assert (lines[i] == "source|Warning|entry " + NumberFormatter::format(i));
+		}
+		assert (pChannel->dropped() == 0);
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testTruncate()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(AsyncFileChannel::PROP_PATTERN, "%t");
+		std::string text(AsyncFileChannel::DEFAULT_MAX_TEXT_LENGTH + 100, 'x');
+		pChannel->log(Message("source", text, Message::PRIO_INFORMATION));
+		pChannel->close();
+
+		pChannel->setProperty(AsyncFileChannel::PROP_MAXTEXTLENGTH, "4096");
+		pChannel->log(Message("source", text, Message::PRIO_INFORMATION));
+		pChannel->close();
+
+		std::vector<std::string> lines = readLines(name);
+		assert (lines.size() == 2);
+		assert (lines[0] == std::string(AsyncFileChannel::DEFAULT_MAX_TEXT_LENGTH, 'x'));
+		assert (lines[1] == text);
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testParameters()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(AsyncFileChannel::PROP_PATTERN, "%s|%[user]|%t");
+		pChannel->setProperty(AsyncFileChannel::PROP_MAXTEXTLENGTH, "16");
+		std::string text(100, 'x');
+		for (int i = 0; i < 100; ++i)
+		{
+			Message msg("source", text, Message::PRIO_INFORMATION);
+			if (i % 2 == 0) msg["user"] = "user" + NumberFormatter::format(i);
+			pChannel->log(msg);
+		}
+		pChannel->close();
+
+		std::vector<std::string> lines = readLines(name);
+		assert (lines.size() == 100);
+		for (int i = 0; i < 100; ++i)
+		{
+			// messages with parameters are kept completely
+			if (i % 2 == 0)
+				assert (lines[i] == "source|user" + NumberFormatter::format(i) + "|" + text);
+			else
+				assert (lines[i] == "source||" + std::string(16, 'x'));
+		}
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testRotateBySize()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_ROTATION, "2 K");
+		pChannel->setProperty(AsyncFileChannel::PROP_BATCHSIZE, "512");
+		pChannel->setProperty(AsyncFileChannel::PROP_PATTERN, "%t");
+		pChannel->open();
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 200; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+		File f(name + ".0");
+		assert (f.exists());
+		f = name + ".1";
+		assert (f.exists());
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testDrop()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(AsyncFileChannel::PROP_CAPACITY, "4");
+		pChannel->setProperty(AsyncFileChannel::PROP_OVERFLOW, "drop");
+		pChannel->setProperty(AsyncFileChannel::PROP_PATTERN, "%t");
+		pChannel->open();
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 10000; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+
+		std::vector<std::string> lines = readLines(name);
+		assert (lines.size() + pChannel->dropped() == 10000);
+		assert (pChannel->getProperty(AsyncFileChannel::PROP_DROPPED) == NumberFormatter::format(pChannel->dropped()));
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testProperties()
+{
+	AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel;
+	assert (pChannel->getProperty(AsyncFileChannel::PROP_CAPACITY) == "1024");
+	assert (pChannel->getProperty(AsyncFileChannel::PROP_OVERFLOW) == "block");
+	assert (pChannel->getProperty(AsyncFileChannel::PROP_MAXTEXTLENGTH) == "1024");
+	pChannel->setProperty(AsyncFileChannel::PROP_MAXTEXTLENGTH, "200");
+	assert (pChannel->getProperty(AsyncFileChannel::PROP_MAXTEXTLENGTH) == "200");
+	pChannel->setProperty(AsyncFileChannel::PROP_CAPACITY, "100");
+	assert (pChannel->getProperty(AsyncFileChannel::PROP_CAPACITY) == "128");
+	pChannel->setProperty(AsyncFileChannel::PROP_OVERFLOW, "drop");
+	assert (pChannel->getOverflowPolicy() == AsyncFileChannel::OVERFLOW_DROP);
+	pChannel->setProperty(AsyncFileChannel::PROP_PATTERN, "%t");
+	assert (pChannel->getProperty(AsyncFileChannel::PROP_PATTERN) == "%t");
+	pChannel->setProperty(FileChannel::PROP_PATH, "test.log");
+	assert (pChannel->getProperty(FileChannel::PROP_PATH) == "test.log");
+
+	try
+	{
+		pChannel->setProperty(AsyncFileChannel::PROP_OVERFLOW, "wait");
+		fail("invalid overflow policy - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	try
+	{
+		pChannel->setProperty(AsyncFileChannel::PROP_MAXTEXTLENGTH, "0");
+		fail("invalid maximum text length - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void AsyncFileChannelTest::setUp()
+{
+}
+
+
+void AsyncFileChannelTest::tearDown()
+{
+}
+
+
+void AsyncFileChannelTest::remove(const std::string& baseName)
+{
+	DirectoryIterator it(Path::current());
+	DirectoryIterator end;
+	std::vector<std::string> files;
+	while (it != end)
+	{
+		if (it.name().find(baseName) == 0)
+		{
+			files.push_back(it.name());
+		}
+		++it;
+	}
+	for (std::vector<std::string>::iterator it = files.begin(); it != files.end(); ++it)
+	{
+		try
+		{
+			File f(*it);
+			f.remove();
+		}
+		catch (...)
+		{
+		}
+	}
+}
+
+
+std::string AsyncFileChannelTest::filename() const
+{
+	std::string name = "async_log_";
+	name.append(DateTimeFormatter::format(Timestamp(), "%Y%m%d%H%M%S"));
+	name.append(".log");
+	return name;
+}
+
+
+CppUnit::Test* AsyncFileChannelTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("AsyncFileChannelTest");
+
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testWrite);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testTruncate);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testParameters);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testRotateBySize);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testDrop);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testProperties);
+
+	return pSuite;
+}
@@ -0,0 +1,46 @@
+//
+// AsyncFileChannelTest.h
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/AsyncFileChannelTest.h#1 $
+//
+// Definition of the AsyncFileChannelTest class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef AsyncFileChannelTest_INCLUDED
+#define AsyncFileChannelTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+
+
+class AsyncFileChannelTest: public CppUnit::TestCase
+{
+public:
+	AsyncFileChannelTest(const std::string& name);
+	~AsyncFileChannelTest();
+
+	void testWrite();
+	void testTruncate();
+	void testParameters();
+	void testRotateBySize();
+	void testDrop();
+	void testProperties();
+
+	void setUp();
+	void tearDown();
+	static CppUnit::Test* suite();
+
+private:
+	void remove(const std::string& baseName);
+	std::string filename() const;
+};
+
+
+#endif // AsyncFileChannelTest_INCLUDED
@@ -317,6 +317,21 @@ void BasicEventTest::testAsyncNotify()
 	assert (_count == LARGEINC);
 }
 
+void BasicEventTest::testModifyDuringNotify()
+{
+	Simple += delegate(this, &BasicEventTest::onModify);
+	Simple += delegate(this, &BasicEventTest::onSimple);
+
+	int tmp = 0;
+	Simple.notify(this, tmp);
+	// onSimple has been removed before being invoked, onSimpleOther
+	// has been added and becomes active with the next notify
+	assert (_count == 1);
+
+	Simple.notify(this, tmp);
+	assert (_count == 102);
+}
+
 void BasicEventTest::onStaticVoid(const void* pSender)
 {
 	BasicEventTest* p = const_cast<BasicEventTest*>(reinterpret_cast<const BasicEventTest*>(pSender));
@@ -389,6 +404,15 @@ void BasicEventTest::onConst2Complex(const void* pSender, const Poco::EventArgs
 	_count++;
 }
 
+void BasicEventTest::onModify(const void* pSender, int& i)
+{
+	if (_count++ == 0)
+	{
+		Simple -= delegate(this, &BasicEventTest::onSimple);
+		Simple += delegate(this, &BasicEventTest::onSimpleOther);
+	}
+}
+
 void BasicEventTest::onAsync(const void* pSender, int& i)
 {
 	Poco::Thread::sleep(700);
@@ -435,6 +459,7 @@ CppUnit::Test* BasicEventTest::suite()
 	CppUnit_addTest(pSuite, BasicEventTest, testExpireReRegister);
 	CppUnit_addTest(pSuite, BasicEventTest, testOverwriteDelegate);
 	CppUnit_addTest(pSuite, BasicEventTest, testAsyncNotify);
+	CppUnit_addTest(pSuite, BasicEventTest, testModifyDuringNotify);
 	CppUnit_addTest(pSuite, BasicEventTest, testNullMutex);
 	return pSuite;
 }
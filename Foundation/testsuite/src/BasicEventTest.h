@@ -45,6 +45,7 @@ public:
 	void testReturnParams();
 	void testOverwriteDelegate();
 	void testAsyncNotify();
+	void testModifyDuringNotify();
 	void testNullMutex();
 	
 	void setUp();
@@ -70,6 +71,7 @@ protected:
 	void onConstComplex(const void* pSender, const Poco::EventArgs*& i);
 	void onConst2Complex(const void* pSender, const Poco::EventArgs * const & i);
 	void onAsync(const void* pSender, int& i);
+	void onModify(const void* pSender, int& i);
 
 	int getCount() const;
 private:
@@ -0,0 +1,467 @@
+//
+// BinaryLogChannelTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/BinaryLogChannelTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "BinaryLogChannelTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/BinaryLogChannel.h"
+#include "Poco/BinaryLogReader.h"
+#include "Poco/PatternFormatter.h"
+#include "Poco/Message.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/File.h"
+#include "Poco/Path.h"
+#include "Poco/Timestamp.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/DirectoryIterator.h"
+#include "Poco/FileStream.h"
+#include "Poco/Exception.h"
+#include <vector>
+
+
+using Poco::BinaryLogChannel;
+using Poco::BinaryLogReader;
+using Poco::PatternFormatter;
+using Poco::Message;
+using Poco::AutoPtr;
+using Poco::File;
+using Poco::Path;
+using Poco::Timestamp;
+using Poco::DateTimeFormatter;
+using Poco::NumberFormatter;
+using Poco::DirectoryIterator;
+
+
+BinaryLogChannelTest::BinaryLogChannelTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+BinaryLogChannelTest::~BinaryLogChannelTest()
+{
+}
+
+
+void BinaryLogChannelTest::testWriteRead()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(name);
+		Message msg("source", "", Message::PRIO_WARNING);
+		msg.setThread("worker");
+		msg.setTid(42);
+		for (int i = 0; i < 1000; ++i)
+		{
+			msg.setText("entry " + NumberFormatter::format(i));
+			msg["index"] = NumberFormatter::format(i);
+			pChannel->log(msg);
+		}
+		assert (pChannel->segmentPath() == name + ".0");
+		pChannel->close();
+		assert (pChannel->segmentPath().empty());
+
+		BinaryLogReader reader(name);
+		assert (reader.segments() == 1);
+		PatternFormatter fmt("%s|%p|%T|%I|%t|%K");
+		Message read;
+		std::string text;
+		int n = 0;
+		while (reader.read(read))
+		{
+			assert (read.getTime() == msg.getTime());
+			assert (read.getPid() == msg.getPid());
+			text.clear();
+			fmt.format(read, text);
+			assert (text == "source|Warning|worker|42|entry " + NumberFormatter::format(n) + "|index=" + NumberFormatter::format(n));
+			++n;
+		}
+		assert (n == 1000);
+		assert (!reader.read(read));
+
+		reader.rewind();
+		assert (reader.read(read));
+		assert (read.getText() == "entry 0");
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void BinaryLogChannelTest::testCorruptRecord()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(name);
+		Message msg("source", "text", Message::PRIO_INFORMATION);
+		msg["key"] = "value";
+		pChannel->log(msg);
+		pChannel->close();
+
+		Poco::UInt32 pos;
+		Poco::FileStream str(name + ".0");
+		str.seekg(8);
+		str.read(reinterpret_cast<char*>(&pos), sizeof(pos));
+		// the length of the source exceeds the record
+		Poco::UInt32 length = 0x10000;
+		str.seekp(pos + BinaryLogChannel::RECORD_HEADER_SIZE);
+		str.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		str.close();
+
+		BinaryLogReader reader(name);
+		Message read;
+		try
+		{
+			reader.read(read);
+			fail("corrupt record - must throw");
+		}
+		catch (Poco::DataFormatException&)
+		{
+		}
+
+		// a parameter count that does not match the record
+		str.open(name + ".0", std::ios::in | std::ios::out);
+		length = 6;
+		str.seekp(pos + BinaryLogChannel::RECORD_HEADER_SIZE);
+		str.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		Poco::UInt16 count = 1000;
+		str.seekp(pos + 6);
+		str.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		str.close();
+
+		reader.rewind();
+		try
+		{
+			reader.read(read);
+			fail("corrupt record - must throw");
+		}
+		catch (Poco::DataFormatException&)
+		{
+		}
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void BinaryLogChannelTest::testSegments()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(name);
+		pChannel->setProperty(BinaryLogChannel::PROP_SEGMENTSIZE, "8 K");
+		Message msg("source", "", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 1000; ++i)
+		{
+			msg.setText("This is log file entry " + NumberFormatter::format(i));
+			pChannel->log(msg);
+		}
+		// a message that does not fit into a segment of the default size
+		std::string large(10000, 'x');
+		msg.setText(large);
+		pChannel->log(msg);
+		pChannel->close();
+
+		BinaryLogReader reader(name);
+		assert (reader.segments() > 10);
+		Message read;
+		for (int i = 0; i < 1000; ++i)
+		{
+			assert (reader.read(read));
+			assert (read.getText() == "This is log file entry " + NumberFormatter::format(i));
+		}
+		assert (reader.read(read));
+		assert (read.getText() == large);
+		assert (!reader.read(read));
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void BinaryLogChannelTest::testReopen()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(name);
+		pChannel->log(Message("source", "first", Message::PRIO_INFORMATION));
+		pChannel->close();
+		pChannel->log(Message("source", "second", Message::PRIO_INFORMATION));
+		assert (pChannel->segmentPath() == name + ".1");
+
+		// the current segment can be read while it is being written
+		BinaryLogReader reader(name);
+		assert (reader.segments() == 2);
+		Message read;
+		assert (reader.read(read));
+		assert (read.getText() == "first");
+		assert (reader.read(read));
+		assert (read.getText() == "second");
+		assert (!reader.read(read));
+		pChannel->log(Message("source", "third", Message::PRIO_INFORMATION));
+		assert (reader.read(read));
+		assert (read.getText() == "third");
+		pChannel->close();
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void BinaryLogChannelTest::testSeek()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(name);
+		pChannel->setProperty(BinaryLogChannel::PROP_SEGMENTSIZE, "64 K");
+		Timestamp::TimeVal start = Timestamp().epochMicroseconds();
+		Message msg("source", "", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 10000; ++i)
+		{
+			msg.setTime(Timestamp(start + i*Timestamp::resolution()));
+			msg.setText(NumberFormatter::format(i));
+			pChannel->log(msg);
+		}
+		pChannel->close();
+
+		BinaryLogReader reader(name);
+		assert (reader.segments() > 1);
+		Message read;
+		int positions[] = {0, 1, 1234, 5000, 9998, 9999};
+		for (std::size_t i = 0; i < sizeof(positions)/sizeof(positions[0]); ++i)
+		{
+			reader.seek(Timestamp(start + positions[i]*Timestamp::resolution()));
+			assert (reader.read(read));
+			assert (read.getText() == NumberFormatter::format(positions[i]));
+		}
+		reader.seek(Timestamp(start + 1234*Timestamp::resolution() + 1));
+		assert (reader.read(read));
+		assert (read.getText() == "1235");
+
+		reader.seek(Timestamp(start - Timestamp::resolution()));
+		assert (reader.read(read));
+		assert (read.getText() == "0");
+
+		reader.seek(Timestamp(start + 10000*Timestamp::resolution()));
+		assert (!reader.read(read));
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void BinaryLogChannelTest::testRotateBySize()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(name);
+		pChannel->setProperty(BinaryLogChannel::PROP_ROTATION, "2 K");
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 200; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+		assert (File(name + ".0").exists());
+		assert (File(name + ".1").exists());
+
+		BinaryLogReader reader(name);
+		Message read;
+		int n = 0;
+		while (reader.read(read)) ++n;
+		assert (n == 200);
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void BinaryLogChannelTest::testPurgeCount()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(name);
+		pChannel->setProperty(BinaryLogChannel::PROP_ROTATION, "1 K");
+		pChannel->setProperty(BinaryLogChannel::PROP_PURGECOUNT, "2");
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 200; ++i)
+		{
+			pChannel->log(msg);
+		}
+		std::string current = pChannel->segmentPath();
+		pChannel->close();
+
+		std::vector<unsigned> numbers;
+		BinaryLogChannel::listSegments(name, numbers);
+		assert (numbers.size() == 2);
+		assert (BinaryLogChannel::segmentPath(name, numbers[1]) == current);
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void BinaryLogChannelTest::testProperties()
+{
+	AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel;
+	assert (pChannel->getProperty(BinaryLogChannel::PROP_TIMES) == "utc");
+	assert (pChannel->getProperty(BinaryLogChannel::PROP_SEGMENTSIZE) == NumberFormatter::format(BinaryLogChannel::DEFAULT_SEGMENT_SIZE));
+	pChannel->setProperty(BinaryLogChannel::PROP_SEGMENTSIZE, "2 M");
+	assert (pChannel->getProperty(BinaryLogChannel::PROP_SEGMENTSIZE) == "2097152");
+	pChannel->setProperty(BinaryLogChannel::PROP_PATH, "test.blog");
+	assert (pChannel->getProperty(BinaryLogChannel::PROP_PATH) == "test.blog");
+	pChannel->setProperty(BinaryLogChannel::PROP_ROTATION, "daily");
+	assert (pChannel->getProperty(BinaryLogChannel::PROP_ROTATION) == "daily");
+
+	try
+	{
+		pChannel->setProperty(BinaryLogChannel::PROP_SEGMENTSIZE, "1 K");
+		fail("segment smaller than header - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	try
+	{
+		pChannel->setProperty(BinaryLogChannel::PROP_ROTATION, "sometimes");
+		fail("invalid rotation - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void BinaryLogChannelTest::testRotationStrategies()
+{
+	static const char* rotations[] = {"never", "100 K", "1 M", "10 seconds", "5 minutes", "1 hours", "2 days", "1 weeks", "1 months", "daily", "weekly", "monthly", "12:00", "Mon,12:00"};
+
+	std::string name = filename();
+	try
+	{
+		for (std::size_t i = 0; i < sizeof(rotations)/sizeof(rotations[0]); ++i)
+		{
+			AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(name);
+			pChannel->setProperty(BinaryLogChannel::PROP_ROTATION, rotations[i]);
+			Message msg("source", "text", Message::PRIO_INFORMATION);
+			pChannel->log(msg);
+			pChannel->log(msg);
+			pChannel->close();
+		}
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void BinaryLogChannelTest::setUp()
+{
+}
+
+
+void BinaryLogChannelTest::tearDown()
+{
+}
+
+
+void BinaryLogChannelTest::remove(const std::string& baseName)
+{
+	DirectoryIterator it(Path::current());
+	DirectoryIterator end;
+	std::vector<std::string> files;
+	while (it != end)
+	{
+		if (it.name().find(baseName) == 0)
+		{
+			files.push_back(it.name());
+		}
+		++it;
+	}
+	for (std::vector<std::string>::iterator it = files.begin(); it != files.end(); ++it)
+	{
+		try
+		{
+			File f(*it);
+			f.remove();
+		}
+		catch (...)
+		{
+		}
+	}
+}
+
+
+std::string BinaryLogChannelTest::filename() const
+{
+	std::string name = "binary_log_";
+	name.append(DateTimeFormatter::format(Timestamp(), "%Y%m%d%H%M%S"));
+	name.append(".blog");
+	return name;
+}
+
+
+CppUnit::Test* BinaryLogChannelTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("BinaryLogChannelTest");
+
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testWriteRead);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testCorruptRecord);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testSegments);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testReopen);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testSeek);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testRotateBySize);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testPurgeCount);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testProperties);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testRotationStrategies);
+
+	return pSuite;
+}
@@ -0,0 +1,49 @@
+//
+// BinaryLogChannelTest.h
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/BinaryLogChannelTest.h#1 $
+//
+// Definition of the BinaryLogChannelTest class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef BinaryLogChannelTest_INCLUDED
+#define BinaryLogChannelTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+
+
+class BinaryLogChannelTest: public CppUnit::TestCase
+{
+public:
+	BinaryLogChannelTest(const std::string& name);
+	~BinaryLogChannelTest();
+
+	void testWriteRead();
+	void testCorruptRecord();
+	void testSegments();
+	void testReopen();
+	void testSeek();
+	void testRotateBySize();
+	void testPurgeCount();
+	void testProperties();
+	void testRotationStrategies();
+
+	void setUp();
+	void tearDown();
+	static CppUnit::Test* suite();
+
+private:
+	void remove(const std::string& baseName);
+	std::string filename() const;
+};
+
+
+#endif // BinaryLogChannelTest_INCLUDED
@@ -0,0 +1,286 @@
+//
+// BoundedNotificationQueueTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/BoundedNotificationQueueTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "BoundedNotificationQueueTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/BoundedNotificationQueue.h"
+#include "Poco/Notification.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/Stopwatch.h"
+
+
+using Poco::BoundedNotificationQueue;
+using Poco::Notification;
+using Poco::Thread;
+using Poco::RunnableAdapter;
+using Poco::Stopwatch;
+
+
+namespace
+{
+	class QTestNotification: public Notification
+	{
+	public:
+		QTestNotification(const std::string& data): _data(data)
+		{
+		}
+		~QTestNotification()
+		{
+		}
+		const std::string& data() const
+		{
+			return _data;
+		}
+
+	private:
+		std::string _data;
+	};
+
+	const int NOTIFICATION_COUNT = 5000;
+}
+
+
+BoundedNotificationQueueTest::BoundedNotificationQueueTest(const std::string& name):
+	CppUnit::TestCase(name),
+	_queue(16)
+{
+}
+
+
+BoundedNotificationQueueTest::~BoundedNotificationQueueTest()
+{
+}
+
+
+void BoundedNotificationQueueTest::testQueueDequeue()
+{
+	BoundedNotificationQueue queue;
+	assert (queue.empty());
+	assert (queue.size() == 0);
+	Notification* pNf = queue.dequeueNotification();
+	assertNullPtr(pNf);
+	queue.enqueueNotification(new Notification);
+	assert (!queue.empty());
+	assert (queue.size() == 1);
+	pNf = queue.dequeueNotification();
+	assertNotNullPtr(pNf);
+	assert (queue.empty());
+	assert (queue.size() == 0);
+	pNf->release();
+
+	queue.enqueueNotification(new QTestNotification("first"));
+	queue.enqueueNotification(new QTestNotification("second"));
+	assert (!queue.empty());
+	assert (queue.size() == 2);
+	QTestNotification* pTNf = dynamic_cast<QTestNotification*>(queue.dequeueNotification());
+	assertNotNullPtr(pTNf);
+	assert (pTNf->data() == "first");
+	pTNf->release();
+	assert (!queue.empty());
+	assert (queue.size() == 1);
+	pTNf = dynamic_cast<QTestNotification*>(queue.dequeueNotification());
+	assertNotNullPtr(pTNf);
+	assert (pTNf->data() == "second");
+	pTNf->release();
+	assert (queue.empty());
+	assert (queue.size() == 0);
+
+	pNf = queue.dequeueNotification();
+	assertNullPtr(pNf);
+}
+
+
+void BoundedNotificationQueueTest::testCapacity()
+{
+	BoundedNotificationQueue queue(3);
+	assert (queue.capacity() == 4);
+	for (int i = 0; i < 4; ++i)
+	{
+		assert (queue.tryEnqueueNotification(new Notification));
+	}
+	assert (queue.size() == 4);
+	Notification::Ptr pNf = new Notification;
+	assert (!queue.tryEnqueueNotification(pNf));
+	assert (pNf->referenceCount() == 1);
+
+	// the ring buffer wraps around
+	for (int i = 0; i < 100; ++i)
+	{
+		Notification::Ptr pDeq = queue.dequeueNotification();
+		assertNotNullPtr(pDeq.get());
+		assert (queue.tryEnqueueNotification(new QTestNotification("x")));
+		assert (queue.size() == 4);
+	}
+	queue.clear();
+	assert (queue.empty());
+	assert (queue.tryEnqueueNotification(pNf));
+	assert (pNf->referenceCount() == 2);
+	queue.clear();
+	assert (pNf->referenceCount() == 1);
+}
+
+
+void BoundedNotificationQueueTest::testWaitDequeue()
+{
+	BoundedNotificationQueue queue;
+	queue.enqueueNotification(new QTestNotification("third"));
+	queue.enqueueNotification(new QTestNotification("fourth"));
+	assert (!queue.empty());
+	assert (queue.size() == 2);
+	QTestNotification* pTNf = dynamic_cast<QTestNotification*>(queue.waitDequeueNotification(10));
+	assertNotNullPtr(pTNf);
+	assert (pTNf->data() == "third");
+	pTNf->release();
+	assert (!queue.empty());
+	assert (queue.size() == 1);
+	pTNf = dynamic_cast<QTestNotification*>(queue.waitDequeueNotification(10));
+	assertNotNullPtr(pTNf);
+	assert (pTNf->data() == "fourth");
+	pTNf->release();
+	assert (queue.empty());
+	assert (queue.size() == 0);
+
+	Stopwatch sw;
+	sw.start();
+	Notification* pNf = queue.waitDequeueNotification(100);
+	sw.stop();
+	assertNullPtr(pNf);
+	assert (sw.elapsed() >= 90000);
+}
+
+
+void BoundedNotificationQueueTest::testWakeUpAll()
+{
+	Thread t1("thread1");
+	Thread t2("thread2");
+
+	RunnableAdapter<BoundedNotificationQueueTest> ra(*this, &BoundedNotificationQueueTest::work);
+	t1.start(ra);
+	t2.start(ra);
+	while (!_queue.hasIdleThreads()) Thread::sleep(10);
+	_queue.enqueueNotification(new Notification);
+	while (!_queue.empty()) Thread::sleep(10);
+	Thread::sleep(20);
+	_queue.wakeUpAll();
+	t1.join();
+	t2.join();
+	assert (_handled.size() == 1);
+}
+
+
+void BoundedNotificationQueueTest::testThreads()
+{
+	Thread t1("thread1");
+	Thread t2("thread2");
+	Thread t3("thread3");
+
+	RunnableAdapter<BoundedNotificationQueueTest> ra(*this, &BoundedNotificationQueueTest::work);
+	t1.start(ra);
+	t2.start(ra);
+	t3.start(ra);
+	for (int i = 0; i < NOTIFICATION_COUNT; ++i)
+	{
+		_queue.enqueueNotification(new Notification);
+	}
+	while (!_queue.empty()) Thread::sleep(50);
+	Thread::sleep(20);
+	_queue.wakeUpAll();
+	t1.join();
+	t2.join();
+	t3.join();
+	assert (_handled.size() == NOTIFICATION_COUNT);
+	assert (_handled.count("thread1") > 0);
+	assert (_handled.count("thread2") > 0);
+	assert (_handled.count("thread3") > 0);
+}
+
+
+void BoundedNotificationQueueTest::testBlockingEnqueue()
+{
+	Thread p1;
+	Thread p2;
+	RunnableAdapter<BoundedNotificationQueueTest> producer(*this, &BoundedNotificationQueueTest::produce);
+	p1.start(producer);
+	p2.start(producer);
+
+	// the producers fill the queue and wait for room
+	while (_queue.size() < _queue.capacity()) Thread::sleep(10);
+	Thread::sleep(20);
+	assert (_queue.size() == _queue.capacity());
+
+	int received = 0;
+	while (received < 2*NOTIFICATION_COUNT)
+	{
+		Notification::Ptr pNf = _queue.waitDequeueNotification(5000);
+		assertNotNullPtr(pNf.get());
+		++received;
+	}
+	p1.join();
+	p2.join();
+	assert (_produced.value() == 2*NOTIFICATION_COUNT);
+	assert (_queue.empty());
+}
+
+
+void BoundedNotificationQueueTest::setUp()
+{
+	_handled.clear();
+	_produced = 0;
+}
+
+
+void BoundedNotificationQueueTest::tearDown()
+{
+	_queue.clear();
+}
+
+
+void BoundedNotificationQueueTest::work()
+{
+	Notification* pNf = _queue.waitDequeueNotification();
+	while (pNf)
+	{
+		pNf->release();
+		_mutex.lock();
+		_handled.insert(Thread::current()->name());
+		_mutex.unlock();
+		pNf = _queue.waitDequeueNotification();
+	}
+}
+
+
+void BoundedNotificationQueueTest::produce()
+{
+	for (int i = 0; i < NOTIFICATION_COUNT; ++i)
+	{
+		_queue.enqueueNotification(new Notification);
+		++_produced;
+	}
+}
+
+
+CppUnit::Test* BoundedNotificationQueueTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("BoundedNotificationQueueTest");
+
+	CppUnit_addTest(pSuite, BoundedNotificationQueueTest, testQueueDequeue);
+	CppUnit_addTest(pSuite, BoundedNotificationQueueTest, testCapacity);
+	CppUnit_addTest(pSuite, BoundedNotificationQueueTest, testWaitDequeue);
+	CppUnit_addTest(pSuite, BoundedNotificationQueueTest, testWakeUpAll);
+	CppUnit_addTest(pSuite, BoundedNotificationQueueTest, testThreads);
+	CppUnit_addTest(pSuite, BoundedNotificationQueueTest, testBlockingEnqueue);
+
+	return pSuite;
+}
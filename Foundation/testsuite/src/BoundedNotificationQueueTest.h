@@ -0,0 +1,57 @@
+//
+// BoundedNotificationQueueTest.h
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/BoundedNotificationQueueTest.h#1 $
+//
+// Definition of the BoundedNotificationQueueTest class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef BoundedNotificationQueueTest_INCLUDED
+#define BoundedNotificationQueueTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+#include "Poco/BoundedNotificationQueue.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
+#include <set>
+
+
+class BoundedNotificationQueueTest: public CppUnit::TestCase
+{
+public:
+	BoundedNotificationQueueTest(const std::string& name);
+	~BoundedNotificationQueueTest();
+
+	void testQueueDequeue();
+	void testCapacity();
+	void testWaitDequeue();
+	void testWakeUpAll();
+	void testThreads();
+	void testBlockingEnqueue();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+protected:
+	void work();
+	void produce();
+
+private:
+	Poco::BoundedNotificationQueue _queue;
+	std::multiset<std::string>     _handled;
+	Poco::FastMutex                _mutex;
+	Poco::AtomicCounter            _produced;
+};
+
+
+#endif // BoundedNotificationQueueTest_INCLUDED
@@ -16,6 +16,7 @@
 #include "ExpireLRUCacheTest.h"
 #include "UniqueExpireCacheTest.h"
 #include "UniqueExpireLRUCacheTest.h"
+#include "ShardedCacheTest.h"
 
 CppUnit::Test* CacheTestSuite::suite()
 {
@@ -26,6 +27,7 @@ CppUnit::Test* CacheTestSuite::suite()
 	pSuite->addTest(UniqueExpireCacheTest::suite());
 	pSuite->addTest(ExpireLRUCacheTest::suite());
 	pSuite->addTest(UniqueExpireLRUCacheTest::suite());
+	pSuite->addTest(ShardedCacheTest::suite());
 
 	return pSuite;
 }
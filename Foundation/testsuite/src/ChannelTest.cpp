@@ -21,6 +21,7 @@
 #include "Poco/FormattingChannel.h"
 #include "Poco/ConsoleChannel.h"
 #include "Poco/StreamChannel.h"
+#include "Poco/Exception.h"
 #include "TestChannel.h"
 #include <sstream>
 
@@ -82,6 +83,33 @@ void ChannelTest::testAsync()
 }
 
 
+void ChannelTest::testAsyncQueueSize()
+{
+	AutoPtr<TestChannel> pChannel = new TestChannel;
+	AutoPtr<AsyncChannel> pAsync = new AsyncChannel(pChannel.get());
+	assert (pAsync->getProperty("queueSize") == "none");
+	pAsync->setProperty("queueSize", "4");
+	assert (pAsync->getProperty("queueSize") == "4");
+	pAsync->open();
+	try
+	{
+		pAsync->setProperty("queueSize", "none");
+		fail("channel is open - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+	Message msg;
+	for (int i = 0; i < 100; ++i)
+		pAsync->log(msg);
+	pAsync->close();
+	assert (pChannel->list().size() == 100);
+
+	pAsync->setProperty("queueSize", "0");
+	assert (pAsync->getProperty("queueSize") == "none");
+}
+
+
 void ChannelTest::testFormatting()
 {
 	AutoPtr<TestChannel> pChannel = new TestChannel;
@@ -132,6 +160,7 @@ CppUnit::Test* ChannelTest::suite()
 
 	CppUnit_addTest(pSuite, ChannelTest, testSplitter);
 	CppUnit_addTest(pSuite, ChannelTest, testAsync);
+	CppUnit_addTest(pSuite, ChannelTest, testAsyncQueueSize);
 	CppUnit_addTest(pSuite, ChannelTest, testFormatting);
 	CppUnit_addTest(pSuite, ChannelTest, testConsole);
 	CppUnit_addTest(pSuite, ChannelTest, testStream);
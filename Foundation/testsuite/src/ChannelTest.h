@@ -28,6 +28,7 @@ public:
 
 	void testSplitter();
 	void testAsync();
+	void testAsyncQueueSize();
 	void testFormatting();
 	void testConsole();
 	void testStream();
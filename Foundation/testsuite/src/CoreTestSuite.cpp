@@ -28,6 +28,8 @@
 #include "NumberParserTest.h"
 #include "DynamicFactoryTest.h"
 #include "MemoryPoolTest.h"
+#include "ThreadCachingMemoryPoolTest.h"
+#include "ArenaTest.h"
 #include "AnyTest.h"
 #include "VarTest.h"
 #include "FormatTest.h"
@@ -61,6 +63,8 @@ CppUnit::Test* CoreTestSuite::suite()
 	pSuite->addTest(NumberParserTest::suite());
 	pSuite->addTest(DynamicFactoryTest::suite());
 	pSuite->addTest(MemoryPoolTest::suite());
+	pSuite->addTest(ThreadCachingMemoryPoolTest::suite());
+	pSuite->addTest(ArenaTest::suite());
 	pSuite->addTest(AnyTest::suite());
 	pSuite->addTest(VarTest::suite());
 	pSuite->addTest(FormatTest::suite());
@@ -16,6 +16,8 @@
 #include "PatternFormatterTest.h"
 #include "FileChannelTest.h"
 #include "SimpleFileChannelTest.h"
+#include "AsyncFileChannelTest.h"
+#include "BinaryLogChannelTest.h"
 #include "LoggingFactoryTest.h"
 #include "LoggingRegistryTest.h"
 #include "LogStreamTest.h"
@@ -30,6 +32,8 @@ CppUnit::Test* LoggingTestSuite::suite()
 	pSuite->addTest(PatternFormatterTest::suite());
 	pSuite->addTest(FileChannelTest::suite());
 	pSuite->addTest(SimpleFileChannelTest::suite());
+	pSuite->addTest(AsyncFileChannelTest::suite());
+	pSuite->addTest(BinaryLogChannelTest::suite());
 	pSuite->addTest(LoggingFactoryTest::suite());
 	pSuite->addTest(LoggingRegistryTest::suite());
 	pSuite->addTest(LogStreamTest::suite());
@@ -16,11 +16,17 @@
 #include "Poco/PatternFormatter.h"
 #include "Poco/Message.h"
 #include "Poco/DateTime.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timezone.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
 
 
 using Poco::PatternFormatter;
 using Poco::Message;
 using Poco::DateTime;
+using Poco::Timestamp;
 
 
 PatternFormatterTest::PatternFormatterTest(const std::string& name): CppUnit::TestCase(name)
@@ -96,6 +102,216 @@ void PatternFormatterTest::testPatternFormatter()
 }
 
 
+void PatternFormatterTest::testTimeCache()
+{
+	Message msg("TestSource", "Test message text", Message::PRIO_INFORMATION);
+	PatternFormatter fmt("%Y-%m-%d %H:%M:%S [%p] %t");
+	PatternFormatter fmtMillis("%H:%M:%S.%i|%F %E");
+
+	DateTime dt(2005, 1, 1, 14, 30, 15, 500, 250);
+	msg.setTime(dt.timestamp());
+	std::string result;
+	fmt.format(msg, result);
+	assert (result == "2005-01-01 14:30:15 [Information] Test message text");
+	result.clear();
+	fmtMillis.format(msg, result);
+	assert (result == "14:30:15.500|500250 1104589815");
+
+	// same second, different millisecond
+	msg.setTime(DateTime(2005, 1, 1, 14, 30, 15, 999).timestamp());
+	result.clear();
+	fmt.format(msg, result);
+	assert (result == "2005-01-01 14:30:15 [Information] Test message text");
+	result.clear();
+	fmtMillis.format(msg, result);
+	assert (result == "14:30:15.999|999000 1104589815");
+
+	// next second
+	msg.setTime(DateTime(2005, 1, 1, 14, 30, 16, 0).timestamp());
+	result.clear();
+	fmt.format(msg, result);
+	assert (result == "2005-01-01 14:30:16 [Information] Test message text");
+	result.clear();
+	fmtMillis.format(msg, result);
+	assert (result == "14:30:16.000|000000 1104589816");
+
+	// back in time
+	msg.setTime(DateTime(2004, 12, 31, 23, 59, 59, 0).timestamp());
+	result.clear();
+	fmt.format(msg, result);
+	assert (result == "2004-12-31 23:59:59 [Information] Test message text");
+
+	// time zone
+	fmt.setProperty("pattern", "%H:%M %z");
+	result.clear();
+	fmt.format(msg, result);
+	assert (result == "23:59 Z");
+	fmt.setProperty("times", "local");
+	result.clear();
+	fmt.format(msg, result);
+	DateTime local(msg.getTime() + Poco::Timezone::tzd()*Timestamp::resolution());
+	assert (result.find(Poco::DateTimeFormatter::format(local, "%H:%M ")) == 0);
+}
+
+
+void PatternFormatterTest::testParameters()
+{
+	Message msg("TestSource", "Test message text", Message::PRIO_INFORMATION);
+	PatternFormatter fmt("%t %K");
+	std::string result;
+	fmt.format(msg, result);
+	assert (result == "Test message text ");
+
+	msg["user"] = "guest";
+	msg["path"] = "/index.html";
+	msg["agent"] = "Some \"Browser\" 1.0";
+	msg["empty"] = "";
+	result.clear();
+	fmt.format(msg, result);
+	assert (result == "Test message text agent=\"Some \\\"Browser\\\" 1.0\" empty=\"\" path=/index.html user=guest");
+}
+
+
+void PatternFormatterTest::testCacheRollover()
+{
+	static const char* patterns[] =
+	{
+		"%Y-%m-%d %H:%M:%S.%i [%p] %t",
+		"%w, %e %b %y %H:%M:%S %Z|%E|%c",
+		"%A %h:%M|%s|%S.%F %z",
+		"%L%Y-%m-%d %H:%M:%S %z [%s] %t %H:%M"
+	};
+	static const DateTime times[] =
+	{
+		DateTime(2004, 12, 31, 23, 59, 58, 999, 999),
+		DateTime(2004, 12, 31, 23, 59, 59, 0, 0),
+		DateTime(2004, 12, 31, 23, 59, 59, 0, 1),
+		DateTime(2004, 12, 31, 23, 59, 59, 999, 0),
+		DateTime(2005, 1, 1, 0, 0, 0, 0, 0),        // next second, minute, hour, day and year
+		DateTime(2005, 1, 1, 0, 0, 0, 1, 0),
+		DateTime(2005, 1, 1, 11, 59, 59, 999, 0),
+		DateTime(2005, 1, 1, 12, 0, 0, 0, 0),       // am/pm
+		DateTime(2005, 1, 1, 12, 0, 59, 500, 0),
+		DateTime(2005, 1, 1, 12, 1, 0, 500, 0),     // next minute, same millisecond
+		DateTime(2005, 1, 1, 12, 0, 59, 500, 0),    // back in time
+		DateTime(2005, 1, 1, 12, 0, 59, 500, 0)
+	};
+	static const char* zones[] = { "UTC", "local", "local", "UTC" };
+
+	Message msg("TestSource", "Test message text", Message::PRIO_WARNING);
+	for (std::size_t p = 0; p < sizeof(patterns)/sizeof(patterns[0]); ++p)
+	{
+		PatternFormatter cached(patterns[p]);
+		for (std::size_t z = 0; z < sizeof(zones)/sizeof(zones[0]); ++z)
+		{
+			// time zone changes must not return text cached for a different time zone
+			cached.setProperty("times", zones[z]);
+			for (std::size_t t = 0; t < sizeof(times)/sizeof(times[0]); ++t)
+			{
+				msg.setTime(times[t].timestamp());
+				std::string result;
+				cached.format(msg, result);
+
+				PatternFormatter uncached(patterns[p]);
+				uncached.setProperty("times", zones[z]);
+				std::string expected;
+				uncached.format(msg, expected);
+				assert (result == expected);
+			}
+		}
+	}
+
+	// compare with DateTimeFormatter, which does not cache
+	PatternFormatter fmt("%Y-%m-%d %H:%M:%S.%i %z");
+	for (std::size_t t = 0; t < sizeof(times)/sizeof(times[0]); ++t)
+	{
+		msg.setTime(times[t].timestamp());
+		std::string result;
+		fmt.format(msg, result);
+		assert (result == Poco::DateTimeFormatter::format(times[t], "%Y-%m-%d %H:%M:%S.%i %z"));
+	}
+	fmt.setProperty("times", "local");
+	for (std::size_t t = 0; t < sizeof(times)/sizeof(times[0]); ++t)
+	{
+		msg.setTime(times[t].timestamp());
+		std::string result;
+		fmt.format(msg, result);
+		int tzd = Poco::Timezone::tzd();
+		DateTime local(times[t].timestamp() + tzd*Timestamp::resolution());
+		assert (result == Poco::DateTimeFormatter::format(local, "%Y-%m-%d %H:%M:%S.%i %z", tzd));
+	}
+}
+
+
+namespace
+{
+	class FormatRunnable: public Poco::Runnable
+	{
+	public:
+		FormatRunnable(PatternFormatter& fmt, Timestamp::TimeVal start, int step):
+			_fmt(fmt),
+			_start(start),
+			_step(step),
+			_errors(0)
+		{
+		}
+
+		void run()
+		{
+			Message msg("TestSource", "Test message text", Message::PRIO_INFORMATION);
+			std::string result;
+			for (int i = 0; i < 20000; ++i)
+			{
+				Timestamp time(_start + Timestamp::TimeVal(i/_step)*1000);
+				msg.setTime(time);
+				result.clear();
+				_fmt.format(msg, result);
+				if (result != Poco::DateTimeFormatter::format(time, "%Y-%m-%d %H:%M:%S.%i ") + msg.getText())
+					++_errors;
+			}
+		}
+
+		int errors() const
+		{
+			return _errors;
+		}
+
+	private:
+		PatternFormatter& _fmt;
+		Timestamp::TimeVal _start;
+		int _step;
+		int _errors;
+	};
+}
+
+
+void PatternFormatterTest::testConcurrentFormat()
+{
+	PatternFormatter fmt("%Y-%m-%d %H:%M:%S.%i %t");
+	Timestamp::TimeVal start = DateTime(2015, 1, 1).timestamp().epochMicroseconds();
+	FormatRunnable r1(fmt, start, 1);
+	FormatRunnable r2(fmt, start, 3);
+	FormatRunnable r3(fmt, start + 3600*Timestamp::resolution(), 7);
+	FormatRunnable r4(fmt, start + 7200*Timestamp::resolution(), 1000);
+	Poco::Thread t1;
+	Poco::Thread t2;
+	Poco::Thread t3;
+	Poco::Thread t4;
+	t1.start(r1);
+	t2.start(r2);
+	t3.start(r3);
+	t4.start(r4);
+	t1.join();
+	t2.join();
+	t3.join();
+	t4.join();
+	assert (r1.errors() == 0);
+	assert (r2.errors() == 0);
+	assert (r3.errors() == 0);
+	assert (r4.errors() == 0);
+}
+
+
 void PatternFormatterTest::setUp()
 {
 }
@@ -111,6 +327,10 @@ CppUnit::Test* PatternFormatterTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PatternFormatterTest");
 
 	CppUnit_addTest(pSuite, PatternFormatterTest, testPatternFormatter);
+	CppUnit_addTest(pSuite, PatternFormatterTest, testTimeCache);
+	CppUnit_addTest(pSuite, PatternFormatterTest, testParameters);
+	CppUnit_addTest(pSuite, PatternFormatterTest, testCacheRollover);
+	CppUnit_addTest(pSuite, PatternFormatterTest, testConcurrentFormat);
 
 	return pSuite;
 }
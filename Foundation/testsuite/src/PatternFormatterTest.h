@@ -27,6 +27,10 @@ public:
 	~PatternFormatterTest();
 
 	void testPatternFormatter();
+	void testTimeCache();
+	void testParameters();
+	void testCacheRollover();
+	void testConcurrentFormat();
 
 	void setUp();
 	void tearDown();
@@ -0,0 +1,329 @@
+//
+// ShardedCacheTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/ShardedCacheTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "ShardedCacheTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/ShardedCache.h"
+#include "Poco/Exception.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include <string>
+
+
+using Poco::ShardedCache;
+using Poco::SharedPtr;
+using Poco::Thread;
+
+
+namespace
+{
+	struct StringSize
+	{
+		std::size_t operator () (const int&, const std::string& value) const
+		{
+			return value.size();
+		}
+	};
+
+	typedef ShardedCache<int, int> IntCache;
+	typedef ShardedCache<int, std::string, StringSize> StringCache;
+
+	class CacheUser: public Poco::Runnable
+	{
+	public:
+		CacheUser(IntCache& cache, int offset):
+			_cache(cache),
+			_offset(offset),
+			_errors(0)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < 10000; ++i)
+			{
+				int key = _offset + i % 500;
+				SharedPtr<int> pValue = _cache.get(key);
+				if (pValue.isNull())
+					_cache.add(key, key*2);
+				else if (*pValue != key*2)
+					++_errors;
+			}
+		}
+
+		int errors() const
+		{
+			return _errors;
+		}
+
+	private:
+		IntCache& _cache;
+		int _offset;
+		int _errors;
+	};
+}
+
+
+ShardedCacheTest::ShardedCacheTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+ShardedCacheTest::~ShardedCacheTest()
+{
+}
+
+
+void ShardedCacheTest::testClear()
+{
+	IntCache aCache(100, 4);
+	assert (aCache.shards() == 4);
+	assert (aCache.size() == 0);
+	assert (aCache.getAllKeys().size() == 0);
+	aCache.add(1, 2);
+	aCache.add(3, 4);
+	aCache.add(5, 6);
+	assert (aCache.size() == 3);
+	assert (aCache.getAllKeys().size() == 3);
+	assert (aCache.has(1));
+	assert (aCache.has(3));
+	assert (aCache.has(5));
+	assert (*aCache.get(1) == 2);
+	assert (*aCache.get(3) == 4);
+	assert (*aCache.get(5) == 6);
+	aCache.remove(3);
+	assert (!aCache.has(3));
+	assert (aCache.get(3).isNull());
+	aCache.clear();
+	assert (aCache.size() == 0);
+	assert (!aCache.has(1));
+	assert (!aCache.has(5));
+}
+
+
+void ShardedCacheTest::testUpdate()
+{
+	IntCache aCache(3, 1);
+	aCache.add(1, 2);
+	SharedPtr<int> pOld = aCache.get(1);
+	aCache.update(1, 3);
+	assert (aCache.size() == 1);
+	assert (*aCache.get(1) == 3);
+	assert (*pOld == 2);
+}
+
+
+void ShardedCacheTest::testClockEviction()
+{
+	IntCache aCache(3, 1);
+	aCache.add(1, 10);
+	aCache.add(2, 20);
+	aCache.add(3, 30);
+	assert (aCache.get(1));
+
+	aCache.add(4, 40); // 1 is referenced, so 2 is evicted
+	assert (aCache.size() == 3);
+	assert (aCache.has(1));
+	assert (!aCache.has(2));
+	assert (aCache.has(3));
+	assert (aCache.has(4));
+
+	aCache.add(5, 50); // the hand has moved on to 3
+	assert (aCache.size() == 3);
+	assert (aCache.has(1));
+	assert (!aCache.has(3));
+	assert (aCache.has(4));
+	assert (aCache.has(5));
+
+	IntCache::Statistics stats = aCache.statistics();
+	assert (stats.evictions == 2);
+}
+
+
+void ShardedCacheTest::testSizeOf()
+{
+	StringCache aCache(10, 1);
+	aCache.add(1, "abcd");
+	aCache.add(2, "efgh");
+	assert (aCache.statistics().size == 8);
+	aCache.add(3, "ijkl"); // evicts 1
+	assert (aCache.statistics().size == 8);
+	assert (!aCache.has(1));
+	assert (aCache.has(2));
+	assert (aCache.has(3));
+
+	aCache.update(2, "ef"); // shrinks
+	assert (aCache.statistics().size == 6);
+	aCache.update(2, "efghijkl"); // grows, evicts 3
+	assert (aCache.statistics().size == 8);
+	assert (aCache.has(2));
+	assert (!aCache.has(3));
+}
+
+
+void ShardedCacheTest::testTooLarge()
+{
+	StringCache aCache(10, 1);
+	aCache.add(1, "abcd");
+	aCache.add(2, "abcdefghijk");
+	assert (!aCache.has(2));
+	assert (aCache.has(1));
+
+	aCache.update(1, "abcdefghijk");
+	assert (!aCache.has(1));
+	assert (aCache.size() == 0);
+	assert (aCache.statistics().size == 0);
+}
+
+
+void ShardedCacheTest::testExpireAfterAdd()
+{
+	IntCache aCache(100, IntCache::EXPIRE_AFTER_ADD, 200, 4);
+	aCache.add(1, 2);
+	aCache.add(3, 4);
+	Thread::sleep(100);
+	assert (aCache.has(1));
+	assert (*aCache.get(1) == 2);
+	Thread::sleep(150);
+	assert (!aCache.has(1));
+	assert (aCache.get(1).isNull());
+	assert (aCache.size() == 1);
+	aCache.forceReplace();
+	assert (aCache.size() == 0);
+	assert (aCache.statistics().expirations == 2);
+}
+
+
+void ShardedCacheTest::testExpireAfterAccess()
+{
+	IntCache aCache(100, IntCache::EXPIRE_AFTER_ACCESS, 200, 4);
+	aCache.add(1, 2);
+	aCache.add(3, 4);
+	Thread::sleep(100);
+	assert (aCache.get(1));
+	Thread::sleep(150);
+	assert (aCache.has(1));
+	assert (!aCache.has(3));
+	Thread::sleep(100);
+	assert (!aCache.has(1));
+}
+
+
+void ShardedCacheTest::testExpireTooShort()
+{
+	try
+	{
+		IntCache aCache(100, IntCache::EXPIRE_AFTER_ADD, 10);
+		failmsg ("expire time of 10 ms is illegal, test should fail");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void ShardedCacheTest::testSmallCapacity()
+{
+	IntCache aCache(3);
+	assert (aCache.shards() == 2);
+	for (int i = 0; i < 3; ++i)
+	{
+		aCache.add(i, i);
+		assert (aCache.has(i));
+	}
+
+	IntCache oneCache(1);
+	assert (oneCache.shards() == 1);
+	oneCache.add(1, 2);
+	assert (oneCache.has(1));
+
+	try
+	{
+		IntCache zeroCache(0);
+		failmsg ("capacity of 0 is illegal, test should fail");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void ShardedCacheTest::testStatistics()
+{
+	IntCache aCache(100);
+	aCache.add(1, 2);
+	aCache.get(1);
+	aCache.get(1);
+	aCache.get(2);
+	IntCache::Statistics stats = aCache.statistics();
+	assert (stats.hits == 2);
+	assert (stats.misses == 1);
+	assert (stats.evictions == 0);
+	assert (stats.expirations == 0);
+	assert (stats.entries == 1);
+	assert (stats.size == 1);
+}
+
+
+void ShardedCacheTest::testConcurrent()
+{
+	IntCache aCache(1000, 8);
+	CacheUser user1(aCache, 0);
+	CacheUser user2(aCache, 250);
+	CacheUser user3(aCache, 500);
+	Thread t1;
+	Thread t2;
+	Thread t3;
+	t1.start(user1);
+	t2.start(user2);
+	t3.start(user3);
+	t1.join();
+	t2.join();
+	t3.join();
+	assert (user1.errors() == 0);
+	assert (user2.errors() == 0);
+	assert (user3.errors() == 0);
+	assert (aCache.size() <= 1000);
+	IntCache::Statistics stats = aCache.statistics();
+	assert (stats.hits + stats.misses == 30000);
+}
+
+
+void ShardedCacheTest::setUp()
+{
+}
+
+
+void ShardedCacheTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ShardedCacheTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ShardedCacheTest");
+
+	CppUnit_addTest(pSuite, ShardedCacheTest, testClear);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testUpdate);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testClockEviction);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testSizeOf);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testTooLarge);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testSmallCapacity);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testExpireAfterAdd);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testExpireAfterAccess);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testExpireTooShort);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testStatistics);
+	CppUnit_addTest(pSuite, ShardedCacheTest, testConcurrent);
+
+	return pSuite;
+}
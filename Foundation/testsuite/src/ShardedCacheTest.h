@@ -0,0 +1,46 @@
+//
+// ShardedCacheTest.h
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/ShardedCacheTest.h#1 $
+//
+// Tests for ShardedCache
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+#ifndef ShardedCacheTest_INCLUDED
+#define ShardedCacheTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+
+
+class ShardedCacheTest: public CppUnit::TestCase
+{
+public:
+	ShardedCacheTest(const std::string& name);
+	~ShardedCacheTest();
+
+	void testClear();
+	void testUpdate();
+	void testClockEviction();
+	void testSizeOf();
+	void testTooLarge();
+	void testSmallCapacity();
+	void testExpireAfterAdd();
+	void testExpireAfterAccess();
+	void testExpireTooShort();
+	void testStatistics();
+	void testConcurrent();
+
+	void setUp();
+	void tearDown();
+	static CppUnit::Test* suite();
+};
+
+
+#endif // ShardedCacheTest_INCLUDED
@@ -0,0 +1,303 @@
+//
+// TaskExecutorTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/TaskExecutorTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "TaskExecutorTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/TaskExecutor.h"
+#include "Poco/TaskManager.h"
+#include "Poco/Task.h"
+#include "Poco/ActiveMethod.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/Exception.h"
+#include <vector>
+
+
+using Poco::TaskExecutor;
+using Poco::TaskExecutorStarter;
+using Poco::TaskManager;
+using Poco::Task;
+using Poco::ActiveMethod;
+using Poco::ActiveResult;
+using Poco::RunnableAdapter;
+using Poco::Runnable;
+using Poco::AtomicCounter;
+
+
+namespace
+{
+	class FanOutTask: public Runnable
+		/// Splits a range into two halves, which are
+		/// scheduled as new tasks, until the range is
+		/// small enough.
+	{
+	public:
+		FanOutTask(TaskExecutor& executor, AtomicCounter& sum, int begin, int end):
+			_executor(executor),
+			_sum(sum),
+			_begin(begin),
+			_end(end)
+		{
+		}
+
+		void run()
+		{
+			if (_end - _begin <= 16)
+			{
+				for (int i = _begin; i < _end; ++i) ++_sum;
+			}
+			else
+			{
+				int mid = _begin + (_end - _begin)/2;
+				_children.push_back(new FanOutTask(_executor, _sum, _begin, mid));
+				_children.push_back(new FanOutTask(_executor, _sum, mid, _end));
+				_executor.execute(*_children[0]);
+				_executor.execute(*_children[1]);
+			}
+		}
+
+		~FanOutTask()
+		{
+			for (std::vector<FanOutTask*>::iterator it = _children.begin(); it != _children.end(); ++it)
+				delete *it;
+		}
+
+	private:
+		TaskExecutor& _executor;
+		AtomicCounter& _sum;
+		int _begin;
+		int _end;
+		std::vector<FanOutTask*> _children;
+	};
+
+	class CountingTask: public Task
+	{
+	public:
+		CountingTask(AtomicCounter& counter):
+			Task("CountingTask"),
+			_counter(counter)
+		{
+		}
+
+		void runTask()
+		{
+			++_counter;
+		}
+
+	private:
+		AtomicCounter& _counter;
+	};
+
+	class ActiveObject
+	{
+	public:
+		ActiveObject():
+			square(this, &ActiveObject::squareImpl)
+		{
+		}
+
+		ActiveMethod<int, int, ActiveObject, TaskExecutorStarter<ActiveObject> > square;
+
+	protected:
+		int squareImpl(const int& n)
+		{
+			return n*n;
+		}
+	};
+}
+
+
+TaskExecutorTest::TaskExecutorTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+TaskExecutorTest::~TaskExecutorTest()
+{
+}
+
+
+void TaskExecutorTest::testExecute()
+{
+	TaskExecutor executor("TaskExecutorTest", 4);
+	assert (executor.workers() == 4);
+	assert (executor.queueCapacity() == TaskExecutor::DEFAULT_QUEUE_CAPACITY);
+
+	RunnableAdapter<TaskExecutorTest> ra(*this, &TaskExecutorTest::count);
+	for (int i = 0; i < 10000; ++i)
+	{
+		executor.execute(ra);
+	}
+	executor.joinAll();
+	assert (_count.value() == 10000);
+	assert (executor.pending() == 0);
+	assert (!executor.isWorkerThread());
+}
+
+
+void TaskExecutorTest::testFanOut()
+{
+	TaskExecutor executor(4, 64);
+	AtomicCounter sum;
+	FanOutTask root(executor, sum, 0, 100000);
+	executor.execute(root);
+	executor.joinAll();
+	assert (sum.value() == 100000);
+	assert (executor.pending() == 0);
+}
+
+
+void TaskExecutorTest::testBackPressure()
+{
+	TaskExecutor executor(1, 2);
+	assert (executor.queueCapacity() == 2);
+
+	RunnableAdapter<TaskExecutorTest> blocker(*this, &TaskExecutorTest::block);
+	RunnableAdapter<TaskExecutorTest> ra(*this, &TaskExecutorTest::count);
+	executor.execute(blocker);
+	_started.wait();
+
+	assert (executor.tryExecute(ra));
+	assert (executor.tryExecute(ra));
+	assert (!executor.tryExecute(ra));
+	assert (!executor.tryExecute(ra, 100));
+	assert (executor.pending() == 3);
+
+	_release.set();
+	assert (executor.tryExecute(ra, 10000));
+	executor.joinAll();
+	assert (_count.value() == 3);
+}
+
+
+void TaskExecutorTest::testSubmit()
+{
+	TaskExecutor executor(2);
+	ActiveResult<int> result = executor.submit(this, &TaskExecutorTest::square, 12);
+	result.wait();
+	assert (!result.failed());
+	assert (result.data() == 144);
+
+	ActiveResult<void> voidResult = executor.submit(this, &TaskExecutorTest::count);
+	voidResult.wait();
+	assert (!voidResult.failed());
+	assert (_count.value() == 1);
+
+	ActiveResult<int> failed = executor.submit(this, &TaskExecutorTest::throwException);
+	failed.wait();
+	assert (failed.failed());
+	assert (failed.error() == "failed");
+}
+
+
+void TaskExecutorTest::testActiveMethod()
+{
+	ActiveObject obj;
+	std::vector<ActiveResult<int> > results;
+	for (int i = 0; i < 100; ++i)
+	{
+		results.push_back(obj.square(i));
+	}
+	for (int i = 0; i < 100; ++i)
+	{
+		results[i].wait();
+		assert (results[i].data() == i*i);
+	}
+}
+
+
+void TaskExecutorTest::testTaskManager()
+{
+	TaskExecutor executor(2, 4);
+	TaskManager tm(executor);
+	AtomicCounter counter;
+	for (int i = 0; i < 20; ++i)
+	{
+		tm.start(new CountingTask(counter));
+	}
+	tm.joinAll();
+	assert (counter.value() == 20);
+	assert (tm.count() == 0);
+}
+
+
+void TaskExecutorTest::testShutdown()
+{
+	TaskExecutor executor(2);
+	RunnableAdapter<TaskExecutorTest> ra(*this, &TaskExecutorTest::count);
+	for (int i = 0; i < 100; ++i)
+	{
+		executor.execute(ra);
+	}
+	executor.shutdown();
+	assert (_count.value() == 100);
+	try
+	{
+		executor.execute(ra);
+		failmsg("executor has been shut down - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+}
+
+
+void TaskExecutorTest::count()
+{
+	++_count;
+}
+
+
+void TaskExecutorTest::block()
+{
+	_started.set();
+	_release.wait();
+}
+
+
+int TaskExecutorTest::square(const int& n)
+{
+	return n*n;
+}
+
+
+int TaskExecutorTest::throwException()
+{
+	throw Poco::InvalidArgumentException("failed");
+}
+
+
+void TaskExecutorTest::setUp()
+{
+	_count = 0;
+}
+
+
+void TaskExecutorTest::tearDown()
+{
+}
+
+
+CppUnit::Test* TaskExecutorTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TaskExecutorTest");
+
+	CppUnit_addTest(pSuite, TaskExecutorTest, testExecute);
+	CppUnit_addTest(pSuite, TaskExecutorTest, testFanOut);
+	CppUnit_addTest(pSuite, TaskExecutorTest, testBackPressure);
+	CppUnit_addTest(pSuite, TaskExecutorTest, testSubmit);
+	CppUnit_addTest(pSuite, TaskExecutorTest, testActiveMethod);
+	CppUnit_addTest(pSuite, TaskExecutorTest, testTaskManager);
+	CppUnit_addTest(pSuite, TaskExecutorTest, testShutdown);
+
+	return pSuite;
+}
@@ -0,0 +1,57 @@
+//
+// TaskExecutorTest.h
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/TaskExecutorTest.h#1 $
+//
+// Definition of the TaskExecutorTest class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef TaskExecutorTest_INCLUDED
+#define TaskExecutorTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Event.h"
+
+
+class TaskExecutorTest: public CppUnit::TestCase
+{
+public:
+	TaskExecutorTest(const std::string& name);
+	~TaskExecutorTest();
+
+	void testExecute();
+	void testFanOut();
+	void testBackPressure();
+	void testSubmit();
+	void testActiveMethod();
+	void testTaskManager();
+	void testShutdown();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+protected:
+	void count();
+	void block();
+	int square(const int& n);
+	int throwException();
+
+private:
+	Poco::AtomicCounter _count;
+	Poco::Event _started;
+	Poco::Event _release;
+};
+
+
+#endif // TaskExecutorTest_INCLUDED
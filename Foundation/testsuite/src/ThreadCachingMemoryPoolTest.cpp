@@ -0,0 +1,297 @@
+//
+// ThreadCachingMemoryPoolTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/ThreadCachingMemoryPoolTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "ThreadCachingMemoryPoolTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/ThreadCachingMemoryPool.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <cstring>
+
+
+using Poco::ThreadCachingMemoryPool;
+using Poco::PooledBufferAllocator;
+using Poco::Thread;
+
+
+namespace
+{
+	class PoolUser: public Poco::Runnable
+	{
+	public:
+		PoolUser(ThreadCachingMemoryPool& pool, int rounds):
+			_pool(pool),
+			_rounds(rounds),
+			_ok(true)
+		{
+		}
+
+		void run()
+		{
+			std::vector<char*> blocks;
+			for (int r = 0; r < _rounds; ++r)
+			{
+				for (std::size_t size = 1; size <= 8192; size *= 2)
+				{
+					char* ptr = static_cast<char*>(_pool.get(size));
+					std::memset(ptr, static_cast<int>(size & 0xFF), size);
+					blocks.push_back(ptr);
+				}
+				std::size_t size = 1;
+				for (std::vector<char*>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+				{
+					if ((*it)[size - 1] != static_cast<char>(size & 0xFF)) _ok = false;
+					_pool.release(*it, size);
+					size *= 2;
+				}
+				blocks.clear();
+			}
+		}
+
+		bool ok() const
+		{
+			return _ok;
+		}
+
+	private:
+		ThreadCachingMemoryPool& _pool;
+		int  _rounds;
+		bool _ok;
+	};
+
+
+	class CacheUser: public Poco::Runnable
+	{
+	public:
+		CacheUser(ThreadCachingMemoryPool& pool):
+			_pool(pool)
+		{
+		}
+
+		void run()
+		{
+			void* ptr = _pool.get(100);
+			_pool.release(ptr, 100);
+			for (int i = 0; i < 10; ++i)
+			{
+				ptr = _pool.get(100);
+				_pool.release(ptr, 100);
+			}
+			_stats = _pool.statistics();
+			_pool.flush();
+			_flushedStats = _pool.statistics();
+		}
+
+		ThreadCachingMemoryPool::Statistics _stats;
+		ThreadCachingMemoryPool::Statistics _flushedStats;
+
+	private:
+		ThreadCachingMemoryPool& _pool;
+	};
+}
+
+
+ThreadCachingMemoryPoolTest::ThreadCachingMemoryPoolTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+ThreadCachingMemoryPoolTest::~ThreadCachingMemoryPoolTest()
+{
+}
+
+
+void ThreadCachingMemoryPoolTest::testBlockSize()
+{
+	ThreadCachingMemoryPool pool(3000);
+	assert (pool.maxBlockSize() == 4096);
+	assert (pool.maxBytes() == 0);
+	assert (pool.blockSize(0) == 16);
+	assert (pool.blockSize(1) == 16);
+	assert (pool.blockSize(16) == 16);
+	assert (pool.blockSize(17) == 32);
+	assert (pool.blockSize(1000) == 1024);
+	assert (pool.blockSize(4096) == 4096);
+	assert (pool.blockSize(4097) == 4097);
+}
+
+
+void ThreadCachingMemoryPoolTest::testGetRelease()
+{
+	ThreadCachingMemoryPool pool;
+
+	ThreadCachingMemoryPool::Statistics stats = pool.statistics();
+	assert (stats.hits == 0);
+	assert (stats.misses == 0);
+	assert (stats.bytesAllocated == 0);
+	assert (stats.bytesOutstanding == 0);
+
+	void* p1 = pool.get(100);
+	void* p2 = pool.get(1000);
+	stats = pool.statistics();
+	assert (stats.misses == 2);
+	assert (stats.bytesAllocated == 128 + 1024);
+	assert (stats.bytesOutstanding == 128 + 1024);
+
+	pool.release(p1, 100);
+	stats = pool.statistics();
+	assert (stats.bytesAllocated == 128 + 1024);
+	assert (stats.bytesOutstanding == 1024);
+
+	void* p3 = pool.get(120);
+	assert (p3 == p1);
+	stats = pool.statistics();
+	assert (stats.bytesAllocated == 128 + 1024);
+
+	pool.release(p2, 1000);
+	pool.release(p3, 120);
+	stats = pool.statistics();
+	assert (stats.misses == 3);
+	assert (stats.bytesOutstanding == 0);
+}
+
+
+void ThreadCachingMemoryPoolTest::testMaxBytes()
+{
+	ThreadCachingMemoryPool pool(1024, 4096);
+	assert (pool.maxBytes() == 4096);
+
+	std::vector<void*> ptrs;
+	for (int i = 0; i < 4; ++i)
+	{
+		ptrs.push_back(pool.get(1024));
+	}
+	try
+	{
+		pool.get(1024);
+		fail("pool exhausted - must throw exception");
+	}
+	catch (Poco::OutOfMemoryException&)
+	{
+	}
+	try
+	{
+		pool.get(16);
+		fail("pool exhausted - must throw exception");
+	}
+	catch (Poco::OutOfMemoryException&)
+	{
+	}
+
+	pool.release(ptrs.back(), 1024);
+	ptrs.back() = pool.get(1024);
+	for (std::vector<void*>::iterator it = ptrs.begin(); it != ptrs.end(); ++it)
+	{
+		pool.release(*it, 1024);
+	}
+	assert (pool.statistics().bytesAllocated == 4096);
+}
+
+
+void ThreadCachingMemoryPoolTest::testLargeBlocks()
+{
+	ThreadCachingMemoryPool pool(1024);
+
+	void* ptr = pool.get(100000);
+	std::memset(ptr, 0, 100000);
+	assert (pool.statistics().bytesAllocated == 100000);
+	assert (pool.statistics().bytesOutstanding == 100000);
+	pool.release(ptr, 100000);
+	assert (pool.statistics().bytesAllocated == 0);
+	assert (pool.statistics().bytesOutstanding == 0);
+}
+
+
+void ThreadCachingMemoryPoolTest::testThreadCache()
+{
+	ThreadCachingMemoryPool pool;
+	CacheUser user(pool);
+	Thread thread;
+	thread.start(user);
+	thread.join();
+
+	assert (user._stats.misses == 1);
+	assert (user._stats.hits == 10);
+	assert (user._stats.bytesAllocated == 128);
+	assert (user._stats.bytesOutstanding == 0);
+	assert (user._flushedStats.bytesOutstanding == 0);
+
+	// the block is now in the central free list
+	void* ptr = pool.get(100);
+	pool.release(ptr, 100);
+	assert (pool.statistics().bytesAllocated == 128);
+}
+
+
+void ThreadCachingMemoryPoolTest::testThreads()
+{
+	ThreadCachingMemoryPool pool(8192);
+
+	const int THREAD_COUNT = 8;
+	std::vector<PoolUser*> users;
+	std::vector<Thread*> threads;
+	for (int i = 0; i < THREAD_COUNT; ++i)
+	{
+		users.push_back(new PoolUser(pool, 1000));
+		threads.push_back(new Thread);
+		threads.back()->start(*users.back());
+	}
+	for (int i = 0; i < THREAD_COUNT; ++i)
+	{
+		threads[i]->join();
+		assert (users[i]->ok());
+		delete threads[i];
+		delete users[i];
+	}
+
+	ThreadCachingMemoryPool::Statistics stats = pool.statistics();
+	assert (stats.hits + stats.misses == THREAD_COUNT*1000*14);
+	assert (stats.hits > stats.misses);
+	assert (stats.bytesOutstanding == 0);
+}
+
+
+void ThreadCachingMemoryPoolTest::testBufferAllocator()
+{
+	char* ptr = PooledBufferAllocator<char>::allocate(4096);
+	std::memset(ptr, 0, 4096);
+	PooledBufferAllocator<char>::deallocate(ptr, 4096);
+}
+
+
+void ThreadCachingMemoryPoolTest::setUp()
+{
+}
+
+
+void ThreadCachingMemoryPoolTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ThreadCachingMemoryPoolTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ThreadCachingMemoryPoolTest");
+
+	CppUnit_addTest(pSuite, ThreadCachingMemoryPoolTest, testBlockSize);
+	CppUnit_addTest(pSuite, ThreadCachingMemoryPoolTest, testGetRelease);
+	CppUnit_addTest(pSuite, ThreadCachingMemoryPoolTest, testMaxBytes);
+	CppUnit_addTest(pSuite, ThreadCachingMemoryPoolTest, testLargeBlocks);
+	CppUnit_addTest(pSuite, ThreadCachingMemoryPoolTest, testThreadCache);
+	CppUnit_addTest(pSuite, ThreadCachingMemoryPoolTest, testThreads);
+	CppUnit_addTest(pSuite, ThreadCachingMemoryPoolTest, testBufferAllocator);
+
+	return pSuite;
+}
@@ -0,0 +1,46 @@
+//
+// ThreadCachingMemoryPoolTest.h
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/ThreadCachingMemoryPoolTest.h#1 $
+//
+// Definition of the ThreadCachingMemoryPoolTest class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef ThreadCachingMemoryPoolTest_INCLUDED
+#define ThreadCachingMemoryPoolTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+
+
+class ThreadCachingMemoryPoolTest: public CppUnit::TestCase
+{
+public:
+	ThreadCachingMemoryPoolTest(const std::string& name);
+	~ThreadCachingMemoryPoolTest();
+
+	void testBlockSize();
+	void testGetRelease();
+	void testMaxBytes();
+	void testLargeBlocks();
+	void testThreadCache();
+	void testThreads();
+	void testBufferAllocator();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // ThreadCachingMemoryPoolTest_INCLUDED
@@ -15,7 +15,9 @@
 #include "SemaphoreTest.h"
 #include "RWLockTest.h"
 #include "ThreadPoolTest.h"
+#include "TaskExecutorTest.h"
 #include "TimerTest.h"
+#include "TimingWheelTest.h"
 #include "ThreadLocalTest.h"
 #include "ActivityTest.h"
 #include "ActiveMethodTest.h"
@@ -31,7 +33,9 @@ CppUnit::Test* ThreadingTestSuite::suite()
 	pSuite->addTest(SemaphoreTest::suite());
 	pSuite->addTest(RWLockTest::suite());
 	pSuite->addTest(ThreadPoolTest::suite());
+	pSuite->addTest(TaskExecutorTest::suite());
 	pSuite->addTest(TimerTest::suite());
+	pSuite->addTest(TimingWheelTest::suite());
 	pSuite->addTest(ThreadLocalTest::suite());
 	pSuite->addTest(ActivityTest::suite());
 	pSuite->addTest(ActiveMethodTest::suite());
@@ -0,0 +1,335 @@
+//
+// TimingWheelTest.cpp
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/TimingWheelTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "TimingWheelTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/TimingWheel.h"
+#include "Poco/Clock.h"
+#include <vector>
+
+
+using Poco::TimingWheel;
+using Poco::Clock;
+
+
+namespace
+{
+	class TestEntry: public TimingWheel::Entry
+	{
+	public:
+		TestEntry(int id = 0): _id(id)
+		{
+		}
+
+		int id() const
+		{
+			return _id;
+		}
+
+	private:
+		int _id;
+	};
+
+	const Clock::ClockDiff RESOLUTION = 1000;
+
+	Clock at(const Clock& base, Clock::ClockDiff ticks)
+	{
+		return base + ticks*RESOLUTION;
+	}
+}
+
+
+TimingWheelTest::TimingWheelTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+TimingWheelTest::~TimingWheelTest()
+{
+}
+
+
+void TimingWheelTest::testSchedule()
+{
+	TimingWheel wheel(RESOLUTION);
+	Clock base;
+	assert (wheel.empty());
+	assert (wheel.resolution() == RESOLUTION);
+
+	TestEntry entry;
+	assert (!entry.isScheduled());
+	wheel.schedule(entry, at(base, 10));
+	assert (entry.isScheduled());
+	assert (entry.expiration() == at(base, 10));
+	assert (wheel.size() == 1);
+
+	TimingWheel::EntryVec expired;
+	assert (wheel.advance(at(base, 9), expired) == 0);
+	assert (expired.empty());
+	assert (wheel.advance(at(base, 11), expired) == 1);
+	assert (expired.size() == 1);
+	assert (expired[0] == &entry);
+	assert (!entry.isScheduled());
+	assert (wheel.empty());
+
+	// an entry scheduled in the past expires immediately
+	expired.clear();
+	wheel.schedule(entry, at(base, 5));
+	assert (wheel.advance(at(base, 11), expired) == 1);
+	assert (expired[0] == &entry);
+}
+
+
+void TimingWheelTest::testOrder()
+{
+	TimingWheel wheel(RESOLUTION);
+	Clock base;
+
+	std::vector<TestEntry*> entries;
+	for (int i = 0; i < 10; ++i)
+	{
+		entries.push_back(new TestEntry(i));
+	}
+	for (int i = 9; i >= 0; --i)
+	{
+		wheel.schedule(*entries[i], at(base, 100 + 50*i));
+	}
+	TimingWheel::EntryVec expired;
+	assert (wheel.advance(at(base, 1000), expired) == 10);
+	for (int i = 0; i < 10; ++i)
+	{
+		assert (static_cast<TestEntry*>(expired[i])->id() == i);
+		delete entries[i];
+	}
+}
+
+
+void TimingWheelTest::testCancel()
+{
+	TimingWheel wheel(RESOLUTION);
+	Clock base;
+
+	TestEntry entry1(1);
+	TestEntry entry2(2);
+	TestEntry entry3(3);
+	wheel.schedule(entry1, at(base, 10));
+	wheel.schedule(entry2, at(base, 10));
+	wheel.schedule(entry3, at(base, 10));
+	assert (wheel.size() == 3);
+
+	assert (wheel.cancel(entry2));
+	assert (!entry2.isScheduled());
+	assert (!wheel.cancel(entry2));
+	assert (wheel.size() == 2);
+
+	{
+		TestEntry entry4(4);
+		wheel.schedule(entry4, at(base, 10));
+		assert (wheel.size() == 3);
+	}
+	assert (wheel.size() == 2);
+
+	TimingWheel::EntryVec expired;
+	assert (wheel.advance(at(base, 20), expired) == 2);
+	assert (expired[0] == &entry1 || expired[1] == &entry1);
+	assert (expired[0] == &entry3 || expired[1] == &entry3);
+
+	TimingWheel otherWheel(RESOLUTION);
+	wheel.schedule(entry1, at(base, 30));
+	assert (!otherWheel.cancel(entry1));
+	assert (entry1.isScheduled());
+}
+
+
+void TimingWheelTest::testReschedule()
+{
+	TimingWheel wheel(RESOLUTION);
+	Clock base;
+
+	TestEntry entry;
+	wheel.schedule(entry, at(base, 10));
+	wheel.schedule(entry, at(base, 1000));
+	assert (wheel.size() == 1);
+
+	TimingWheel::EntryVec expired;
+	assert (wheel.advance(at(base, 500), expired) == 0);
+	assert (wheel.advance(at(base, 1001), expired) == 1);
+
+	TimingWheel otherWheel(RESOLUTION);
+	wheel.schedule(entry, at(base, 2000));
+	otherWheel.schedule(entry, at(base, 2000));
+	assert (wheel.empty());
+	assert (otherWheel.size() == 1);
+}
+
+
+void TimingWheelTest::testCascade()
+{
+	TimingWheel wheel(RESOLUTION);
+	Clock base;
+
+	// one entry on each level of the wheel
+	TestEntry entry1(1);
+	TestEntry entry2(2);
+	TestEntry entry3(3);
+	TestEntry entry4(4);
+	wheel.schedule(entry1, at(base, 100));
+	wheel.schedule(entry2, at(base, 1000));
+	wheel.schedule(entry3, at(base, 100000));
+	wheel.schedule(entry4, at(base, 20000000));
+
+	TimingWheel::EntryVec expired;
+	assert (wheel.advance(at(base, 99), expired) == 0);
+	assert (wheel.advance(at(base, 101), expired) == 1);
+	assert (expired.back() == &entry1);
+	assert (wheel.advance(at(base, 999), expired) == 0);
+	assert (wheel.advance(at(base, 1001), expired) == 1);
+	assert (expired.back() == &entry2);
+	assert (wheel.advance(at(base, 99999), expired) == 0);
+	assert (wheel.advance(at(base, 100001), expired) == 1);
+	assert (expired.back() == &entry3);
+	assert (wheel.advance(at(base, 19999999), expired) == 0);
+	assert (wheel.advance(at(base, 20000001), expired) == 1);
+	assert (expired.back() == &entry4);
+	assert (wheel.empty());
+
+	// advancing in small steps must give the same result
+	expired.clear();
+	Clock now = at(base, 20000001);
+	wheel.schedule(entry1, at(now, 300));
+	wheel.schedule(entry2, at(now, 70000));
+	for (int i = 0; i <= 70001; ++i)
+	{
+		wheel.advance(at(now, i), expired);
+		if (i < 300) assert (expired.empty());
+		else if (i > 300 && i < 70000) assert (expired.size() == 1);
+	}
+	assert (expired.size() == 2);
+	assert (expired[0] == &entry1);
+	assert (expired[1] == &entry2);
+}
+
+
+void TimingWheelTest::testNextExpiration()
+{
+	TimingWheel wheel(RESOLUTION);
+	Clock base;
+	Clock next;
+	assert (!wheel.nextExpiration(next));
+
+	TestEntry entry1;
+	TestEntry entry2;
+	wheel.schedule(entry1, at(base, 100));
+	wheel.schedule(entry2, at(base, 50));
+	assert (wheel.nextExpiration(next));
+	assert (next >= at(base, 50) && next < at(base, 51));
+
+	// not exact, but never later than the expiration time
+	wheel.cancel(entry1);
+	wheel.cancel(entry2);
+	wheel.schedule(entry1, at(base, 100000));
+	assert (wheel.nextExpiration(next));
+	assert (next <= at(base, 100001));
+
+	TimingWheel::EntryVec expired;
+	while (expired.empty())
+	{
+		assert (wheel.nextExpiration(next));
+		wheel.advance(next, expired);
+	}
+	assert (next >= at(base, 100000) && next < at(base, 100001));
+}
+
+
+void TimingWheelTest::testClear()
+{
+	TimingWheel wheel(RESOLUTION);
+	Clock base;
+
+	TestEntry entry1;
+	TestEntry entry2;
+	wheel.schedule(entry1, at(base, 100));
+	wheel.schedule(entry2, at(base, 100000));
+
+	TimingWheel::EntryVec cancelled;
+	wheel.clear(cancelled);
+	assert (cancelled.size() == 2);
+	assert (wheel.empty());
+	assert (!entry1.isScheduled());
+	assert (!entry2.isScheduled());
+
+	TimingWheel::EntryVec expired;
+	assert (wheel.advance(at(base, 200000), expired) == 0);
+}
+
+
+void TimingWheelTest::testMany()
+{
+	TimingWheel wheel(RESOLUTION);
+	Clock base;
+
+	const int ENTRY_COUNT = 100000;
+	TestEntry* entries = new TestEntry[ENTRY_COUNT];
+	for (int i = 0; i < ENTRY_COUNT; ++i)
+	{
+		wheel.schedule(entries[i], at(base, (i*7919) % 300000));
+	}
+	for (int i = 0; i < ENTRY_COUNT; i += 3)
+	{
+		wheel.cancel(entries[i]);
+	}
+	TimingWheel::EntryVec expired;
+	Clock now = base;
+	Clock lastExpiration = base;
+	while (!wheel.empty())
+	{
+		std::size_t first = expired.size();
+		now += 997*RESOLUTION;
+		wheel.advance(now, expired);
+		for (std::size_t i = first; i < expired.size(); ++i)
+		{
+			assert (expired[i]->expiration() <= now);
+			assert (expired[i]->expiration() + RESOLUTION > lastExpiration);
+		}
+		if (!expired.empty()) lastExpiration = expired.back()->expiration();
+	}
+	assert (expired.size() == ENTRY_COUNT - (ENTRY_COUNT + 2)/3);
+	delete [] entries;
+}
+
+
+void TimingWheelTest::setUp()
+{
+}
+
+
+void TimingWheelTest::tearDown()
+{
+}
+
+
+CppUnit::Test* TimingWheelTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TimingWheelTest");
+
+	CppUnit_addTest(pSuite, TimingWheelTest, testSchedule);
+	CppUnit_addTest(pSuite, TimingWheelTest, testOrder);
+	CppUnit_addTest(pSuite, TimingWheelTest, testCancel);
+	CppUnit_addTest(pSuite, TimingWheelTest, testReschedule);
+	CppUnit_addTest(pSuite, TimingWheelTest, testCascade);
+	CppUnit_addTest(pSuite, TimingWheelTest, testNextExpiration);
+	CppUnit_addTest(pSuite, TimingWheelTest, testClear);
+	CppUnit_addTest(pSuite, TimingWheelTest, testMany);
+
+	return pSuite;
+}
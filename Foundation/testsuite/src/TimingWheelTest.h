@@ -0,0 +1,47 @@
+//
+// TimingWheelTest.h
+//
+// $Id: //poco/1.4/Foundation/testsuite/src/TimingWheelTest.h#1 $
+//
+// Definition of the TimingWheelTest class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef TimingWheelTest_INCLUDED
+#define TimingWheelTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+
+
+class TimingWheelTest: public CppUnit::TestCase
+{
+public:
+	TimingWheelTest(const std::string& name);
+	~TimingWheelTest();
+
+	void testSchedule();
+	void testOrder();
+	void testCancel();
+	void testReschedule();
+	void testCascade();
+	void testNextExpiration();
+	void testClear();
+	void testMany();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // TimingWheelTest_INCLUDED
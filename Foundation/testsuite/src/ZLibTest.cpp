@@ -15,6 +15,9 @@
 #include "CppUnit/TestSuite.h"
 #include "Poco/InflatingStream.h"
 #include "Poco/DeflatingStream.h"
+#include "Poco/Deflater.h"
+#include "Poco/Inflater.h"
+#include "Poco/Exception.h"
 #include "Poco/MemoryStream.h"
 #include "Poco/StreamCopier.h"
 #include "Poco/Buffer.h"
@@ -28,6 +31,8 @@ using Poco::DeflatingInputStream;
 using Poco::InflatingStreamBuf;
 using Poco::DeflatingStreamBuf;
 using Poco::StreamCopier;
+using Poco::Deflater;
+using Poco::Inflater;
 
 
 ZLibTest::ZLibTest(const std::string& name): CppUnit::TestCase(name)
@@ -177,6 +182,53 @@ void ZLibTest::testGzip3()
 }
 
 
+void ZLibTest::testDeflater()
+{
+	std::string data;
+	for (int i = 0; i < 100; ++i) data += "abcdefghijklmnopqrstuvwxyz";
+
+	Deflater deflater(-15, Z_DEFAULT_COMPRESSION);
+	Inflater inflater(-15);
+	char compressed[4096];
+	char decompressed[4096];
+	for (int msg = 0; msg < 2; ++msg)
+	{
+		// one message, flushed to a byte boundary, sharing the context
+		deflater.setInput(data.data(), data.size());
+		std::size_t n = deflater.deflate(compressed, sizeof(compressed), Deflater::FLUSH_SYNC);
+		assert (deflater.inputAvailable() == 0);
+		assert (n > 0 && n < data.size());
+		assert (n >= 4 && std::string(compressed + n - 4, 4) == std::string("\x00\x00\xff\xff", 4));
+
+		inflater.setInput(compressed, n);
+		std::size_t written;
+		assert (inflater.inflate(decompressed, sizeof(decompressed), written) == Inflater::INFLATE_OK);
+		assert (inflater.inputAvailable() == 0);
+		assert (std::string(decompressed, written) == data);
+	}
+
+	deflater.setInput(data.data(), data.size());
+	std::size_t n = deflater.deflate(compressed, 8, Deflater::FLUSH_FINISH);
+	assert (n == 8);
+	n += deflater.deflate(compressed + n, sizeof(compressed) - n, Deflater::FLUSH_FINISH);
+	inflater.setInput(compressed, n);
+	std::size_t written;
+	assert (inflater.inflate(decompressed, sizeof(decompressed), written) == Inflater::INFLATE_STREAM_END);
+	assert (std::string(decompressed, written) == data);
+	inflater.reset();
+
+	inflater.setInput("\xff\xff\xff\xff", 4);
+	try
+	{
+		inflater.inflate(decompressed, sizeof(decompressed), written);
+		fail("invalid data - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+}
+
+
 void ZLibTest::setUp()
 {
 }
@@ -198,6 +250,7 @@ CppUnit::Test* ZLibTest::suite()
 	CppUnit_addTest(pSuite, ZLibTest, testGzip1);
 	CppUnit_addTest(pSuite, ZLibTest, testGzip2);
 	CppUnit_addTest(pSuite, ZLibTest, testGzip3);
+	CppUnit_addTest(pSuite, ZLibTest, testDeflater);
 
 	return pSuite;
 }
@@ -33,6 +33,7 @@ public:
 	void testGzip1();
 	void testGzip2();
 	void testGzip3();
+	void testDeflater();
 
 	void setUp();
 	void tearDown();
@@ -0,0 +1,244 @@
+//
+// CompiledQuery.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  CompiledQuery
+//
+// Definition of the CompiledQuery and QueryBatch classes.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_CompiledQuery_INCLUDED
+#define JSON_CompiledQuery_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/Document.h"
+#include "Poco/Dynamic/Var.h"
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API CompiledQuery
+	/// A JSON path that is parsed once and can then be evaluated
+	/// against any number of documents, without parsing the path again.
+	///
+	/// The path syntax extends the one of Query. A path consists of
+	/// segments separated by dots. Each segment is a member name,
+	/// followed by any number of array subscripts:
+	///
+	///   - name:    the member with the given name
+	///   - *:       all members of an object, or all elements of an array
+	///   - [n]:     the element with the given index; a negative
+	///              index counts from the end of the array
+	///   - [*]:     all elements of an array
+	///   - [m:n]:   the elements from index m up to, but not including,
+	///              index n; m and n are optional and may be negative
+	///
+	/// For example, "store.books[*].title", "store.books[-1]",
+	/// "store.books[0:2].author" or "store.*.name".
+	///
+	/// A path can be evaluated against an Object, Array, Object::Ptr,
+	/// Array::Ptr, Document::Ptr or DocumentValue. Members and elements
+	/// are visited in place, without being copied; only the results are.
+	/// Unlike Query, a subscript applied to a value that is not an array
+	/// does not match anything.
+	///
+	/// To evaluate many paths against the same document, use a QueryBatch.
+{
+public:
+	CompiledQuery(const std::string& path);
+		/// Creates the CompiledQuery by parsing the given path.
+		/// Throws a SyntaxException if the path is malformed.
+
+	~CompiledQuery();
+		/// Destroys the CompiledQuery.
+
+	const std::string& path() const;
+		/// Returns the path.
+
+	bool isSingular() const;
+		/// Returns true if the path contains no wildcards and
+		/// no slices, so it can match at most one value.
+
+	Dynamic::Var find(const Dynamic::Var& source) const;
+		/// Returns the first value matched by the path, or an
+		/// empty value if the path does not match anything.
+
+	std::size_t find(const Dynamic::Var& source, std::vector<Dynamic::Var>& results) const;
+		/// Stores all values matched by the path in results,
+		/// in document order, and returns their number.
+
+	DocumentValue find(const DocumentValue& source) const;
+		/// Returns the first value matched by the path, or an
+		/// empty DocumentValue if the path does not match anything.
+
+	std::size_t find(const DocumentValue& source, std::vector<DocumentValue>& results) const;
+		/// Stores all values matched by the path in results,
+		/// in document order, and returns their number.
+
+	template <typename T>
+	T findValue(const Dynamic::Var& source, const T& def) const
+		/// Returns the first value matched by the path, converted
+		/// to the given type. When the path does not match or
+		/// the value cannot be converted, def is returned.
+	{
+		T result = def;
+		Dynamic::Var value = find(source);
+		if (!value.isEmpty())
+		{
+			try
+			{
+				result = value.convert<T>();
+			}
+			catch (...)
+			{
+			}
+		}
+		return result;
+	}
+
+	struct Step
+		/// A single step of a compiled path.
+	{
+		enum Type
+		{
+			STEP_KEY,
+			STEP_INDEX,
+			STEP_SLICE,
+			STEP_WILDCARD
+		};
+
+		Type        type;
+		std::string key;
+		int         start;
+		int         end;
+
+		bool operator == (const Step& other) const;
+	};
+
+	typedef std::vector<Step> Steps;
+
+	const Steps& steps() const;
+		/// Returns the compiled steps of the path.
+
+private:
+	void compile();
+
+	std::string _path;
+	Steps       _steps;
+};
+
+
+class JSON_API QueryBatch
+	/// A set of CompiledQuery paths that are evaluated together,
+	/// in a single traversal of a document.
+	///
+	/// The paths are merged into a tree, so that common prefixes
+	/// like "person.address" in "person.address.street" and
+	/// "person.address.city" are only evaluated once.
+	///
+	///    QueryBatch batch;
+	///    std::size_t street = batch.add("person.address.street");
+	///    std::size_t city = batch.add("person.address.city");
+	///    std::vector<Dynamic::Var> values;
+	///    batch.find(pObject, values);
+	///    // values[street], values[city]
+{
+public:
+	QueryBatch();
+		/// Creates an empty QueryBatch.
+
+	~QueryBatch();
+		/// Destroys the QueryBatch.
+
+	std::size_t add(const std::string& path);
+		/// Adds a path and returns its index in the results.
+		/// Throws a SyntaxException if the path is malformed.
+
+	std::size_t add(const CompiledQuery& query);
+		/// Adds a compiled path and returns its index in the results.
+
+	std::size_t size() const;
+		/// Returns the number of paths.
+
+	void find(const Dynamic::Var& source, std::vector<Dynamic::Var>& values) const;
+		/// Stores the first value matched by each path in values,
+		/// or an empty value if the path does not match.
+
+	void findAll(const Dynamic::Var& source, std::vector<std::vector<Dynamic::Var> >& values) const;
+		/// Stores all values matched by each path in values.
+
+	void find(const DocumentValue& source, std::vector<DocumentValue>& values) const;
+		/// Stores the first value matched by each path in values,
+		/// or an empty DocumentValue if the path does not match.
+
+	void findAll(const DocumentValue& source, std::vector<std::vector<DocumentValue> >& values) const;
+		/// Stores all values matched by each path in values.
+
+	struct Node
+		/// A node of the path tree. Each node applies its step to the
+		/// values matched by its parent; the paths ending at the node
+		/// receive the resulting values.
+	{
+		CompiledQuery::Step      step;
+		std::vector<std::size_t> children;
+		std::vector<std::size_t> paths;
+	};
+
+	typedef std::vector<Node> Nodes;
+
+	const Nodes& nodes() const;
+		/// Returns the path tree. The first node is the root,
+		/// which matches the source itself.
+
+private:
+	Nodes       _nodes;
+	std::size_t _size;
+};
+
+
+//
+// inlines
+//
+inline const std::string& CompiledQuery::path() const
+{
+	return _path;
+}
+
+
+inline const CompiledQuery::Steps& CompiledQuery::steps() const
+{
+	return _steps;
+}
+
+
+inline const QueryBatch::Nodes& QueryBatch::nodes() const
+{
+	return _nodes;
+}
+
+
+inline std::size_t QueryBatch::size() const
+{
+	return _size;
+}
+
+
+}} // namespace Poco::JSON
+
+
+#endif // JSON_CompiledQuery_INCLUDED
@@ -0,0 +1,500 @@
+//
+// Document.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Document
+//
+// Definition of the Document and DocumentValue classes.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_Document_INCLUDED
+#define JSON_Document_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Dynamic/Var.h"
+#include <map>
+#include <vector>
+#include <iterator>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class DocumentValue;
+class DocumentHandler;
+
+
+class JSON_API Document
+	/// A compact, read-only representation of a parsed JSON document.
+	///
+	/// Instead of a tree of heap-allocated Object and Array instances
+	/// holding Dynamic::Var values, a Document stores all values in a
+	/// single contiguous tape of fixed-size nodes, in document order.
+	/// Every object or array node is directly followed by its children
+	/// and knows where its subtree ends, so siblings can be skipped
+	/// without looking at their contents. The characters of all strings
+	/// are kept in a single buffer, and object member names are interned,
+	/// so each distinct name is stored only once.
+	///
+	/// A Document is built by a DocumentHandler and accessed through
+	/// DocumentValue views:
+	///
+	///    Parser parser(new DocumentHandler);
+	///    Var result = parser.parse(json);
+	///    Document::Ptr pDoc = result.extract<Document::Ptr>();
+	///    DocumentValue root = pDoc->root();
+	///    std::string name = root.get("person").getValue<std::string>("name");
+	///
+	/// Query and Stringifier work directly on a Document.
+{
+public:
+	typedef SharedPtr<Document> Ptr;
+
+	enum Type
+		/// The type of a value in the document.
+	{
+		TYPE_NULL,
+		TYPE_BOOLEAN,
+		TYPE_INT,
+		TYPE_UNSIGNED,
+		TYPE_INT64,
+		TYPE_UINT64,
+		TYPE_DOUBLE,
+		TYPE_STRING,
+		TYPE_OBJECT,
+		TYPE_ARRAY
+	};
+
+	Document();
+		/// Creates an empty Document.
+
+	~Document();
+		/// Destroys the Document.
+
+	DocumentValue root() const;
+		/// Returns the top level value of the document, or
+		/// an empty DocumentValue if the document is empty.
+
+	bool empty() const;
+		/// Returns true if the document does not contain any value.
+
+	std::size_t nodes() const;
+		/// Returns the number of values in the document.
+
+	std::size_t keys() const;
+		/// Returns the number of distinct object member names.
+
+	std::size_t memoryUsage() const;
+		/// Returns the number of bytes used by the document's
+		/// nodes, strings and name table.
+
+private:
+	struct Node
+	{
+		UInt8  type;
+		UInt32 key;
+		UInt32 size;
+		UInt32 next;
+		union
+		{
+			Int64  i;
+			UInt64 u;
+			double d;
+		} value;
+	};
+
+	typedef std::vector<Node> NodeVec;
+	typedef std::map<std::string, UInt32> KeyMap;
+	typedef std::vector<const std::string*> KeyVec;
+
+	static const UInt32 NO_KEY = 0xFFFFFFFF;
+
+	Document(const Document&);
+	Document& operator = (const Document&);
+
+	UInt32 intern(const std::string& key);
+	UInt32 find(const std::string& key) const;
+	Node& add(Type type, UInt32 key);
+	void addString(const std::string& value, UInt32 key);
+
+	NodeVec     _nodes;
+	std::string _strings;
+	KeyMap      _keyMap;
+	KeyVec      _keys;
+
+	friend class DocumentValue;
+	friend class DocumentHandler;
+};
+
+
+class JSON_API DocumentValue
+	/// A lightweight view of a value in a Document.
+	///
+	/// DocumentValue provides the accessors of Object and Array,
+	/// without copying anything out of the document. A DocumentValue
+	/// is only valid as long as the Document it refers to exists.
+	///
+	/// A default-constructed DocumentValue, or one returned for a
+	/// member or element that does not exist, is empty.
+	///
+	/// Member lookup by name is linear in the number of members.
+	/// Element lookup by index takes constant time for arrays of
+	/// scalar values, but is linear in the index for arrays that
+	/// contain objects or arrays. To visit all members or elements,
+	/// use begin() and end() instead of get() with an index.
+{
+public:
+	class ConstIterator;
+
+	DocumentValue();
+		/// Creates an empty DocumentValue.
+
+	DocumentValue(const Document* pDoc, UInt32 index);
+		/// Creates a DocumentValue for the node with the
+		/// given index in the given Document.
+
+	~DocumentValue();
+		/// Destroys the DocumentValue.
+
+	bool isEmpty() const;
+		/// Returns true if the DocumentValue does not refer to a value.
+
+	Document::Type type() const;
+		/// Returns the type of the value. Throws an InvalidAccessException
+		/// if the DocumentValue is empty.
+
+	bool isNull() const;
+		/// Returns true if the value is null.
+
+	bool isBoolean() const;
+		/// Returns true if the value is a boolean.
+
+	bool isInteger() const;
+		/// Returns true if the value is an integer.
+
+	bool isNumeric() const;
+		/// Returns true if the value is an integer or a floating-point number.
+
+	bool isString() const;
+		/// Returns true if the value is a string.
+
+	bool isObject() const;
+		/// Returns true if the value is an object.
+
+	bool isArray() const;
+		/// Returns true if the value is an array.
+
+	std::size_t size() const;
+		/// Returns the number of members of an object or
+		/// elements of an array, or 0 for other values.
+
+	std::string key() const;
+		/// Returns the member name, if the value is a member of
+		/// an object, or an empty string otherwise.
+
+	DocumentValue get(const std::string& key) const;
+		/// Returns the member with the given name. An empty value
+		/// is returned if this is not an object or has no such member.
+		/// If the object contains the name more than once, the first
+		/// member is returned.
+
+	DocumentValue get(unsigned int index) const;
+		/// Returns the element with the given index. An empty value
+		/// is returned if this is not an array or the index is out
+		/// of range.
+		///
+		/// If the array contains objects or arrays, the elements
+		/// before the given index have to be skipped one by one,
+		/// so a loop over all elements using get() takes quadratic
+		/// time. Use begin() and end() to iterate instead.
+
+	bool has(const std::string& key) const;
+		/// Returns true if this is an object with the given member.
+
+	bool isNull(const std::string& key) const;
+		/// Returns true if the given member does not exist or is null.
+
+	bool isArray(const std::string& key) const;
+		/// Returns true if the given member is an array.
+
+	bool isObject(const std::string& key) const;
+		/// Returns true if the given member is an object.
+
+	template <typename T>
+	T convert() const
+		/// Converts the value to the given type, using Dynamic::Var's
+		/// conversion rules. Throws an InvalidAccessException if the
+		/// value is empty.
+		/// Note: This will not work for an array or an object.
+	{
+		return toVar().convert<T>();
+	}
+
+	template <typename T>
+	T getValue(const std::string& key) const
+		/// Retrieves the member with the given name and converts it
+		/// to the given type, with the same semantics as Object::getValue().
+	{
+		return get(key).toVar().convert<T>();
+	}
+
+	template <typename T>
+	T getElement(unsigned int index) const
+		/// Retrieves the element with the given index and converts it
+		/// to the given type, with the same semantics as Array::getElement().
+	{
+		return get(index).toVar().convert<T>();
+	}
+
+	template <typename T>
+	T optValue(const std::string& key, const T& def) const
+		/// Returns the value of a member when the member exists
+		/// and can be converted to the given type. Otherwise
+		/// def will be returned.
+	{
+		T value = def;
+		DocumentValue member = get(key);
+		if (!member.isEmpty() && !member.isNull())
+		{
+			try
+			{
+				value = member.toVar().convert<T>();
+			}
+			catch (...)
+			{
+				// The default value will be returned
+			}
+		}
+		return value;
+	}
+
+	void getNames(std::vector<std::string>& names) const;
+		/// Returns the member names of an object, in document order.
+
+	ConstIterator begin() const;
+		/// Returns an iterator to the first member or element.
+
+	ConstIterator end() const;
+		/// Returns the end iterator for the members or elements.
+
+	Dynamic::Var toVar() const;
+		/// Returns the value as a Dynamic::Var, holding the same types
+		/// ParseHandler would create. Objects and arrays are copied into
+		/// new Object and Array instances (preserving member order),
+		/// which is expensive for large subtrees.
+		/// An empty Var is returned if the DocumentValue is empty.
+
+	std::string toString() const;
+		/// Returns the characters of a string, or the
+		/// value converted to a string otherwise.
+
+	const Document* document() const;
+		/// Returns the document this value belongs to.
+
+	UInt32 index() const;
+		/// Returns the index of the value's node in its document.
+
+private:
+	const Document::Node& node() const;
+	UInt32 find(const std::string& key) const;
+
+	const Document* _pDoc;
+	UInt32 _index;
+
+	friend class ConstIterator;
+};
+
+
+class JSON_API DocumentValue::ConstIterator
+	/// Iterates over the members of an object or
+	/// the elements of an array.
+{
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef DocumentValue value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const DocumentValue* pointer;
+	typedef const DocumentValue& reference;
+
+	ConstIterator();
+	ConstIterator(const Document* pDoc, UInt32 index);
+
+	const DocumentValue& operator * () const;
+	const DocumentValue* operator -> () const;
+	ConstIterator& operator ++ ();
+	ConstIterator operator ++ (int);
+	bool operator == (const ConstIterator& other) const;
+	bool operator != (const ConstIterator& other) const;
+
+private:
+	DocumentValue _value;
+};
+
+
+//
+// inlines
+//
+inline bool Document::empty() const
+{
+	return _nodes.empty();
+}
+
+
+inline std::size_t Document::nodes() const
+{
+	return _nodes.size();
+}
+
+
+inline std::size_t Document::keys() const
+{
+	return _keys.size();
+}
+
+
+inline bool DocumentValue::isEmpty() const
+{
+	return _pDoc == 0;
+}
+
+
+inline const Document::Node& DocumentValue::node() const
+{
+	return _pDoc->_nodes[_index];
+}
+
+
+inline bool DocumentValue::isNull() const
+{
+	return _pDoc && node().type == Document::TYPE_NULL;
+}
+
+
+inline bool DocumentValue::isBoolean() const
+{
+	return _pDoc && node().type == Document::TYPE_BOOLEAN;
+}
+
+
+inline bool DocumentValue::isInteger() const
+{
+	return _pDoc && node().type >= Document::TYPE_INT && node().type <= Document::TYPE_UINT64;
+}
+
+
+inline bool DocumentValue::isNumeric() const
+{
+	return _pDoc && node().type >= Document::TYPE_INT && node().type <= Document::TYPE_DOUBLE;
+}
+
+
+inline bool DocumentValue::isString() const
+{
+	return _pDoc && node().type == Document::TYPE_STRING;
+}
+
+
+inline bool DocumentValue::isObject() const
+{
+	return _pDoc && node().type == Document::TYPE_OBJECT;
+}
+
+
+inline bool DocumentValue::isArray() const
+{
+	return _pDoc && node().type == Document::TYPE_ARRAY;
+}
+
+
+inline bool DocumentValue::has(const std::string& key) const
+{
+	return !get(key).isEmpty();
+}
+
+
+inline bool DocumentValue::isNull(const std::string& key) const
+{
+	DocumentValue member = get(key);
+	return member.isEmpty() || member.isNull();
+}
+
+
+inline bool DocumentValue::isArray(const std::string& key) const
+{
+	return get(key).isArray();
+}
+
+
+inline bool DocumentValue::isObject(const std::string& key) const
+{
+	return get(key).isObject();
+}
+
+
+inline const Document* DocumentValue::document() const
+{
+	return _pDoc;
+}
+
+
+inline UInt32 DocumentValue::index() const
+{
+	return _index;
+}
+
+
+inline const DocumentValue& DocumentValue::ConstIterator::operator * () const
+{
+	return _value;
+}
+
+
+inline const DocumentValue* DocumentValue::ConstIterator::operator -> () const
+{
+	return &_value;
+}
+
+
+inline DocumentValue::ConstIterator& DocumentValue::ConstIterator::operator ++ ()
+{
+	_value._index = _value.node().next;
+	return *this;
+}
+
+
+inline DocumentValue::ConstIterator DocumentValue::ConstIterator::operator ++ (int)
+{
+	ConstIterator tmp(*this);
+	++*this;
+	return tmp;
+}
+
+
+inline bool DocumentValue::ConstIterator::operator == (const ConstIterator& other) const
+{
+	return _value._pDoc == other._value._pDoc && _value._index == other._value._index;
+}
+
+
+inline bool DocumentValue::ConstIterator::operator != (const ConstIterator& other) const
+{
+	return !(*this == other);
+}
+
+
+}} // namespace Poco::JSON
+
+
+#endif // JSON_Document_INCLUDED
@@ -0,0 +1,122 @@
+//
+// DocumentHandler.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  DocumentHandler
+//
+// Definition of the DocumentHandler class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_DocumentHandler_INCLUDED
+#define JSON_DocumentHandler_INCLUDED
+
+
+#include "Poco/JSON/Handler.h"
+#include "Poco/JSON/Document.h"
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API DocumentHandler: public Handler
+	/// A handler for the JSON parser that builds a compact,
+	/// read-only Document, instead of a tree of Object and
+	/// Array instances like ParseHandler.
+	///
+	/// The result of the parser is a Dynamic::Var holding
+	/// a Document::Ptr.
+{
+public:
+	DocumentHandler();
+		/// Creates the DocumentHandler.
+
+	virtual ~DocumentHandler();
+		/// Destroys the DocumentHandler.
+
+	virtual void reset();
+		/// Resets the handler state and starts a new Document.
+
+	void startObject();
+		/// Handles a '{'; a new object is started.
+
+	void endObject();
+		/// Handles a '}'; the object is closed.
+
+	void startArray();
+		/// Handles a '['; a new array is started.
+
+	void endArray();
+		/// Handles a ']'; the array is closed.
+
+	void key(const std::string& k);
+		/// A key is read.
+
+	Dynamic::Var asVar() const;
+		/// Returns a Dynamic::Var holding the Document::Ptr.
+
+	const Document::Ptr& document() const;
+		/// Returns the Document.
+
+	virtual void value(int v);
+		/// An integer value is read
+
+	virtual void value(unsigned v);
+		/// An unsigned value is read. This will only be triggered if the
+		/// value cannot fit into a signed int.
+
+#if defined(POCO_HAVE_INT64)
+	virtual void value(Int64 v);
+		/// A 64-bit integer value is read
+
+	virtual void value(UInt64 v);
+		/// An unsigned 64-bit integer value is read. This will only be
+		/// triggered if the value cannot fit into a signed 64-bit integer.
+#endif
+
+	virtual void value(const std::string& s);
+		/// A string value is read.
+
+	virtual void value(double d);
+		/// A double value is read.
+
+	virtual void value(bool b);
+		/// A boolean value is read.
+
+	virtual void null();
+		/// A null value is read.
+
+private:
+	Document::Node& add(Document::Type type);
+	void start(Document::Type type);
+	void end();
+
+	Document::Ptr       _pDocument;
+	std::vector<UInt32> _stack;
+	UInt32              _key;
+};
+
+
+//
+// inlines
+//
+inline const Document::Ptr& DocumentHandler::document() const
+{
+	return _pDocument;
+}
+
+
+}} // namespace Poco::JSON
+
+
+#endif // JSON_DocumentHandler_INCLUDED
@@ -0,0 +1,174 @@
+//
+// FastParser.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  FastParser
+//
+// Definition of the FastParser class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_FastParser_INCLUDED
+#define JSON_FastParser_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Handler.h"
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API FastParser
+	/// A JSON parser that works on a contiguous buffer and scans
+	/// it in bulk, instead of running a state machine for every
+	/// character like Parser does by default.
+	///
+	/// Strings are searched for the next quote, backslash, control
+	/// or non-ASCII character 32 (AVX2) or 16 (SSE2) bytes at a time,
+	/// and the characters in between are copied to the string buffer
+	/// at once. Runs of whitespace are skipped the same way. On other
+	/// platforms, or if POCO_JSON_NO_SIMD is defined, a scalar loop
+	/// is used.
+	///
+	/// The FastParser reports the same events to its Handler as
+	/// Parser, and supports the same options: comments (/* ... */),
+	/// null bytes in \u0000 escapes, and a depth limit. It accepts
+	/// the JSON grammar of RFC 4627, so the top level value must be
+	/// an object or an array.
+	///
+	/// Usually, the FastParser is used through Parser, by setting the
+	/// parser's engine to Parser::ENGINE_FAST.
+{
+public:
+	FastParser(const Handler::Ptr& pHandler = 0);
+		/// Creates the FastParser.
+
+	~FastParser();
+		/// Destroys the FastParser.
+
+	void setHandler(const Handler::Ptr& pHandler);
+		/// Sets the handler.
+
+	const Handler::Ptr& getHandler() const;
+		/// Returns the handler.
+
+	void setAllowComments(bool comments);
+		/// Allow comments. By default, comments are not allowed.
+
+	bool getAllowComments() const;
+		/// Returns true if comments are allowed, false otherwise.
+
+	void setAllowNullByte(bool nullByte);
+		/// Allow null bytes (\u0000) in strings. By default,
+		/// null bytes are allowed.
+
+	bool getAllowNullByte() const;
+		/// Returns true if null bytes are allowed, false otherwise.
+
+	void setDepth(int depth);
+		/// Sets the allowed JSON depth, with the same meaning
+		/// as for Parser. -1 means unlimited.
+
+	int getDepth() const;
+		/// Returns the allowed JSON depth.
+
+	void parse(const char* begin, const char* end);
+		/// Parses the JSON document in the given buffer.
+		///
+		/// Throws a SyntaxException if the document is not valid
+		/// JSON, or a JSONException if it contains malformed UTF-8.
+
+private:
+	FastParser(const FastParser&);
+	FastParser& operator = (const FastParser&);
+
+	void skipWhitespace();
+	void parseKey();
+	void parseString();
+	void parseEscape();
+	void parseUTF8();
+	unsigned parseHex4();
+	void parseNumber();
+	void parseLiteral(const char* literal, std::size_t length);
+	void enter(char mode);
+	void syntaxError();
+
+	Handler::Ptr      _pHandler;
+	const char*       _pos;
+	const char*       _end;
+	std::string       _buffer;
+	std::string       _number;
+	std::vector<char> _stack;
+	int               _depth;
+	bool              _allowComments;
+	bool              _allowNullByte;
+};
+
+
+//
+// inlines
+//
+inline void FastParser::setHandler(const Handler::Ptr& pHandler)
+{
+	_pHandler = pHandler;
+}
+
+
+inline const Handler::Ptr& FastParser::getHandler() const
+{
+	return _pHandler;
+}
+
+
+inline void FastParser::setAllowComments(bool comments)
+{
+	_allowComments = comments;
+}
+
+
+inline bool FastParser::getAllowComments() const
+{
+	return _allowComments;
+}
+
+
+inline void FastParser::setAllowNullByte(bool nullByte)
+{
+	_allowNullByte = nullByte;
+}
+
+
+inline bool FastParser::getAllowNullByte() const
+{
+	return _allowNullByte;
+}
+
+
+inline void FastParser::setDepth(int depth)
+{
+	_depth = depth;
+}
+
+
+inline int FastParser::getDepth() const
+{
+	return _depth;
+}
+
+
+}} // namespace Poco::JSON
+
+
+#endif // JSON_FastParser_INCLUDED
@@ -103,6 +103,10 @@ public:
 		/// Retrieves a property. An empty value is
 		/// returned when the property doesn't exist.
 
+	const Dynamic::Var* find(const std::string& key) const;
+		/// Returns a pointer to the value of the property, without
+		/// copying it, or a null pointer when the property doesn't exist.
+
 	Array::Ptr getArray(const std::string& key) const;
 		/// Returns a SharedPtr to an array when the property
 		/// is an array. An empty SharedPtr is returned when
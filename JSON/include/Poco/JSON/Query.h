@@ -22,6 +22,7 @@
 #include "Poco/JSON/JSON.h"
 #include "Poco/JSON/Object.h"
 #include "Poco/JSON/Array.h"
+#include "Poco/JSON/Document.h"
 
 
 namespace Poco {
@@ -34,8 +35,8 @@ class JSON_API Query
 public:
 	Query(const Dynamic::Var& source);
 		/// Creates the Query; source must be JSON Object, Array, Object::Ptr,
-		/// Array::Ptr or empty Var. Any other type will trigger throwing of 
-		/// InvalidArgumentException.
+		/// Array::Ptr, Document::Ptr, DocumentValue or empty Var. Any other
+		/// type will trigger throwing of InvalidArgumentException.
 		/// Creating Query holding Ptr will typically result in faster
 		/// performance.
 
@@ -74,6 +75,12 @@ public:
 		/// the name of the first child. When the value can't be found
 		/// an empty value is returned.
 
+	DocumentValue findDocumentValue(const std::string& path) const;
+		/// Searches a value in a Document, without copying it out of
+		/// the Document. When the value can't be found, or the source
+		/// of the Query is not a Document, an empty DocumentValue is
+		/// returned.
+
 	template<typename T>
 	T findValue(const std::string& path, const T& def) const
 		/// Searches for a value will convert it to the given type.
@@ -102,6 +109,8 @@ public:
 	}
 
 private:
+	static void parseToken(const std::string& token, std::string& name, std::vector<int>& indexes);
+
 	Dynamic::Var _source;
 };
 
@@ -23,12 +23,16 @@
 #include "Poco/Dynamic/Var.h"
 #include "Poco/JSON/JSON.h"
 #include <ostream>
+#include <string>
 
 
 namespace Poco {
 namespace JSON {
 
 
+class DocumentValue;
+
+
 class JSON_API Stringifier
 	/// Helper class for creating a String from a JSON object or array
 {
@@ -49,8 +53,22 @@ public:
 		/// When preserveInsertionOrder is true, the original string object members order will be preserved;
 		/// otherwise, object members are sorted by their names.
 
+	static void stringify(const DocumentValue& value, std::ostream& out, unsigned int indent = 0, int step = -1);
+		/// Writes a String representation of a value in a Document to the output stream,
+		/// with the same formatting as for Object and Array. Object members
+		/// are written in document order.
+
 	static void formatString(const std::string& value, std::ostream& out);
 		/// Formats the JSON string and streams it into ostream.
+		/// Characters that need no escaping are written in runs,
+		/// control characters without a short escape sequence
+		/// are written as \u00XX.
+
+	static void formatString(const std::string& value, std::string& out);
+		/// Formats the JSON string and appends it to out.
+
+	static void formatString(const char* value, std::size_t length, std::string& out);
+		/// Formats the JSON string of the given length and appends it to out.
 };
 
 
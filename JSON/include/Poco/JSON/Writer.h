@@ -0,0 +1,196 @@
+//
+// Writer.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Writer
+//
+// Definition of the Writer class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_Writer_INCLUDED
+#define JSON_Writer_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API Writer
+	/// Writer produces JSON text directly from a sequence of calls,
+	/// without building Object and Array instances first:
+	///
+	///    Writer writer(response.send());
+	///    writer.startObject();
+	///    writer.key("name");
+	///    writer.value("Homer");
+	///    writer.key("children");
+	///    writer.startArray();
+	///    writer.value("Bart");
+	///    writer.value("Lisa");
+	///    writer.endArray();
+	///    writer.endObject();
+	///    writer.flush();
+	///
+	/// The output is collected in an internal buffer which is written
+	/// to the output stream whenever it exceeds the buffer size, when
+	/// flush() is called, and when the Writer is destroyed. Alternatively,
+	/// the Writer can append the output directly to a caller-provided
+	/// std::string.
+	///
+	/// Integers and doubles are formatted without going through
+	/// std::ostream, doubles using the shortest representation that
+	/// round-trips. Since JSON has no representation for them, infinite
+	/// and NaN doubles are written as null. Strings are escaped with
+	/// Stringifier::formatString().
+	///
+	/// With an indent greater than zero, the output is laid out like
+	/// Stringifier does. Calls that would produce invalid JSON, like a
+	/// value without a key inside an object or an unbalanced end, throw
+	/// a JSONException.
+{
+public:
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 8192
+	};
+
+	Writer(std::ostream& out, unsigned indent = 0, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates a Writer that writes to the given stream.
+
+	Writer(std::string& str, unsigned indent = 0);
+		/// Creates a Writer that appends to the given string.
+
+	~Writer();
+		/// Destroys the Writer, flushing the buffer.
+
+	void startObject();
+		/// Writes a '{' and starts a new object.
+
+	void endObject();
+		/// Closes the current object with a '}'.
+
+	void startArray();
+		/// Writes a '[' and starts a new array.
+
+	void endArray();
+		/// Closes the current array with a ']'.
+
+	void key(const std::string& k);
+		/// Writes the name of the next member of the current object.
+
+	void key(const char* k);
+		/// Writes the name of the next member of the current object.
+
+	void null();
+		/// Writes a null value.
+
+	void value(bool b);
+		/// Writes a boolean value.
+
+	void value(int v);
+		/// Writes an integer value.
+
+	void value(unsigned v);
+		/// Writes an unsigned integer value.
+
+	void value(Int64 v);
+		/// Writes a 64-bit integer value.
+
+	void value(UInt64 v);
+		/// Writes an unsigned 64-bit integer value.
+
+	void value(double d);
+		/// Writes a double value.
+
+	void value(const std::string& s);
+		/// Writes a string value.
+
+	void value(const char* s);
+		/// Writes a string value.
+
+	void flush();
+		/// Writes the buffered output to the output stream and
+		/// flushes the stream. Does nothing when writing to a string.
+
+	bool complete() const;
+		/// Returns true if a complete top-level value has been written.
+
+	void reset();
+		/// Discards the state, so that a new top-level value can be
+		/// written. Buffered output is not discarded.
+
+private:
+	Writer(const Writer&);
+	Writer& operator = (const Writer&);
+
+	void beforeValue();
+	void afterValue();
+	void start(char type, char bracket);
+	void end(char type, char bracket);
+	void newLine();
+	void writeKey(const char* k, std::size_t length);
+	void writeRaw(const char* s, std::size_t length);
+	void checkFlush();
+
+	std::ostream*     _pOut;
+	std::string       _buffer;
+	std::string&      _str;
+	std::size_t       _bufferSize;
+	unsigned          _indent;
+	std::vector<char> _stack;
+	bool              _first;
+	bool              _hasKey;
+	bool              _complete;
+};
+
+
+//
+// inlines
+//
+inline bool Writer::complete() const
+{
+	return _complete;
+}
+
+
+inline void Writer::key(const std::string& k)
+{
+	writeKey(k.data(), k.size());
+}
+
+
+inline void Writer::writeRaw(const char* s, std::size_t length)
+{
+	_str.append(s, length);
+}
+
+
+inline void Writer::checkFlush()
+{
+	if (_pOut && _buffer.size() >= _bufferSize)
+	{
+		_pOut->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+		_buffer.clear();
+	}
+}
+
+
+}} // namespace Poco::JSON
+
+
+#endif // JSON_Writer_INCLUDED
@@ -14,6 +14,7 @@
 
 #include "Poco/JSON/Parser.h"
 #include "Poco/JSON/ParseHandler.h"
+#include "Poco/JSON/DocumentHandler.h"
 #include "Poco/JSON/JSONException.h"
 #include "Poco/Environment.h"
 #include "Poco/Path.h"
@@ -75,6 +76,15 @@ int main(int argc, char** argv)
 	std::cout << "[std::istringstream] parsed in " << sw.elapsed() << " [us]" << std::endl;
 	std::cout << "----------------------------------------" << std::endl;
 
+	Poco::JSON::Parser fparser(0);
+	fparser.setEngine(Poco::JSON::Parser::ENGINE_FAST);
+	sw.restart();
+	fparser.parse(jsonStr);
+	sw.stop();
+	std::cout << "----------------------------------------" << std::endl;
+	std::cout << "[std::string, fast engine] parsed in " << sw.elapsed() << " [us]" << std::endl;
+	std::cout << "----------------------------------------" << std::endl;
+
 	std::cout << std::endl << "POCO JSON Handle/Stringify" << std::endl;
 	try
 	{
@@ -97,6 +107,26 @@ int main(int argc, char** argv)
 		std::cout << "[std::istringstream] parsed/handled in " << sw.elapsed() << " [us]" << std::endl;
 		std::cout << "------------------------------------------------" << std::endl;
 
+		Poco::JSON::Parser fsparser;
+		fsparser.setEngine(Poco::JSON::Parser::ENGINE_FAST);
+		sw.restart();
+		fsparser.parse(jsonStr);
+		result = fsparser.result();
+		sw.stop();
+		std::cout << "------------------------------------------------" << std::endl;
+		std::cout << "[std::string, fast engine] parsed/handled in " << sw.elapsed() << " [us]" << std::endl;
+		std::cout << "------------------------------------------------" << std::endl;
+
+		Poco::JSON::Parser dparser(new Poco::JSON::DocumentHandler);
+		dparser.setEngine(Poco::JSON::Parser::ENGINE_FAST);
+		sw.restart();
+		Poco::JSON::Document::Ptr pDoc = dparser.parse(jsonStr).extract<Poco::JSON::Document::Ptr>();
+		sw.stop();
+		std::cout << "------------------------------------------------" << std::endl;
+		std::cout << "[std::string, fast engine] document built in " << sw.elapsed() << " [us]" << std::endl;
+		std::cout << pDoc->nodes() << " values in " << pDoc->memoryUsage() << " bytes" << std::endl;
+		std::cout << "------------------------------------------------" << std::endl;
+
 		//Serialize to string
 		Poco::JSON::Object::Ptr obj;
 		if ( result.type() == typeid(Poco::JSON::Object::Ptr) )
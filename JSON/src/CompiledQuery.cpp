@@ -0,0 +1,584 @@
+//
+// CompiledQuery.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  CompiledQuery
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/CompiledQuery.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <limits>
+
+
+using Poco::Dynamic::Var;
+
+
+namespace Poco {
+namespace JSON {
+
+
+namespace
+{
+	int normalize(int index, std::size_t size)
+		/// Resolves a negative index relative to the end and
+		/// clamps the index to the range [0, size].
+	{
+		int n = static_cast<int>(size);
+		if (index < 0) index += n;
+		if (index < 0) return 0;
+		if (index > n) return n;
+		return index;
+	}
+
+
+	struct VarAccess
+		/// Visits Object and Array values in place, through pointers.
+	{
+		typedef const Var* Value;
+
+		static const Object* object(Value v)
+		{
+			if (v->type() == typeid(Object::Ptr))
+				return v->extract<Object::Ptr>().get();
+			else if (v->type() == typeid(Object))
+				return &v->extract<Object>();
+			else
+				return 0;
+		}
+
+		static const Array* array(Value v)
+		{
+			if (v->type() == typeid(Array::Ptr))
+				return v->extract<Array::Ptr>().get();
+			else if (v->type() == typeid(Array))
+				return &v->extract<Array>();
+			else
+				return 0;
+		}
+
+		template <class F>
+		static bool key(Value v, const std::string& name, F& f)
+		{
+			const Object* pObject = object(v);
+			if (pObject)
+			{
+				const Var* pValue = pObject->find(name);
+				if (pValue) return f(pValue);
+			}
+			return false;
+		}
+
+		template <class F>
+		static bool index(Value v, int index, F& f)
+		{
+			const Array* pArray = array(v);
+			if (pArray)
+			{
+				if (index < 0) index += static_cast<int>(pArray->size());
+				if (index >= 0 && static_cast<std::size_t>(index) < pArray->size())
+					return f(&*(pArray->begin() + index));
+			}
+			return false;
+		}
+
+		template <class F>
+		static bool slice(Value v, int start, int end, F& f)
+		{
+			const Array* pArray = array(v);
+			if (pArray)
+			{
+				Array::ValueVec::const_iterator it = pArray->begin();
+				int last = normalize(end, pArray->size());
+				for (int i = normalize(start, pArray->size()); i < last; ++i)
+				{
+					if (f(&*(it + i))) return true;
+				}
+			}
+			return false;
+		}
+
+		template <class F>
+		static bool all(Value v, F& f)
+		{
+			const Object* pObject = object(v);
+			if (pObject)
+			{
+				for (Object::ConstIterator it = pObject->begin(); it != pObject->end(); ++it)
+				{
+					if (f(&it->second)) return true;
+				}
+				return false;
+			}
+			return slice(v, 0, std::numeric_limits<int>::max(), f);
+		}
+	};
+
+
+	struct DocumentAccess
+		/// Visits the values of a Document.
+	{
+		typedef DocumentValue Value;
+
+		template <class F>
+		static bool key(const Value& v, const std::string& name, F& f)
+		{
+			DocumentValue member = v.get(name);
+			if (!member.isEmpty()) return f(member);
+			return false;
+		}
+
+		template <class F>
+		static bool index(const Value& v, int index, F& f)
+		{
+			if (v.isArray())
+			{
+				if (index < 0) index += static_cast<int>(v.size());
+				if (index >= 0)
+				{
+					DocumentValue element = v.get(static_cast<unsigned>(index));
+					if (!element.isEmpty()) return f(element);
+				}
+			}
+			return false;
+		}
+
+		template <class F>
+		static bool slice(const Value& v, int start, int end, F& f)
+		{
+			if (v.isArray())
+			{
+				int first = normalize(start, v.size());
+				int last = normalize(end, v.size());
+				int i = 0;
+				for (DocumentValue::ConstIterator it = v.begin(); it != v.end() && i < last; ++it, ++i)
+				{
+					if (i >= first && f(*it)) return true;
+				}
+			}
+			return false;
+		}
+
+		template <class F>
+		static bool all(const Value& v, F& f)
+		{
+			for (DocumentValue::ConstIterator it = v.begin(); it != v.end(); ++it)
+			{
+				if (f(*it)) return true;
+			}
+			return false;
+		}
+	};
+
+
+	template <class A, class F>
+	bool apply(const CompiledQuery::Step& step, const typename A::Value& v, F& f)
+		/// Calls f for every value the step matches in v, until f returns true.
+		/// Returns true if f did.
+	{
+		switch (step.type)
+		{
+		case CompiledQuery::Step::STEP_KEY:
+			return A::key(v, step.key, f);
+		case CompiledQuery::Step::STEP_INDEX:
+			return A::index(v, step.start, f);
+		case CompiledQuery::Step::STEP_SLICE:
+			return A::slice(v, step.start, step.end, f);
+		case CompiledQuery::Step::STEP_WILDCARD:
+			return A::all(v, f);
+		}
+		return false;
+	}
+
+
+	template <class A>
+	class PathEvaluator
+		/// Evaluates the steps of a single path, depth first.
+	{
+	public:
+		typedef typename A::Value Value;
+
+		PathEvaluator(const CompiledQuery::Steps& steps, std::vector<Value>& results, bool firstOnly):
+			_steps(steps),
+			_results(results),
+			_firstOnly(firstOnly),
+			_pos(0)
+		{
+		}
+
+		bool operator () (const Value& v)
+		{
+			if (_pos == _steps.size())
+			{
+				_results.push_back(v);
+				return _firstOnly;
+			}
+			const CompiledQuery::Step& step = _steps[_pos++];
+			bool stop = apply<A>(step, v, *this);
+			--_pos;
+			return stop;
+		}
+
+	private:
+		const CompiledQuery::Steps& _steps;
+		std::vector<Value>&         _results;
+		bool                        _firstOnly;
+		std::size_t                 _pos;
+	};
+
+
+	template <class A>
+	class BatchEvaluator
+		/// Evaluates a tree of paths, depth first.
+	{
+	public:
+		typedef typename A::Value Value;
+
+		BatchEvaluator(const QueryBatch::Nodes& nodes, std::vector<std::vector<Value> >& results, bool firstOnly):
+			_nodes(nodes),
+			_results(results),
+			_firstOnly(firstOnly),
+			_node(0)
+		{
+		}
+
+		bool operator () (const Value& v)
+		{
+			const QueryBatch::Node& node = _nodes[_node];
+			for (std::vector<std::size_t>::const_iterator it = node.paths.begin(); it != node.paths.end(); ++it)
+			{
+				if (!_firstOnly || _results[*it].empty()) _results[*it].push_back(v);
+			}
+			std::size_t current = _node;
+			for (std::vector<std::size_t>::const_iterator it = node.children.begin(); it != node.children.end(); ++it)
+			{
+				_node = *it;
+				apply<A>(_nodes[_node].step, v, *this);
+			}
+			_node = current;
+			return false;
+		}
+
+	private:
+		const QueryBatch::Nodes&          _nodes;
+		std::vector<std::vector<Value> >& _results;
+		bool                              _firstOnly;
+		std::size_t                       _node;
+	};
+
+
+	bool isDocument(const Var& source)
+	{
+		return source.type() == typeid(Document::Ptr) || source.type() == typeid(DocumentValue);
+	}
+
+
+	DocumentValue documentValue(const Var& source)
+	{
+		if (source.type() == typeid(Document::Ptr))
+			return source.extract<Document::Ptr>()->root();
+		else
+			return source.extract<DocumentValue>();
+	}
+}
+
+
+//
+// CompiledQuery
+//
+
+
+bool CompiledQuery::Step::operator == (const Step& other) const
+{
+	return type == other.type && key == other.key && start == other.start && end == other.end;
+}
+
+
+CompiledQuery::CompiledQuery(const std::string& path):
+	_path(path)
+{
+	compile();
+}
+
+
+CompiledQuery::~CompiledQuery()
+{
+}
+
+
+bool CompiledQuery::isSingular() const
+{
+	for (Steps::const_iterator it = _steps.begin(); it != _steps.end(); ++it)
+	{
+		if (it->type == Step::STEP_SLICE || it->type == Step::STEP_WILDCARD) return false;
+	}
+	return true;
+}
+
+
+Var CompiledQuery::find(const Var& source) const
+{
+	if (isDocument(source)) return find(documentValue(source)).toVar();
+
+	std::vector<const Var*> results;
+	PathEvaluator<VarAccess> evaluator(_steps, results, true);
+	evaluator(&source);
+	if (results.empty())
+		return Var();
+	else
+		return *results.front();
+}
+
+
+std::size_t CompiledQuery::find(const Var& source, std::vector<Var>& results) const
+{
+	results.clear();
+	if (isDocument(source))
+	{
+		std::vector<DocumentValue> values;
+		find(documentValue(source), values);
+		for (std::vector<DocumentValue>::const_iterator it = values.begin(); it != values.end(); ++it)
+		{
+			results.push_back(it->toVar());
+		}
+	}
+	else
+	{
+		std::vector<const Var*> values;
+		PathEvaluator<VarAccess> evaluator(_steps, values, false);
+		evaluator(&source);
+		results.reserve(values.size());
+		for (std::vector<const Var*>::const_iterator it = values.begin(); it != values.end(); ++it)
+		{
+			results.push_back(**it);
+		}
+	}
+	return results.size();
+}
+
+
+DocumentValue CompiledQuery::find(const DocumentValue& source) const
+{
+	std::vector<DocumentValue> results;
+	if (!source.isEmpty())
+	{
+		PathEvaluator<DocumentAccess> evaluator(_steps, results, true);
+		evaluator(source);
+	}
+	if (results.empty())
+		return DocumentValue();
+	else
+		return results.front();
+}
+
+
+std::size_t CompiledQuery::find(const DocumentValue& source, std::vector<DocumentValue>& results) const
+{
+	results.clear();
+	if (!source.isEmpty())
+	{
+		PathEvaluator<DocumentAccess> evaluator(_steps, results, false);
+		evaluator(source);
+	}
+	return results.size();
+}
+
+
+void CompiledQuery::compile()
+{
+	std::string::const_iterator it  = _path.begin();
+	std::string::const_iterator end = _path.end();
+	while (it != end)
+	{
+		std::string::const_iterator start = it;
+		while (it != end && *it != '.' && *it != '[') ++it;
+		std::string name(start, it);
+		if (name == "*")
+		{
+			Step step = { Step::STEP_WILDCARD, "", 0, 0 };
+			_steps.push_back(step);
+		}
+		else if (!name.empty())
+		{
+			Step step = { Step::STEP_KEY, name, 0, 0 };
+			_steps.push_back(step);
+		}
+
+		while (it != end && *it == '[')
+		{
+			start = ++it;
+			while (it != end && *it != ']') ++it;
+			if (it == end) throw SyntaxException("Missing ] in JSON path", _path);
+			std::string subscript(start, it++);
+
+			Step step = { Step::STEP_SLICE, "", 0, std::numeric_limits<int>::max() };
+			std::string::size_type colon = subscript.find(':');
+			if (subscript == "*")
+			{
+			}
+			else if (colon != std::string::npos)
+			{
+				std::string first(subscript, 0, colon);
+				std::string last(subscript, colon + 1);
+				if ((!first.empty() && !NumberParser::tryParse(first, step.start)) ||
+					(!last.empty() && !NumberParser::tryParse(last, step.end)))
+					throw SyntaxException("Invalid slice in JSON path", _path);
+			}
+			else
+			{
+				step.type = Step::STEP_INDEX;
+				if (!NumberParser::tryParse(subscript, step.start))
+					throw SyntaxException("Invalid index in JSON path", _path);
+			}
+			_steps.push_back(step);
+		}
+
+		if (it != end)
+		{
+			if (*it != '.') throw SyntaxException("Expected . in JSON path", _path);
+			++it;
+		}
+	}
+}
+
+
+//
+// QueryBatch
+//
+
+
+QueryBatch::QueryBatch():
+	_nodes(1),
+	_size(0)
+{
+	_nodes[0].step.type  = CompiledQuery::Step::STEP_WILDCARD;
+	_nodes[0].step.start = 0;
+	_nodes[0].step.end   = 0;
+}
+
+
+QueryBatch::~QueryBatch()
+{
+}
+
+
+std::size_t QueryBatch::add(const std::string& path)
+{
+	return add(CompiledQuery(path));
+}
+
+
+std::size_t QueryBatch::add(const CompiledQuery& query)
+{
+	std::size_t node = 0;
+	const CompiledQuery::Steps& steps = query.steps();
+	for (CompiledQuery::Steps::const_iterator it = steps.begin(); it != steps.end(); ++it)
+	{
+		std::size_t child = 0;
+		const std::vector<std::size_t>& children = _nodes[node].children;
+		for (std::vector<std::size_t>::const_iterator itc = children.begin(); itc != children.end(); ++itc)
+		{
+			if (_nodes[*itc].step == *it)
+			{
+				child = *itc;
+				break;
+			}
+		}
+		if (child == 0)
+		{
+			child = _nodes.size();
+			Node newNode;
+			newNode.step = *it;
+			_nodes.push_back(newNode);
+			_nodes[node].children.push_back(child);
+		}
+		node = child;
+	}
+	_nodes[node].paths.push_back(_size);
+	return _size++;
+}
+
+
+void QueryBatch::find(const Var& source, std::vector<Var>& values) const
+{
+	std::vector<std::vector<Var> > all;
+	findAll(source, all);
+	values.assign(_size, Var());
+	for (std::size_t i = 0; i < _size; ++i)
+	{
+		if (!all[i].empty()) values[i] = all[i].front();
+	}
+}
+
+
+void QueryBatch::findAll(const Var& source, std::vector<std::vector<Var> >& values) const
+{
+	values.clear();
+	values.resize(_size);
+	if (isDocument(source))
+	{
+		std::vector<std::vector<DocumentValue> > results;
+		findAll(documentValue(source), results);
+		for (std::size_t i = 0; i < _size; ++i)
+		{
+			for (std::vector<DocumentValue>::const_iterator it = results[i].begin(); it != results[i].end(); ++it)
+			{
+				values[i].push_back(it->toVar());
+			}
+		}
+	}
+	else
+	{
+		std::vector<std::vector<const Var*> > results(_size);
+		BatchEvaluator<VarAccess> evaluator(_nodes, results, false);
+		evaluator(&source);
+		for (std::size_t i = 0; i < _size; ++i)
+		{
+			values[i].reserve(results[i].size());
+			for (std::vector<const Var*>::const_iterator it = results[i].begin(); it != results[i].end(); ++it)
+			{
+				values[i].push_back(**it);
+			}
+		}
+	}
+}
+
+
+void QueryBatch::find(const DocumentValue& source, std::vector<DocumentValue>& values) const
+{
+	std::vector<std::vector<DocumentValue> > results(_size);
+	if (!source.isEmpty())
+	{
+		BatchEvaluator<DocumentAccess> evaluator(_nodes, results, true);
+		evaluator(source);
+	}
+	values.assign(_size, DocumentValue());
+	for (std::size_t i = 0; i < _size; ++i)
+	{
+		if (!results[i].empty()) values[i] = results[i].front();
+	}
+}
+
+
+void QueryBatch::findAll(const DocumentValue& source, std::vector<std::vector<DocumentValue> >& values) const
+{
+	values.clear();
+	values.resize(_size);
+	if (!source.isEmpty())
+	{
+		BatchEvaluator<DocumentAccess> evaluator(_nodes, values, false);
+		evaluator(source);
+	}
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,311 @@
+//
+// Document.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Document
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/Document.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/Exception.h"
+
+
+using Poco::Dynamic::Var;
+
+
+namespace Poco {
+namespace JSON {
+
+
+const UInt32 Document::NO_KEY;
+
+
+//
+// Document
+//
+
+
+Document::Document()
+{
+}
+
+
+Document::~Document()
+{
+}
+
+
+DocumentValue Document::root() const
+{
+	if (_nodes.empty())
+		return DocumentValue();
+	else
+		return DocumentValue(this, 0);
+}
+
+
+std::size_t Document::memoryUsage() const
+{
+	std::size_t usage = _nodes.capacity()*sizeof(Node) + _strings.capacity() + _keys.capacity()*sizeof(const std::string*);
+	for (KeyMap::const_iterator it = _keyMap.begin(); it != _keyMap.end(); ++it)
+	{
+		usage += sizeof(KeyMap::value_type) + it->first.capacity();
+	}
+	return usage;
+}
+
+
+UInt32 Document::intern(const std::string& key)
+{
+	KeyMap::iterator it = _keyMap.find(key);
+	if (it == _keyMap.end())
+	{
+		it = _keyMap.insert(KeyMap::value_type(key, static_cast<UInt32>(_keys.size()))).first;
+		_keys.push_back(&it->first);
+	}
+	return it->second;
+}
+
+
+UInt32 Document::find(const std::string& key) const
+{
+	KeyMap::const_iterator it = _keyMap.find(key);
+	if (it != _keyMap.end())
+		return it->second;
+	else
+		return NO_KEY;
+}
+
+
+Document::Node& Document::add(Type type, UInt32 key)
+{
+	if (_nodes.size() >= NO_KEY) throw JSONException("Document too large");
+
+	Node node;
+	node.type    = static_cast<UInt8>(type);
+	node.key     = key;
+	node.size    = 0;
+	node.next    = static_cast<UInt32>(_nodes.size() + 1);
+	node.value.u = 0;
+	_nodes.push_back(node);
+	return _nodes.back();
+}
+
+
+void Document::addString(const std::string& value, UInt32 key)
+{
+	if (value.size() >= NO_KEY) throw JSONException("String too large");
+
+	Node& node = add(TYPE_STRING, key);
+	node.size    = static_cast<UInt32>(value.size());
+	node.value.u = _strings.size();
+	_strings.append(value);
+}
+
+
+//
+// DocumentValue
+//
+
+
+DocumentValue::DocumentValue():
+	_pDoc(0),
+	_index(0)
+{
+}
+
+
+DocumentValue::DocumentValue(const Document* pDoc, UInt32 index):
+	_pDoc(pDoc),
+	_index(index)
+{
+	poco_assert (!_pDoc || _index < _pDoc->_nodes.size());
+}
+
+
+DocumentValue::~DocumentValue()
+{
+}
+
+
+Document::Type DocumentValue::type() const
+{
+	if (!_pDoc) throw InvalidAccessException("Empty DocumentValue");
+
+	return static_cast<Document::Type>(node().type);
+}
+
+
+std::size_t DocumentValue::size() const
+{
+	if (isObject() || isArray())
+		return node().size;
+	else
+		return 0;
+}
+
+
+std::string DocumentValue::key() const
+{
+	if (_pDoc && node().key != Document::NO_KEY)
+		return *_pDoc->_keys[node().key];
+	else
+		return std::string();
+}
+
+
+DocumentValue DocumentValue::get(const std::string& key) const
+{
+	if (isObject())
+	{
+		UInt32 id = _pDoc->find(key);
+		if (id != Document::NO_KEY)
+		{
+			const Document::Node* pNodes = &_pDoc->_nodes[0];
+			UInt32 end = pNodes[_index].next;
+			for (UInt32 i = _index + 1; i < end; i = pNodes[i].next)
+			{
+				if (pNodes[i].key == id) return DocumentValue(_pDoc, i);
+			}
+		}
+	}
+	return DocumentValue();
+}
+
+
+DocumentValue DocumentValue::get(unsigned int index) const
+{
+	if (isArray() && index < node().size)
+	{
+		const Document::Node* pNodes = &_pDoc->_nodes[0];
+		UInt32 i = _index + 1;
+		// If no element has children, the elements are stored
+		// one after the other and can be indexed directly.
+		if (pNodes[_index].next - i == node().size)
+			return DocumentValue(_pDoc, i + index);
+		while (index-- > 0) i = pNodes[i].next;
+		return DocumentValue(_pDoc, i);
+	}
+	return DocumentValue();
+}
+
+
+void DocumentValue::getNames(std::vector<std::string>& names) const
+{
+	names.clear();
+	if (isObject())
+	{
+		for (ConstIterator it = begin(); it != end(); ++it)
+		{
+			names.push_back(it->key());
+		}
+	}
+}
+
+
+DocumentValue::ConstIterator DocumentValue::begin() const
+{
+	if (isObject() || isArray())
+		return ConstIterator(_pDoc, _index + 1);
+	else
+		return end();
+}
+
+
+DocumentValue::ConstIterator DocumentValue::end() const
+{
+	if (isObject() || isArray())
+		return ConstIterator(_pDoc, node().next);
+	else if (_pDoc)
+		return ConstIterator(_pDoc, _index);
+	else
+		return ConstIterator();
+}
+
+
+Var DocumentValue::toVar() const
+{
+	if (!_pDoc) return Var();
+
+	const Document::Node& n = node();
+	switch (n.type)
+	{
+	case Document::TYPE_NULL:
+		return Var();
+	case Document::TYPE_BOOLEAN:
+		return Var(n.value.i != 0);
+	case Document::TYPE_INT:
+		return Var(static_cast<int>(n.value.i));
+	case Document::TYPE_UNSIGNED:
+		return Var(static_cast<unsigned>(n.value.u));
+	case Document::TYPE_INT64:
+		return Var(n.value.i);
+	case Document::TYPE_UINT64:
+		return Var(n.value.u);
+	case Document::TYPE_DOUBLE:
+		return Var(n.value.d);
+	case Document::TYPE_STRING:
+		return Var(toString());
+	case Document::TYPE_OBJECT:
+		{
+			Object::Ptr pObject = new Object(true);
+			for (ConstIterator it = begin(); it != end(); ++it)
+			{
+				pObject->set(it->key(), it->toVar());
+			}
+			return pObject;
+		}
+	case Document::TYPE_ARRAY:
+		{
+			Array::Ptr pArray = new Array;
+			for (ConstIterator it = begin(); it != end(); ++it)
+			{
+				pArray->add(it->toVar());
+			}
+			return pArray;
+		}
+	default:
+		poco_bugcheck();
+		return Var();
+	}
+}
+
+
+std::string DocumentValue::toString() const
+{
+	if (isString())
+		return std::string(_pDoc->_strings.data() + node().value.u, node().size);
+	else
+		return toVar().convert<std::string>();
+}
+
+
+//
+// DocumentValue::ConstIterator
+//
+
+
+DocumentValue::ConstIterator::ConstIterator()
+{
+}
+
+
+DocumentValue::ConstIterator::ConstIterator(const Document* pDoc, UInt32 index):
+	_value(pDoc, 0)
+{
+	_value._index = index;
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,161 @@
+//
+// DocumentHandler.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  DocumentHandler
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/DocumentHandler.h"
+
+
+using Poco::Dynamic::Var;
+
+
+namespace Poco {
+namespace JSON {
+
+
+DocumentHandler::DocumentHandler(): Handler(),
+	_pDocument(new Document),
+	_key(Document::NO_KEY)
+{
+}
+
+
+DocumentHandler::~DocumentHandler()
+{
+}
+
+
+void DocumentHandler::reset()
+{
+	_pDocument = new Document;
+	_stack.clear();
+	_key = Document::NO_KEY;
+}
+
+
+void DocumentHandler::startObject()
+{
+	start(Document::TYPE_OBJECT);
+}
+
+
+void DocumentHandler::endObject()
+{
+	end();
+}
+
+
+void DocumentHandler::startArray()
+{
+	start(Document::TYPE_ARRAY);
+}
+
+
+void DocumentHandler::endArray()
+{
+	end();
+}
+
+
+void DocumentHandler::key(const std::string& k)
+{
+	_key = _pDocument->intern(k);
+}
+
+
+Var DocumentHandler::asVar() const
+{
+	return _pDocument;
+}
+
+
+void DocumentHandler::value(int v)
+{
+	add(Document::TYPE_INT).value.i = v;
+}
+
+
+void DocumentHandler::value(unsigned v)
+{
+	add(Document::TYPE_UNSIGNED).value.u = v;
+}
+
+
+#if defined(POCO_HAVE_INT64)
+void DocumentHandler::value(Int64 v)
+{
+	add(Document::TYPE_INT64).value.i = v;
+}
+
+
+void DocumentHandler::value(UInt64 v)
+{
+	add(Document::TYPE_UINT64).value.u = v;
+}
+#endif
+
+
+void DocumentHandler::value(const std::string& s)
+{
+	if (!_stack.empty()) ++_pDocument->_nodes[_stack.back()].size;
+	_pDocument->addString(s, _key);
+	_key = Document::NO_KEY;
+}
+
+
+void DocumentHandler::value(double d)
+{
+	add(Document::TYPE_DOUBLE).value.d = d;
+}
+
+
+void DocumentHandler::value(bool b)
+{
+	add(Document::TYPE_BOOLEAN).value.i = b ? 1 : 0;
+}
+
+
+void DocumentHandler::null()
+{
+	add(Document::TYPE_NULL);
+}
+
+
+Document::Node& DocumentHandler::add(Document::Type type)
+{
+	if (!_stack.empty()) ++_pDocument->_nodes[_stack.back()].size;
+	Document::Node& node = _pDocument->add(type, _key);
+	_key = Document::NO_KEY;
+	return node;
+}
+
+
+void DocumentHandler::start(Document::Type type)
+{
+	add(type);
+	_stack.push_back(static_cast<UInt32>(_pDocument->_nodes.size() - 1));
+}
+
+
+void DocumentHandler::end()
+{
+	if (!_stack.empty())
+	{
+		_pDocument->_nodes[_stack.back()].next = static_cast<UInt32>(_pDocument->_nodes.size());
+		_stack.pop_back();
+	}
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,541 @@
+//
+// FastParser.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  FastParser
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/FastParser.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/UTF8Encoding.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#undef min
+#undef max
+#include <limits>
+#include <cstring>
+
+
+#if !defined(POCO_JSON_NO_SIMD)
+	#if defined(__AVX2__)
+		#define POCO_JSON_AVX2
+		#define POCO_JSON_SSE2
+		#include <immintrin.h>
+	#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define POCO_JSON_SSE2
+		#include <emmintrin.h>
+	#endif
+	#if defined(POCO_JSON_SSE2) && defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+#endif
+
+
+namespace Poco {
+namespace JSON {
+
+
+namespace
+{
+	inline bool isBlank(char c)
+	{
+		return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+	}
+
+	inline bool isDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	inline bool isStringSpecial(char c)
+		/// Returns true for the characters that end a run of
+		/// plain characters in a string: the quote, the backslash,
+		/// control characters and the bytes of UTF-8 sequences.
+	{
+		unsigned char u = static_cast<unsigned char>(c);
+		return u == '"' || u == '\\' || u < 0x20 || u >= 0x80;
+	}
+
+#if defined(POCO_JSON_SSE2)
+
+	inline int firstBit(unsigned mask)
+	{
+	#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<int>(index);
+	#else
+		return __builtin_ctz(mask);
+	#endif
+	}
+
+#endif
+
+	const char* findStringSpecial(const char* p, const char* end)
+		/// Returns a pointer to the first special string
+		/// character in [p, end), or end.
+	{
+#if defined(POCO_JSON_AVX2)
+		const __m256i quote32     = _mm256_set1_epi8('"');
+		const __m256i backslash32 = _mm256_set1_epi8('\\');
+		const __m256i space32     = _mm256_set1_epi8(0x20);
+		while (end - p >= 32)
+		{
+			__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			// bytes >= 0x80 are negative, so the signed comparison
+			// catches control characters and UTF-8 bytes at once
+			__m256i special = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), _mm256_cmpeq_epi8(chunk, backslash32)),
+				_mm256_cmpgt_epi8(space32, chunk));
+			unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+			if (mask) return p + firstBit(mask);
+			p += 32;
+		}
+#endif
+#if defined(POCO_JSON_SSE2)
+		const __m128i quote     = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i space     = _mm_set1_epi8(0x20);
+		while (end - p >= 16)
+		{
+			__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			__m128i special = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+				_mm_cmplt_epi8(chunk, space));
+			unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+			if (mask) return p + firstBit(mask);
+			p += 16;
+		}
+#endif
+		while (p < end && !isStringSpecial(*p)) ++p;
+		return p;
+	}
+
+	const char* findNonBlank(const char* p, const char* end)
+		/// Returns a pointer to the first character in [p, end)
+		/// that is not JSON whitespace, or end.
+	{
+#if defined(POCO_JSON_SSE2)
+		const __m128i blank = _mm_set1_epi8(' ');
+		const __m128i tab   = _mm_set1_epi8('\t');
+		const __m128i lf    = _mm_set1_epi8('\n');
+		const __m128i cr    = _mm_set1_epi8('\r');
+		while (end - p >= 16)
+		{
+			__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			__m128i ws = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, blank), _mm_cmpeq_epi8(chunk, tab)),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr)));
+			unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xFFFF;
+			if (mask) return p + firstBit(mask);
+			p += 16;
+		}
+#endif
+		while (p < end && isBlank(*p)) ++p;
+		return p;
+	}
+
+	inline bool isHighSurrogate(unsigned uc)
+	{
+		return (uc & 0xFC00) == 0xD800;
+	}
+
+	inline bool isLowSurrogate(unsigned uc)
+	{
+		return (uc & 0xFC00) == 0xDC00;
+	}
+}
+
+
+FastParser::FastParser(const Handler::Ptr& pHandler):
+	_pHandler(pHandler),
+	_pos(0),
+	_end(0),
+	_depth(-1),
+	_allowComments(false),
+	_allowNullByte(true)
+{
+}
+
+
+FastParser::~FastParser()
+{
+}
+
+
+void FastParser::parse(const char* begin, const char* end)
+{
+	Handler* pHandler = _pHandler.get();
+	_pos = begin;
+	_end = end;
+	_stack.clear();
+
+	skipWhitespace();
+	if (_pos == _end || (*_pos != '{' && *_pos != '[')) syntaxError();
+
+	for (;;)
+	{
+		// a value is expected, and whitespace has been skipped
+		if (_pos == _end) syntaxError();
+		switch (*_pos)
+		{
+		case '{':
+			++_pos;
+			enter('{');
+			if (pHandler) pHandler->startObject();
+			skipWhitespace();
+			if (_pos < _end && *_pos == '}')
+			{
+				++_pos;
+				_stack.pop_back();
+				if (pHandler) pHandler->endObject();
+				break;
+			}
+			parseKey();
+			continue;
+		case '[':
+			++_pos;
+			enter('[');
+			if (pHandler) pHandler->startArray();
+			skipWhitespace();
+			if (_pos < _end && *_pos == ']')
+			{
+				++_pos;
+				_stack.pop_back();
+				if (pHandler) pHandler->endArray();
+				break;
+			}
+			continue;
+		case '"':
+			++_pos;
+			parseString();
+			if (pHandler) pHandler->value(_buffer);
+			break;
+		case 't':
+			parseLiteral("true", 4);
+			if (pHandler) pHandler->value(true);
+			break;
+		case 'f':
+			parseLiteral("false", 5);
+			if (pHandler) pHandler->value(false);
+			break;
+		case 'n':
+			parseLiteral("null", 4);
+			if (pHandler) pHandler->null();
+			break;
+		case '-':
+		case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			parseNumber();
+			break;
+		default:
+			syntaxError();
+		}
+
+		// a value has been parsed; close containers
+		// until the next value is expected
+		for (;;)
+		{
+			skipWhitespace();
+			if (_stack.empty())
+			{
+				if (_pos != _end) syntaxError();
+				return;
+			}
+			if (_pos == _end) syntaxError();
+			char c = *_pos++;
+			if (c == ',')
+			{
+				skipWhitespace();
+				if (_stack.back() == '{') parseKey();
+				break;
+			}
+			else if (c == '}' && _stack.back() == '{')
+			{
+				_stack.pop_back();
+				if (pHandler) pHandler->endObject();
+			}
+			else if (c == ']' && _stack.back() == '[')
+			{
+				_stack.pop_back();
+				if (pHandler) pHandler->endArray();
+			}
+			else syntaxError();
+		}
+	}
+}
+
+
+void FastParser::skipWhitespace()
+{
+	for (;;)
+	{
+		// compact JSON has no more than a single blank between tokens
+		if (_pos < _end && isBlank(*_pos))
+		{
+			++_pos;
+			if (_pos < _end && isBlank(*_pos)) _pos = findNonBlank(_pos, _end);
+		}
+		if (_allowComments && _end - _pos >= 2 && _pos[0] == '/' && _pos[1] == '*')
+		{
+			const char* p = _pos + 2;
+			for (;;)
+			{
+				p = static_cast<const char*>(std::memchr(p, '*', _end - p));
+				if (!p || _end - p < 2) syntaxError();
+				if (p[1] == '/') break;
+				++p;
+			}
+			_pos = p + 2;
+			continue;
+		}
+		return;
+	}
+}
+
+
+void FastParser::parseKey()
+{
+	if (_pos == _end || *_pos != '"') syntaxError();
+	++_pos;
+	parseString();
+	if (_pHandler) _pHandler->key(_buffer);
+	skipWhitespace();
+	if (_pos == _end || *_pos != ':') syntaxError();
+	++_pos;
+	skipWhitespace();
+}
+
+
+void FastParser::parseString()
+{
+	_buffer.clear();
+	for (;;)
+	{
+		const char* p = findStringSpecial(_pos, _end);
+		_buffer.append(_pos, p - _pos);
+		_pos = p;
+		if (_pos == _end) syntaxError();
+		char c = *_pos;
+		if (c == '"')
+		{
+			++_pos;
+			return;
+		}
+		else if (c == '\\')
+			parseEscape();
+		else if (static_cast<unsigned char>(c) >= 0x80)
+			parseUTF8();
+		else
+			syntaxError();
+	}
+}
+
+
+void FastParser::parseEscape()
+{
+	if (_end - _pos < 2) syntaxError();
+	char c = _pos[1];
+	_pos += 2;
+	switch (c)
+	{
+	case '"':  _buffer += '"'; break;
+	case '\\': _buffer += '\\'; break;
+	case '/':  _buffer += '/'; break;
+	case 'b':  _buffer += '\b'; break;
+	case 'f':  _buffer += '\f'; break;
+	case 'n':  _buffer += '\n'; break;
+	case 'r':  _buffer += '\r'; break;
+	case 't':  _buffer += '\t'; break;
+	case 'u':
+		{
+			unsigned uc = parseHex4();
+			if (isHighSurrogate(uc))
+			{
+				if (_end - _pos < 2 || _pos[0] != '\\' || _pos[1] != 'u') syntaxError();
+				_pos += 2;
+				unsigned lo = parseHex4();
+				if (!isLowSurrogate(lo)) syntaxError();
+				uc = ((uc & 0x3FF) << 10) + (lo & 0x3FF) + 0x10000;
+			}
+			else if (isLowSurrogate(uc)) syntaxError();
+			if (uc == 0 && !_allowNullByte) syntaxError();
+
+			unsigned char bytes[4];
+			int n = UTF8Encoding().convert(static_cast<int>(uc), bytes, sizeof(bytes));
+			_buffer.append(reinterpret_cast<const char*>(bytes), n);
+		}
+		break;
+	default:
+		syntaxError();
+	}
+}
+
+
+void FastParser::parseUTF8()
+{
+	unsigned char c = static_cast<unsigned char>(*_pos);
+	int length = 0;
+	if (c >= 0xC2 && c <= 0xDF)
+		length = 2;
+	else if (c >= 0xE0 && c <= 0xEF)
+		length = 3;
+	else if (c >= 0xF0 && c <= 0xF4)
+		length = 4;
+	else
+		throw JSONException("Bad character.");
+
+	if (_end - _pos < length) throw JSONException("Invalid UTF8 sequence found");
+	if (!UTF8Encoding::isLegal(reinterpret_cast<const unsigned char*>(_pos), length))
+		throw JSONException("No legal UTF8 found");
+
+	_buffer.append(_pos, length);
+	_pos += length;
+}
+
+
+unsigned FastParser::parseHex4()
+{
+	if (_end - _pos < 4) syntaxError();
+	unsigned uc = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		char c = *_pos++;
+		uc <<= 4;
+		if (c >= '0' && c <= '9')
+			uc |= c - '0';
+		else if (c >= 'a' && c <= 'f')
+			uc |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			uc |= c - 'A' + 10;
+		else
+			syntaxError();
+	}
+	return uc;
+}
+
+
+void FastParser::parseNumber()
+{
+	const char* start = _pos;
+	const char* p = _pos;
+	bool negative = false;
+	if (*p == '-')
+	{
+		negative = true;
+		if (++p == _end) syntaxError();
+	}
+
+	UInt64 value = 0;
+	bool overflow = false;
+	if (*p == '0')
+	{
+		++p;
+	}
+	else if (*p >= '1' && *p <= '9')
+	{
+		do
+		{
+			unsigned digit = *p++ - '0';
+			if (value > (std::numeric_limits<UInt64>::max() - digit)/10)
+				overflow = true;
+			else
+				value = value*10 + digit;
+		}
+		while (p < _end && isDigit(*p));
+	}
+	else syntaxError();
+
+	bool isFloat = false;
+	if (p < _end && *p == '.')
+	{
+		if (++p == _end || !isDigit(*p)) syntaxError();
+		while (p < _end && isDigit(*p)) ++p;
+		isFloat = true;
+	}
+	if (p < _end && (*p == 'e' || *p == 'E'))
+	{
+		if (++p < _end && (*p == '+' || *p == '-')) ++p;
+		if (p == _end || !isDigit(*p)) syntaxError();
+		while (p < _end && isDigit(*p)) ++p;
+		isFloat = true;
+	}
+	_pos = p;
+
+	Handler* pHandler = _pHandler.get();
+	if (!pHandler) return;
+
+	if (isFloat)
+	{
+		_number.assign(start, p);
+		pHandler->value(NumberParser::parseFloat(_number));
+		return;
+	}
+	// integers are reported with the smallest of the types
+	// int, Int64 and UInt64 that can hold them, as by Parser
+	if (overflow) throw SyntaxException("Number out of range", std::string(start, p));
+#if defined(POCO_HAVE_INT64)
+	if (negative)
+	{
+		if (value > static_cast<UInt64>(std::numeric_limits<Int64>::max()) + 1)
+			throw SyntaxException("Number out of range", std::string(start, p));
+		Int64 v = static_cast<Int64>(0 - value);
+		if (v < std::numeric_limits<int>::min())
+			pHandler->value(v);
+		else
+			pHandler->value(static_cast<int>(v));
+	}
+	else if (value > static_cast<UInt64>(std::numeric_limits<Int64>::max()))
+		pHandler->value(value);
+	else if (value > static_cast<UInt64>(std::numeric_limits<int>::max()))
+		pHandler->value(static_cast<Int64>(value));
+	else
+		pHandler->value(static_cast<int>(value));
+#else
+	if (negative)
+	{
+		if (value > static_cast<UInt64>(std::numeric_limits<int>::max()) + 1)
+			throw SyntaxException("Number out of range", std::string(start, p));
+		pHandler->value(static_cast<int>(0 - static_cast<unsigned>(value)));
+	}
+	else if (value > static_cast<UInt64>(std::numeric_limits<unsigned>::max()))
+		throw SyntaxException("Number out of range", std::string(start, p));
+	else if (value > static_cast<UInt64>(std::numeric_limits<int>::max()))
+		pHandler->value(static_cast<unsigned>(value));
+	else
+		pHandler->value(static_cast<int>(value));
+#endif
+}
+
+
+void FastParser::parseLiteral(const char* literal, std::size_t length)
+{
+	if (static_cast<std::size_t>(_end - _pos) < length || std::memcmp(_pos, literal, length) != 0) syntaxError();
+	_pos += length;
+}
+
+
+void FastParser::enter(char mode)
+{
+	// same limit as Parser, whose stack also holds the top level
+	if (_depth >= 0 && static_cast<int>(_stack.size()) + 1 >= _depth) syntaxError();
+	_stack.push_back(mode);
+}
+
+
+void FastParser::syntaxError()
+{
+	throw SyntaxException("JSON syntax error");
+}
+
+
+} } // namespace Poco::JSON
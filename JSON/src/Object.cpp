@@ -56,6 +56,18 @@ Var Object::get(const std::string& key) const
 }
 
 
+const Var* Object::find(const std::string& key) const
+{
+	ValueMap::const_iterator it = _values.find(key);
+	if (it != _values.end())
+	{
+		return &it->second;
+	}
+
+	return 0;
+}
+
+
 Array::Ptr Object::getArray(const std::string& key) const
 {
 	ValueMap::const_iterator it = _values.find(key);
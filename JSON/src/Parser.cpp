@@ -19,6 +19,7 @@
 #include "Poco/Ascii.h"
 #include "Poco/Token.h"
 #include "Poco/UTF8Encoding.h"
+#include "Poco/StreamCopier.h"
 #undef min
 #undef max
 #include <limits>
@@ -113,7 +114,9 @@ Parser::Parser(const Handler::Ptr& pHandler, std::size_t bufSize) :
 	_parseBuffer(bufSize),
 	_decimalPoint('.'),
 	_allowNullByte(true),
-	_allowComments(false)
+	_allowComments(false),
+	_engine(ENGINE_STATE_MACHINE),
+	_pendingSize(0)
 {
 	_parseBuffer.resize(0);
 	push(MODE_DONE);
@@ -133,6 +136,7 @@ void Parser::reset()
 	_escaped = 0;
 	_utf16HighSurrogate = 0;
 	_top = -1;
+	_pendingSize = 0;
 
 	_stack.clear();
 	_parseBuffer.resize(0);
@@ -143,6 +147,12 @@ void Parser::reset()
 
 Dynamic::Var Parser::parse(const std::string& json)
 {
+	if (_engine == ENGINE_FAST)
+	{
+		parseFast(json.data(), json.data() + json.size());
+		return asVar();
+	}
+
 	std::string::const_iterator it = json.begin();
 	std::string::const_iterator end = json.end();
 	Source<std::string::const_iterator> source(it, end);
@@ -163,6 +173,14 @@ Dynamic::Var Parser::parse(const std::string& json)
 
 Dynamic::Var Parser::parse(std::istream& in)
 {
+	if (_engine == ENGINE_FAST)
+	{
+		std::string json;
+		StreamCopier::copyToString(in, json);
+		parseFast(json.data(), json.data() + json.size());
+		return asVar();
+	}
+
 	std::istreambuf_iterator<char> it(in.rdbuf());
 	std::istreambuf_iterator<char> end;
 	Source<std::istreambuf_iterator<char> > source(it, end);
@@ -180,6 +198,64 @@ Dynamic::Var Parser::parse(std::istream& in)
 }
 
 
+void Parser::feed(const char* data, std::size_t length)
+{
+	const char* end = data + length;
+
+	// complete a UTF-8 sequence that was split between chunks
+	if (_pendingSize > 0)
+	{
+		int count = utf8CheckFirst(_pending[0]);
+		while (_pendingSize < count && data < end) _pending[_pendingSize++] = *data++;
+		if (_pendingSize < count) return;
+
+		Source<const char*> source(_pending + 1, _pending + count);
+		_pendingSize = 0;
+		if (0 == parseChar(_pending[0], source)) throw SyntaxException("JSON syntax error");
+	}
+
+	while (data < end)
+	{
+		int count = 1;
+		if (static_cast<unsigned char>(*data) >= 0x80)
+		{
+			count = utf8CheckFirst(*data);
+			if (count > end - data)
+			{
+				while (data < end) _pending[_pendingSize++] = *data++;
+				return;
+			}
+		}
+
+		Source<const char*> source(data + 1, end);
+		if (0 == parseChar(*data, source)) throw SyntaxException("JSON syntax error");
+		data += count;
+	}
+}
+
+
+Dynamic::Var Parser::finish()
+{
+	if (_pendingSize > 0)
+		throw JSONException("Invalid UTF8 sequence found");
+
+	if (!done())
+		throw JSONException("JSON syntax error");
+
+	return asVar();
+}
+
+
+void Parser::parseFast(const char* begin, const char* end)
+{
+	_fastParser.setHandler(_pHandler);
+	_fastParser.setAllowComments(_allowComments);
+	_fastParser.setAllowNullByte(_allowNullByte);
+	_fastParser.setDepth(_depth);
+	_fastParser.parse(begin, end);
+}
+
+
 bool Parser::push(int mode)
 {
 	_top += 1;
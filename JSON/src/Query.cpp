@@ -34,8 +34,10 @@ Query::Query(const Var& source): _source(source)
 		source.type() != typeid(Object) &&
 		source.type() != typeid(Object::Ptr) &&
 		source.type() != typeid(Array) &&
-		source.type() != typeid(Array::Ptr))
-		throw InvalidArgumentException("Only JSON Object, Array or pointers thereof allowed.");
+		source.type() != typeid(Array::Ptr) &&
+		source.type() != typeid(Document::Ptr) &&
+		source.type() != typeid(DocumentValue))
+		throw InvalidArgumentException("Only JSON Object, Array, Document or pointers thereof allowed.");
 }
 
 
@@ -102,33 +104,18 @@ Array& Query::findArray(const std::string& path, Array& arr) const
 
 Var Query::find(const std::string& path) const
 {
+	if (_source.type() == typeid(Document::Ptr) || _source.type() == typeid(DocumentValue))
+		return findDocumentValue(path).toVar();
+
 	Var result = _source;
 	StringTokenizer tokenizer(path, ".");
 	for(StringTokenizer::Iterator token = tokenizer.begin(); token != tokenizer.end(); token++)
 	{
 		if (!result.isEmpty())
 		{
+			std::string name;
 			std::vector<int> indexes;
-			RegularExpression::MatchVec matches;
-			int firstOffset = -1;
-			int offset = 0;
-			RegularExpression regex("\\[([0-9]+)\\]");
-			while(regex.match(*token, offset, matches) > 0)
-			{
-				if (firstOffset == -1)
-				{
-					firstOffset = static_cast<int>(matches[0].offset);
-				}
-				std::string num = token->substr(matches[1].offset, matches[1].length);
-				indexes.push_back(NumberParser::parse(num));
-				offset = static_cast<int>(matches[0].offset + matches[0].length);
-			}
-
-			std::string name(*token);
-			if (firstOffset != -1)
-			{
-				name = name.substr(0, firstOffset);
-			}
+			parseToken(*token, name, indexes);
 
 			if (name.length() > 0)
 			{
@@ -171,4 +158,55 @@ Var Query::find(const std::string& path) const
 }
 
 
+DocumentValue Query::findDocumentValue(const std::string& path) const
+{
+	DocumentValue result;
+	if (_source.type() == typeid(Document::Ptr))
+		result = _source.extract<Document::Ptr>()->root();
+	else if (_source.type() == typeid(DocumentValue))
+		result = _source.extract<DocumentValue>();
+
+	StringTokenizer tokenizer(path, ".");
+	for(StringTokenizer::Iterator token = tokenizer.begin(); token != tokenizer.end() && !result.isEmpty(); token++)
+	{
+		std::string name;
+		std::vector<int> indexes;
+		parseToken(*token, name, indexes);
+
+		if (name.length() > 0) result = result.get(name);
+
+		for(std::vector<int>::iterator it = indexes.begin(); it != indexes.end() && !result.isEmpty(); ++it)
+		{
+			if (result.isArray()) result = result.get(static_cast<unsigned>(*it));
+		}
+	}
+	return result;
+}
+
+
+void Query::parseToken(const std::string& token, std::string& name, std::vector<int>& indexes)
+{
+	RegularExpression::MatchVec matches;
+	int firstOffset = -1;
+	int offset = 0;
+	RegularExpression regex("\\[([0-9]+)\\]");
+	while(regex.match(token, offset, matches) > 0)
+	{
+		if (firstOffset == -1)
+		{
+			firstOffset = static_cast<int>(matches[0].offset);
+		}
+		std::string num = token.substr(matches[1].offset, matches[1].length);
+		indexes.push_back(NumberParser::parse(num));
+		offset = static_cast<int>(matches[0].offset + matches[0].length);
+	}
+
+	name = token;
+	if (firstOffset != -1)
+	{
+		name = name.substr(0, firstOffset);
+	}
+}
+
+
 } } // Namespace Poco::JSON
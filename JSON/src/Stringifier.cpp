@@ -17,6 +17,7 @@
 #include "Poco/JSON/Stringifier.h"
 #include "Poco/JSON/Array.h"
 #include "Poco/JSON/Object.h"
+#include "Poco/JSON/Document.h"
 #include <iomanip>
 
 
@@ -27,7 +28,91 @@ namespace Poco {
 namespace JSON {
 
 
-void Stringifier::stringify(const Var& any, std::ostream& out, unsigned int indent, int step, bool preserveInsertionOrder)
+namespace
+{
+	class StreamSink
+	{
+	public:
+		StreamSink(std::ostream& out): _out(out)
+		{
+		}
+
+		void put(char c)
+		{
+			_out.put(c);
+		}
+
+		void write(const char* p, std::size_t n)
+		{
+			if (n > 0) _out.write(p, static_cast<std::streamsize>(n));
+		}
+
+	private:
+		std::ostream& _out;
+	};
+
+	class StringSink
+	{
+	public:
+		StringSink(std::string& str): _str(str)
+		{
+		}
+
+		void put(char c)
+		{
+			_str += c;
+		}
+
+		void write(const char* p, std::size_t n)
+		{
+			_str.append(p, n);
+		}
+
+	private:
+		std::string& _str;
+	};
+
+	template <class S>
+	void escape(const char* begin, const char* end, S& sink)
+		/// Writes the quoted string to the sink. Runs of characters
+		/// that need no escaping are written at once.
+	{
+		static const char hex[] = "0123456789abcdef";
+
+		sink.put('"');
+		const char* run = begin;
+		for (const char* it = begin; it != end; ++it)
+		{
+			unsigned char c = static_cast<unsigned char>(*it);
+			if (c >= 0x20 && c != '"' && c != '\\' && c != '/') continue;
+
+			sink.write(run, it - run);
+			run = it + 1;
+			switch (c)
+			{
+				case '\\': sink.write("\\\\", 2); break;
+				case '"': sink.write("\\\"", 2); break;
+				case '/': sink.write("\\/", 2); break;
+				case '\b': sink.write("\\b", 2); break;
+				case '\f': sink.write("\\f", 2); break;
+				case '\n': sink.write("\\n", 2); break;
+				case '\r': sink.write("\\r", 2); break;
+				case '\t': sink.write("\\t", 2); break;
+				default:
+					{
+						char buffer[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F] };
+						sink.write(buffer, sizeof(buffer));
+					}
+					break;
+			}
+		}
+		sink.write(run, end - run);
+		sink.put('"');
+	}
+}
+
+
+void Stringifier::stringify(const Var& any, std::ostream& out, unsigned int indent, int step, bool /*preserveInsertionOrder*/)
 {
 	if (step == -1) step = indent;
 
@@ -51,6 +136,15 @@ void Stringifier::stringify(const Var& any, std::ostream& out, unsigned int inde
 		const Array::Ptr& a = any.extract<Array::Ptr>();
 		a->stringify(out, indent == 0 ? 0 : indent, step);
 	}
+	else if ( any.type() == typeid(Document::Ptr) )
+	{
+		const Document::Ptr& pDoc = any.extract<Document::Ptr>();
+		stringify(pDoc->root(), out, indent, step);
+	}
+	else if ( any.type() == typeid(DocumentValue) )
+	{
+		stringify(any.extract<DocumentValue>(), out, indent, step);
+	}
 	else if ( any.isEmpty() )
 	{
 		out << "null";
@@ -67,26 +161,83 @@ void Stringifier::stringify(const Var& any, std::ostream& out, unsigned int inde
 }
 
 
-void Stringifier::formatString(const std::string& value, std::ostream& out)
+void Stringifier::stringify(const DocumentValue& value, std::ostream& out, unsigned int indent, int step)
 {
-	out << '"';
-	for (std::string::const_iterator it = value.begin(),
-		 end = value.end(); it != end; ++it)
+	if (step == -1) step = indent;
+
+	if (value.isEmpty())
 	{
-		switch (*it)
+		out << "null";
+		return;
+	}
+
+	switch (value.type())
+	{
+	case Document::TYPE_NULL:
+		out << "null";
+		break;
+	case Document::TYPE_BOOLEAN:
+	case Document::TYPE_INT:
+	case Document::TYPE_UNSIGNED:
+	case Document::TYPE_INT64:
+	case Document::TYPE_UINT64:
+	case Document::TYPE_DOUBLE:
+		out << value.convert<std::string>();
+		break;
+	case Document::TYPE_STRING:
+		formatString(value.toString(), out);
+		break;
+	case Document::TYPE_OBJECT:
+	case Document::TYPE_ARRAY:
 		{
-			case '\\': out << "\\\\"; break;
-			case '"': out << "\\\""; break;
-			case '/': out << "\\/"; break;
-			case '\b': out << "\\b"; break;
-			case '\f': out << "\\f"; break;
-			case '\n': out << "\\n"; break;
-			case '\r': out << "\\r"; break;
-			case '\t': out << "\\t"; break;
-			default: out << *it; break;
+			bool isObject = value.isObject();
+			out << (isObject ? '{' : '[');
+			if (indent > 0) out << std::endl;
+
+			DocumentValue::ConstIterator it = value.begin();
+			DocumentValue::ConstIterator end = value.end();
+			while (it != end)
+			{
+				for (unsigned int i = 0; i < indent; i++) out << ' ';
+				if (isObject)
+				{
+					formatString(it->key(), out);
+					out << ((indent > 0) ? " : " : ":");
+				}
+				stringify(*it, out, indent + step, step);
+				bool last = ++it == end;
+				if (!last) out << ',';
+				if (step > 0 && (isObject || !last)) out << std::endl;
+			}
+			if (step > 0 && !isObject) out << std::endl;
+
+			if (indent >= static_cast<unsigned int>(step)) indent -= step;
+			for (unsigned int i = 0; i < indent; i++) out << ' ';
+			out << (isObject ? '}' : ']');
 		}
+		break;
 	}
-	out << '"';
+}
+
+
+void Stringifier::formatString(const std::string& value, std::ostream& out)
+{
+	StreamSink sink(out);
+	escape(value.data(), value.data() + value.size(), sink);
+}
+
+
+void Stringifier::formatString(const std::string& value, std::string& out)
+{
+	StringSink sink(out);
+	escape(value.data(), value.data() + value.size(), sink);
+}
+
+
+void Stringifier::formatString(const char* value, std::size_t length, std::string& out)
+{
+	StringSink sink(out);
+	escape(value, value + length, sink);
 }
 
 
@@ -0,0 +1,282 @@
+//
+// Writer.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Writer
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/Writer.h"
+#include "Poco/JSON/Stringifier.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/NumericString.h"
+#include "Poco/FPEnvironment.h"
+#include <cstring>
+
+
+namespace Poco {
+namespace JSON {
+
+
+Writer::Writer(std::ostream& out, unsigned indent, std::size_t bufferSize):
+	_pOut(&out),
+	_str(_buffer),
+	_bufferSize(bufferSize),
+	_indent(indent),
+	_first(true),
+	_hasKey(false),
+	_complete(false)
+{
+	_buffer.reserve(_bufferSize + POCO_MAX_INT_STRING_LEN);
+}
+
+
+Writer::Writer(std::string& str, unsigned indent):
+	_pOut(0),
+	_str(str),
+	_bufferSize(0),
+	_indent(indent),
+	_first(true),
+	_hasKey(false),
+	_complete(false)
+{
+}
+
+
+Writer::~Writer()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void Writer::startObject()
+{
+	start('o', '{');
+}
+
+
+void Writer::endObject()
+{
+	end('o', '}');
+}
+
+
+void Writer::startArray()
+{
+	start('a', '[');
+}
+
+
+void Writer::endArray()
+{
+	end('a', ']');
+}
+
+
+void Writer::key(const char* k)
+{
+	writeKey(k, std::strlen(k));
+}
+
+
+void Writer::null()
+{
+	beforeValue();
+	writeRaw("null", 4);
+	afterValue();
+}
+
+
+void Writer::value(bool b)
+{
+	beforeValue();
+	if (b)
+		writeRaw("true", 4);
+	else
+		writeRaw("false", 5);
+	afterValue();
+}
+
+
+void Writer::value(int v)
+{
+	value(static_cast<Int64>(v));
+}
+
+
+void Writer::value(unsigned v)
+{
+	value(static_cast<UInt64>(v));
+}
+
+
+void Writer::value(Int64 v)
+{
+	beforeValue();
+	char buffer[POCO_MAX_INT_STRING_LEN];
+	std::size_t size = POCO_MAX_INT_STRING_LEN;
+	intToStr(v, 10, buffer, size);
+	writeRaw(buffer, size);
+	afterValue();
+}
+
+
+void Writer::value(UInt64 v)
+{
+	beforeValue();
+	char buffer[POCO_MAX_INT_STRING_LEN];
+	std::size_t size = POCO_MAX_INT_STRING_LEN;
+	uIntToStr(v, 10, buffer, size);
+	writeRaw(buffer, size);
+	afterValue();
+}
+
+
+void Writer::value(double d)
+{
+	if (FPEnvironment::isInfinite(d) || FPEnvironment::isNaN(d))
+	{
+		null();
+		return;
+	}
+
+	beforeValue();
+	char buffer[POCO_MAX_FLT_STRING_LEN];
+	doubleToStr(buffer, POCO_MAX_FLT_STRING_LEN, d);
+	writeRaw(buffer, std::strlen(buffer));
+	afterValue();
+}
+
+
+void Writer::value(const std::string& s)
+{
+	beforeValue();
+	Stringifier::formatString(s.data(), s.size(), _str);
+	afterValue();
+}
+
+
+void Writer::value(const char* s)
+{
+	beforeValue();
+	Stringifier::formatString(s, std::strlen(s), _str);
+	afterValue();
+}
+
+
+void Writer::flush()
+{
+	if (_pOut)
+	{
+		if (!_buffer.empty())
+		{
+			_pOut->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+			_buffer.clear();
+		}
+		_pOut->flush();
+	}
+}
+
+
+void Writer::reset()
+{
+	_stack.clear();
+	_first    = true;
+	_hasKey   = false;
+	_complete = false;
+}
+
+
+void Writer::beforeValue()
+{
+	if (_stack.empty())
+	{
+		if (_complete) throw JSONException("Only one top-level value can be written");
+	}
+	else if (_stack.back() == 'o')
+	{
+		if (!_hasKey) throw JSONException("Object member written without a key");
+		_hasKey = false;
+	}
+	else
+	{
+		if (!_first) _str += ',';
+		newLine();
+		_first = false;
+	}
+}
+
+
+void Writer::afterValue()
+{
+	if (_stack.empty()) _complete = true;
+	checkFlush();
+}
+
+
+void Writer::start(char type, char bracket)
+{
+	beforeValue();
+	_str += bracket;
+	_stack.push_back(type);
+	_first = true;
+}
+
+
+void Writer::end(char type, char bracket)
+{
+	if (_stack.empty() || _stack.back() != type)
+		throw JSONException(type == 'o' ? "No object to end" : "No array to end");
+	if (_hasKey) throw JSONException("Object member without a value");
+
+	_stack.pop_back();
+	if (!_first) newLine();
+	_str += bracket;
+	_first = false;
+	afterValue();
+}
+
+
+void Writer::newLine()
+{
+	if (_indent > 0)
+	{
+		_str += '\n';
+		_str.append(_stack.size()*_indent, ' ');
+	}
+}
+
+
+void Writer::writeKey(const char* k, std::size_t length)
+{
+	if (_stack.empty() || _stack.back() != 'o') throw JSONException("Key written outside of an object");
+	if (_hasKey) throw JSONException("Object member without a value");
+
+	if (!_first) _str += ',';
+	newLine();
+	_first = false;
+	Stringifier::formatString(k, length, _str);
+	if (_indent > 0)
+		writeRaw(" : ", 3);
+	else
+		_str += ':';
+	_hasKey = true;
+}
+
+
+} } // namespace Poco::JSON
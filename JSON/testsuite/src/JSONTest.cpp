@@ -24,6 +24,9 @@
 #include "Poco/Nullable.h"
 #include "Poco/Dynamic/Struct.h"
 #include <set>
+#include <vector>
+#include <limits>
+#include <algorithm>
 #include <iostream>
 
 
@@ -1710,6 +1713,846 @@ void JSONTest::testSmallBuffer()
 }
 
 
+void JSONTest::testFastParser()
+{
+	std::vector<std::string> docs;
+	docs.push_back("{}");
+	docs.push_back("[]");
+	docs.push_back(" \t\r\n[ 1 , -2, 3.5, -0.25e-3, 1E10, 0, -0 ] \n");
+	docs.push_back("[2147483647, -2147483648, 4294967296, -9223372036854775807, 18446744073709551615]");
+	docs.push_back("{\"a\":true,\"b\":false,\"c\":null,\"d\":[{},[],\"\"],\"e\":{\"f\":{\"g\":[[[1]]]}}}");
+	docs.push_back("[\"\\\"\\\\\\/\\b\\f\\n\\r\\t\", \"\\u0041\\u00e9\\u20AC\\ud834\\udd1e\"]");
+
+	// long strings with escapes and multi-byte characters at
+	// every offset around the 16 and 32 byte block boundaries
+	for (int i = 0; i < 40; ++i)
+	{
+		std::string s(i, 'x');
+		docs.push_back("[\"" + s + "\\n" + s + "\", \"" + s + "\xC3\xA9" + s + "\xE2\x82\xAC\", \"" + s + "\"]");
+		docs.push_back("{\"" + s + "\":" + std::string(i, ' ') + "[" + std::string(i, '\n') + "\"" + s + "\"]}");
+	}
+
+	std::ostringstream pretty;
+	pretty << "{\n";
+	for (int i = 0; i < 100; ++i)
+	{
+		pretty << "    \"key" << i << "\" : [ \"value " << i << "\", " << i*1.5 << ", " << -i << " ],\n";
+	}
+	pretty << "    \"last\" : null\n}\n";
+	docs.push_back(pretty.str());
+
+	for (std::vector<std::string>::const_iterator it = docs.begin(); it != docs.end(); ++it)
+	{
+		std::ostringstream expected;
+		Parser parser(new PrintHandler(expected));
+		parser.parse(*it);
+
+		std::ostringstream actual;
+		Parser fastParser(new PrintHandler(actual));
+		fastParser.setEngine(Parser::ENGINE_FAST);
+		assert (fastParser.getEngine() == Parser::ENGINE_FAST);
+		fastParser.parse(*it);
+		assert (actual.str() == expected.str());
+
+		fastParser.reset();
+		actual.str("");
+		std::istringstream istr(*it);
+		fastParser.parse(istr);
+		assert (actual.str() == expected.str());
+	}
+
+	Parser parser;
+	parser.setEngine(Parser::ENGINE_FAST);
+	Var result = parser.parse("{ \"int\": 42, \"neg\": -42, \"big\": 9223372036854775807, \"ubig\": 18446744073709551615, \"dbl\": 1.5e2 }");
+	Object::Ptr pObject = result.extract<Object::Ptr>();
+	assert (pObject->get("int").type() == typeid(int));
+	assert (pObject->get("int") == 42);
+	assert (pObject->get("neg") == -42);
+	assert (pObject->get("big").type() == typeid(Poco::Int64));
+	assert (pObject->get("ubig").type() == typeid(Poco::UInt64));
+	assert (pObject->get("dbl").type() == typeid(double));
+	assert (pObject->get("dbl") == 150.0);
+
+	parser.reset();
+	parser.setAllowComments(true);
+	result = parser.parse("/* leading */ { /* a */ \"a\" /* b */ : /* c */ [1, /* d */ 2] /**/ } /* trailing */");
+	pObject = result.extract<Object::Ptr>();
+	assert (pObject->getArray("a")->size() == 2);
+
+	parser.reset();
+	parser.setAllowNullByte(true);
+	result = parser.parse("[\"a\\u0000b\"]");
+	assert (result.extract<Poco::JSON::Array::Ptr>()->getElement<std::string>(0) == std::string("a\0b", 3));
+
+	parser.reset();
+	parser.setDepth(3);
+	parser.parse("[[1]]");
+}
+
+
+void JSONTest::testFastParserErrors()
+{
+	const char* invalid[] =
+	{
+		"",
+		"   ",
+		"1",
+		"\"string\"",
+		"{",
+		"[",
+		"[1,]",
+		"[,1]",
+		"{\"a\":1,}",
+		"{\"a\" 1}",
+		"{1:1}",
+		"[01]",
+		"[1.]",
+		"[.5]",
+		"[1e]",
+		"[-]",
+		"[+1]",
+		"[tru]",
+		"[nul]",
+		"[True]",
+		"[\"abc]",
+		"[\"\\x\"]",
+		"[\"\\u12\"]",
+		"[\"a\tb\"]",
+		"[1] 2",
+		"[1]]",
+		"{\"a\":1}}",
+		"[1} ",
+		"/* comment */ [1]"
+	};
+
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		Parser parser;
+		parser.setEngine(Parser::ENGINE_FAST);
+		try
+		{
+			parser.parse(invalid[i]);
+			fail(std::string("invalid JSON - must throw: ") + invalid[i]);
+		}
+		catch (Poco::SyntaxException&)
+		{
+		}
+	}
+
+	Parser parser;
+	parser.setEngine(Parser::ENGINE_FAST);
+	parser.setAllowNullByte(false);
+	try
+	{
+		parser.parse("[\"a\\u0000b\"]");
+		fail("null byte not allowed - must throw");
+	}
+	catch (Poco::SyntaxException&)
+	{
+	}
+
+	parser.reset();
+	parser.setAllowNullByte(true);
+	parser.setDepth(3);
+	try
+	{
+		parser.parse("[[[1]]]");
+		fail("depth exceeded - must throw");
+	}
+	catch (Poco::SyntaxException&)
+	{
+	}
+
+	parser.reset();
+	parser.setDepth(-1);
+	std::string invalidUTF8[] = { "[\"\x92\"]", "[\"\xC2\"]", "[\"\xE2\x82\"]", "[\"\xF5\x80\x80\x80\"]", "[\"\xC0\xAF\"]" };
+	for (std::size_t i = 0; i < sizeof(invalidUTF8)/sizeof(invalidUTF8[0]); ++i)
+	{
+		try
+		{
+			parser.parse(invalidUTF8[i]);
+			fail("invalid UTF-8 - must throw");
+		}
+		catch (JSONException&)
+		{
+		}
+	}
+}
+
+
+void JSONTest::testFastParserJanssonFiles()
+{
+	const char* types[] = { "valid", "invalid", "invalid-unicode" };
+	for (int type = 0; type < 3; ++type)
+	{
+		Poco::Path pathPattern(getTestFilesPath(types[type]));
+
+		std::set<std::string> paths;
+		Poco::Glob::glob(pathPattern, paths);
+
+		for (std::set<std::string>::iterator it = paths.begin(); it != paths.end(); ++it)
+		{
+			Poco::Path filePath(*it, "input");
+			if (!filePath.isFile() || !Poco::File(filePath).exists()) continue;
+
+			Poco::FileInputStream fis(filePath.toString());
+			Parser parser;
+			parser.setEngine(Parser::ENGINE_FAST);
+			parser.setAllowNullByte(type == 0);
+			if (type == 0)
+			{
+				parser.parse(fis);
+				assert (!parser.asVar().isEmpty());
+			}
+			else
+			{
+				try
+				{
+					parser.parse(fis);
+					fail("invalid JSON - must throw: " + filePath.toString());
+				}
+				catch (JSONException&)
+				{
+				}
+				catch (Poco::SyntaxException&)
+				{
+				}
+			}
+		}
+	}
+}
+
+
+void JSONTest::testDocument()
+{
+	std::string json = "{ \"name\" : \"Franky\", \"age\" : 42, \"big\" : 9223372036854775807, \"ubig\" : 18446744073709551615, "
+		"\"height\" : 1.85, \"married\" : true, \"car\" : null, "
+		"\"children\" : [ { \"name\" : \"Jonas\", \"age\" : 10 }, { \"name\" : \"Ellen\", \"age\" : 8 } ], "
+		"\"empty\" : {}, \"none\" : [] }";
+
+	for (int engine = Parser::ENGINE_STATE_MACHINE; engine <= Parser::ENGINE_FAST; ++engine)
+	{
+		Parser parser(new DocumentHandler);
+		parser.setEngine(static_cast<Parser::Engine>(engine));
+		Var result = parser.parse(json);
+		assert (result.type() == typeid(Document::Ptr));
+
+		Document::Ptr pDoc = result.extract<Document::Ptr>();
+		assert (pDoc->nodes() == 17);
+		assert (pDoc->keys() == 10);
+
+		DocumentValue root = pDoc->root();
+		assert (root.isObject());
+		assert (root.size() == 10);
+		assert (root.key().empty());
+
+		assert (root.getValue<std::string>("name") == "Franky");
+		assert (root.get("name").isString());
+		assert (root.get("name").key() == "name");
+		assert (root.getValue<int>("age") == 42);
+		assert (root.get("age").type() == Document::TYPE_INT);
+		assert (root.get("age").toVar().type() == typeid(int));
+		assert (root.getValue<Poco::Int64>("big") == std::numeric_limits<Poco::Int64>::max());
+		assert (root.get("big").toVar().type() == typeid(Poco::Int64));
+		assert (root.getValue<Poco::UInt64>("ubig") == std::numeric_limits<Poco::UInt64>::max());
+		assert (root.get("ubig").toVar().type() == typeid(Poco::UInt64));
+		assert (root.getValue<double>("height") == 1.85);
+		assert (root.get("height").isNumeric());
+		assert (!root.get("height").isInteger());
+		assert (root.getValue<bool>("married"));
+		assert (root.get("married").isBoolean());
+		assert (root.isNull("car"));
+		assert (root.get("car").isNull());
+		assert (root.isNull("nothing"));
+		assert (!root.has("nothing"));
+		assert (root.get("nothing").isEmpty());
+		assert (root.optValue<std::string>("nothing", "default") == "default");
+		assert (root.optValue<int>("car", 7) == 7);
+		assert (root.optValue<int>("age", 7) == 42);
+		assert (root.isObject("empty"));
+		assert (root.get("empty").size() == 0);
+		assert (root.get("empty").begin() == root.get("empty").end());
+		assert (root.isArray("none"));
+		assert (root.get("none").size() == 0);
+		assert (root.get("none").get(0u).isEmpty());
+
+		DocumentValue children = root.get("children");
+		assert (children.isArray());
+		assert (children.size() == 2);
+		assert (children.get(0u).getValue<std::string>("name") == "Jonas");
+		assert (children.get(1u).getValue<int>("age") == 8);
+		assert (children.get(2u).isEmpty());
+		assert (children.get("name").isEmpty());
+		assert (root.get(0u).isEmpty());
+
+		int ages = 0;
+		for (DocumentValue::ConstIterator it = children.begin(); it != children.end(); ++it)
+		{
+			ages += it->getValue<int>("age");
+		}
+		assert (ages == 18);
+
+		std::vector<std::string> names;
+		root.getNames(names);
+		assert (names.size() == 10);
+		assert (names[0] == "name");
+		assert (names[9] == "none");
+
+		Var var = root.toVar();
+		assert (var.type() == typeid(Object::Ptr));
+		Object::Ptr pObject = var.extract<Object::Ptr>();
+		assert (pObject->getArray("children")->getObject(1)->getValue<std::string>("name") == "Ellen");
+		assert (pObject->getValue<double>("height") == 1.85);
+
+		parser.reset();
+		Document::Ptr pFlat = parser.parse("[ 1, \"two\", 3, null ]").extract<Document::Ptr>();
+		DocumentValue flat = pFlat->root();
+		assert (flat.size() == 4);
+		assert (flat.get(0u).convert<int>() == 1);
+		assert (flat.get(1u).convert<std::string>() == "two");
+		assert (flat.get(3u).isNull());
+		assert (flat.get(4u).isEmpty());
+
+		parser.reset();
+		Document::Ptr pNested = parser.parse("[ [ 1, 2 ], 3, { \"a\" : 4 }, 5 ]").extract<Document::Ptr>();
+		DocumentValue nested = pNested->root();
+		assert (nested.size() == 4);
+		assert (nested.get(0u).get(1u).convert<int>() == 2);
+		assert (nested.get(1u).convert<int>() == 3);
+		assert (nested.get(2u).getValue<int>("a") == 4);
+		assert (nested.get(3u).convert<int>() == 5);
+		assert (nested.get(4u).isEmpty());
+
+		try
+		{
+			DocumentValue().type();
+			fail("empty value - must throw");
+		}
+		catch (Poco::InvalidAccessException&)
+		{
+		}
+	}
+}
+
+
+void JSONTest::testDocumentQuery()
+{
+	std::string json = "{ \"name\" : \"Franky\", \"children\" : [ \"Jonas\", \"Ellen\" ], \"address\": { \"street\": \"A Street\", \"number\": 123, \"city\":\"The City\"}, "
+		"\"matrix\" : [ [ 1, 2 ], [ 3, 4 ] ] }";
+	Parser parser(new DocumentHandler);
+	Var result = parser.parse(json);
+
+	Query query(result);
+	assert (query.findValue("children[0]", "") == "Jonas");
+	assert (query.findValue<int>("address.number", 0) == 123);
+	assert (query.findValue<int>("matrix[1][0]", 0) == 3);
+	assert (query.find("address.street.anotherObject").isEmpty());
+	assert (query.find("children[2]").isEmpty());
+
+	Object::Ptr pAddress = query.findObject("address");
+	assert (pAddress->getValue<std::string>("street") == "A Street");
+	assert (query.findObject("bad address").isNull());
+
+	Poco::JSON::Array::Ptr pChildren = query.findArray("children");
+	assert (pChildren->getElement<std::string>(1) == "Ellen");
+
+	DocumentValue street = query.findDocumentValue("address.street");
+	assert (street.isString());
+	assert (street.toString() == "A Street");
+	assert (query.findDocumentValue("address.nothing").isEmpty());
+
+	Query subQuery(query.findDocumentValue("address"));
+	assert (subQuery.findValue("city", "") == "The City");
+
+	Query domQuery(Parser().parse(json));
+	assert (domQuery.findDocumentValue("address").isEmpty());
+}
+
+
+void JSONTest::testDocumentStringify()
+{
+	std::string json = "{ \"Simpsons\" : { \"husband\" : { \"name\" : \"Homer\" , \"age\" : 38 }, \"wife\" : { \"name\" : \"Marge\", \"age\" : 36 }, "
+		"\"children\" : [ \"Bart\", \"Lisa\", \"Maggie\" ], \"address\" : { \"number\" : 742, \"street\" : \"Evergreen \\\"Terrace\\\"\", \"town\" : \"Springfield\" }, "
+		"\"pets\" : [], \"car\" : null, \"rating\" : 9.5, \"cancelled\" : false, \"empty\" : {} } }";
+
+	Parser domParser(new ParseHandler(true));
+	Var dom = domParser.parse(json);
+	Parser docParser(new DocumentHandler);
+	Var doc = docParser.parse(json);
+
+	for (unsigned indent = 0; indent < 5; ++indent)
+	{
+		std::ostringstream expected;
+		Stringifier::stringify(dom, expected, indent);
+		std::ostringstream actual;
+		Stringifier::stringify(doc, actual, indent);
+		assert (actual.str() == expected.str());
+
+		actual.str("");
+		Stringifier::stringify(doc.extract<Document::Ptr>()->root(), actual, indent);
+		assert (actual.str() == expected.str());
+	}
+
+	std::ostringstream ostr;
+	Stringifier::stringify(doc.extract<Document::Ptr>()->root().get("Simpsons").get("children"), ostr);
+	assert (ostr.str() == "[\"Bart\",\"Lisa\",\"Maggie\"]");
+}
+
+
+void JSONTest::testWriter()
+{
+	std::string json = "{ \"name\" : \"Homer \\\"J.\\\" Simpson\", \"age\" : 38, \"income\" : -9223372036854775807, \"savings\" : 18446744073709551615, "
+		"\"height\" : 1.83, \"weight\" : 1e+21, \"bald\" : true, \"hair\" : false, \"car\" : null, "
+		"\"children\" : [ \"Bart\", \"Lisa\", { \"name\" : \"Maggie\", \"toys\" : [ 1, [ 2, 3 ] ] } ], "
+		"\"address\" : { \"number\" : 742, \"street\" : \"Evergreen Terrace\" } }";
+	Var dom = Parser(new ParseHandler(true)).parse(json);
+
+	for (unsigned indent = 0; indent < 4; ++indent)
+	{
+		std::ostringstream ostr;
+		{
+			// a small buffer size forces intermediate writes
+			Writer writer(ostr, indent, 16);
+			writer.startObject();
+			writer.key("name");
+			writer.value("Homer \"J.\" Simpson");
+			writer.key(std::string("age"));
+			writer.value(38);
+			writer.key("income");
+			writer.value(Poco::Int64(-9223372036854775807LL));
+			writer.key("savings");
+			writer.value(std::numeric_limits<Poco::UInt64>::max());
+			writer.key("height");
+			writer.value(1.83);
+			writer.key("weight");
+			writer.value(1e21);
+			writer.key("bald");
+			writer.value(true);
+			writer.key("hair");
+			writer.value(false);
+			writer.key("car");
+			writer.null();
+			writer.key("children");
+			writer.startArray();
+			writer.value(std::string("Bart"));
+			writer.value("Lisa");
+			writer.startObject();
+			writer.key("name");
+			writer.value("Maggie");
+			writer.key("toys");
+			writer.startArray();
+			writer.value(1u);
+			writer.startArray();
+			writer.value(2);
+			writer.value(3);
+			writer.endArray();
+			writer.endArray();
+			writer.endObject();
+			writer.endArray();
+			writer.key("address");
+			writer.startObject();
+			writer.key("number");
+			writer.value(742);
+			writer.key("street");
+			writer.value("Evergreen Terrace");
+			writer.endObject();
+			writer.endObject();
+			assert (writer.complete());
+		}
+
+		std::ostringstream expected;
+		Stringifier::stringify(dom, expected, indent);
+		assert (ostr.str() == expected.str());
+	}
+
+	std::string str("prefix ");
+	Writer writer(str);
+	writer.startArray();
+	writer.startObject();
+	writer.endObject();
+	writer.startArray();
+	writer.endArray();
+	writer.value(std::numeric_limits<double>::infinity());
+	writer.value(0.1);
+	writer.value(-0.5e-10);
+	writer.value("tab\tslash/");
+	writer.endArray();
+	assert (str == "prefix [{},[],null,0.1,-0.00000000005,\"tab\\tslash\\/\"]");
+
+	writer.reset();
+	str.clear();
+	writer.value("top");
+	assert (writer.complete());
+	assert (str == "\"top\"");
+
+	std::ostringstream ostr;
+	Writer pretty(ostr, 2);
+	pretty.startObject();
+	pretty.key("empty");
+	pretty.startArray();
+	pretty.endArray();
+	pretty.endObject();
+	assert (ostr.str().empty());
+	pretty.flush();
+	assert (ostr.str() == "{\n  \"empty\" : []\n}");
+}
+
+
+void JSONTest::testWriterErrors()
+{
+	std::string str;
+	Writer writer(str);
+	writer.startObject();
+	try
+	{
+		writer.value(1);
+		fail("value without key - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	try
+	{
+		writer.endArray();
+		fail("mismatched end - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	writer.key("a");
+	try
+	{
+		writer.key("b");
+		fail("key without value - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	try
+	{
+		writer.endObject();
+		fail("key without value - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	writer.startArray();
+	try
+	{
+		writer.key("c");
+		fail("key in array - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	writer.endArray();
+	writer.endObject();
+	assert (str == "{\"a\":[]}");
+	try
+	{
+		writer.value(1);
+		fail("second top-level value - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	try
+	{
+		writer.endObject();
+		fail("no open object - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+}
+
+
+void JSONTest::testFormatString()
+{
+	std::string value("plain \"quoted\" back\\slash /slash \b\f\n\r\t ctrl\x01\x1f end \xC3\xA9");
+	std::string expected("\"plain \\\"quoted\\\" back\\\\slash \\/slash \\b\\f\\n\\r\\t ctrl\\u0001\\u001f end \xC3\xA9\"");
+
+	std::ostringstream ostr;
+	Stringifier::formatString(value, ostr);
+	assert (ostr.str() == expected);
+
+	std::string str;
+	Stringifier::formatString(value, str);
+	assert (str == expected);
+
+	str = "x";
+	Stringifier::formatString(value.data(), 5, str);
+	assert (str == "x\"plain\"");
+
+	// the escaped string must parse back to the original
+	Var result = Parser().parse("[" + expected + "]");
+	assert (result.extract<Poco::JSON::Array::Ptr>()->getElement<std::string>(0) == value);
+}
+
+
+void JSONTest::testIncremental()
+{
+	std::string json = "{ \"name\" : \"Fr\xC3\xA4nky \xE2\x82\xAC \xF0\xA4\xAD\xA2\", \"escaped\" : \"\\u00e9\\ud834\\udd1e\\n\", "
+		"\"numbers\" : [ 0, -12, 3.25e-2, 9223372036854775807, 18446744073709551615 ], "
+		"\"flags\" : [ true, false, null ], \"nested\" : { \"empty\" : {}, \"none\" : [] } }";
+
+	std::ostringstream expected;
+	Parser(new PrintHandler(expected)).parse(json);
+
+	// split the document at every possible position
+	for (std::size_t chunk = 1; chunk <= json.size(); ++chunk)
+	{
+		std::ostringstream actual;
+		Parser parser(new PrintHandler(actual));
+		for (std::size_t pos = 0; pos < json.size(); pos += chunk)
+		{
+			parser.feed(json.data() + pos, std::min(chunk, json.size() - pos));
+		}
+		parser.finish();
+		assert (actual.str() == expected.str());
+	}
+
+	// handler events are delivered as the data arrives
+	std::ostringstream ostr;
+	Parser parser(new PrintHandler(ostr));
+	parser.feed("[ \"first\", ");
+	assert (ostr.str() == "[\"first\"");
+	parser.feed("\"sec");
+	assert (ostr.str() == "[\"first\"");
+	parser.feed("ond\" ]");
+	assert (ostr.str() == "[\"first\",\"second\"]");
+	parser.finish();
+
+	// many documents can be parsed at the same time
+	Parser first;
+	Parser second;
+	for (std::size_t pos = 0; pos < json.size(); pos += 7)
+	{
+		std::string chunk = json.substr(pos, 7);
+		first.feed(chunk);
+		second.feed(chunk);
+	}
+	Object::Ptr pFirst = first.finish().extract<Object::Ptr>();
+	Object::Ptr pSecond = second.finish().extract<Object::Ptr>();
+	assert (pFirst->getValue<std::string>("name") == "Fr\xC3\xA4nky \xE2\x82\xAC \xF0\xA4\xAD\xA2");
+	assert (pSecond->getArray("numbers")->getElement<double>(2) == 3.25e-2);
+
+	// the parser can be reused after a reset
+	first.reset();
+	first.feed("[1]");
+	assert (first.finish().extract<Poco::JSON::Array::Ptr>()->getElement<int>(0) == 1);
+}
+
+
+void JSONTest::testIncrementalErrors()
+{
+	Parser parser;
+	parser.feed("{ \"a\" : ");
+	try
+	{
+		parser.feed("1 ]");
+		fail("invalid JSON - must throw");
+	}
+	catch (Poco::SyntaxException&)
+	{
+	}
+
+	parser.reset();
+	parser.feed("{ \"a\" : [ 1");
+	try
+	{
+		parser.finish();
+		fail("incomplete JSON - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	parser.reset();
+	parser.feed("[ \"\xE2\x82");
+	try
+	{
+		parser.finish();
+		fail("incomplete UTF-8 sequence - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	parser.reset();
+	parser.feed("[ \"\xE2");
+	try
+	{
+		parser.feed("\x82\x20\"]");
+		fail("invalid UTF-8 sequence - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	parser.reset();
+	try
+	{
+		parser.feed("[ \"\x92\" ]");
+		fail("invalid UTF-8 sequence - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+}
+
+void JSONTest::testCompiledQuery()
+{
+	std::string json = "{ \"store\" : { \"books\" : [ "
+		"{ \"title\" : \"Iliad\", \"author\" : \"Homer\", \"price\" : 10 }, "
+		"{ \"title\" : \"Odyssey\", \"author\" : \"Homer\", \"price\" : 12 }, "
+		"{ \"title\" : \"Aeneid\", \"author\" : \"Virgil\", \"price\" : 8 } ], "
+		"\"owner\" : { \"name\" : \"Franky\" } }, \"matrix\" : [ [ 1, 2 ], [ 3, 4 ] ] }";
+	Var result = Parser().parse(json);
+
+	CompiledQuery title("store.books[1].title");
+	assert (title.isSingular());
+	assert (title.steps().size() == 4);
+	assert (title.find(result).toString() == "Odyssey");
+	assert (title.find(result.extract<Object::Ptr>()).toString() == "Odyssey");
+	assert (CompiledQuery("store.books[-1].title").find(result).toString() == "Aeneid");
+	assert (CompiledQuery("store.books[3].title").find(result).isEmpty());
+	assert (CompiledQuery("store.books[-4]").find(result).isEmpty());
+	assert (CompiledQuery("store.owner[0]").find(result).isEmpty());
+	assert (CompiledQuery("store.nothing.name").find(result).isEmpty());
+	assert (CompiledQuery("matrix[1][0]").findValue<int>(result, 0) == 3);
+	assert (CompiledQuery("store.owner.name").findValue<int>(result, 42) == 42);
+
+	std::vector<Var> values;
+	CompiledQuery titles("store.books[*].title");
+	assert (!titles.isSingular());
+	assert (titles.find(result, values) == 3);
+	assert (values[0] == "Iliad" && values[1] == "Odyssey" && values[2] == "Aeneid");
+	assert (titles.find(result).toString() == "Iliad");
+
+	assert (CompiledQuery("store.books[0:2].title").find(result, values) == 2);
+	assert (values[0] == "Iliad" && values[1] == "Odyssey");
+	assert (CompiledQuery("store.books[-2:].price").find(result, values) == 2);
+	assert (values[0] == 12 && values[1] == 8);
+	assert (CompiledQuery("store.books[:-2].price").find(result, values) == 1);
+	assert (values[0] == 10);
+	assert (CompiledQuery("store.books[2:1]").find(result, values) == 0);
+	assert (CompiledQuery("matrix[*][1]").find(result, values) == 2);
+	assert (values[0] == 2 && values[1] == 4);
+	assert (CompiledQuery("store.*.name").find(result, values) == 1);
+	assert (values[0] == "Franky");
+	assert (CompiledQuery("store.books.*.author").find(result, values) == 3);
+	assert (values[2] == "Virgil");
+
+	assert (CompiledQuery("").find(result, values) == 1);
+	assert (values[0].type() == typeid(Object::Ptr));
+
+	const char* plainPaths[] = { "store.owner.name", "store.books[0].price", "matrix[0][1]", "store.books[5]", "matrix" };
+	Query query(result);
+	for (std::size_t i = 0; i < sizeof(plainPaths)/sizeof(plainPaths[0]); ++i)
+	{
+		Var expected = query.find(plainPaths[i]);
+		Var actual = CompiledQuery(plainPaths[i]).find(result);
+		assert (expected.isEmpty() == actual.isEmpty());
+		if (!expected.isEmpty()) assert (expected.toString() == actual.toString());
+	}
+
+	Parser parser(new DocumentHandler);
+	Var document = parser.parse(json);
+	assert (title.find(document).toString() == "Odyssey");
+	DocumentValue root = document.extract<Document::Ptr>()->root();
+	DocumentValue last = CompiledQuery("store.books[-1]").find(root);
+	assert (last.isObject());
+	assert (last.getValue<std::string>("author") == "Virgil");
+	assert (CompiledQuery("store.books[3]").find(root).isEmpty());
+
+	std::vector<DocumentValue> docValues;
+	assert (CompiledQuery("store.books[1:].price").find(root, docValues) == 2);
+	assert (docValues[0].convert<int>() == 12 && docValues[1].convert<int>() == 8);
+	assert (CompiledQuery("matrix.*[0]").find(root, docValues) == 2);
+	assert (docValues[1].convert<int>() == 3);
+	assert (titles.find(document, values) == 3);
+	assert (values[1] == "Odyssey");
+
+	const char* badPaths[] = { "a[0", "a[x]", "a[1:x]", "a[0]b", "a[]" };
+	for (std::size_t i = 0; i < sizeof(badPaths)/sizeof(badPaths[0]); ++i)
+	{
+		try
+		{
+			CompiledQuery bad(badPaths[i]);
+			fail("malformed path - must throw");
+		}
+		catch (Poco::SyntaxException&)
+		{
+		}
+	}
+}
+
+
+void JSONTest::testQueryBatch()
+{
+	std::string json = "{ \"person\" : { \"name\" : \"Franky\", \"address\" : { \"street\" : \"A Street\", \"city\" : \"The City\" }, "
+		"\"children\" : [ \"Jonas\", \"Ellen\" ] } }";
+
+	QueryBatch batch;
+	std::size_t street = batch.add("person.address.street");
+	std::size_t city = batch.add("person.address.city");
+	std::size_t children = batch.add("person.children[*]");
+	std::size_t missing = batch.add("person.address.zip");
+	std::size_t again = batch.add(CompiledQuery("person.address.city"));
+	assert (batch.size() == 5);
+	assert (street == 0 && city == 1 && children == 2 && missing == 3 && again == 4);
+
+	// root, person, address, street, city, children, [*], zip
+	assert (batch.nodes().size() == 8);
+	assert (batch.nodes()[0].children.size() == 1);
+	assert (batch.nodes()[2].children.size() == 3);
+	assert (batch.nodes()[4].paths.size() == 2);
+
+	Var result = Parser().parse(json);
+	std::vector<Var> values;
+	batch.find(result, values);
+	assert (values.size() == 5);
+	assert (values[street] == "A Street");
+	assert (values[city] == "The City");
+	assert (values[children] == "Jonas");
+	assert (values[missing].isEmpty());
+	assert (values[again] == "The City");
+
+	std::vector<std::vector<Var> > allValues;
+	batch.findAll(result, allValues);
+	assert (allValues.size() == 5);
+	assert (allValues[children].size() == 2);
+	assert (allValues[children][1] == "Ellen");
+	assert (allValues[missing].empty());
+	assert (allValues[street].size() == 1);
+
+	Parser parser(new DocumentHandler);
+	Var document = parser.parse(json);
+	batch.find(document, values);
+	assert (values[street] == "A Street");
+	assert (values[children] == "Jonas");
+	assert (values[missing].isEmpty());
+
+	std::vector<DocumentValue> docValues;
+	DocumentValue root = document.extract<Document::Ptr>()->root();
+	batch.find(root, docValues);
+	assert (docValues.size() == 5);
+	assert (docValues[city].toString() == "The City");
+	assert (docValues[missing].isEmpty());
+
+	std::vector<std::vector<DocumentValue> > allDocValues;
+	batch.findAll(root, allDocValues);
+	assert (allDocValues[children].size() == 2);
+	assert (allDocValues[children][1].toString() == "Ellen");
+
+	QueryBatch empty;
+	empty.find(result, values);
+	assert (values.empty());
+}
+
+
+
 std::string JSONTest::getTestFilesPath(const std::string& type)
 {
 	std::ostringstream ostr;
@@ -1782,6 +2625,19 @@ CppUnit::Test* JSONTest::suite()
 	CppUnit_addTest(pSuite, JSONTest, testTemplate);
 	CppUnit_addTest(pSuite, JSONTest, testUnicode);
 	CppUnit_addTest(pSuite, JSONTest, testSmallBuffer);
+	CppUnit_addTest(pSuite, JSONTest, testFastParser);
+	CppUnit_addTest(pSuite, JSONTest, testFastParserErrors);
+	CppUnit_addTest(pSuite, JSONTest, testFastParserJanssonFiles);
+	CppUnit_addTest(pSuite, JSONTest, testDocument);
+	CppUnit_addTest(pSuite, JSONTest, testDocumentQuery);
+	CppUnit_addTest(pSuite, JSONTest, testDocumentStringify);
+	CppUnit_addTest(pSuite, JSONTest, testWriter);
+	CppUnit_addTest(pSuite, JSONTest, testWriterErrors);
+	CppUnit_addTest(pSuite, JSONTest, testFormatString);
+	CppUnit_addTest(pSuite, JSONTest, testIncremental);
+	CppUnit_addTest(pSuite, JSONTest, testIncrementalErrors);
+	CppUnit_addTest(pSuite, JSONTest, testCompiledQuery);
+	CppUnit_addTest(pSuite, JSONTest, testQueryBatch);
 
 	return pSuite;
 }
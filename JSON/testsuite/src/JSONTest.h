@@ -21,11 +21,15 @@
 #include "Poco/JSON/Object.h"
 #include "Poco/JSON/Parser.h"
 #include "Poco/JSON/Query.h"
+#include "Poco/JSON/CompiledQuery.h"
 #include "Poco/JSON/JSONException.h"
 #include "Poco/JSON/Stringifier.h"
 #include "Poco/JSON/ParseHandler.h"
 #include "Poco/JSON/PrintHandler.h"
 #include "Poco/JSON/Template.h"
+#include "Poco/JSON/Document.h"
+#include "Poco/JSON/DocumentHandler.h"
+#include "Poco/JSON/Writer.h"
 #include <sstream>
 
 
@@ -77,6 +81,19 @@ public:
 	void testUnicode(); 
 	void testInvalidUnicodeJanssonFiles();
 	void testSmallBuffer();
+	void testFastParser();
+	void testFastParserErrors();
+	void testFastParserJanssonFiles();
+	void testDocument();
+	void testDocumentQuery();
+	void testDocumentStringify();
+	void testWriter();
+	void testWriterErrors();
+	void testFormatString();
+	void testIncremental();
+	void testIncrementalErrors();
+	void testCompiledQuery();
+	void testQueryBatch();
 
 	void setUp();
 	void tearDown();
@@ -21,7 +21,7 @@
 
 
 #include "Poco/Net/Net.h"
-#include "Poco/MemoryPool.h"
+#include "Poco/ThreadCachingMemoryPool.h"
 #include <ios>
 
 
@@ -31,6 +31,9 @@ namespace Net {
 
 class Net_API HTTPBufferAllocator
 	/// A BufferAllocator for HTTP streams.
+	///
+	/// The buffers are taken from a ThreadCachingMemoryPool, so that
+	/// connection threads rarely have to wait for each other.
 {
 public:
 	static char* allocate(std::streamsize size);
@@ -42,7 +45,7 @@ public:
 	};
 
 private:
-	static Poco::MemoryPool _pool;
+	static Poco::ThreadCachingMemoryPool _pool;
 };
 
 
@@ -26,6 +26,7 @@
 #include "Poco/SharedPtr.h"
 #include <istream>
 #include <ostream>
+#include <deque>
 
 
 namespace Poco {
@@ -62,6 +63,15 @@ class Net_API HTTPClientSession: public HTTPSession
 	/// Proxies and proxy authorization (only HTTP Basic Authorization)
 	/// is supported. Use setProxy() and setProxyCredentials() to
 	/// set up a session through a proxy.
+	///
+	/// With persistent connections enabled, requests without a
+	/// body can also be pipelined. Pass each request to
+	/// sendPipelinedRequest(), then call receivePipelinedResponse()
+	/// once for every request, in the same order. The requests are
+	/// written to the server back to back, so that a batch only
+	/// costs a single round trip. The number of requests sent
+	/// before their responses have been received is limited by the
+	/// pipeline depth (see setPipelineDepth()).
 {
 public:
 	struct ProxyConfig
@@ -227,6 +237,69 @@ public:
 		/// to ensure a new connection will be set up
 		/// for the next request.
 		
+	void sendPipelinedRequest(HTTPRequest& request);
+		/// Queues the given HTTP request for pipelining.
+		///
+		/// The HTTPClientSession will set the request's Host
+		/// header accordingly. The request must not have a body,
+		/// and persistent connections must be enabled with
+		/// setKeepAlive(true). Otherwise, an InvalidArgumentException
+		/// or IllegalStateException is thrown.
+		///
+		/// Queued requests are sent together, up to the pipeline
+		/// depth, when receivePipelinedResponse() is called for the
+		/// first time.
+		/// More requests can be queued while responses for earlier
+		/// requests are still outstanding.
+		///
+		/// sendRequest() must not be called while responses to
+		/// pipelined requests are outstanding.
+
+	std::istream& receivePipelinedResponse(HTTPResponse& response);
+		/// Sends queued pipelined requests that have not been sent
+		/// yet, up to the pipeline depth, and receives the header of
+		/// the response to the oldest outstanding pipelined request.
+		///
+		/// The returned input stream can be used to read the
+		/// response body, which must be read completely before
+		/// the next response is received.
+		///
+		/// If the connection is closed by the server (e.g., because
+		/// the server's maximum number of requests per connection
+		/// has been reached), or fails before the response header
+		/// has been received, all outstanding requests are sent again
+		/// over a new connection, provided that they all use
+		/// idempotent methods (GET, HEAD, PUT, DELETE, OPTIONS or TRACE).
+		/// Otherwise, all outstanding requests are discarded
+		/// and the exception is propagated to the caller.
+		///
+		/// Throws an IllegalStateException if no pipelined request
+		/// is outstanding.
+
+	std::size_t pipelinedRequests() const;
+		/// Returns the number of pipelined requests for
+		/// which no response has been received yet.
+
+	void setPipelineDepth(int depth);
+		/// Sets the maximum number of pipelined requests that
+		/// are sent to the server before their responses have
+		/// been received. Further requests stay queued and are
+		/// sent by later calls to receivePipelinedResponse(), as
+		/// responses come in.
+		///
+		/// The client does not read responses while it is writing
+		/// requests. If it sent an unbounded number of requests, both
+		/// sides could block in send(), once the server stops reading
+		/// requests because its responses are not being read.
+		/// Therefore the depth should be small enough for the
+		/// requests (and the server for the responses) to fit into
+		/// the socket buffers. The default is 8.
+
+	int getPipelineDepth() const;
+		/// Returns the maximum number of pipelined requests
+		/// sent to the server before their responses have been
+		/// received.
+
 	void reset();
 		/// Resets the session and closes the socket.
 		///
@@ -250,7 +323,8 @@ public:
 protected:
 	enum
 	{
-		DEFAULT_KEEP_ALIVE_TIMEOUT = 8
+		DEFAULT_KEEP_ALIVE_TIMEOUT = 8,
+		DEFAULT_PIPELINE_DEPTH = 8
 	};
 	
 	void reconnect();
@@ -282,7 +356,35 @@ protected:
 		/// Calls proxyConnect() and attaches the resulting StreamSocket
 		/// to the HTTPClientSession.
 
+	void prepareRequest(HTTPRequest& request);
+		/// Sets the Host header and, for requests going through
+		/// a proxy, the request URI prefix and proxy credentials.
+
+	std::istream& createResponseStream(const HTTPResponse& response);
+		/// Creates the input stream for the body of the given response.
+
+	void flushPipeline();
+		/// Sends queued pipelined requests that have not been sent yet,
+		/// up to the pipeline depth, connecting to the server if necessary.
+
+	bool replayPipeline();
+		/// Closes the connection and prepares all outstanding pipelined
+		/// requests for being sent again over a new connection.
+		///
+		/// Returns false, and discards all outstanding requests, if at
+		/// least one of them uses a non-idempotent method.
+
 private:
+	struct PipelinedRequest
+	{
+		std::string data;
+		bool expectResponseBody;
+		bool idempotent;
+	};
+
+	typedef std::deque<PipelinedRequest> Pipeline;
+
+
 	std::string     _host;
 	Poco::UInt16    _port;
 	ProxyConfig     _proxyConfig;
@@ -293,6 +395,9 @@ private:
 	bool            _expectResponseBody;
 	Poco::SharedPtr<std::ostream> _pRequestStream;
 	Poco::SharedPtr<std::istream> _pResponseStream;
+	Pipeline        _pipeline;
+	std::size_t     _pipelineSent;
+	int             _pipelineDepth;
 
 	static ProxyConfig _globalProxyConfig;
 	
@@ -306,6 +411,18 @@ private:
 //
 // inlines
 //
+inline std::size_t HTTPClientSession::pipelinedRequests() const
+{
+	return _pipeline.size();
+}
+
+
+inline int HTTPClientSession::getPipelineDepth() const
+{
+	return _pipelineDepth;
+}
+
+
 inline const std::string& HTTPClientSession::getHost() const
 {
 	return _host;
@@ -0,0 +1,257 @@
+//
+// HTTPClientSessionPool.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/HTTPClientSessionPool.h#1 $
+//
+// Library: Net
+// Package: HTTPClient
+// Module:  HTTPClientSessionPool
+//
+// Definition of the HTTPClientSessionPool class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPClientSessionPool_INCLUDED
+#define Net_HTTPClientSessionPool_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPSessionFactory.h"
+#include "Poco/URI.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Timer.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Mutex.h"
+#include <list>
+#include <map>
+#include <set>
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTPClientSession;
+
+
+class Net_API HTTPClientSessionPool: public Poco::RefCountedObject
+	/// This class implements a pool of persistent HTTP client
+	/// sessions.
+	///
+	/// Sessions are created by a HTTPSessionFactory, so the pool
+	/// supports all protocols for which a HTTPSessionInstantiator
+	/// has been registered with the factory (e.g., HTTPS, with
+	/// HTTPSSessionInstantiator from the NetSSL library). The
+	/// proxy settings of the factory also apply to the sessions
+	/// created by the pool.
+	///
+	/// Sessions are pooled by scheme, host, port and proxy.
+	/// A session obtained with get() must be given back to the
+	/// pool by calling putBack(), after the complete response
+	/// body has been read. If the session is still connected and
+	/// the server agreed to keep the connection alive, the session
+	/// is kept as an idle session, and handed out again by a later
+	/// call to get() for the same scheme, host and port.
+	///
+	/// Before an idle session is handed out, it is checked
+	/// whether its connection is still usable. Idle sessions that
+	/// are no longer connected, or that have been idle for longer
+	/// than the idle time, are evicted from the pool by a timer.
+	///
+	/// Usage example:
+	///
+	///     HTTPClientSessionPool::Ptr pPool = new HTTPClientSessionPool;
+	///     HTTPClientSession* pSession = pPool->get(uri);
+	///     try
+	///     {
+	///         pSession->sendRequest(request);
+	///         std::istream& rs = pSession->receiveResponse(response);
+	///         StreamCopier::copyStream(rs, ostr);
+	///     }
+	///     catch (...)
+	///     {
+	///         pSession->reset();
+	///         pPool->putBack(pSession);
+	///         throw;
+	///     }
+	///     pPool->putBack(pSession);
+{
+public:
+	typedef Poco::AutoPtr<HTTPClientSessionPool> Ptr;
+
+	enum
+	{
+		DEFAULT_MAX_SESSIONS_PER_HOST = 8,
+		DEFAULT_IDLE_TIME = 30
+	};
+
+	HTTPClientSessionPool(int maxSessionsPerHost = DEFAULT_MAX_SESSIONS_PER_HOST, int idleTime = DEFAULT_IDLE_TIME);
+		/// Creates the HTTPClientSessionPool, using the default
+		/// HTTPSessionFactory.
+		///
+		/// At most maxSessionsPerHost sessions (idle and in use)
+		/// are created for a single scheme, host and port.
+		/// Sessions idle for more than idleTime seconds are
+		/// closed and removed from the pool.
+
+	HTTPClientSessionPool(HTTPSessionFactory& factory, int maxSessionsPerHost = DEFAULT_MAX_SESSIONS_PER_HOST, int idleTime = DEFAULT_IDLE_TIME);
+		/// Creates the HTTPClientSessionPool, using the given
+		/// HTTPSessionFactory, which must be valid for the lifetime
+		/// of the pool.
+
+	HTTPClientSession* get(const Poco::URI& uri);
+		/// Returns a session for the given URI's scheme, host and port.
+		///
+		/// If an idle session is available, it is reused. Otherwise,
+		/// a new session is created by the HTTPSessionFactory.
+		/// For the "http" scheme, a plain HTTPClientSession using the
+		/// factory's proxy settings is created if no instantiator has
+		/// been registered with the factory. Other schemes, like "https",
+		/// require a registered instantiator.
+		///
+		/// If the maximum number of sessions for the host has
+		/// been reached, a new session that is not counted against
+		/// the limit is created. Such a session is not kept when
+		/// it is put back, but deleted, and the pool's overflows()
+		/// counter is incremented. New sessions are created without
+		/// holding the pool's lock.
+		///
+		/// Throws a HTTPException if the pool has been shut down.
+
+	void putBack(HTTPClientSession* pSession);
+		/// Gives a session obtained with get() back to the pool.
+		///
+		/// If the session is still connected, has keep-alive
+		/// enabled and the pool has not been shut down, it becomes
+		/// an idle session. Otherwise, it is deleted.
+		///
+		/// The response body of the last request must have been
+		/// read completely. Otherwise, reset() must be called on
+		/// the session before putting it back.
+
+	void shutdown();
+		/// Stops the eviction timer and deletes all idle sessions.
+		/// Sessions still in use are deleted when they are put back.
+
+	int maxSessionsPerHost() const;
+		/// Returns the maximum number of sessions per host.
+
+	int idleTime() const;
+		/// Returns the idle time in seconds.
+
+	int idle() const;
+		/// Returns the number of idle sessions.
+
+	int used() const;
+		/// Returns the number of sessions in use.
+
+	int hits() const;
+		/// Returns the number of calls to get() that
+		/// have been served with an idle session.
+
+	int misses() const;
+		/// Returns the number of calls to get() that
+		/// required a new session to be created.
+
+	int overflows() const;
+		/// Returns the number of calls to get() that
+		/// exceeded the maximum number of sessions for the host
+		/// and have been served with an unpooled session.
+
+	int evictions() const;
+		/// Returns the number of idle sessions that have been
+		/// removed from the pool, either because their idle time
+		/// expired or because their connection was no longer usable.
+
+protected:
+	~HTTPClientSessionPool();
+		/// Destroys the HTTPClientSessionPool.
+
+	void onEvictionTimer(Poco::Timer& timer);
+		/// Evicts expired and disconnected idle sessions.
+
+	static bool usable(HTTPClientSession* pSession);
+		/// Returns true if the connection of the given idle
+		/// session can be used for another request.
+
+	HTTPClientSession* createSession(const Poco::URI& uri);
+		/// Creates a new session for the given URI.
+
+	std::string key(const Poco::URI& uri) const;
+		/// Returns the pool key for the given URI.
+
+	void releaseSlot(const std::string& k);
+		/// Releases a slot reserved by get() for a session
+		/// that could not be created.
+
+private:
+	struct IdleSession
+	{
+		HTTPClientSession* pSession;
+		Poco::Timestamp    lastUsed;
+	};
+
+	typedef std::list<IdleSession> IdleList;
+
+	struct HostEntry
+	{
+		HostEntry():
+			active(0)
+		{
+		}
+
+		IdleList idle;
+		int      active;
+	};
+
+	typedef std::map<std::string, HostEntry> HostMap;
+	typedef std::map<HTTPClientSession*, std::string> ActiveMap;
+	typedef std::set<HTTPClientSession*> SessionSet;
+
+	HTTPClientSessionPool(const HTTPClientSessionPool&);
+	HTTPClientSessionPool& operator = (const HTTPClientSessionPool&);
+
+	void init();
+
+	HTTPSessionFactory& _factory;
+	int                 _maxSessionsPerHost;
+	int                 _idleTime;
+	HostMap             _hosts;
+	ActiveMap           _active;
+	SessionSet          _unpooled;
+	int                 _idle;
+	int                 _hits;
+	int                 _misses;
+	int                 _evictions;
+	int                 _overflows;
+	bool                _shutdown;
+	Poco::Timer         _evictionTimer;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline int HTTPClientSessionPool::maxSessionsPerHost() const
+{
+	return _maxSessionsPerHost;
+}
+
+
+inline int HTTPClientSessionPool::idleTime() const
+{
+	return _idleTime;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPClientSessionPool_INCLUDED
@@ -22,6 +22,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPClientSessionPool.h"
 #include "Poco/UnbufferedStreamBuf.h"
 
 
@@ -38,17 +39,34 @@ public:
 	HTTPResponseStreamBuf(std::istream& istr);
 	
 	~HTTPResponseStreamBuf();
+
+	void setContentLength(Poco::Int64 length);
+		/// Sets the length of the response body, if known.
+
+	bool atEnd() const;
+		/// Returns true if the complete response body has been read,
+		/// either because the end of the stream has been reached, or
+		/// because as many bytes as given to setContentLength() have
+		/// been read. Does not read from the underlying stream.
 		
 private:
 	int readFromDevice();
 	
 	std::istream& _istr;
+	Poco::Int64   _length;
+	Poco::Int64   _count;
+	bool          _eof;
 };
 
 
 inline int HTTPResponseStreamBuf::readFromDevice()
 {
-	return _istr.get();
+	int c = _istr.get();
+	if (c == std::char_traits<char>::eof())
+		_eof = true;
+	else
+		++_count;
+	return c;
 }
 
 
@@ -76,11 +94,26 @@ class Net_API HTTPResponseStream: public HTTPResponseIOS, public std::istream
 {
 public:
 	HTTPResponseStream(std::istream& istr, HTTPClientSession* pSession);
+		/// Creates the HTTPResponseStream, which takes ownership
+		/// of the given session.
+
+	HTTPResponseStream(std::istream& istr, HTTPClientSession* pSession, HTTPClientSessionPool::Ptr pPool, const HTTPResponse& response);
+		/// Creates the HTTPResponseStream for a session obtained
+		/// from the given HTTPClientSessionPool. The session is
+		/// put back into the pool when the stream is destroyed.
+		///
+		/// The session's connection is only kept open if the response
+		/// allows a persistent connection, its body is delimited by
+		/// a Content-Length or chunked transfer encoding, and the body
+		/// has been read completely. Otherwise, the connection is reset
+		/// without reading the rest of the body.
 		
 	~HTTPResponseStream();
 	
 private:
 	HTTPClientSession* _pSession;
+	HTTPClientSessionPool::Ptr _pPool;
+	bool _reusable;
 };
 
 
@@ -0,0 +1,158 @@
+//
+// HTTPKeepAliveReactor.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/HTTPKeepAliveReactor.h#1 $
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPKeepAliveReactor
+//
+// Definition of the HTTPKeepAliveReactor class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPKeepAliveReactor_INCLUDED
+#define Net_HTTPKeepAliveReactor_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/NObserver.h"
+#include "Poco/Thread.h"
+#include "Poco/Timestamp.h"
+#include "Poco/TimingWheel.h"
+#include "Poco/Mutex.h"
+#include "Poco/SharedPtr.h"
+#include <map>
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class TCPServerDispatcher;
+
+
+class Net_API HTTPKeepAliveReactor: public SocketReactor
+	/// HTTPKeepAliveReactor is used by HTTPServer in reactor mode
+	/// (see HTTPServerParams::setReactorMode()) to watch persistent
+	/// connections while they are idle between two requests.
+	///
+	/// Instead of blocking a server thread until the next request
+	/// arrives on a persistent connection, HTTPServerConnection parks
+	/// the connection's socket with the HTTPKeepAliveReactor and
+	/// returns its thread to the pool. As soon as the socket becomes
+	/// readable, the reactor hands it back to a TCPServerDispatcher,
+	/// which creates a new HTTPServerConnection for it on one of its
+	/// worker threads. If the server uses more than one acceptor,
+	/// resumed connections are distributed among the acceptors'
+	/// dispatchers in round-robin fashion.
+	///
+	/// Parked connections on which no request arrives within the
+	/// keep-alive timeout are closed. The keep-alive timeouts are
+	/// kept in a TimingWheel, so expiring them does not require
+	/// scanning all parked connections. Parked connections are
+	/// looked up by socket in a std::map, so parking and resuming
+	/// a connection takes logarithmic time and allocates a small
+	/// bookkeeping object per connection. Connections handed to a
+	/// dispatcher, but not yet picked up by resume() (e.g., because
+	/// the dispatcher refused them), are kept in a second map,
+	/// which expire() scans linearly on every reactor timeout.
+	///
+	/// The HTTPKeepAliveReactor runs in its own thread, which is
+	/// started by the constructor.
+{
+public:
+	typedef Poco::SharedPtr<HTTPKeepAliveReactor> Ptr;
+	typedef std::vector<TCPServerDispatcher*> DispatcherVec;
+
+	HTTPKeepAliveReactor(const DispatcherVec& dispatchers, HTTPServerParams::Ptr pParams);
+		/// Creates the HTTPKeepAliveReactor for the given dispatchers
+		/// and starts the reactor thread.
+		///
+		/// The dispatchers must stay alive until shutdown() has
+		/// been called.
+
+	~HTTPKeepAliveReactor();
+		/// Shuts down and destroys the HTTPKeepAliveReactor.
+
+	void park(const StreamSocket& socket, int maxKeepAliveRequests);
+		/// Parks the given socket until the next request arrives
+		/// on it, or until the keep-alive timeout expires.
+		///
+		/// maxKeepAliveRequests is the remaining number of requests
+		/// allowed on the connection (negative for unlimited), and is
+		/// handed back to the next HTTPServerConnection by resume().
+		///
+		/// If the reactor has already been shut down, the socket is
+		/// closed.
+
+	bool resume(const StreamSocket& socket, int& maxKeepAliveRequests);
+		/// If the given socket has been parked and is now being
+		/// resumed, stores the remaining number of requests given
+		/// to park() in maxKeepAliveRequests and returns true.
+		/// Returns false for a new connection.
+
+	void shutdown();
+		/// Stops the reactor thread and closes all parked connections.
+
+	int parkedConnections() const;
+		/// Returns the number of currently parked connections.
+
+protected:
+	void onTimeout();
+	void onBusy();
+
+	void onReadable(const Poco::AutoPtr<ReadableNotification>& pNf);
+		/// Hands a parked socket back to the dispatcher.
+
+	void expire();
+		/// Closes all parked sockets whose keep-alive timeout has expired.
+
+private:
+	struct ParkedConnection: public Poco::TimingWheel::Entry
+	{
+		StreamSocket socket;
+		int maxKeepAliveRequests;
+	};
+
+	struct ResumedConnection
+	{
+		Poco::Timestamp expires;
+		int maxKeepAliveRequests;
+	};
+
+	typedef std::map<Socket, Poco::SharedPtr<ParkedConnection> > ParkedMap;
+	typedef std::map<Socket, ResumedConnection> ResumedMap;
+
+	HTTPKeepAliveReactor();
+	HTTPKeepAliveReactor(const HTTPKeepAliveReactor&);
+	HTTPKeepAliveReactor& operator = (const HTTPKeepAliveReactor&);
+
+	DispatcherVec        _dispatchers;
+	std::size_t          _nextDispatcher;
+	Poco::Timespan       _keepAliveTimeout;
+	Poco::NObserver<HTTPKeepAliveReactor, ReadableNotification> _readableObserver;
+	Poco::TimingWheel    _expiry;
+	ParkedMap            _parked;
+	ResumedMap           _resumed;
+	Poco::Timestamp      _lastExpire;
+	bool                 _stopped;
+	Poco::Thread         _thread;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPKeepAliveReactor_INCLUDED
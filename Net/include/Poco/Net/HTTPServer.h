@@ -24,6 +24,7 @@
 #include "Poco/Net/TCPServer.h"
 #include "Poco/Net/HTTPRequestHandlerFactory.h"
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPKeepAliveReactor.h"
 
 
 namespace Poco {
@@ -49,6 +50,12 @@ class Net_API HTTPServer: public TCPServer
 	/// Please see the TCPServer class for information about
 	/// connection and thread handling.
 	///
+	/// If reactor mode is enabled in the HTTPServerParams
+	/// (see HTTPServerParams::setReactorMode()), persistent
+	/// connections that are idle between two requests do not
+	/// occupy a thread. Please see the HTTPKeepAliveReactor class
+	/// for more information.
+	///
 	/// See RFC 2616 <http://www.faqs.org/rfcs/rfc2616.html> for more
 	/// information about the HTTP protocol.
 {
@@ -93,9 +100,23 @@ public:
 		/// complete. If abortCurrent is true, the underlying sockets of
 		/// all client connections are shut down, causing all requests
 		/// to abort.
+		///
+		/// In reactor mode, all parked idle connections are closed.
+
+	int parkedConnections() const;
+		/// Returns the number of idle persistent connections
+		/// currently parked with the HTTPKeepAliveReactor.
+		///
+		/// Always returns 0 if reactor mode is not enabled.
+
+protected:
+	void startReactor(HTTPServerParams::Ptr pParams);
+		/// Creates the HTTPKeepAliveReactor if reactor mode is
+		/// enabled in the given HTTPServerParams.
 
 private:
 	HTTPRequestHandlerFactory::Ptr _pFactory;
+	HTTPKeepAliveReactor::Ptr      _pReactor;
 };
 
 
@@ -25,6 +25,7 @@
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPRequestHandlerFactory.h"
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPKeepAliveReactor.h"
 #include "Poco/Mutex.h"
 
 
@@ -43,6 +44,13 @@ public:
 	HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory);
 		/// Creates the HTTPServerConnection.
 
+	HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory, HTTPKeepAliveReactor::Ptr pReactor);
+		/// Creates the HTTPServerConnection for use in reactor mode.
+		///
+		/// Instead of waiting for the next request on a persistent
+		/// connection, run() parks the connection's socket with the
+		/// given HTTPKeepAliveReactor and returns.
+
 	virtual ~HTTPServerConnection();
 		/// Destroys the HTTPServerConnection.
 		
@@ -56,6 +64,7 @@ protected:
 private:
 	HTTPServerParams::Ptr          _pParams;
 	HTTPRequestHandlerFactory::Ptr _pFactory;
+	HTTPKeepAliveReactor::Ptr      _pReactor;
 	bool _stopped;
 	Poco::FastMutex _mutex;
 };
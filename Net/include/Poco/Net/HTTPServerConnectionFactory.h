@@ -24,6 +24,7 @@
 #include "Poco/Net/TCPServerConnectionFactory.h"
 #include "Poco/Net/HTTPRequestHandlerFactory.h"
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPKeepAliveReactor.h"
 
 
 namespace Poco {
@@ -44,10 +45,16 @@ public:
 	TCPServerConnection* createConnection(const StreamSocket& socket);
 		/// Creates an instance of HTTPServerConnection
 		/// using the given StreamSocket.
+
+	void setKeepAliveReactor(HTTPKeepAliveReactor::Ptr pReactor);
+		/// Sets the HTTPKeepAliveReactor that created
+		/// HTTPServerConnection objects use to park idle
+		/// persistent connections in reactor mode.
 	
 private:
 	HTTPServerParams::Ptr          _pParams;
 	HTTPRequestHandlerFactory::Ptr _pFactory;
+	HTTPKeepAliveReactor::Ptr      _pReactor;
 };
 
 
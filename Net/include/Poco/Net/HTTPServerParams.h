@@ -45,6 +45,7 @@ public:
 		///   - keepAlive:            true
 		///   - maxKeepAliveRequests: 0
 		///   - keepAliveTimeout:     10 seconds
+		///   - reactorMode:          false
 		
 	void setServerName(const std::string& serverName);
 		/// Sets the name and port (name:port) that the server uses to identify itself.
@@ -97,6 +98,21 @@ public:
 		/// during a persistent connection, or 0 if
 		/// unlimited connections are allowed.
 
+	void setReactorMode(bool reactorMode);
+		/// Enables (reactorMode == true) or disables (reactorMode == false)
+		/// reactor mode for persistent connections.
+		///
+		/// Normally, a persistent connection occupies a server thread
+		/// while it waits for the next request, until the keep-alive
+		/// timeout expires. In reactor mode, idle persistent connections
+		/// are handed over to a HTTPKeepAliveReactor, and a server thread
+		/// is only assigned again when the next request arrives. The
+		/// number of threads needed then depends on the number of requests
+		/// in progress, rather than on the number of open connections.
+
+	bool getReactorMode() const;
+		/// Returns true iff reactor mode is enabled.
+
 protected:
 	virtual ~HTTPServerParams();
 		/// Destroys the HTTPServerParams.
@@ -108,6 +124,7 @@ private:
 	bool           _keepAlive;
 	int            _maxKeepAliveRequests;
 	Poco::Timespan _keepAliveTimeout;
+	bool           _reactorMode;
 };
 
 
@@ -150,6 +167,12 @@ inline const Poco::Timespan& HTTPServerParams::getKeepAliveTimeout() const
 }
 
 
+inline bool HTTPServerParams::getReactorMode() const
+{
+	return _reactorMode;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -76,7 +76,39 @@ public:
 		///
 		/// Throws a FileNotFoundException if the file
 		/// cannot be found, or an OpenFileException if
-		/// the file cannot be opened.
+		/// the file cannot be opened. If the file becomes
+		/// shorter while it is being sent, a ReadFileException
+		/// is thrown and the connection is closed, as the
+		/// Content-Length has already been sent.
+		
+	virtual void sendFileRange(const std::string& path, const std::string& mediaType);
+		/// Sends the response header to the client, followed
+		/// by the content of the given file, honoring a byte
+		/// range given in the request's Range header.
+		///
+		/// If the request contains a single, satisfiable byte range,
+		/// a 206 Partial Content response containing only the
+		/// requested range is sent. If the range cannot be satisfied,
+		/// a 416 Requested Range Not Satisfiable response without
+		/// body is sent. Otherwise (no Range header, multiple ranges,
+		/// malformed Range header, or an If-Range header not matching
+		/// the file's modification date), the complete file is
+		/// sent, as with sendFile(). The response always contains
+		/// an "Accept-Ranges: bytes" header.
+		///
+		/// Must not be called after send(), sendBuffer() 
+		/// or redirect() has been called.
+		///
+		/// Throws a FileNotFoundException if the file
+		/// cannot be found, or an OpenFileException if
+		/// the file cannot be opened. If the file becomes
+		/// shorter while it is being sent, a ReadFileException
+		/// is thrown and the connection is closed, as the
+		/// Content-Length has already been sent.
+		///
+		/// The default implementation ignores the Range header
+		/// and calls sendFile(). Subclasses that have access to
+		/// the request should override it.
 		
 	virtual void sendBuffer(const void* pBuffer, std::size_t length) = 0;
 		/// Sends the response header to the client, followed
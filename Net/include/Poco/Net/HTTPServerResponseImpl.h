@@ -75,6 +75,31 @@ public:
 		/// Throws a FileNotFoundException if the file
 		/// cannot be found, or an OpenFileException if
 		/// the file cannot be opened.
+		///
+		/// On Linux, the file content is sent with sendfile(),
+		/// unless the connection is secure.
+		
+	void sendFileRange(const std::string& path, const std::string& mediaType);
+		/// Sends the response header to the client, followed
+		/// by the content of the given file, honoring a byte
+		/// range given in the request's Range header.
+		///
+		/// If the request contains a single, satisfiable byte range,
+		/// a 206 Partial Content response containing only the
+		/// requested range is sent. If the range cannot be satisfied,
+		/// a 416 Requested Range Not Satisfiable response without
+		/// body is sent. Otherwise (no Range header, multiple ranges,
+		/// malformed Range header, or an If-Range header not matching
+		/// the file's modification date), the complete file is
+		/// sent, as with sendFile(). The response always contains
+		/// an "Accept-Ranges: bytes" header.
+		///
+		/// Must not be called after send(), sendBuffer() 
+		/// or redirect() has been called.
+		///
+		/// Throws a FileNotFoundException if the file
+		/// cannot be found, or an OpenFileException if
+		/// the file cannot be opened.
 		
 	void sendBuffer(const void* pBuffer, std::size_t length);
 		/// Sends the response header to the client, followed
@@ -110,6 +135,20 @@ public:
 
 protected:
 	void attachRequest(HTTPServerRequestImpl* pRequest);
+
+	void sendFileContent(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length);
+		/// Sends the response header, followed by length bytes
+		/// of the given file, starting at offset.
+
+	enum RangeResult
+	{
+		RANGE_NONE,          /// no usable range; send the complete file
+		RANGE_SATISFIABLE,   /// send the range [first, last]
+		RANGE_UNSATISFIABLE  /// the range lies outside the file
+	};
+
+	static RangeResult parseRange(const std::string& range, Poco::UInt64 length, Poco::UInt64& first, Poco::UInt64& last);
+		/// Parses the value of a Range header containing a single byte range.
 	
 private:
 	HTTPServerSession& _session;
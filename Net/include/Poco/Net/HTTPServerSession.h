@@ -26,6 +26,7 @@
 #include "Poco/Net/HTTPServerSession.h"
 #include "Poco/Net/HTTPServerParams.h"
 #include "Poco/Timespan.h"
+#include "Poco/Arena.h"
 
 
 namespace Poco {
@@ -36,6 +37,12 @@ class Net_API HTTPServerSession: public HTTPSession
 	/// This class handles the server side of a
 	/// HTTP session. It is used internally by
 	/// HTTPServer.
+	///
+	/// The session owns an Arena, which is reset for every
+	/// request. Only the request and response body streams
+	/// are created in the Arena. The request and response
+	/// objects, their header fields and all other strings
+	/// are still allocated from the heap.
 {
 public:
 	HTTPServerSession(const StreamSocket& socket, HTTPServerParams::Ptr pParams);
@@ -46,20 +53,52 @@ public:
 				
 	bool hasMoreRequests();
 		/// Returns true if there are requests available.
+		///
+		/// Also resets the session's arena, so the body
+		/// streams of the previous request must have
+		/// been destroyed.
 	
 	bool canKeepAlive() const;
 		/// Returns true if the session can be kept alive.
+
+	bool idle();
+		/// Returns true if the session is being kept alive,
+		/// but no data for the next request has been buffered yet.
+		/// In this case, hasMoreRequests() would have to wait
+		/// for the next request to arrive.
+		///
+		/// The socket itself is not polled, so that the check does
+		/// not cost a system call per request. Data that has already
+		/// arrived on the socket is reported by the reactor the
+		/// connection is parked with.
+
+	int getMaxKeepAliveRequests() const;
+		/// Returns the remaining number of requests allowed
+		/// on the persistent connection, or a negative
+		/// value if the number of requests is unlimited.
+
+	void setMaxKeepAliveRequests(int maxKeepAliveRequests);
+		/// Sets the remaining number of requests allowed on
+		/// the persistent connection. Used when resuming a
+		/// connection that has been parked with a
+		/// HTTPKeepAliveReactor.
 	
 	SocketAddress clientAddress();
 		/// Returns the client's address.
 		
 	SocketAddress serverAddress();
 		/// Returns the server's address.
+
+	Poco::Arena& arena();
+		/// Returns the Arena in which HTTPServerRequestImpl and
+		/// HTTPServerResponseImpl create the body streams of the
+		/// current request. The Arena is reset by hasMoreRequests().
 		
 private:
 	bool           _firstRequest;
 	Poco::Timespan _keepAliveTimeout;
 	int            _maxKeepAliveRequests;
+	Poco::Arena    _arena;
 };
 
 
@@ -72,6 +111,24 @@ inline bool HTTPServerSession::canKeepAlive() const
 }
 
 
+inline int HTTPServerSession::getMaxKeepAliveRequests() const
+{
+	return _maxKeepAliveRequests;
+}
+
+
+inline void HTTPServerSession::setMaxKeepAliveRequests(int maxKeepAliveRequests)
+{
+	_maxKeepAliveRequests = maxKeepAliveRequests;
+}
+
+
+inline Poco::Arena& HTTPServerSession::arena()
+{
+	return _arena;
+}
+
+
 } } // namespace Poco::Net
 
 
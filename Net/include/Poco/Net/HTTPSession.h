@@ -142,6 +142,10 @@ protected:
 	virtual int write(const char* buffer, std::streamsize length);
 		/// Writes data to the socket.
 
+	Poco::UInt64 sendFile(Poco::FileInputStream& stream, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends count bytes of the given file, starting at offset,
+		/// directly through the socket. See StreamSocket::sendFile().
+
 	int receive(char* buffer, int length);
 		/// Reads up to length bytes.
 		
@@ -190,6 +194,7 @@ private:
 	friend class HTTPHeaderStreamBuf;
 	friend class HTTPFixedLengthStreamBuf;
 	friend class HTTPChunkedStreamBuf;
+	friend class HTTPServerResponseImpl;
 };
 
 
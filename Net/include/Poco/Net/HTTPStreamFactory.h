@@ -22,6 +22,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/HTTPSession.h"
+#include "Poco/Net/HTTPClientSessionPool.h"
 #include "Poco/URIStreamFactory.h"
 
 
@@ -66,7 +67,23 @@ public:
 		/// UnsupportedRedirectException exception is thrown.
 		/// The offending URI can then be obtained via the message()
 		/// method of UnsupportedRedirectException.
+		///
+		/// If a HTTPClientSessionPool has been set, the session
+		/// is obtained from the pool, unless a proxy is used.
 		
+	void setSessionPool(HTTPClientSessionPool::Ptr pPool);
+		/// Sets a HTTPClientSessionPool, from which sessions for
+		/// requests not going through a proxy are obtained.
+		///
+		/// The session is given back to the pool when the
+		/// returned stream is destroyed, so that the connection
+		/// can be reused for subsequent requests to the same host.
+		/// A null pointer (the default) disables pooling.
+
+	HTTPClientSessionPool::Ptr getSessionPool() const;
+		/// Returns the HTTPClientSessionPool, or a null pointer
+		/// if no pool has been set.
+
 	static void registerFactory();
 		/// Registers the HTTPStreamFactory with the
 		/// default URIStreamOpener instance.	
@@ -80,11 +97,14 @@ private:
 	{
 		MAX_REDIRECTS = 10
 	};
+
+	void releaseSession(HTTPClientSession* pSession, bool pooled);
 	
 	std::string  _proxyHost;
 	Poco::UInt16 _proxyPort;
 	std::string  _proxyUsername;
 	std::string  _proxyPassword;
+	HTTPClientSessionPool::Ptr _pPool;
 };
 
 
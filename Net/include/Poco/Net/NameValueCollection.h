@@ -23,6 +23,8 @@
 #include "Poco/Net/Net.h"
 #include "Poco/String.h"
 #include "Poco/ListMap.h"
+#include <list>
+#include <vector>
 #include <cstddef>
 
 
@@ -38,6 +40,15 @@ class Net_API NameValueCollection
 	///
 	/// There can be more than one name-value pair with the 
 	/// same name.
+	///
+	/// The name-value pairs are kept in insertion order, with
+	/// pairs having the same name kept together. Once the
+	/// collection holds more than a few pairs, it builds an
+	/// index, which is a small open-addressing hash table
+	/// keyed by a case-insensitive hash of the name, so that
+	/// lookups no longer have to compare every name in the
+	/// collection. The order of the pairs is not affected by
+	/// the index.
 {
 public:
 	typedef Poco::ListMap<std::string, std::string> HeaderMap;
@@ -109,7 +120,49 @@ public:
 		/// Removes all name-value pairs and their values.
 
 private:
-	HeaderMap _map;
+	typedef std::list<HeaderMap::ValueType> Container;
+
+	struct IndexEntry
+	{
+		IndexEntry():
+			used(false),
+			hash(0)
+		{
+		}
+		
+		bool         used;
+		Poco::UInt32 hash;
+		Iterator     first;
+	};
+
+	typedef std::vector<IndexEntry> Index;
+
+	enum
+	{
+		INDEX_THRESHOLD = 8,
+		MIN_INDEX_SIZE  = 16
+	};
+
+	static Poco::UInt32 hash(const std::string& name);
+		/// Returns the case-insensitive hash value for the given name.
+
+	Iterator lookup(const std::string& name, Poco::UInt32 hash) const;
+		/// Returns the first name-value pair with the given name.
+
+	IndexEntry* lookupEntry(const std::string& name, Poco::UInt32 hash) const;
+		/// Returns the index entry for the given name, or
+		/// the empty entry where it should be inserted.
+
+	void insert(const std::string& name, const std::string& value, Poco::UInt32 hash);
+		/// Inserts a new name-value pair.
+
+	void rebuildIndex();
+		/// Rebuilds the index if the collection is large enough,
+		/// or removes it otherwise.
+
+	Container     _list;
+	mutable Index _index;
+	std::size_t   _indexSize;
 };
 
 
@@ -0,0 +1,193 @@
+//
+// PerMessageDeflate.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/PerMessageDeflate.h#1 $
+//
+// Library: Net
+// Package: WebSocket
+// Module:  PerMessageDeflate
+//
+// Definition of the PerMessageDeflate class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_PerMessageDeflate_INCLUDED
+#define Net_PerMessageDeflate_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/WebSocket.h"
+#include "Poco/Net/SocketImpl.h"
+#include "Poco/Buffer.h"
+#include "Poco/Deflater.h"
+#include "Poco/Inflater.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class MessageHeader;
+
+
+class Net_API PerMessageDeflate
+	/// This class implements the permessage-deflate WebSocket
+	/// extension specified in RFC 7692.
+	///
+	/// A PerMessageDeflate object holds the deflate (sending) and
+	/// inflate (receiving) zlib streams of a single WebSocket
+	/// connection. Unless "no context takeover" has been
+	/// negotiated for a direction, the LZ77 sliding window is kept
+	/// from one message to the next, which greatly improves the
+	/// compression of small, similar messages.
+	///
+	/// The static member functions offer(), accept() and complete()
+	/// implement the extension negotiation with the
+	/// Sec-WebSocket-Extensions header.
+	///
+	/// This class is used internally by WebSocket and WebSocketImpl
+	/// and should not be used directly.
+{
+public:
+	PerMessageDeflate(int level, int deflateWindowBits, bool deflateNoContextTakeover, bool inflateNoContextTakeover);
+		/// Creates the PerMessageDeflate, using the given compression
+		/// level and LZ77 window size (9 - 15) for compressing
+		/// outgoing messages.
+		///
+		/// If deflateNoContextTakeover is true, the compressor is reset
+		/// after every message. If inflateNoContextTakeover is true, the
+		/// decompressor is reset after every message.
+
+	~PerMessageDeflate();
+		/// Destroys the PerMessageDeflate.
+
+	const Poco::Buffer<char>& deflate(const SocketBufVec& buffers, bool fin);
+		/// Compresses the payload of a message frame gathered from the
+		/// given buffers and returns the compressed payload.
+		///
+		/// If fin is true, the frame is the last frame of the message,
+		/// and the trailing empty deflate block is removed from the
+		/// compressed payload.
+		///
+		/// The returned buffer is valid until the next call to deflate().
+
+	char* inflateBuffer(int length);
+		/// Returns a buffer for at least length bytes of compressed
+		/// payload, to be passed to inflate().
+
+	int inflate(const char* data, int length, bool fin, char* buffer, int bufferLength);
+		/// Decompresses length bytes of the compressed payload of a
+		/// message frame and stores up to bufferLength bytes of
+		/// decompressed payload in buffer.
+		///
+		/// If fin is true, the frame is the last frame of the message.
+		///
+		/// Returns the number of bytes stored in buffer.
+		/// Throws a WebSocketException if the decompressed payload
+		/// does not fit into buffer, or if the compressed payload
+		/// is invalid.
+
+	Poco::UInt64 bytesDeflated() const;
+		/// Returns the total number of payload bytes passed to deflate().
+
+	Poco::UInt64 compressedBytesDeflated() const;
+		/// Returns the total number of compressed payload bytes returned
+		/// by deflate().
+
+	Poco::UInt64 bytesInflated() const;
+		/// Returns the total number of decompressed payload bytes
+		/// returned by inflate().
+
+	Poco::UInt64 compressedBytesInflated() const;
+		/// Returns the total number of compressed payload bytes
+		/// passed to inflate().
+
+	static std::string offer(const WebSocket::DeflateConfig& config);
+		/// Returns the extension offer for the Sec-WebSocket-Extensions
+		/// header of a client handshake request.
+
+	static PerMessageDeflate* accept(const MessageHeader& request, const WebSocket::DeflateConfig& config, std::string& response);
+		/// Examines the extension offers in the Sec-WebSocket-Extensions
+		/// headers of the given server handshake request, and accepts
+		/// the first valid permessage-deflate offer.
+		///
+		/// If an offer has been accepted, returns a new PerMessageDeflate
+		/// and stores the extension response for the Sec-WebSocket-Extensions
+		/// header of the handshake response in response. Otherwise,
+		/// returns null.
+
+	static PerMessageDeflate* complete(const MessageHeader& response, const WebSocket::DeflateConfig& config);
+		/// Examines the Sec-WebSocket-Extensions header of a client
+		/// handshake response for a request created with offer().
+		///
+		/// Returns a new PerMessageDeflate if the server has accepted
+		/// the offer, or null if the server has declined it.
+		/// Throws a WebSocketException if the extension response
+		/// is not valid.
+
+	static const std::string EXTENSION_NAME;
+		/// The extension name (permessage-deflate).
+
+private:
+	PerMessageDeflate();
+	PerMessageDeflate(const PerMessageDeflate&);
+	PerMessageDeflate& operator = (const PerMessageDeflate&);
+
+	void inflateInput(const char* data, int length, char* buffer, std::size_t bufferLength, std::size_t& used);
+
+	enum
+	{
+		MIN_WINDOW_BITS = 9,
+		MAX_WINDOW_BITS = 15,
+		DEFLATE_BUFFER_SIZE = 4096
+	};
+
+	Poco::Deflater     _deflater;
+	Poco::Inflater     _inflater;
+	bool               _deflateNoContextTakeover;
+	bool               _inflateNoContextTakeover;
+	Poco::Buffer<char> _deflateBuffer;
+	Poco::Buffer<char> _inflateBuffer;
+	Poco::UInt64       _bytesDeflated;
+	Poco::UInt64       _compressedBytesDeflated;
+	Poco::UInt64       _bytesInflated;
+	Poco::UInt64       _compressedBytesInflated;
+};
+
+
+//
+// inlines
+//
+inline Poco::UInt64 PerMessageDeflate::bytesDeflated() const
+{
+	return _bytesDeflated;
+}
+
+
+inline Poco::UInt64 PerMessageDeflate::compressedBytesDeflated() const
+{
+	return _compressedBytesDeflated;
+}
+
+
+inline Poco::UInt64 PerMessageDeflate::bytesInflated() const
+{
+	return _bytesInflated;
+}
+
+
+inline Poco::UInt64 PerMessageDeflate::compressedBytesInflated() const
+{
+	return _compressedBytesInflated;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_PerMessageDeflate_INCLUDED
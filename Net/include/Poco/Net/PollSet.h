@@ -0,0 +1,119 @@
+//
+// PollSet.h
+//
+// $Id: //poco/1.4/Net/include/Poco/Net/PollSet.h#1 $
+//
+// Library: Net
+// Package: Sockets
+// Module:  PollSet
+//
+// Definition of the PollSet class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_PollSet_INCLUDED
+#define Net_PollSet_INCLUDED
+
+
+#include "Poco/Net/Socket.h"
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class PollSetImpl;
+
+
+class Net_API PollSet
+	/// A set of sockets that can be efficiently polled as a whole.
+	///
+	/// In contrast to Socket::select(), which has to pass the
+	/// complete set of sockets to the operating system on every
+	/// call, a PollSet keeps its interest set alive between calls
+	/// to poll(). Sockets are registered once with add(), their
+	/// interest mask can be changed with update(), and they are
+	/// deregistered with remove(). poll() only returns the sockets
+	/// that are actually ready.
+	///
+	/// If supported, PollSet is implemented using epoll (Linux,
+	/// enabled with POCO_HAVE_FD_EPOLL). Otherwise, it falls back
+	/// to Socket::select(), which will use poll() or select(),
+	/// depending on the platform.
+	///
+	/// All member functions are thread safe. In particular, it is
+	/// safe to add(), update() or remove() sockets from another
+	/// thread while poll() is in progress.
+{
+public:
+	enum Mode
+	{
+		POLL_READ  = Socket::SELECT_READ,
+		POLL_WRITE = Socket::SELECT_WRITE,
+		POLL_ERROR = Socket::SELECT_ERROR
+	};
+
+	typedef std::map<Poco::Net::Socket, int> SocketModeMap;
+
+	PollSet();
+		/// Creates an empty PollSet.
+
+	~PollSet();
+		/// Destroys the PollSet.
+
+	void add(const Poco::Net::Socket& socket, int mode);
+		/// Adds the given socket to the set, for polling with
+		/// the given mode, which can be an OR'd combination of
+		/// POLL_READ, POLL_WRITE and POLL_ERROR.
+		///
+		/// If the socket is already in the set, its mode
+		/// is replaced with the given one.
+
+	void remove(const Poco::Net::Socket& socket);
+		/// Removes the given socket from the set.
+		/// Does nothing if the socket is not in the set.
+
+	void update(const Poco::Net::Socket& socket, int mode);
+		/// Updates the mode of the given socket. If mode is 0,
+		/// the socket is removed from the set. If the socket
+		/// is not in the set, it is added.
+
+	bool has(const Poco::Net::Socket& socket) const;
+		/// Returns true if the given socket is in the set.
+
+	bool empty() const;
+		/// Returns true if the set contains no sockets.
+
+	std::size_t count() const;
+		/// Returns the number of sockets in the set.
+
+	void clear();
+		/// Removes all sockets from the set.
+
+	SocketModeMap poll(const Poco::Timespan& timeout);
+		/// Waits until the state of at least one of the sockets
+		/// in the set changes accordingly to its mode, or until
+		/// the timeout expires.
+		///
+		/// Returns a map containing the ready sockets, together
+		/// with their ready modes. The map is empty if the timeout
+		/// expired or if the set is empty.
+
+private:
+	PollSetImpl* _pImpl;
+
+	PollSet(const PollSet&);
+	PollSet& operator = (const PollSet&);
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_PollSet_INCLUDED
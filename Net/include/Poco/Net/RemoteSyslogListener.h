@@ -25,6 +25,8 @@
 #include "Poco/ThreadPool.h"
 #include "Poco/SplitterChannel.h"
 #include "Poco/NotificationQueue.h"
+#include "Poco/BoundedNotificationQueue.h"
+#include "Poco/AtomicCounter.h"
 
 
 namespace Poco {
@@ -52,6 +54,12 @@ class Net_API RemoteSyslogListener: public Poco::SplitterChannel
 	///   - addr: IP address of the host/interface sending the message.
 	///   - host: host name; only for "new" syslog messages.
 	///   - app:  application name; only for "new" syslog messages.
+	///
+	/// Received messages are queued for the parser threads. By
+	/// default, the queue is unbounded. If a queue size is set,
+	/// a BoundedNotificationQueue is used instead, and messages
+	/// received while the queue is full are dropped and counted
+	/// (see droppedMessages()).
 {
 public:
 	RemoteSyslogListener();
@@ -74,6 +82,11 @@ public:
 		///     * threads: The number of parser threads processing
 		///       received syslog messages. Defaults to 1. A maximum
 		///       of 16 threads is supported.
+		///     * queueSize: The maximum number of received messages
+		///       waiting for a parser thread. The value "none" or 0
+		///       (default) selects an unbounded queue. Can only be
+		///       changed while the listener is closed; otherwise, an
+		///       IllegalStateException is thrown.
 		
 	std::string getProperty(const std::string& name) const;
 		/// Returns the value of the property with the given name.
@@ -91,12 +104,20 @@ public:
 	void enqueueMessage(const std::string& messageText, const Poco::Net::SocketAddress& senderAddress);
 		/// Enqueues a single line of text containing a syslog message
 		/// for asynchronous processing by a parser thread.
+		///
+		/// If the queue is bounded and full, waits until there
+		/// is room.
+
+	int droppedMessages() const;
+		/// Returns the number of received UDP messages that have
+		/// been dropped because the bounded queue was full.
 
 	static void registerChannel();
 		/// Registers the channel with the global LoggingFactory.
 
 	static const std::string PROP_PORT;
 	static const std::string PROP_THREADS;
+	static const std::string PROP_QUEUE_SIZE;
 
     static const std::string LOG_PROP_APP;
     static const std::string LOG_PROP_HOST;
@@ -106,12 +127,21 @@ protected:
 		/// Destroys the RemoteSyslogListener.
 
 private:
-	RemoteUDPListener*      _pListener;
-	SyslogParser*           _pParser;
-	Poco::ThreadPool        _threadPool;
-	Poco::NotificationQueue _queue;
-	Poco::UInt16            _port;
-	int                     _threads;
+	void setQueueSize(const std::string& value);
+	bool tryEnqueue(Poco::Notification* pNotification);
+	Poco::Notification* waitDequeue(long milliseconds);
+
+	RemoteUDPListener*              _pListener;
+	SyslogParser*                   _pParser;
+	Poco::ThreadPool                _threadPool;
+	Poco::NotificationQueue         _queue;
+	Poco::BoundedNotificationQueue* _pBoundedQueue;
+	Poco::AtomicCounter             _droppedMessages;
+	Poco::UInt16                    _port;
+	int                             _threads;
+
+	friend class RemoteUDPListener;
+	friend class SyslogParser;
 };
 
 
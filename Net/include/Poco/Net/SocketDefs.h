@@ -134,6 +134,7 @@
 	#include <errno.h>
 	#include <sys/types.h>
 	#include <sys/socket.h>
+	#include <sys/uio.h>
 	#include <fcntl.h>
 	#if POCO_OS != POCO_OS_HPUX
 		#include <sys/select.h>
@@ -25,12 +25,50 @@
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/Timespan.h"
+#include <vector>
 
 
 namespace Poco {
+
+
+class FileInputStream;
+
+
 namespace Net {
 
 
+//
+// SocketBuf is a buffer descriptor for scatter/gather I/O
+// (struct iovec on POSIX platforms, WSABUF on Windows).
+// Use makeSocketBuf() to create a SocketBuf.
+//
+#if defined(POCO_OS_FAMILY_WINDOWS)
+typedef WSABUF SocketBuf;
+#elif defined(POCO_OS_FAMILY_UNIX) || defined(POCO_OS_FAMILY_VMS)
+typedef struct iovec SocketBuf;
+#else
+struct SocketBuf
+{
+	void*       iov_base;
+	std::size_t iov_len;
+};
+#endif
+
+typedef std::vector<SocketBuf> SocketBufVec;
+
+
+SocketBuf makeSocketBuf(const void* buffer, std::size_t length);
+	/// Returns a SocketBuf for the given buffer and length.
+
+
+const char* socketBufData(const SocketBuf& buf);
+	/// Returns a pointer to the data of the given SocketBuf.
+
+
+std::size_t socketBufLength(const SocketBuf& buf);
+	/// Returns the length of the given SocketBuf.
+
+
 class Net_API SocketImpl: public Poco::RefCountedObject
 	/// This class encapsulates the Berkeley sockets API.
 	/// 
@@ -136,6 +174,32 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 	
+	virtual int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket.
+		///
+		/// For sockets that are not secure, all buffers are sent
+		/// with a single gathering system call (sendmsg() or
+		/// WSASend()), without copying them into a single buffer
+		/// first. Otherwise, the buffers are sent one after another
+		/// with sendBytes().
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+
+	Poco::UInt64 sendFile(Poco::FileInputStream& stream, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends count bytes of the given file, starting at the given
+		/// offset, through the socket. The socket must be in blocking
+		/// mode.
+		///
+		/// On Linux, for sockets that are not secure, the file is sent
+		/// with sendfile(), without copying its contents through user
+		/// space. Otherwise, the file is read in chunks and sent with
+		/// sendBytes().
+		///
+		/// Returns the number of bytes sent, which is less than count
+		/// only if the end of the file has been reached.
+
 	virtual int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
@@ -429,12 +493,47 @@ private:
 	
 	friend class Socket;
 	friend class SecureSocketImpl;
+	friend class PollSetImpl;
 };
 
 
 //
 // inlines
 //
+inline SocketBuf makeSocketBuf(const void* buffer, std::size_t length)
+{
+	SocketBuf buf;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	buf.buf = reinterpret_cast<char*>(const_cast<void*>(buffer));
+	buf.len = static_cast<ULONG>(length);
+#else
+	buf.iov_base = const_cast<void*>(buffer);
+	buf.iov_len  = length;
+#endif
+	return buf;
+}
+
+
+inline const char* socketBufData(const SocketBuf& buf)
+{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	return buf.buf;
+#else
+	return reinterpret_cast<const char*>(buf.iov_base);
+#endif
+}
+
+
+inline std::size_t socketBufLength(const SocketBuf& buf)
+{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	return buf.len;
+#else
+	return buf.iov_len;
+#endif
+}
+
+
 inline poco_socket_t SocketImpl::sockfd() const
 {
 	return _sockfd;
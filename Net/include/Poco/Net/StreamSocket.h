@@ -122,6 +122,27 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket, using a single gathering system call
+		/// if the socket is not secure.
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers for a
+		/// non-blocking socket.
+
+	Poco::UInt64 sendFile(Poco::FileInputStream& stream, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends count bytes of the given file, starting at the given
+		/// offset, through the socket. The socket must be in blocking
+		/// mode.
+		///
+		/// If supported by the platform (currently Linux) and the
+		/// socket is not secure, the file is sent with sendfile(),
+		/// without copying its contents through user space.
+		///
+		/// Returns the number of bytes sent, which is less than count
+		/// only if the end of the file has been reached.
+
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
@@ -50,6 +50,14 @@ public:
 		/// Returns the number of bytes sent. The return value may also be
 		/// negative to denote some special condition.
 
+	virtual int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Ensures that all data in buffers is sent if the socket
+		/// is blocking. In case of a non-blocking socket, sends as
+		/// many bytes as possible.
+		///
+		/// Returns the number of bytes sent. The return value may also be
+		/// negative to denote some special condition.
+
 protected:
 	virtual ~StreamSocketImpl();
 };
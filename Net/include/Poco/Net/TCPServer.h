@@ -27,6 +27,8 @@
 #include "Poco/Runnable.h"
 #include "Poco/Thread.h"
 #include "Poco/ThreadPool.h"
+#include "Poco/TaskExecutor.h"
+#include <vector>
 
 
 namespace Poco {
@@ -76,6 +78,28 @@ class Net_API TCPServer: public Poco::Runnable
 	/// After calling stop(), no new connections will be accepted and
 	/// all queued connections will be discarded.
 	/// Already served connections, however, will continue being served.
+	///
+	/// On a machine with many cores, a single accept thread and the
+	/// connection queue shared by all connection threads can become
+	/// a bottleneck under a high rate of incoming connections.
+	/// If TCPServerParams::setAcceptors() is used to specify more than
+	/// one acceptor, the server opens additional listening sockets,
+	/// bound to the same address as the ServerSocket passed to the
+	/// constructor, using SO_REUSEPORT. Each acceptor has its own
+	/// accept thread and its own TCPServerDispatcher with its own
+	/// connection queue, and the operating system distributes incoming
+	/// connections among the listening sockets. The connection threads
+	/// of all acceptors are taken from the same thread pool, and each
+	/// acceptor may use up to TCPServerParams::getMaxThreads() threads.
+	/// If the ServerSocket passed to the constructor does not have
+	/// SO_REUSEPORT enabled (see ServerSocket::bind() and
+	/// Socket::setReusePort()), or if the platform does not support
+	/// SO_REUSEPORT, only a single acceptor is used.
+	///
+	/// The statistics functions (currentConnections(), etc.) return
+	/// the totals over all acceptors. Statistics for a single acceptor
+	/// can be obtained by passing the acceptor's index to the
+	/// respective overload.
 {
 public:
 	TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::UInt16 portNumber = 0, TCPServerParams::Ptr pParams = 0);
@@ -116,6 +140,20 @@ public:
 		///
 		/// New threads are taken from the given thread pool.
 
+	TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::TaskExecutor& executor, const ServerSocket& socket, TCPServerParams::Ptr pParams = 0);
+		/// Creates the TCPServer, using the given ServerSocket.
+		///
+		/// The server takes ownership of the TCPServerConnectionFactory
+		/// and deletes it when it's no longer needed.
+		///
+		/// The server also takes ownership of the TCPServerParams object.
+		/// If no TCPServerParams object is given, the server's TCPServerDispatcher
+		/// creates its own one.
+		///
+		/// Connections are handled by tasks scheduled with the given
+		/// TaskExecutor. Note that a connection occupies one of the
+		/// TaskExecutor's worker threads while it is being handled.
+
 	virtual ~TCPServer();
 		/// Destroys the TCPServer and its TCPServerConnectionFactory.
 
@@ -153,6 +191,15 @@ public:
 
 	int maxConcurrentConnections() const;
 		/// Returns the maximum number of concurrently handled connections.	
+		///
+		/// This is a statistic, not a limit. With more than one acceptor,
+		/// it is the sum of the maxima of the individual acceptors, which
+		/// may have been reached at different times. The result is
+		/// therefore an upper bound of the number of connections the
+		/// server has handled at the same time, and may exceed
+		/// TCPServerParams::getMaxThreads(), since each acceptor can use
+		/// up to that many threads. Use maxConcurrentConnections(int)
+		/// to obtain the maximum of a single acceptor.
 		
 	int queuedConnections() const;
 		/// Returns the number of queued connections.
@@ -160,9 +207,35 @@ public:
 	int refusedConnections() const;
 		/// Returns the number of refused connections.
 
+	int acceptors() const;
+		/// Returns the number of acceptors, each one having its
+		/// own listening socket, accept thread and dispatcher.
+
+	int currentConnections(int acceptor) const;
+		/// Returns the number of connections currently handled
+		/// by the given acceptor.
+
+	int queuedConnections(int acceptor) const;
+		/// Returns the number of connections queued by the given acceptor.
+
+	int refusedConnections(int acceptor) const;
+		/// Returns the number of connections refused by the given acceptor.
+
+	int maxConcurrentConnections(int acceptor) const;
+		/// Returns the maximum number of connections concurrently
+		/// handled by the given acceptor.
+
+	int totalConnections(int acceptor) const;
+		/// Returns the total number of connections handled
+		/// by the given acceptor.
+
 	const ServerSocket& socket() const;
 		/// Returns the underlying server socket.
 
+	const ServerSocket& socket(int acceptor) const;
+		/// Returns the listening socket of the given acceptor.
+		/// The socket of acceptor 0 is the one passed to the constructor.
+
 	Poco::UInt16 port() const;
 		/// Returns the port the server socket listens on.
 
@@ -176,14 +249,51 @@ protected:
 	static std::string threadName(const ServerSocket& socket);
 		/// Returns a thread name for the server thread.
 
+	TCPServerDispatcher* dispatcher() const;
+		/// Returns the TCPServerDispatcher used by the server.
+
+	TCPServerDispatcher* dispatcher(int acceptor) const;
+		/// Returns the TCPServerDispatcher of the given acceptor.
+
 private:
+	struct Acceptor
+	{
+		Acceptor(TCPServer* pServer, const ServerSocket& socket, TCPServerDispatcher* pDispatcher);
+
+		TCPServer*           pServer;
+		ServerSocket         socket;
+		TCPServerDispatcher* pDispatcher;
+		Poco::Thread         thread;
+	};
+
+	typedef std::vector<Acceptor*> AcceptorVec;
+
 	TCPServer();
 	TCPServer(const TCPServer&);
 	TCPServer& operator = (const TCPServer&);
+
+	static int acceptorsFor(TCPServerParams::Ptr pParams, const ServerSocket& socket);
+		/// Returns the number of acceptors to use for the given
+		/// parameters and server socket.
+
+	void createAcceptors(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool* pThreadPool, Poco::TaskExecutor* pExecutor, TCPServerParams::Ptr pParams, int count);
+		/// Creates the additional acceptors, whose dispatchers use
+		/// either the given thread pool or the given TaskExecutor.
+
+	void acceptConnections(ServerSocket& socket, TCPServerDispatcher* pDispatcher);
+		/// Runs the accept loop for the given socket.
+
+	static void runAcceptor(void* pAcceptor);
+		/// Thread entry point for additional acceptors.
+
+	void releaseAcceptors();
+		/// Releases the dispatchers of the additional acceptors
+		/// and deletes them.
 	
 	ServerSocket         _socket;
 	TCPServerDispatcher* _pDispatcher;
 	Poco::Thread         _thread;
+	AcceptorVec          _acceptors;
 	bool                 _stopped;
 };
 
@@ -200,6 +310,18 @@ inline Poco::UInt16 TCPServer::port() const
 }
 
 
+inline int TCPServer::acceptors() const
+{
+	return static_cast<int>(_acceptors.size()) + 1;
+}
+
+
+inline TCPServerDispatcher* TCPServer::dispatcher() const
+{
+	return _pDispatcher;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -27,6 +27,7 @@
 #include "Poco/Runnable.h"
 #include "Poco/NotificationQueue.h"
 #include "Poco/ThreadPool.h"
+#include "Poco/TaskExecutor.h"
 #include "Poco/Mutex.h"
 
 
@@ -46,6 +47,21 @@ public:
 		/// If no TCPServerParams object is supplied, the TCPServerDispatcher
 		/// creates one.
 
+	TCPServerDispatcher(TCPServerConnectionFactory::Ptr pFactory, Poco::TaskExecutor& executor, TCPServerParams::Ptr pParams);
+		/// Creates the TCPServerDispatcher, which runs as a task
+		/// scheduled with the given TaskExecutor instead of in
+		/// threads obtained from a thread pool.
+		///
+		/// In this case, a dispatcher task ends as soon as there
+		/// are no more queued connections, so that it does not
+		/// block a worker thread of the TaskExecutor. If the
+		/// TaskExecutor cannot take another task and no dispatcher
+		/// task is running, the queued connections are refused.
+		///
+		/// The dispatcher takes ownership of the TCPServerParams object.
+		/// If no TCPServerParams object is supplied, the TCPServerDispatcher
+		/// creates one.
+
 	void duplicate();
 		/// Increments the object's reference count.
 
@@ -60,6 +76,15 @@ public:
 	void enqueue(const StreamSocket& socket);
 		/// Queues the given socket connection.
 
+	void resume(const StreamSocket& socket);
+		/// Queues a connection that has already been handled before,
+		/// like a persistent connection handed back by the
+		/// HTTPKeepAliveReactor.
+		///
+		/// Unlike enqueue(), resume() does not count the connection
+		/// in totalConnections(), or in refusedConnections() if the
+		/// queue is full. In the latter case, the connection is closed.
+
 	void stop();
 		/// Stops the dispatcher.
 			
@@ -67,7 +92,8 @@ public:
 		/// Returns the number of currently used threads.
 
 	int maxThreads() const;
-		/// Returns the maximum number of threads available.
+		/// Returns the maximum number of threads available
+		/// (the number of worker threads if a TaskExecutor is used).
 		
 	int totalConnections() const;
 		/// Returns the total number of handled connections.
@@ -87,17 +113,25 @@ public:
 	const TCPServerParams& params() const;
 		/// Returns a const reference to the TCPServerParam object.
 
+	TCPServerConnectionFactory::Ptr connectionFactory() const;
+		/// Returns the TCPServerConnectionFactory used
+		/// to create connection objects.
+
 protected:
 	~TCPServerDispatcher();
 		/// Destroys the TCPServerDispatcher.
 
-	void beginConnection();
+	void beginConnection(bool resumed = false);
 		/// Updates the performance counters.
 		
 	void endConnection();
 		/// Updates the performance counters.
 
 private:
+	void init();
+	void enqueue(const StreamSocket& socket, bool resumed);
+	void startExecutorTask();
+
 	TCPServerDispatcher();
 	TCPServerDispatcher(const TCPServerDispatcher&);
 	TCPServerDispatcher& operator = (const TCPServerDispatcher&);
@@ -112,7 +146,8 @@ private:
 	bool _stopped;
 	Poco::NotificationQueue         _queue;
 	TCPServerConnectionFactory::Ptr _pConnectionFactory;
-	Poco::ThreadPool&               _threadPool;
+	Poco::ThreadPool*               _pThreadPool;
+	Poco::TaskExecutor*             _pExecutor;
 	mutable Poco::FastMutex         _mutex;
 };
 
@@ -126,6 +161,12 @@ inline const TCPServerParams& TCPServerDispatcher::params() const
 }
 
 
+inline TCPServerConnectionFactory::Ptr TCPServerDispatcher::connectionFactory() const
+{
+	return _pConnectionFactory;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -47,6 +47,7 @@ public:
 		///   - threadIdleTime:       10 seconds
 		///   - maxThreads:           0
 		///   - maxQueued:            64
+		///   - acceptors:            1
 
 	void setThreadIdleTime(const Poco::Timespan& idleTime);
 		/// Sets the maximum idle time for a thread before
@@ -94,6 +95,21 @@ public:
 		/// Returns the priority of TCP server threads
 		/// created by TCPServer. 
 
+	void setAcceptors(int count);
+		/// Sets the number of acceptors used by the TCPServer.
+		/// Must be greater than 0.
+		///
+		/// Each acceptor has its own listening socket, accept
+		/// thread and TCPServerDispatcher. All listening sockets
+		/// are bound to the same address, using SO_REUSEPORT, and
+		/// the operating system distributes incoming connections
+		/// among them. See TCPServer for more information.
+		///
+		/// The default number is 1.
+
+	int getAcceptors() const;
+		/// Returns the number of acceptors used by the TCPServer.
+
 protected:
 	virtual ~TCPServerParams();
 		/// Destroys the TCPServerParams.
@@ -103,6 +119,7 @@ private:
 	int _maxThreads;
 	int _maxQueued;
 	Poco::Thread::Priority _threadPriority;
+	int _acceptors;
 };
 
 
@@ -133,6 +150,12 @@ inline Poco::Thread::Priority TCPServerParams::getThreadPriority() const
 }
 
 
+inline int TCPServerParams::getAcceptors() const
+{
+	return _acceptors;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -50,6 +50,11 @@ class Net_API WebSocket: public StreamSocket
 	/// Note that special frames like PING must be handled at
 	/// application level. In the case of a PING, a PONG message
 	/// must be returned.
+	///
+	/// The permessage-deflate extension (RFC 7692) is supported
+	/// for compressing messages. It is enabled by passing a
+	/// DeflateConfig to the constructor, and used if both ends
+	/// of the connection agree on it in the handshake.
 {
 public:
 	enum Mode
@@ -123,10 +128,78 @@ public:
 			/// No Sec-WebSocket-Accept header or wrong value.
 		WS_ERR_UNAUTHORIZED                   = 6,
 			/// The server rejected the username or password for authentication.
+		WS_ERR_HANDSHAKE_EXTENSION            = 7,
+			/// Invalid Sec-WebSocket-Extensions header in handshake response.
 		WS_ERR_PAYLOAD_TOO_BIG                = 10,
 			/// Payload too big for supplied buffer.
-		WS_ERR_INCOMPLETE_FRAME               = 11
+		WS_ERR_INCOMPLETE_FRAME               = 11,
 			/// Incomplete frame received.
+		WS_ERR_COMPRESSION                    = 12
+			/// Invalid compressed payload received.
+	};
+
+	struct DeflateConfig
+		/// Configuration of the permessage-deflate extension.
+	{
+		DeflateConfig():
+			compressionLevel(-1),
+			serverMaxWindowBits(15),
+			clientMaxWindowBits(15),
+			serverNoContextTakeover(false),
+			clientNoContextTakeover(false)
+		{
+		}
+
+		int  compressionLevel;
+			/// The zlib compression level (0 - 9) for outgoing messages,
+			/// or -1 for the default compression level.
+		int  serverMaxWindowBits;
+			/// The maximum size of the LZ77 sliding window (9 - 15) used
+			/// by the server for compressing messages.
+		int  clientMaxWindowBits;
+			/// The maximum size of the LZ77 sliding window (9 - 15) used
+			/// by the client for compressing messages.
+		bool serverNoContextTakeover;
+			/// If true, the server resets its compressor after every message.
+			/// This reduces the memory required to keep a connection, at the
+			/// cost of a lower compression ratio.
+		bool clientNoContextTakeover;
+			/// If true, the client resets its compressor after every message.
+	};
+
+	struct DeflateStatistics
+		/// Payload byte counters of the permessage-deflate extension.
+	{
+		DeflateStatistics():
+			bytesSent(0),
+			compressedBytesSent(0),
+			bytesReceived(0),
+			compressedBytesReceived(0)
+		{
+		}
+
+		double sendRatio() const
+			/// Returns the ratio of compressed to uncompressed
+			/// payload bytes sent, or 1 if nothing has been sent.
+		{
+			return bytesSent > 0 ? double(compressedBytesSent)/double(bytesSent) : 1.0;
+		}
+
+		double receiveRatio() const
+			/// Returns the ratio of compressed to uncompressed
+			/// payload bytes received, or 1 if nothing has been received.
+		{
+			return bytesReceived > 0 ? double(compressedBytesReceived)/double(bytesReceived) : 1.0;
+		}
+
+		Poco::UInt64 bytesSent;
+			/// Uncompressed payload bytes of compressed messages sent.
+		Poco::UInt64 compressedBytesSent;
+			/// Compressed payload bytes of compressed messages sent.
+		Poco::UInt64 bytesReceived;
+			/// Uncompressed payload bytes of compressed messages received.
+		Poco::UInt64 compressedBytesReceived;
+			/// Compressed payload bytes of compressed messages received.
 	};
 	
 	WebSocket(HTTPServerRequest& request, HTTPServerResponse& response);
@@ -139,6 +212,13 @@ public:
 		///
 		/// Throws an exception if the request is not a proper WebSocket
 		/// upgrade request.
+
+	WebSocket(HTTPServerRequest& request, HTTPServerResponse& response, const DeflateConfig& deflateConfig);
+		/// Creates a server-side WebSocket from within a
+		/// HTTPRequestHandler, like the constructor above.
+		///
+		/// If the client offers the permessage-deflate extension,
+		/// the offer is accepted, using the given configuration.
 		
 	WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response);
 		/// Creates a client-side WebSocket, using the given
@@ -166,6 +246,14 @@ public:
 		///
 		/// The result of the handshake can be obtained from the response
 		/// object.
+
+	WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, const DeflateConfig& deflateConfig);
+		/// Creates a client-side WebSocket, like the constructor
+		/// above, offering the permessage-deflate extension
+		/// with the given configuration in the handshake.
+		///
+		/// Use deflateEnabled() to find out whether the server
+		/// has accepted the offer.
 	
 	WebSocket(const Socket& socket);
 		/// Creates a WebSocket from another Socket, which must be a WebSocket,
@@ -203,6 +291,21 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 
+	int sendFrame(const SocketBufVec& buffers, int flags = FRAME_TEXT);
+		/// Sends the contents of the given buffers through
+		/// the socket as a single frame.
+		///
+		/// The frame header and the payload buffers are written
+		/// with a single gathering system call, without copying the
+		/// payload into a frame buffer first. A client-side WebSocket
+		/// must mask the payload, so in this case the payload is
+		/// masked into a frame buffer.
+		///
+		/// Values from the FrameFlags, FrameOpcodes and SendFlags enumerations
+		/// can be specified in flags.
+		///
+		/// Returns the number of payload bytes sent.
+
 	int receiveFrame(void* buffer, int length, int& flags);
 		/// Receives a frame from the socket and stores it
 		/// in buffer. Up to length bytes are received. If
@@ -225,13 +328,27 @@ public:
 		/// Returns WS_SERVER if the WebSocket is a server-side
 		/// WebSocket, or WS_CLIENT otherwise.
 
+	bool deflateEnabled() const;
+		/// Returns true if the permessage-deflate extension
+		/// has been negotiated for the connection.
+		///
+		/// If so, TEXT and BINARY messages sent with sendFrame()
+		/// are compressed, and compressed messages received
+		/// with receiveFrame() are decompressed. The sizes passed
+		/// to and returned from sendFrame() and receiveFrame()
+		/// always refer to the uncompressed payload.
+
+	DeflateStatistics deflateStatistics() const;
+		/// Returns the payload byte counters of the
+		/// permessage-deflate extension.
+
 	static const std::string WEBSOCKET_VERSION;
 		/// The WebSocket protocol version supported (13).
 	
 protected:
-	static WebSocketImpl* accept(HTTPServerRequest& request, HTTPServerResponse& response);
-	static WebSocketImpl* connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials);
-	static WebSocketImpl* completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key);
+	static WebSocketImpl* accept(HTTPServerRequest& request, HTTPServerResponse& response, const DeflateConfig* pDeflateConfig = 0);
+	static WebSocketImpl* connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const DeflateConfig* pDeflateConfig = 0);
+	static WebSocketImpl* completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key, const DeflateConfig* pDeflateConfig = 0);
 	static std::string computeAccept(const std::string& key);
 	static std::string createKey();
 	
@@ -28,17 +28,32 @@ namespace Poco {
 namespace Net {
 
 
+class PerMessageDeflate;
+
+
 class Net_API WebSocketImpl: public StreamSocketImpl
 	/// This class implements a WebSocket, according
 	/// to the WebSocket protocol described in RFC 6455.
 {
 public:
-	WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, bool mustMaskPayload);
+	WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, bool mustMaskPayload, PerMessageDeflate* pDeflate = 0);
 		/// Creates a StreamSocketImpl using the given native socket.
+		///
+		/// If pDeflate is not null, messages are compressed using
+		/// the permessage-deflate extension. The WebSocketImpl takes
+		/// ownership of the PerMessageDeflate object.
 	
 	// StreamSocketImpl
 	virtual int sendBytes(const void* buffer, int length, int flags);
 		/// Sends a WebSocket protocol frame.
+
+	virtual int sendBytes(const SocketBufVec& buffers, int flags);
+		/// Sends a WebSocket protocol frame, with the payload
+		/// gathered from the given buffers.
+		///
+		/// If the payload need not be masked, the frame header
+		/// and the payload buffers are sent with a single gathering
+		/// system call, without copying the payload.
 		
 	virtual int receiveBytes(void* buffer, int length, int flags);
 		/// Receives a WebSocket protocol frame.
@@ -70,6 +85,19 @@ public:
 	bool mustMaskPayload() const;
 		/// Returns true if the payload must be masked.
 
+	const PerMessageDeflate* perMessageDeflate() const;
+		/// Returns the PerMessageDeflate object if the permessage-deflate
+		/// extension is used, or null otherwise.
+
+	static void maskPayload(const char* src, char* dst, std::size_t length, const char* mask);
+		/// XORs length bytes from src with the given 4-byte
+		/// masking key, as specified in RFC 6455, section 5.3,
+		/// and stores the result in dst. src and dst may be
+		/// the same buffer.
+		///
+		/// Depending on the CPU, the payload is processed
+		/// in 32 byte (AVX2), 16 byte (SSE2) or 8 byte chunks.
+
 protected:
 	enum
 	{
@@ -77,6 +105,7 @@ protected:
 		MAX_HEADER_LENGTH = 14
 	};
 	
+	void sendFrame(const SocketBufVec& buffers, std::size_t length, int flags);
 	int receiveNBytes(void* buffer, int bytes);
 	virtual ~WebSocketImpl();
 
@@ -87,6 +116,9 @@ private:
 	int _frameFlags;
 	bool _mustMaskPayload;
 	Poco::Random _rnd;
+	PerMessageDeflate* _pDeflate;
+	bool _deflateSending;
+	bool _deflateReceiving;
 };
 
 
@@ -105,6 +137,12 @@ inline bool WebSocketImpl::mustMaskPayload() const
 }
 
 
+inline const PerMessageDeflate* WebSocketImpl::perMessageDeflate() const
+{
+	return _pDeflate;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -17,21 +17,21 @@
 #include "Poco/Net/HTTPBufferAllocator.h"
 
 
-using Poco::MemoryPool;
+using Poco::ThreadCachingMemoryPool;
 
 
 namespace Poco {
 namespace Net {
 
 
-MemoryPool HTTPBufferAllocator::_pool(HTTPBufferAllocator::BUFFER_SIZE, 16);
+ThreadCachingMemoryPool HTTPBufferAllocator::_pool(HTTPBufferAllocator::BUFFER_SIZE);
 
 
 char* HTTPBufferAllocator::allocate(std::streamsize size)
 {
 	poco_assert_dbg (size == BUFFER_SIZE);
 
-	return reinterpret_cast<char*>(_pool.get());
+	return reinterpret_cast<char*>(_pool.get(static_cast<std::size_t>(size)));
 }
 
 
@@ -39,7 +39,7 @@ void HTTPBufferAllocator::deallocate(char* ptr, std::streamsize size)
 {
 	poco_assert_dbg (size == BUFFER_SIZE);
 
-	_pool.release(ptr);
+	_pool.release(ptr, static_cast<std::size_t>(size));
 }
 
 
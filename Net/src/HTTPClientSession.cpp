@@ -31,6 +31,7 @@
 
 using Poco::NumberFormatter;
 using Poco::IllegalStateException;
+using Poco::InvalidArgumentException;
 
 
 namespace Poco {
@@ -46,7 +47,9 @@ HTTPClientSession::HTTPClientSession():
 	_keepAliveTimeout(DEFAULT_KEEP_ALIVE_TIMEOUT, 0),
 	_reconnect(false),
 	_mustReconnect(false),
-	_expectResponseBody(false)
+	_expectResponseBody(false),
+	_pipelineSent(0),
+	_pipelineDepth(DEFAULT_PIPELINE_DEPTH)
 {
 }
 
@@ -58,7 +61,9 @@ HTTPClientSession::HTTPClientSession(const StreamSocket& socket):
 	_keepAliveTimeout(DEFAULT_KEEP_ALIVE_TIMEOUT, 0),
 	_reconnect(false),
 	_mustReconnect(false),
-	_expectResponseBody(false)
+	_expectResponseBody(false),
+	_pipelineSent(0),
+	_pipelineDepth(DEFAULT_PIPELINE_DEPTH)
 {
 }
 
@@ -70,7 +75,9 @@ HTTPClientSession::HTTPClientSession(const SocketAddress& address):
 	_keepAliveTimeout(DEFAULT_KEEP_ALIVE_TIMEOUT, 0),
 	_reconnect(false),
 	_mustReconnect(false),
-	_expectResponseBody(false)
+	_expectResponseBody(false),
+	_pipelineSent(0),
+	_pipelineDepth(DEFAULT_PIPELINE_DEPTH)
 {
 }
 
@@ -82,7 +89,9 @@ HTTPClientSession::HTTPClientSession(const std::string& host, Poco::UInt16 port)
 	_keepAliveTimeout(DEFAULT_KEEP_ALIVE_TIMEOUT, 0),
 	_reconnect(false),
 	_mustReconnect(false),
-	_expectResponseBody(false)
+	_expectResponseBody(false),
+	_pipelineSent(0),
+	_pipelineDepth(DEFAULT_PIPELINE_DEPTH)
 {
 }
 
@@ -94,7 +103,9 @@ HTTPClientSession::HTTPClientSession(const std::string& host, Poco::UInt16 port,
 	_keepAliveTimeout(DEFAULT_KEEP_ALIVE_TIMEOUT, 0),
 	_reconnect(false),
 	_mustReconnect(false),
-	_expectResponseBody(false)
+	_expectResponseBody(false),
+	_pipelineSent(0),
+	_pipelineDepth(DEFAULT_PIPELINE_DEPTH)
 {
 }
 
@@ -190,6 +201,8 @@ void HTTPClientSession::setKeepAliveTimeout(const Poco::Timespan& timeout)
 
 std::ostream& HTTPClientSession::sendRequest(HTTPRequest& request)
 {
+	if (!_pipeline.empty()) throw IllegalStateException("Pipelined HTTP requests are outstanding");
+
 	clearException();
 	_pResponseStream = 0;
 
@@ -205,13 +218,7 @@ std::ostream& HTTPClientSession::sendRequest(HTTPRequest& request)
 			reconnect();
 		if (!keepAlive)
 			request.setKeepAlive(false);
-		if (!request.has(HTTPRequest::HOST))
-			request.setHost(_host, _port);
-		if (!_proxyConfig.host.empty() && !bypassProxy())
-		{
-			request.setURI(proxyRequestPrefix() + request.getURI());
-			proxyAuthenticate(request);
-		}
+		prepareRequest(request);
 		_reconnect = keepAlive;
 		_expectResponseBody = request.getMethod() != HTTPRequest::HTTP_HEAD;
 		if (request.getChunkedTransferEncoding())
@@ -281,26 +288,117 @@ std::istream& HTTPClientSession::receiveResponse(HTTPResponse& response)
 
 	_mustReconnect = getKeepAlive() && !response.getKeepAlive();
 
-	if (!_expectResponseBody || response.getStatus() < 200 || response.getStatus() == HTTPResponse::HTTP_NO_CONTENT || response.getStatus() == HTTPResponse::HTTP_NOT_MODIFIED)
-		_pResponseStream = new HTTPFixedLengthInputStream(*this, 0);
-	else if (response.getChunkedTransferEncoding())
-		_pResponseStream = new HTTPChunkedInputStream(*this);
-	else if (response.hasContentLength())
-#if defined(POCO_HAVE_INT64)
-		_pResponseStream = new HTTPFixedLengthInputStream(*this, response.getContentLength64());
-#else
-		_pResponseStream = new HTTPFixedLengthInputStream(*this, response.getContentLength());
-#endif
-	else
-		_pResponseStream = new HTTPInputStream(*this);
-		
-	return *_pResponseStream;
+	return createResponseStream(response);
+}
+
+
+void HTTPClientSession::sendPipelinedRequest(HTTPRequest& request)
+{
+	if (!getKeepAlive())
+		throw IllegalStateException("HTTP pipelining requires persistent connections");
+	if (request.getChunkedTransferEncoding() || 
+	    (request.hasContentLength() && request.getContentLength() != 0) ||
+	    (!request.hasContentLength() && (request.getMethod() == HTTPRequest::HTTP_PUT || request.getMethod() == HTTPRequest::HTTP_POST)))
+		throw InvalidArgumentException("Pipelined HTTP requests must not have a body");
+
+	if (_pipeline.empty())
+	{
+		clearException();
+		_pResponseStream = 0;
+		_pRequestStream = 0;
+		if (mustReconnect())
+		{
+			close();
+			_mustReconnect = false;
+		}
+	}
+	prepareRequest(request);
+	std::ostringstream ostr;
+	request.write(ostr);
+
+	const std::string& method = request.getMethod();
+	PipelinedRequest pr;
+	pr.data = ostr.str();
+	pr.expectResponseBody = method != HTTPRequest::HTTP_HEAD;
+	pr.idempotent = method == HTTPRequest::HTTP_GET
+		|| method == HTTPRequest::HTTP_HEAD
+		|| method == HTTPRequest::HTTP_PUT
+		|| method == HTTPRequest::HTTP_DELETE
+		|| method == HTTPRequest::HTTP_OPTIONS
+		|| method == HTTPRequest::HTTP_TRACE;
+	_pipeline.push_back(pr);
+}
+
+
+std::istream& HTTPClientSession::receivePipelinedResponse(HTTPResponse& response)
+{
+	if (_pipeline.empty()) throw IllegalStateException("No pipelined HTTP request outstanding");
+
+	_pResponseStream = 0;
+
+	// Outstanding requests are sent again at most once per response,
+	// so that a server that keeps failing does not make us loop forever.
+	bool replayed = false;
+	if (_mustReconnect || networkException())
+	{
+		// The server has announced that it will close the connection after
+		// the previous response, or reading the previous response failed.
+		if (!replayPipeline())
+			throw HTTPException("Connection closed with non-idempotent pipelined HTTP requests outstanding");
+		replayed = true;
+	}
+	for (;;)
+	{
+		try
+		{
+			flushPipeline();
+			do
+			{
+				response.clear();
+				HTTPHeaderInputStream his(*this);
+				response.read(his);
+			}
+			while (response.getStatus() == HTTPResponse::HTTP_CONTINUE);
+			break;
+		}
+		catch (Exception&)
+		{
+			if (replayed || !replayPipeline())
+			{
+				close();
+				_pipeline.clear();
+				_pipelineSent = 0;
+				if (networkException())
+					networkException()->rethrow();
+				else
+					throw;
+			}
+			replayed = true;
+		}
+	}
+
+	_expectResponseBody = _pipeline.front().expectResponseBody;
+	_pipeline.pop_front();
+	--_pipelineSent;
+	_mustReconnect = !response.getKeepAlive();
+
+	return createResponseStream(response);
 }
 
 
 void HTTPClientSession::reset()
 {
 	close();
+	_pipeline.clear();
+	_pipelineSent = 0;
+}
+
+
+void HTTPClientSession::setPipelineDepth(int depth)
+{
+	poco_assert (depth > 0);
+
+	_pipelineDepth = depth;
 }
 
 
@@ -385,6 +483,81 @@ void HTTPClientSession::proxyAuthenticateImpl(HTTPRequest& request)
 }
 
 
+void HTTPClientSession::prepareRequest(HTTPRequest& request)
+{
+	if (!request.has(HTTPRequest::HOST))
+		request.setHost(_host, _port);
+	if (!_proxyConfig.host.empty() && !bypassProxy())
+	{
+		request.setURI(proxyRequestPrefix() + request.getURI());
+		proxyAuthenticate(request);
+	}
+}
+
+
+std::istream& HTTPClientSession::createResponseStream(const HTTPResponse& response)
+{
+	if (!_expectResponseBody || response.getStatus() < 200 || response.getStatus() == HTTPResponse::HTTP_NO_CONTENT || response.getStatus() == HTTPResponse::HTTP_NOT_MODIFIED)
+		_pResponseStream = new HTTPFixedLengthInputStream(*this, 0);
+	else if (response.getChunkedTransferEncoding())
+		_pResponseStream = new HTTPChunkedInputStream(*this);
+	else if (response.hasContentLength())
+#if defined(POCO_HAVE_INT64)
+		_pResponseStream = new HTTPFixedLengthInputStream(*this, response.getContentLength64());
+#else
+		_pResponseStream = new HTTPFixedLengthInputStream(*this, response.getContentLength());
+#endif
+	else
+		_pResponseStream = new HTTPInputStream(*this);
+		
+	return *_pResponseStream;
+}
+
+
+void HTTPClientSession::flushPipeline()
+{
+	std::size_t maxSent = static_cast<std::size_t>(_pipelineDepth);
+	if (_pipelineSent >= _pipeline.size() || _pipelineSent >= maxSent) return;
+
+	if (!connected()) reconnect();
+	std::string data;
+	std::size_t sent = _pipelineSent;
+	while (sent < _pipeline.size() && sent < maxSent)
+	{
+		data += _pipeline[sent].data;
+		++sent;
+	}
+	const char* p = data.data();
+	std::streamsize remaining = static_cast<std::streamsize>(data.size());
+	while (remaining > 0)
+	{
+		int n = HTTPSession::write(p, remaining);
+		p += n;
+		remaining -= n;
+	}
+	_pipelineSent = sent;
+	_lastRequest.update();
+}
+
+
+bool HTTPClientSession::replayPipeline()
+{
+	close();
+	clearException();
+	_mustReconnect = false;
+	_pipelineSent = 0;
+	for (Pipeline::const_iterator it = _pipeline.begin(); it != _pipeline.end(); ++it)
+	{
+		if (!it->idempotent)
+		{
+			_pipeline.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+
 StreamSocket HTTPClientSession::proxyConnect()
 {
 	ProxyConfig emptyProxyConfig;
@@ -0,0 +1,362 @@
+//
+// HTTPClientSessionPool.cpp
+//
+// $Id: //poco/1.4/Net/src/HTTPClientSessionPool.cpp#1 $
+//
+// Library: Net
+// Package: HTTPClient
+// Module:  HTTPClientSessionPool
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPClientSessionPool.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/NumberFormatter.h"
+#include <vector>
+
+
+using Poco::FastMutex;
+using Poco::NumberFormatter;
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTPClientSessionPool::HTTPClientSessionPool(int maxSessionsPerHost, int idleTime):
+	_factory(HTTPSessionFactory::defaultFactory()),
+	_maxSessionsPerHost(maxSessionsPerHost),
+	_idleTime(idleTime),
+	_idle(0),
+	_hits(0),
+	_misses(0),
+	_evictions(0),
+	_overflows(0),
+	_shutdown(false),
+	_evictionTimer(250*idleTime, 250*idleTime)
+{
+	init();
+}
+
+
+HTTPClientSessionPool::HTTPClientSessionPool(HTTPSessionFactory& factory, int maxSessionsPerHost, int idleTime):
+	_factory(factory),
+	_maxSessionsPerHost(maxSessionsPerHost),
+	_idleTime(idleTime),
+	_idle(0),
+	_hits(0),
+	_misses(0),
+	_evictions(0),
+	_overflows(0),
+	_shutdown(false),
+	_evictionTimer(250*idleTime, 250*idleTime)
+{
+	init();
+}
+
+
+HTTPClientSessionPool::~HTTPClientSessionPool()
+{
+	try
+	{
+		shutdown();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void HTTPClientSessionPool::init()
+{
+	poco_assert (_maxSessionsPerHost > 0 && _idleTime > 0);
+
+	Poco::TimerCallback<HTTPClientSessionPool> callback(*this, &HTTPClientSessionPool::onEvictionTimer);
+	_evictionTimer.start(callback);
+}
+
+
+HTTPClientSession* HTTPClientSessionPool::get(const Poco::URI& uri)
+{
+	std::string k = key(uri);
+	std::vector<HTTPClientSession*> evicted;
+	HTTPClientSession* pSession = 0;
+	bool pooled = true;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		if (_shutdown) throw HTTPException("HTTPClientSessionPool has been shut down");
+
+		HostEntry& entry = _hosts[k];
+		while (!entry.idle.empty() && !pSession)
+		{
+			// most recently used sessions are at the front
+			HTTPClientSession* pIdle = entry.idle.front().pSession;
+			entry.idle.pop_front();
+			--_idle;
+			if (usable(pIdle))
+			{
+				pSession = pIdle;
+				++_hits;
+			}
+			else
+			{
+				evicted.push_back(pIdle);
+				++_evictions;
+			}
+		}
+		if (pSession)
+		{
+			++entry.active;
+			_active[pSession] = k;
+		}
+		else if (entry.active < _maxSessionsPerHost)
+		{
+			// reserve the slot; the session is created outside the lock
+			++entry.active;
+			++_misses;
+		}
+		else
+		{
+			pooled = false;
+			++_overflows;
+		}
+	}
+	for (std::vector<HTTPClientSession*>::iterator it = evicted.begin(); it != evicted.end(); ++it)
+		delete *it;
+	if (pSession) return pSession;
+
+	try
+	{
+		pSession = createSession(uri);
+	}
+	catch (...)
+	{
+		if (pooled) releaseSlot(k);
+		throw;
+	}
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (pooled)
+	{
+		pSession->setKeepAlive(true);
+		_active[pSession] = k;
+	}
+	else _unpooled.insert(pSession);
+	return pSession;
+}
+
+
+void HTTPClientSessionPool::putBack(HTTPClientSession* pSession)
+{
+	poco_check_ptr (pSession);
+
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		ActiveMap::iterator it = _active.find(pSession);
+		if (it == _active.end())
+		{
+			std::size_t n = _unpooled.erase(pSession);
+			poco_assert (n == 1);
+		}
+		else
+		{
+			HostMap::iterator itHost = _hosts.find(it->second);
+			poco_assert_dbg (itHost != _hosts.end());
+			--itHost->second.active;
+			_active.erase(it);
+			if (!_shutdown && pSession->getKeepAlive() && pSession->connected())
+			{
+				IdleSession idle;
+				idle.pSession = pSession;
+				itHost->second.idle.push_front(idle);
+				++_idle;
+				return;
+			}
+			if (itHost->second.active == 0 && itHost->second.idle.empty())
+				_hosts.erase(itHost);
+		}
+	}
+	delete pSession;
+}
+
+
+void HTTPClientSessionPool::releaseSlot(const std::string& k)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	HostMap::iterator itHost = _hosts.find(k);
+	poco_assert_dbg (itHost != _hosts.end());
+	--itHost->second.active;
+	if (itHost->second.active == 0 && itHost->second.idle.empty())
+		_hosts.erase(itHost);
+}
+
+
+void HTTPClientSessionPool::shutdown()
+{
+	std::vector<HTTPClientSession*> sessions;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		if (_shutdown) return;
+		_shutdown = true;
+	}
+	_evictionTimer.stop();
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		for (HostMap::iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+		{
+			for (IdleList::iterator itIdle = it->second.idle.begin(); itIdle != it->second.idle.end(); ++itIdle)
+				sessions.push_back(itIdle->pSession);
+			it->second.idle.clear();
+		}
+		_idle = 0;
+	}
+	for (std::vector<HTTPClientSession*>::iterator it = sessions.begin(); it != sessions.end(); ++it)
+		delete *it;
+}
+
+
+int HTTPClientSessionPool::idle() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _idle;
+}
+
+
+int HTTPClientSessionPool::used() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return static_cast<int>(_active.size() + _unpooled.size());
+}
+
+
+int HTTPClientSessionPool::hits() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _hits;
+}
+
+
+int HTTPClientSessionPool::misses() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _misses;
+}
+
+
+int HTTPClientSessionPool::overflows() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _overflows;
+}
+
+
+int HTTPClientSessionPool::evictions() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _evictions;
+}
+
+
+void HTTPClientSessionPool::onEvictionTimer(Poco::Timer&)
+{
+	std::vector<HTTPClientSession*> evicted;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		if (_shutdown) return;
+
+		Poco::Timestamp::TimeDiff maxIdle = Poco::Timestamp::TimeDiff(_idleTime)*Poco::Timestamp::resolution();
+		HostMap::iterator it = _hosts.begin();
+		while (it != _hosts.end())
+		{
+			IdleList& idle = it->second.idle;
+			IdleList::iterator itIdle = idle.begin();
+			while (itIdle != idle.end())
+			{
+				if (itIdle->lastUsed.isElapsed(maxIdle) || !usable(itIdle->pSession))
+				{
+					evicted.push_back(itIdle->pSession);
+					itIdle = idle.erase(itIdle);
+					--_idle;
+					++_evictions;
+				}
+				else ++itIdle;
+			}
+			if (it->second.active == 0 && idle.empty())
+				_hosts.erase(it++);
+			else
+				++it;
+		}
+	}
+	for (std::vector<HTTPClientSession*>::iterator it = evicted.begin(); it != evicted.end(); ++it)
+		delete *it;
+}
+
+
+bool HTTPClientSessionPool::usable(HTTPClientSession* pSession)
+{
+	try
+	{
+		// An idle connection must not have anything to read. If it is
+		// readable, the server has either closed the connection or sent
+		// data we do not expect, and the connection cannot be reused.
+		return pSession->connected() && !pSession->socket().poll(Poco::Timespan(0), Socket::SELECT_READ);
+	}
+	catch (Poco::Exception&)
+	{
+		return false;
+	}
+}
+
+
+HTTPClientSession* HTTPClientSessionPool::createSession(const Poco::URI& uri)
+{
+	if (uri.getScheme() == "http" && !_factory.supportsProtocol("http"))
+	{
+		HTTPClientSession* pSession = new HTTPClientSession(uri.getHost(), uri.getPort());
+		pSession->setProxy(_factory.proxyHost(), _factory.proxyPort());
+		pSession->setProxyCredentials(_factory.proxyUsername(), _factory.proxyPassword());
+		return pSession;
+	}
+	else return _factory.createClientSession(uri);
+}
+
+
+std::string HTTPClientSessionPool::key(const Poco::URI& uri) const
+{
+	std::string k(uri.getScheme());
+	k += "://";
+	k += uri.getHost();
+	k += ':';
+	NumberFormatter::append(k, uri.getPort());
+	if (!_factory.proxyHost().empty())
+	{
+		k += '|';
+		k += _factory.proxyHost();
+		k += ':';
+		NumberFormatter::append(k, _factory.proxyPort());
+	}
+	return k;
+}
+
+
+} } // namespace Poco::Net
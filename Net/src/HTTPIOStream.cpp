@@ -26,7 +26,10 @@ namespace Net {
 
 
 HTTPResponseStreamBuf::HTTPResponseStreamBuf(std::istream& istr):
-	_istr(istr)
+	_istr(istr),
+	_length(-1),
+	_count(0),
+	_eof(false)
 {
 	// make sure exceptions from underlying string propagate
 	_istr.exceptions(std::ios::badbit);
@@ -38,6 +41,18 @@ HTTPResponseStreamBuf::~HTTPResponseStreamBuf()
 }
 
 
+void HTTPResponseStreamBuf::setContentLength(Poco::Int64 length)
+{
+	_length = length;
+}
+
+
+bool HTTPResponseStreamBuf::atEnd() const
+{
+	return _eof || (_length >= 0 && _count >= _length);
+}
+
+
 HTTPResponseIOS::HTTPResponseIOS(std::istream& istr):
 	_buf(istr)
 {
@@ -53,14 +68,45 @@ HTTPResponseIOS::~HTTPResponseIOS()
 HTTPResponseStream::HTTPResponseStream(std::istream& istr, HTTPClientSession* pSession):
 	HTTPResponseIOS(istr),
 	std::istream(&_buf),
-	_pSession(pSession)
+	_pSession(pSession),
+	_reusable(false)
+{
+}
+
+
+HTTPResponseStream::HTTPResponseStream(std::istream& istr, HTTPClientSession* pSession, HTTPClientSessionPool::Ptr pPool, const HTTPResponse& response):
+	HTTPResponseIOS(istr),
+	std::istream(&_buf),
+	_pSession(pSession),
+	_pPool(pPool),
+	_reusable(response.getKeepAlive())
 {
+	if (response.getStatus() == HTTPResponse::HTTP_NO_CONTENT || response.getStatus() == HTTPResponse::HTTP_NOT_MODIFIED)
+		_buf.setContentLength(0);
+	else if (response.getChunkedTransferEncoding())
+		_buf.setContentLength(-1);
+	else if (response.hasContentLength())
+#if defined(POCO_HAVE_INT64)
+		_buf.setContentLength(response.getContentLength64());
+#else
+		_buf.setContentLength(response.getContentLength());
+#endif
+	else
+		_reusable = false; // body ends when the connection is closed
 }
 
 
 HTTPResponseStream::~HTTPResponseStream()
 {
-	delete _pSession;
+	if (_pPool)
+	{
+		// A session can only be reused if the response body has been
+		// read completely. Never peek at the session here, as that
+		// would block until the server sends more data.
+		if (!_reusable || !_buf.atEnd()) _pSession->reset();
+		_pPool->putBack(_pSession);
+	}
+	else delete _pSession;
 }
 
 
@@ -0,0 +1,229 @@
+//
+// HTTPKeepAliveReactor.cpp
+//
+// $Id: //poco/1.4/Net/src/HTTPKeepAliveReactor.cpp#1 $
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPKeepAliveReactor
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPKeepAliveReactor.h"
+#include "Poco/Net/TCPServerDispatcher.h"
+#include <vector>
+
+
+using Poco::FastMutex;
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	static const std::string threadName("HTTPKeepAliveReactor");
+
+	static const Poco::Clock::ClockDiff EXPIRY_RESOLUTION = 10000; // 10 ms
+}
+
+
+HTTPKeepAliveReactor::HTTPKeepAliveReactor(const DispatcherVec& dispatchers, HTTPServerParams::Ptr pParams):
+	_dispatchers(dispatchers),
+	_nextDispatcher(0),
+	_keepAliveTimeout(pParams->getKeepAliveTimeout()),
+	_readableObserver(*this, &HTTPKeepAliveReactor::onReadable),
+	_expiry(EXPIRY_RESOLUTION),
+	_stopped(false),
+	_thread(threadName)
+{
+	poco_assert (!_dispatchers.empty());
+
+	_thread.start(*this);
+}
+
+
+HTTPKeepAliveReactor::~HTTPKeepAliveReactor()
+{
+	try
+	{
+		shutdown();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void HTTPKeepAliveReactor::park(const StreamSocket& socket, int maxKeepAliveRequests)
+{
+	bool stopped;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		stopped = _stopped;
+		if (!stopped)
+		{
+			Poco::SharedPtr<ParkedConnection>& pConn = _parked[socket];
+			if (!pConn) pConn = new ParkedConnection;
+			pConn->socket = socket;
+			pConn->maxKeepAliveRequests = maxKeepAliveRequests;
+			_expiry.schedule(*pConn, Poco::Clock() + _keepAliveTimeout.totalMicroseconds());
+			// register under the lock, so that shutdown() and expire() cannot miss it
+			addEventHandler(socket, _readableObserver);
+		}
+	}
+	if (stopped)
+	{
+		StreamSocket ss(socket);
+		ss.close();
+	}
+}
+
+
+bool HTTPKeepAliveReactor::resume(const StreamSocket& socket, int& maxKeepAliveRequests)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	ResumedMap::iterator it = _resumed.find(socket);
+	if (it != _resumed.end())
+	{
+		maxKeepAliveRequests = it->second.maxKeepAliveRequests;
+		_resumed.erase(it);
+		return true;
+	}
+	return false;
+}
+
+
+void HTTPKeepAliveReactor::shutdown()
+{
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		if (_stopped) return;
+		_stopped = true;
+	}
+	stop();
+	wakeUp();
+	_thread.join();
+
+	std::vector<StreamSocket> parked;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		for (ParkedMap::iterator it = _parked.begin(); it != _parked.end(); ++it)
+			parked.push_back(it->second->socket);
+		_expiry.clear();
+		_parked.clear();
+		_resumed.clear();
+	}
+	for (std::vector<StreamSocket>::iterator it = parked.begin(); it != parked.end(); ++it)
+	{
+		removeEventHandler(*it, _readableObserver);
+		try
+		{
+			it->close();
+		}
+		catch (...)
+		{
+		}
+	}
+}
+
+
+int HTTPKeepAliveReactor::parkedConnections() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return static_cast<int>(_parked.size());
+}
+
+
+void HTTPKeepAliveReactor::onTimeout()
+{
+	SocketReactor::onTimeout();
+	expire();
+}
+
+
+void HTTPKeepAliveReactor::onBusy()
+{
+	SocketReactor::onBusy();
+	Poco::Timestamp now;
+	if (now - _lastExpire >= getTimeout().totalMicroseconds())
+		expire();
+}
+
+
+void HTTPKeepAliveReactor::onReadable(const Poco::AutoPtr<ReadableNotification>& pNf)
+{
+	StreamSocket socket(pNf->socket());
+	TCPServerDispatcher* pDispatcher;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		ParkedMap::iterator it = _parked.find(socket);
+		if (it == _parked.end()) return;
+		ResumedConnection& conn = _resumed[socket];
+		conn.expires = Poco::Timestamp() + _keepAliveTimeout.totalMicroseconds();
+		conn.maxKeepAliveRequests = it->second->maxKeepAliveRequests;
+		_parked.erase(it); // also cancels the keep-alive timeout
+		pDispatcher = _dispatchers[_nextDispatcher];
+		if (++_nextDispatcher == _dispatchers.size()) _nextDispatcher = 0;
+	}
+	removeEventHandler(socket, _readableObserver);
+	pDispatcher->resume(socket);
+}
+
+
+void HTTPKeepAliveReactor::expire()
+{
+	Poco::Timestamp now;
+	_lastExpire = now;
+
+	std::vector<StreamSocket> expired;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		Poco::TimingWheel::EntryVec timedOut;
+		_expiry.advance(Poco::Clock(), timedOut);
+		for (Poco::TimingWheel::EntryVec::iterator it = timedOut.begin(); it != timedOut.end(); ++it)
+		{
+			StreamSocket socket = static_cast<ParkedConnection*>(*it)->socket;
+			expired.push_back(socket);
+			_parked.erase(socket);
+		}
+
+		// Connections refused by the dispatcher are never resumed.
+		ResumedMap::iterator itr = _resumed.begin();
+		while (itr != _resumed.end())
+		{
+			if (itr->second.expires <= now)
+				_resumed.erase(itr++);
+			else
+				++itr;
+		}
+	}
+	for (std::vector<StreamSocket>::iterator it = expired.begin(); it != expired.end(); ++it)
+	{
+		removeEventHandler(*it, _readableObserver);
+		try
+		{
+			it->close();
+		}
+		catch (...)
+		{
+		}
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -202,32 +202,36 @@ void HTTPRequest::read(std::istream& istr)
 {
 	static const int eof = std::char_traits<char>::eof();
 
-	std::string method;
-	std::string uri;
-	std::string version;
-	method.reserve(16);
-	uri.reserve(64);
-	version.reserve(16);
+	// Only the first character is read through the istream, to detect
+	// errors and the end of the stream. The rest of the request line
+	// is read directly from the stream buffer into fixed-size buffers.
+	char method[MAX_METHOD_LENGTH];
+	char uri[MAX_URI_LENGTH];
+	char version[MAX_VERSION_LENGTH];
+	int methodLength  = 0;
+	int uriLength     = 0;
+	int versionLength = 0;
 	int ch = istr.get();
 	if (istr.bad()) throw NetException("Error reading HTTP request header");
 	if (ch == eof) throw NoMessageException();
-	while (Poco::Ascii::isSpace(ch)) ch = istr.get();
+	std::streambuf& buf = *istr.rdbuf();
+	while (Poco::Ascii::isSpace(ch)) ch = buf.sbumpc();
 	if (ch == eof) throw MessageException("No HTTP request header");
-	while (!Poco::Ascii::isSpace(ch) && ch != eof && method.length() < MAX_METHOD_LENGTH) { method += (char) ch; ch = istr.get(); }
+	while (!Poco::Ascii::isSpace(ch) && ch != eof && methodLength < MAX_METHOD_LENGTH) { method[methodLength++] = static_cast<char>(ch); ch = buf.sbumpc(); }
 	if (!Poco::Ascii::isSpace(ch)) throw MessageException("HTTP request method invalid or too long");
-	while (Poco::Ascii::isSpace(ch)) ch = istr.get();
-	while (!Poco::Ascii::isSpace(ch) && ch != eof && uri.length() < MAX_URI_LENGTH) { uri += (char) ch; ch = istr.get(); }
+	while (Poco::Ascii::isSpace(ch)) ch = buf.sbumpc();
+	while (!Poco::Ascii::isSpace(ch) && ch != eof && uriLength < MAX_URI_LENGTH) { uri[uriLength++] = static_cast<char>(ch); ch = buf.sbumpc(); }
 	if (!Poco::Ascii::isSpace(ch)) throw MessageException("HTTP request URI invalid or too long");
-	while (Poco::Ascii::isSpace(ch)) ch = istr.get();
-	while (!Poco::Ascii::isSpace(ch) && ch != eof && version.length() < MAX_VERSION_LENGTH) { version += (char) ch; ch = istr.get(); }
+	while (Poco::Ascii::isSpace(ch)) ch = buf.sbumpc();
+	while (!Poco::Ascii::isSpace(ch) && ch != eof && versionLength < MAX_VERSION_LENGTH) { version[versionLength++] = static_cast<char>(ch); ch = buf.sbumpc(); }
 	if (!Poco::Ascii::isSpace(ch)) throw MessageException("Invalid HTTP version string");
-	while (ch != '\n' && ch != eof) { ch = istr.get(); }
+	while (ch != '\n' && ch != eof) { ch = buf.sbumpc(); }
 	HTTPMessage::read(istr);
-	ch = istr.get();
-	while (ch != '\n' && ch != eof) { ch = istr.get(); }
-	setMethod(method);
-	setURI(uri);
-	setVersion(version);
+	ch = buf.sbumpc();
+	while (ch != '\n' && ch != eof) { ch = buf.sbumpc(); }
+	setMethod(std::string(method, methodLength));
+	setURI(std::string(uri, uriLength));
+	setVersion(std::string(version, versionLength));
 }
 
 
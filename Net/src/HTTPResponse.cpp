@@ -203,31 +203,36 @@ void HTTPResponse::read(std::istream& istr)
 {
 	static const int eof = std::char_traits<char>::eof();
 
-	std::string version;
-	std::string status;
-	std::string reason;
+	// See HTTPRequest::read().
+	char version[MAX_VERSION_LENGTH];
+	char status[MAX_STATUS_LENGTH];
+	char reason[MAX_REASON_LENGTH];
+	int versionLength = 0;
+	int statusLength  = 0;
+	int reasonLength  = 0;
 	
 	int ch =  istr.get();
 	if (istr.bad()) throw NetException("Error reading HTTP response header");
 	if (ch == eof) throw NoMessageException();
-	while (Poco::Ascii::isSpace(ch)) ch = istr.get();
+	std::streambuf& buf = *istr.rdbuf();
+	while (Poco::Ascii::isSpace(ch)) ch = buf.sbumpc();
 	if (ch == eof) throw MessageException("No HTTP response header");
-	while (!Poco::Ascii::isSpace(ch) && ch != eof && version.length() < MAX_VERSION_LENGTH) { version += (char) ch; ch = istr.get(); }
+	while (!Poco::Ascii::isSpace(ch) && ch != eof && versionLength < MAX_VERSION_LENGTH) { version[versionLength++] = static_cast<char>(ch); ch = buf.sbumpc(); }
 	if (!Poco::Ascii::isSpace(ch)) throw MessageException("Invalid HTTP version string");
-	while (Poco::Ascii::isSpace(ch)) ch = istr.get();
-	while (!Poco::Ascii::isSpace(ch) && ch != eof && status.length() < MAX_STATUS_LENGTH) { status += (char) ch; ch = istr.get(); }
+	while (Poco::Ascii::isSpace(ch)) ch = buf.sbumpc();
+	while (!Poco::Ascii::isSpace(ch) && ch != eof && statusLength < MAX_STATUS_LENGTH) { status[statusLength++] = static_cast<char>(ch); ch = buf.sbumpc(); }
 	if (!Poco::Ascii::isSpace(ch)) throw MessageException("Invalid HTTP status code");
-	while (Poco::Ascii::isSpace(ch) && ch != '\r' && ch != '\n' && ch != eof) ch = istr.get();
-	while (ch != '\r' && ch != '\n' && ch != eof && reason.length() < MAX_REASON_LENGTH) { reason += (char) ch; ch = istr.get(); }
+	while (Poco::Ascii::isSpace(ch) && ch != '\r' && ch != '\n' && ch != eof) ch = buf.sbumpc();
+	while (ch != '\r' && ch != '\n' && ch != eof && reasonLength < MAX_REASON_LENGTH) { reason[reasonLength++] = static_cast<char>(ch); ch = buf.sbumpc(); }
 	if (!Poco::Ascii::isSpace(ch)) throw MessageException("HTTP reason string too long");
-	if (ch == '\r') ch = istr.get();
+	if (ch == '\r') ch = buf.sbumpc();
 
 	HTTPMessage::read(istr);
-	ch = istr.get();
-	while (ch != '\n' && ch != eof) { ch = istr.get(); }
-	setVersion(version);
-	setStatus(status);
-	setReason(reason);
+	ch = buf.sbumpc();
+	while (ch != '\n' && ch != eof) { ch = buf.sbumpc(); }
+	setVersion(std::string(version, versionLength));
+	setStatus(std::string(status, statusLength));
+	setReason(std::string(reason, reasonLength));
 }
 
 
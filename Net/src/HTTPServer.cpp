@@ -16,6 +16,7 @@
 
 #include "Poco/Net/HTTPServer.h"
 #include "Poco/Net/HTTPServerConnectionFactory.h"
+#include "Poco/Net/TCPServerDispatcher.h"
 
 
 namespace Poco {
@@ -26,6 +27,7 @@ HTTPServer::HTTPServer(HTTPRequestHandlerFactory::Ptr pFactory, Poco::UInt16 por
 	TCPServer(new HTTPServerConnectionFactory(pParams, pFactory), portNumber, pParams),
 	_pFactory(pFactory)
 {
+	startReactor(pParams);
 }
 
 
@@ -33,6 +35,7 @@ HTTPServer::HTTPServer(HTTPRequestHandlerFactory::Ptr pFactory, const ServerSock
 	TCPServer(new HTTPServerConnectionFactory(pParams, pFactory), socket, pParams),
 	_pFactory(pFactory)
 {
+	startReactor(pParams);
 }
 
 
@@ -40,19 +43,51 @@ HTTPServer::HTTPServer(HTTPRequestHandlerFactory::Ptr pFactory, Poco::ThreadPool
 	TCPServer(new HTTPServerConnectionFactory(pParams, pFactory), threadPool, socket, pParams),
 	_pFactory(pFactory)
 {
+	startReactor(pParams);
 }
 
 
 HTTPServer::~HTTPServer()
 {
+	try
+	{
+		if (_pReactor) _pReactor->shutdown();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
 }
 
 
 void HTTPServer::stopAll(bool abortCurrent)
 {
 	stop();
+	if (_pReactor) _pReactor->shutdown();
 	_pFactory->serverStopped(this, abortCurrent);
 }
 
 
+int HTTPServer::parkedConnections() const
+{
+	if (_pReactor)
+		return _pReactor->parkedConnections();
+	else
+		return 0;
+}
+
+
+void HTTPServer::startReactor(HTTPServerParams::Ptr pParams)
+{
+	if (pParams && pParams->getReactorMode())
+	{
+		HTTPKeepAliveReactor::DispatcherVec dispatchers;
+		for (int i = 0; i < acceptors(); ++i)
+			dispatchers.push_back(dispatcher(i));
+		_pReactor = new HTTPKeepAliveReactor(dispatchers, pParams);
+		dispatcher()->connectionFactory().cast<HTTPServerConnectionFactory>()->setKeepAliveReactor(_pReactor);
+	}
+}
+
+
 } } // namespace Poco::Net
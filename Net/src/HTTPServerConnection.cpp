@@ -43,6 +43,19 @@ HTTPServerConnection::HTTPServerConnection(const StreamSocket& socket, HTTPServe
 }
 
 
+HTTPServerConnection::HTTPServerConnection(const StreamSocket& socket, HTTPServerParams::Ptr pParams, HTTPRequestHandlerFactory::Ptr pFactory, HTTPKeepAliveReactor::Ptr pReactor):
+	TCPServerConnection(socket),
+	_pParams(pParams),
+	_pFactory(pFactory),
+	_pReactor(pReactor),
+	_stopped(false)
+{
+	poco_check_ptr (pFactory);
+	
+	_pFactory->serverStopped += Poco::delegate(this, &HTTPServerConnection::onServerStopped);
+}
+
+
 HTTPServerConnection::~HTTPServerConnection()
 {
 	try
@@ -60,6 +73,9 @@ void HTTPServerConnection::run()
 {
 	std::string server = _pParams->getSoftwareVersion();
 	HTTPServerSession session(socket(), _pParams);
+	int maxKeepAliveRequests;
+	if (_pReactor && _pReactor->resume(socket(), maxKeepAliveRequests))
+		session.setMaxKeepAliveRequests(maxKeepAliveRequests);
 	while (!_stopped && session.hasMoreRequests())
 	{
 		try
@@ -121,6 +137,11 @@ void HTTPServerConnection::run()
 			}
 			else throw;
 		}
+		if (_pReactor && !_stopped && session.idle())
+		{
+			_pReactor->park(session.detachSocket(), session.getMaxKeepAliveRequests());
+			break;
+		}
 	}
 }
 
@@ -38,7 +38,16 @@ HTTPServerConnectionFactory::~HTTPServerConnectionFactory()
 
 TCPServerConnection* HTTPServerConnectionFactory::createConnection(const StreamSocket& socket)
 {
-	return new HTTPServerConnection(socket, _pParams, _pFactory);
+	if (_pReactor)
+		return new HTTPServerConnection(socket, _pParams, _pFactory, _pReactor);
+	else
+		return new HTTPServerConnection(socket, _pParams, _pFactory);
+}
+
+
+void HTTPServerConnectionFactory::setKeepAliveReactor(HTTPKeepAliveReactor::Ptr pReactor)
+{
+	_pReactor = pReactor;
 }
 
 
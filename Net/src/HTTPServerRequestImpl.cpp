@@ -32,6 +32,24 @@ namespace Poco {
 namespace Net {
 
 
+namespace
+{
+	template <class S>
+	S* newStream(HTTPServerSession& session)
+		/// Creates a request stream in the session's arena.
+	{
+		return ::new (session.arena().allocate(sizeof(S))) S(session);
+	}
+
+
+	template <class S, class A>
+	S* newStream(HTTPServerSession& session, A arg)
+	{
+		return ::new (session.arena().allocate(sizeof(S))) S(session, arg);
+	}
+}
+
+
 const std::string HTTPServerRequestImpl::EXPECT("Expect");
 
 
@@ -51,23 +69,24 @@ HTTPServerRequestImpl::HTTPServerRequestImpl(HTTPServerResponseImpl& response, H
 	_serverAddress = session.serverAddress();
 	
 	if (getChunkedTransferEncoding())
-		_pStream = new HTTPChunkedInputStream(session);
+		_pStream = newStream<HTTPChunkedInputStream>(session);
 	else if (hasContentLength())
 #if defined(POCO_HAVE_INT64)
-		_pStream = new HTTPFixedLengthInputStream(session, getContentLength64());
+		_pStream = newStream<HTTPFixedLengthInputStream>(session, getContentLength64());
 #else
-		_pStream = new HTTPFixedLengthInputStream(session, getContentLength());
+		_pStream = newStream<HTTPFixedLengthInputStream>(session, getContentLength());
 #endif
 	else if (getMethod() == HTTPRequest::HTTP_GET || getMethod() == HTTPRequest::HTTP_HEAD)
-		_pStream = new HTTPFixedLengthInputStream(session, 0);
+		_pStream = newStream<HTTPFixedLengthInputStream>(session, 0);
 	else
-		_pStream = new HTTPInputStream(session);
+		_pStream = newStream<HTTPInputStream>(session);
 }
 
 
 HTTPServerRequestImpl::~HTTPServerRequestImpl()
 {
-	delete _pStream;
+	// the stream's memory is owned by the session's arena
+	if (_pStream) _pStream->~basic_istream();
 }
 
 
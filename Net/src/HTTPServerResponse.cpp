@@ -31,4 +31,10 @@ HTTPServerResponse::~HTTPServerResponse()
 }
 
 
+void HTTPServerResponse::sendFileRange(const std::string& path, const std::string& mediaType)
+{
+	sendFile(path, mediaType);
+}
+
+
 } } // namespace Poco::Net
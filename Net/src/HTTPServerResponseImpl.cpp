@@ -30,6 +30,8 @@
 #include "Poco/FileStream.h"
 #include "Poco/DateTimeFormatter.h"
 #include "Poco/DateTimeFormat.h"
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
 
 
 using Poco::File;
@@ -37,14 +39,34 @@ using Poco::Timestamp;
 using Poco::NumberFormatter;
 using Poco::StreamCopier;
 using Poco::OpenFileException;
+using Poco::ReadFileException;
 using Poco::DateTimeFormatter;
 using Poco::DateTimeFormat;
+using Poco::NumberParser;
 
 
 namespace Poco {
 namespace Net {
 
 
+namespace
+{
+	template <class S>
+	S* newStream(HTTPServerSession& session)
+		/// Creates a response stream in the session's arena.
+	{
+		return ::new (session.arena().allocate(sizeof(S))) S(session);
+	}
+
+
+	template <class S, class A>
+	S* newStream(HTTPServerSession& session, A arg)
+	{
+		return ::new (session.arena().allocate(sizeof(S))) S(session, arg);
+	}
+}
+
+
 HTTPServerResponseImpl::HTTPServerResponseImpl(HTTPServerSession& session):
 	_session(session),
 	_pRequest(0),
@@ -55,7 +77,8 @@ HTTPServerResponseImpl::HTTPServerResponseImpl(HTTPServerSession& session):
 
 HTTPServerResponseImpl::~HTTPServerResponseImpl()
 {
-	delete _pStream;
+	// the stream's memory is owned by the session's arena
+	if (_pStream) _pStream->~basic_ostream();
 }
 
 
@@ -77,29 +100,29 @@ std::ostream& HTTPServerResponseImpl::send()
 	{
 		Poco::CountingOutputStream cs;
 		write(cs);
-		_pStream = new HTTPFixedLengthOutputStream(_session, cs.chars());
+		_pStream = newStream<HTTPFixedLengthOutputStream>(_session, cs.chars());
 		write(*_pStream);
 	}
 	else if (getChunkedTransferEncoding())
 	{
 		HTTPHeaderOutputStream hs(_session);
 		write(hs);
-		_pStream = new HTTPChunkedOutputStream(_session);
+		_pStream = newStream<HTTPChunkedOutputStream>(_session);
 	}
 	else if (hasContentLength())
 	{
 		Poco::CountingOutputStream cs;
 		write(cs);
 #if defined(POCO_HAVE_INT64)	
-		_pStream = new HTTPFixedLengthOutputStream(_session, getContentLength64() + cs.chars());
+		_pStream = newStream<HTTPFixedLengthOutputStream>(_session, getContentLength64() + cs.chars());
 #else
-		_pStream = new HTTPFixedLengthOutputStream(_session, getContentLength() + cs.chars());
+		_pStream = newStream<HTTPFixedLengthOutputStream>(_session, getContentLength() + cs.chars());
 #endif
 		write(*_pStream);
 	}
 	else
 	{
-		_pStream = new HTTPOutputStream(_session);
+		_pStream = newStream<HTTPOutputStream>(_session);
 		setKeepAlive(false);
 		write(*_pStream);
 	}
@@ -123,20 +146,139 @@ void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string
 	setContentType(mediaType);
 	setChunkedTransferEncoding(false);
 
+	sendFileContent(path, 0, length);
+}
+
+
+void HTTPServerResponseImpl::sendFileRange(const std::string& path, const std::string& mediaType)
+{
+	poco_assert (!_pStream);
+
+	File f(path);
+	Timestamp dateTime    = f.getLastModified();
+	File::FileSize length = f.getSize();
+	std::string lastModified = DateTimeFormatter::format(dateTime, DateTimeFormat::HTTP_FORMAT);
+	set("Last-Modified", lastModified);
+	set("Accept-Ranges", "bytes");
+	setContentType(mediaType);
+	setChunkedTransferEncoding(false);
+
+	Poco::UInt64 first = 0;
+	Poco::UInt64 last  = 0;
+	RangeResult result = RANGE_NONE;
+	if (_pRequest && _pRequest->has("Range"))
+	{
+		const std::string& ifRange = _pRequest->get("If-Range", lastModified);
+		if (ifRange == lastModified)
+			result = parseRange(_pRequest->get("Range"), length, first, last);
+	}
+
+	if (result == RANGE_UNSATISFIABLE)
+	{
+		setStatusAndReason(HTTPResponse::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+		set("Content-Range", "bytes */" + NumberFormatter::format(length));
+		setContentLength(0);
+		send();
+		return;
+	}
+	else if (result == RANGE_SATISFIABLE)
+	{
+		setStatusAndReason(HTTPResponse::HTTP_PARTIAL_CONTENT);
+		std::string contentRange("bytes ");
+		contentRange += NumberFormatter::format(first);
+		contentRange += '-';
+		contentRange += NumberFormatter::format(last);
+		contentRange += '/';
+		contentRange += NumberFormatter::format(length);
+		set("Content-Range", contentRange);
+	}
+	else
+	{
+		first = 0;
+		last  = length - 1;
+	}
+	Poco::UInt64 count = length > 0 ? last - first + 1 : 0;
+#if defined(POCO_HAVE_INT64)	
+	setContentLength64(count);
+#else
+	setContentLength(static_cast<int>(count));
+#endif
+
+	sendFileContent(path, first, count);
+}
+
+
+void HTTPServerResponseImpl::sendFileContent(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length)
+{
 	Poco::FileInputStream istr(path);
 	if (istr.good())
 	{
-		_pStream = new HTTPHeaderOutputStream(_session);
+		_pStream = newStream<HTTPHeaderOutputStream>(_session);
 		write(*_pStream);
 		if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
 		{
-			StreamCopier::copyStream(istr, *_pStream);
+			// The header must be on the wire before the
+			// file content is written to the socket directly.
+			_pStream->flush();
+			if (_session.sendFile(istr, offset, length) < length)
+			{
+				// The client expects the number of bytes given in the
+				// Content-Length header, so the connection cannot be used
+				// any further.
+				_session.setKeepAlive(false);
+				throw ReadFileException("File has been truncated while sending it", path);
+			}
 		}
 	}
 	else throw OpenFileException(path);
 }
 
 
+HTTPServerResponseImpl::RangeResult HTTPServerResponseImpl::parseRange(const std::string& range, Poco::UInt64 length, Poco::UInt64& first, Poco::UInt64& last)
+{
+	static const std::string BYTES_UNIT("bytes=");
+
+	if (range.size() <= BYTES_UNIT.size() || Poco::icompare(range, 0, BYTES_UNIT.size(), BYTES_UNIT) != 0)
+		return RANGE_NONE;
+	std::string spec = Poco::trim(range.substr(BYTES_UNIT.size()));
+	std::string::size_type pos = spec.find('-');
+	if (pos == std::string::npos || spec.find(',') != std::string::npos)
+		return RANGE_NONE;
+
+	std::string firstStr = Poco::trim(spec.substr(0, pos));
+	std::string lastStr  = Poco::trim(spec.substr(pos + 1));
+	if (firstStr.empty())
+	{
+		// suffix range: the last n bytes of the file
+		Poco::UInt64 suffix;
+		if (!NumberParser::tryParseUnsigned64(lastStr, suffix))
+			return RANGE_NONE;
+		if (suffix == 0 || length == 0)
+			return RANGE_UNSATISFIABLE;
+		first = suffix < length ? length - suffix : 0;
+		last  = length - 1;
+	}
+	else
+	{
+		if (!NumberParser::tryParseUnsigned64(firstStr, first))
+			return RANGE_NONE;
+		if (lastStr.empty())
+		{
+			last = length > 0 ? length - 1 : 0;
+		}
+		else
+		{
+			if (!NumberParser::tryParseUnsigned64(lastStr, last) || last < first)
+				return RANGE_NONE;
+			if (last >= length) last = length - 1;
+		}
+		if (first >= length)
+			return RANGE_UNSATISFIABLE;
+	}
+	return RANGE_SATISFIABLE;
+}
+
+
 void HTTPServerResponseImpl::sendBuffer(const void* pBuffer, std::size_t length)
 {
 	poco_assert (!_pStream);
@@ -144,7 +286,7 @@ void HTTPServerResponseImpl::sendBuffer(const void* pBuffer, std::size_t length)
 	setContentLength(static_cast<int>(length));
 	setChunkedTransferEncoding(false);
 	
-	_pStream = new HTTPHeaderOutputStream(_session);
+	_pStream = newStream<HTTPHeaderOutputStream>(_session);
 	write(*_pStream);
 	if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
 	{
@@ -163,7 +305,7 @@ void HTTPServerResponseImpl::redirect(const std::string& uri, HTTPStatus status)
 	setStatusAndReason(status);
 	set("Location", uri);
 
-	_pStream = new HTTPHeaderOutputStream(_session);
+	_pStream = newStream<HTTPHeaderOutputStream>(_session);
 	write(*_pStream);
 }
 
@@ -39,6 +39,8 @@ HTTPServerSession::~HTTPServerSession()
 
 bool HTTPServerSession::hasMoreRequests()
 {
+	_arena.reset();
+
 	if (!socket().impl()->initialized()) return false;
 
 	if (_firstRequest)
@@ -57,6 +59,15 @@ bool HTTPServerSession::hasMoreRequests()
 }
 
 
+bool HTTPServerSession::idle()
+{
+	return !_firstRequest
+		&& getKeepAlive()
+		&& canKeepAlive()
+		&& buffered() == 0;
+}
+
+
 SocketAddress HTTPServerSession::clientAddress()
 {
 	return socket().peerAddress();
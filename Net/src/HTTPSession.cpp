@@ -147,6 +147,20 @@ int HTTPSession::write(const char* buffer, std::streamsize length)
 }
 
 
+Poco::UInt64 HTTPSession::sendFile(Poco::FileInputStream& stream, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	try
+	{
+		return _socket.sendFile(stream, offset, count);
+	}
+	catch (Poco::Exception& exc)
+	{
+		setException(exc);
+		throw;
+	}
+}
+
+
 int HTTPSession::receive(char* buffer, int length)
 {
 	try
@@ -72,6 +72,7 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 	URI resolvedURI(uri);
 	URI proxyUri;
 	HTTPClientSession* pSession = 0;
+	bool pooled = false;
 	HTTPResponse res;
 	bool retry = false;
 	bool authorize = false;
@@ -82,7 +83,12 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 	{
 		do
 		{
-			if (!pSession)
+			if (!pSession && _pPool && proxyUri.empty() && _proxyHost.empty())
+			{
+				pSession = _pPool->get(resolvedURI);
+				pooled = true;
+			}
+			else if (!pSession)
 			{
 				pSession = new HTTPClientSession(resolvedURI.getHost(), resolvedURI.getPort());
 			
@@ -132,7 +138,10 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 			}
 			else if (res.getStatus() == HTTPResponse::HTTP_OK)
 			{
-				return new HTTPResponseStream(rs, pSession);
+				if (pooled)
+					return new HTTPResponseStream(rs, pSession, _pPool, res);
+				else
+					return new HTTPResponseStream(rs, pSession);
 			}
 			else if (res.getStatus() == HTTPResponse::HTTP_USEPROXY && !retry)
 			{
@@ -142,8 +151,9 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 				// single request via the proxy. 305 responses MUST only be generated by origin servers.
 				// only use for one single request!
 				proxyUri.resolve(res.get("Location"));
-				delete pSession; 
+				releaseSession(pSession, pooled);
 				pSession = 0;
+				pooled = false;
 				retry = true; // only allow useproxy once
 			}
 			else if (res.getStatus() == HTTPResponse::HTTP_UNAUTHORIZED && !authorize)
@@ -160,12 +170,37 @@ std::istream* HTTPStreamFactory::open(const URI& uri)
 	}
 	catch (...)
 	{
-		delete pSession;
+		if (pSession) releaseSession(pSession, pooled);
 		throw;
 	}
 }
 
 
+void HTTPStreamFactory::setSessionPool(HTTPClientSessionPool::Ptr pPool)
+{
+	_pPool = pPool;
+}
+
+
+HTTPClientSessionPool::Ptr HTTPStreamFactory::getSessionPool() const
+{
+	return _pPool;
+}
+
+
+void HTTPStreamFactory::releaseSession(HTTPClientSession* pSession, bool pooled)
+{
+	if (pooled)
+	{
+		// the response body has not been read, so the
+		// connection cannot be reused
+		pSession->reset();
+		_pPool->putBack(pSession);
+	}
+	else delete pSession;
+}
+
+
 void HTTPStreamFactory::registerFactory()
 {
 	URIStreamOpener::defaultOpener().registerStreamFactory("http", new HTTPStreamFactory);
@@ -18,12 +18,73 @@
 #include "Poco/Net/NetException.h"
 #include "Poco/String.h"
 #include "Poco/Ascii.h"
+#include <cstring>
 
 
 namespace Poco {
 namespace Net {
 
 
+namespace
+{
+	class GetArea: public std::streambuf
+		/// Gives access to the get area of an arbitrary streambuf.
+		/// The pointers to the protected members are taken through
+		/// the derived class, which is allowed, and then applied to
+		/// a std::streambuf.
+	{
+	public:
+		static const char* begin(std::streambuf& buf)
+		{
+			return (buf.*&GetArea::gptr)();
+		}
+		
+		static const char* end(std::streambuf& buf)
+		{
+			return (buf.*&GetArea::egptr)();
+		}
+		
+		static void skip(std::streambuf& buf, int n)
+		{
+			(buf.*&GetArea::gbump)(n);
+		}
+	};
+
+
+	int readRun(std::streambuf& buf, int ch, char stop1, char stop2, char* buffer, int& length, int maxLength)
+		/// Appends ch and the following characters to buffer, until
+		/// stop1, stop2, EOF or maxLength is reached. Characters already
+		/// in the get area are scanned and copied in bulk; only at the
+		/// end of the get area a single character is read with sbumpc(),
+		/// which refills the buffer. Returns the first character not
+		/// appended, which has been consumed, like sbumpc() does.
+	{
+		static const int eof = std::char_traits<char>::eof();
+
+		while (ch != eof && ch != stop1 && ch != stop2 && length < maxLength)
+		{
+			buffer[length++] = static_cast<char>(ch);
+			const char* begin = GetArea::begin(buf);
+			const char* end   = GetArea::end(buf);
+			if (end - begin > maxLength - length) end = begin + (maxLength - length);
+			const char* stop = begin < end ? static_cast<const char*>(std::memchr(begin, stop1, end - begin)) : 0;
+			if (stop) end = stop;
+			stop = begin < end ? static_cast<const char*>(std::memchr(begin, stop2, end - begin)) : 0;
+			if (stop) end = stop;
+			int n = static_cast<int>(end - begin);
+			if (n > 0)
+			{
+				std::memcpy(buffer + length, begin, n);
+				length += n;
+				GetArea::skip(buf, n);
+			}
+			ch = buf.sbumpc();
+		}
+		return ch;
+	}
+}
+
+
 MessageHeader::MessageHeader():
 	_fieldLimit(DFL_FIELD_LIMIT)
 {
@@ -65,24 +126,27 @@ void MessageHeader::read(std::istream& istr)
 	static const int eof = std::char_traits<char>::eof();
 	std::streambuf& buf = *istr.rdbuf();
 
-	std::string name;
-	std::string value;
-	name.reserve(32);
-	value.reserve(64);
+	// Names and values are collected in fixed-size buffers, so
+	// that no strings are built up character by character. Strings
+	// are only created once a field has been read completely.
+	// Runs of name and value characters are copied out of the
+	// streambuf's get area in bulk.
+	char name[MAX_NAME_LENGTH];
+	char value[MAX_VALUE_LENGTH];
 	int ch = buf.sbumpc();
 	int fields = 0;
 	while (ch != eof && ch != '\r' && ch != '\n')
 	{
 		if (_fieldLimit > 0 && fields == _fieldLimit)
 			throw MessageException("Too many header fields");
-		name.clear();
-		value.clear();
-		while (ch != eof && ch != ':' && ch != '\n' && name.length() < MAX_NAME_LENGTH) { name += ch; ch = buf.sbumpc(); }
+		int nameLength  = 0;
+		int valueLength = 0;
+		ch = readRun(buf, ch, ':', '\n', name, nameLength, MAX_NAME_LENGTH);
 		if (ch == '\n') { ch = buf.sbumpc(); continue; } // ignore invalid header lines
 		if (ch != ':') throw MessageException("Field name too long/no colon found");
 		if (ch != eof) ch = buf.sbumpc(); // ':'
 		while (ch != eof && Poco::Ascii::isSpace(ch) && ch != '\r' && ch != '\n') ch = buf.sbumpc();
-		while (ch != eof && ch != '\r' && ch != '\n' && value.length() < MAX_VALUE_LENGTH) { value += ch; ch = buf.sbumpc(); }
+		ch = readRun(buf, ch, '\r', '\n', value, valueLength, MAX_VALUE_LENGTH);
 		if (ch == '\r') ch = buf.sbumpc();
 		if (ch == '\n')
 			ch = buf.sbumpc();
@@ -90,15 +154,15 @@ void MessageHeader::read(std::istream& istr)
 			throw MessageException("Field value too long/no CRLF found");
 		while (ch == ' ' || ch == '\t') // folding
 		{
-			while (ch != eof && ch != '\r' && ch != '\n' && value.length() < MAX_VALUE_LENGTH) { value += ch; ch = buf.sbumpc(); }
+			ch = readRun(buf, ch, '\r', '\n', value, valueLength, MAX_VALUE_LENGTH);
 			if (ch == '\r') ch = buf.sbumpc();
 			if (ch == '\n')
 				ch = buf.sbumpc();
 			else if (ch != eof)
 				throw MessageException("Folded field value too long/no CRLF found");
 		}
-		Poco::trimRightInPlace(value);
-		add(name, value);
+		while (valueLength > 0 && Poco::Ascii::isSpace(value[valueLength - 1])) --valueLength;
+		add(std::string(name, nameLength), std::string(value, valueLength));
 		++fields;
 	}
 	istr.putback(ch);
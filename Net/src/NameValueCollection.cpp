@@ -16,6 +16,7 @@
 
 #include "Poco/Net/NameValueCollection.h"
 #include "Poco/Exception.h"
+#include "Poco/Ascii.h"
 #include <algorithm>
 
 
@@ -26,14 +27,17 @@ namespace Poco {
 namespace Net {
 
 
-NameValueCollection::NameValueCollection()
+NameValueCollection::NameValueCollection():
+	_indexSize(0)
 {
 }
 
 
 NameValueCollection::NameValueCollection(const NameValueCollection& nvc):
-	_map(nvc._map)
+	_list(nvc._list),
+	_indexSize(0)
 {
+	rebuildIndex();
 }
 
 
@@ -46,7 +50,8 @@ NameValueCollection& NameValueCollection::operator = (const NameValueCollection&
 {
 	if (&nvc != this)
 	{
-		_map = nvc._map;
+		_list = nvc._list;
+		rebuildIndex();
 	}
 	return *this;
 }
@@ -54,14 +59,18 @@ NameValueCollection& NameValueCollection::operator = (const NameValueCollection&
 
 void NameValueCollection::swap(NameValueCollection& nvc)
 {
-	std::swap(_map, nvc._map);
+	// list iterators stay valid when swapping the lists,
+	// so the indexes can be swapped as well
+	_list.swap(nvc._list);
+	_index.swap(nvc._index);
+	std::swap(_indexSize, nvc._indexSize);
 }
 
 	
 const std::string& NameValueCollection::operator [] (const std::string& name) const
 {
-	ConstIterator it = _map.find(name);
-	if (it != _map.end())
+	ConstIterator it = lookup(name, hash(name));
+	if (it != _list.end())
 		return it->second;
 	else
 		throw NotFoundException(name);
@@ -70,24 +79,25 @@ const std::string& NameValueCollection::operator [] (const std::string& name) co
 	
 void NameValueCollection::set(const std::string& name, const std::string& value)	
 {
-	Iterator it = _map.find(name);
-	if (it != _map.end())
+	Poco::UInt32 h = hash(name);
+	Iterator it = lookup(name, h);
+	if (it != _list.end())
 		it->second = value;
 	else
-		_map.insert(HeaderMap::ValueType(name, value));
+		insert(name, value, h);
 }
 
 	
 void NameValueCollection::add(const std::string& name, const std::string& value)
 {
-	_map.insert(HeaderMap::ValueType(name, value));
+	insert(name, value, hash(name));
 }
 
 	
 const std::string& NameValueCollection::get(const std::string& name) const
 {
-	ConstIterator it = _map.find(name);
-	if (it != _map.end())
+	ConstIterator it = lookup(name, hash(name));
+	if (it != _list.end())
 		return it->second;
 	else
 		throw NotFoundException(name);
@@ -96,8 +106,8 @@ const std::string& NameValueCollection::get(const std::string& name) const
 
 const std::string& NameValueCollection::get(const std::string& name, const std::string& defaultValue) const
 {
-	ConstIterator it = _map.find(name);
-	if (it != _map.end())
+	ConstIterator it = lookup(name, hash(name));
+	if (it != _list.end())
 		return it->second;
 	else
 		return defaultValue;
@@ -106,49 +116,163 @@ const std::string& NameValueCollection::get(const std::string& name, const std::
 
 bool NameValueCollection::has(const std::string& name) const
 {
-	return _map.find(name) != _map.end();
+	return lookup(name, hash(name)) != _list.end();
 }
 
 
 NameValueCollection::ConstIterator NameValueCollection::find(const std::string& name) const
 {
-	return _map.find(name);
+	return lookup(name, hash(name));
 }
 
 	
 NameValueCollection::ConstIterator NameValueCollection::begin() const
 {
-	return _map.begin();
+	return _list.begin();
 }
 
 	
 NameValueCollection::ConstIterator NameValueCollection::end() const
 {
-	return _map.end();
+	return _list.end();
 }
 
 	
 bool NameValueCollection::empty() const
 {
-	return _map.empty();
+	return _list.empty();
 }
 
 
 std::size_t NameValueCollection::size() const
 {
-	return _map.size();
+	return _list.size();
 }
 
 
 void NameValueCollection::erase(const std::string& name)
 {
-	_map.erase(name);
+	Iterator it = lookup(name, hash(name));
+	if (it != _list.end())
+	{
+		// name-value pairs with the same name are always adjacent
+		while (it != _list.end() && Poco::icompare(it->first, name) == 0)
+			it = _list.erase(it);
+		rebuildIndex();
+	}
 }
 
 
 void NameValueCollection::clear()
 {
-	_map.clear();
+	_list.clear();
+	_index.clear();
+	_indexSize = 0;
+}
+
+
+Poco::UInt32 NameValueCollection::hash(const std::string& name)
+{
+	// FNV-1a over the lower-case characters of the name
+	Poco::UInt32 h = 2166136261U;
+	for (std::string::const_iterator it = name.begin(); it != name.end(); ++it)
+	{
+		h ^= static_cast<unsigned char>(Poco::Ascii::toLower(*it));
+		h *= 16777619U;
+	}
+	return h;
+}
+
+
+NameValueCollection::Iterator NameValueCollection::lookup(const std::string& name, Poco::UInt32 hash) const
+{
+	Container& list = const_cast<Container&>(_list);
+	if (_index.empty())
+	{
+		Iterator it = list.begin();
+		Iterator end = list.end();
+		for (; it != end; ++it)
+		{
+			if (Poco::icompare(it->first, name) == 0) return it;
+		}
+		return end;
+	}
+	else
+	{
+		IndexEntry* pEntry = lookupEntry(name, hash);
+		return pEntry->used ? pEntry->first : list.end();
+	}
+}
+
+
+NameValueCollection::IndexEntry* NameValueCollection::lookupEntry(const std::string& name, Poco::UInt32 hash) const
+{
+	poco_assert_dbg (!_index.empty());
+
+	std::size_t mask = _index.size() - 1;
+	std::size_t i = hash & mask;
+	while (_index[i].used)
+	{
+		if (_index[i].hash == hash && Poco::icompare(_index[i].first->first, name) == 0)
+			break;
+		i = (i + 1) & mask;
+	}
+	return &_index[i];
+}
+
+
+void NameValueCollection::insert(const std::string& name, const std::string& value, Poco::UInt32 hash)
+{
+	Iterator it = lookup(name, hash);
+	if (it == _list.end())
+	{
+		it = _list.insert(_list.end(), HeaderMap::ValueType(name, value));
+		if (!_index.empty())
+		{
+			IndexEntry* pEntry = lookupEntry(name, hash);
+			pEntry->used  = true;
+			pEntry->hash  = hash;
+			pEntry->first = it;
+			if (++_indexSize*2 > _index.size()) rebuildIndex();
+		}
+		else if (_list.size() > INDEX_THRESHOLD)
+		{
+			rebuildIndex();
+		}
+	}
+	else
+	{
+		// same as ListMap: a new pair is inserted in front of the
+		// existing pairs with the same name
+		it = _list.insert(it, HeaderMap::ValueType(name, value));
+		if (!_index.empty())
+			lookupEntry(name, hash)->first = it;
+	}
+}
+
+
+void NameValueCollection::rebuildIndex()
+{
+	_index.clear();
+	_indexSize = 0;
+	if (_list.size() > INDEX_THRESHOLD)
+	{
+		std::size_t size = MIN_INDEX_SIZE;
+		while (size < 2*_list.size()) size *= 2;
+		_index.resize(size);
+		for (Iterator it = _list.begin(); it != _list.end(); ++it)
+		{
+			Poco::UInt32 h = hash(it->first);
+			IndexEntry* pEntry = lookupEntry(it->first, h);
+			if (!pEntry->used)
+			{
+				pEntry->used  = true;
+				pEntry->hash  = h;
+				pEntry->first = it;
+				++_indexSize;
+			}
+		}
+	}
 }
 
 
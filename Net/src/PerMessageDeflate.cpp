@@ -0,0 +1,343 @@
+//
+// PerMessageDeflate.cpp
+//
+// $Id: //poco/1.4/Net/src/PerMessageDeflate.cpp#1 $
+//
+// Library: Net
+// Package: WebSocket
+// Module:  PerMessageDeflate
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/PerMessageDeflate.h"
+#include "Poco/Net/MessageHeader.h"
+#include "Poco/Net/NameValueCollection.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
+#include "Poco/Exception.h"
+#include <cstring>
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	const char DEFLATE_TAIL[] = {'\x00', '\x00', '\xff', '\xff'};
+
+	struct ExtensionParams
+		/// The parameters of a permessage-deflate
+		/// extension offer or response.
+	{
+		ExtensionParams():
+			serverNoContextTakeover(false),
+			clientNoContextTakeover(false),
+			serverMaxWindowBits(0),
+			clientMaxWindowBits(0)
+		{
+		}
+
+		bool serverNoContextTakeover;
+		bool clientNoContextTakeover;
+		int  serverMaxWindowBits; /// 0 if not present
+		int  clientMaxWindowBits; /// 0 if not present, -1 if present without value
+	};
+
+	bool parseWindowBits(const std::string& value, int& bits)
+	{
+		return Poco::NumberParser::tryParse(value, bits) && bits >= 8 && bits <= 15;
+	}
+
+	bool parseExtension(const std::string& element, bool offer, ExtensionParams& params)
+		/// Parses an extension offer (or response, if offer is false).
+		/// Returns false if the element is not a valid permessage-deflate
+		/// extension.
+	{
+		std::string name;
+		NameValueCollection paramColl;
+		MessageHeader::splitParameters(element, name, paramColl);
+		if (Poco::icompare(name, PerMessageDeflate::EXTENSION_NAME) != 0) return false;
+
+		bool haveServerMaxWindowBits = false;
+		bool haveClientMaxWindowBits = false;
+		for (NameValueCollection::ConstIterator it = paramColl.begin(); it != paramColl.end(); ++it)
+		{
+			if (Poco::icompare(it->first, "server_no_context_takeover") == 0)
+			{
+				if (params.serverNoContextTakeover || !it->second.empty()) return false;
+				params.serverNoContextTakeover = true;
+			}
+			else if (Poco::icompare(it->first, "client_no_context_takeover") == 0)
+			{
+				if (params.clientNoContextTakeover || !it->second.empty()) return false;
+				params.clientNoContextTakeover = true;
+			}
+			else if (Poco::icompare(it->first, "server_max_window_bits") == 0)
+			{
+				if (haveServerMaxWindowBits || !parseWindowBits(it->second, params.serverMaxWindowBits)) return false;
+				haveServerMaxWindowBits = true;
+			}
+			else if (Poco::icompare(it->first, "client_max_window_bits") == 0)
+			{
+				if (haveClientMaxWindowBits) return false;
+				haveClientMaxWindowBits = true;
+				if (it->second.empty() && offer)
+					params.clientMaxWindowBits = -1;
+				else if (!parseWindowBits(it->second, params.clientMaxWindowBits))
+					return false;
+			}
+			else return false;
+		}
+		return true;
+	}
+
+	void appendWindowBits(std::string& s, const char* name, int bits)
+	{
+		s += "; ";
+		s += name;
+		s += '=';
+		Poco::NumberFormatter::append(s, bits);
+	}
+}
+
+
+const std::string PerMessageDeflate::EXTENSION_NAME("permessage-deflate");
+
+
+PerMessageDeflate::PerMessageDeflate(int level, int deflateWindowBits, bool deflateNoContextTakeover, bool inflateNoContextTakeover):
+	// negative window bits select a raw deflate stream without zlib header
+	_deflater(-deflateWindowBits, level),
+	// the peer may use any window size up to the maximum
+	_inflater(-MAX_WINDOW_BITS),
+	_deflateNoContextTakeover(deflateNoContextTakeover),
+	_inflateNoContextTakeover(inflateNoContextTakeover),
+	_deflateBuffer(DEFLATE_BUFFER_SIZE),
+	_inflateBuffer(DEFLATE_BUFFER_SIZE),
+	_bytesDeflated(0),
+	_compressedBytesDeflated(0),
+	_bytesInflated(0),
+	_compressedBytesInflated(0)
+{
+	poco_assert (deflateWindowBits >= MIN_WINDOW_BITS && deflateWindowBits <= MAX_WINDOW_BITS);
+}
+
+
+PerMessageDeflate::~PerMessageDeflate()
+{
+}
+
+
+const Poco::Buffer<char>& PerMessageDeflate::deflate(const SocketBufVec& buffers, bool fin)
+{
+	std::size_t used = 0;
+	_deflateBuffer.resize(_deflateBuffer.capacity());
+	Poco::Deflater::FlushMode flush = Poco::Deflater::FLUSH_NONE;
+	SocketBufVec::const_iterator it = buffers.begin();
+	for (;;)
+	{
+		if (flush == Poco::Deflater::FLUSH_NONE)
+		{
+			if (it == buffers.end())
+			{
+				// flush the pending output to a byte boundary, ending
+				// with an empty stored block (00 00 ff ff)
+				flush = Poco::Deflater::FLUSH_SYNC;
+				_deflater.setInput(0, 0);
+			}
+			else
+			{
+				_deflater.setInput(socketBufData(*it), socketBufLength(*it));
+				_bytesDeflated += socketBufLength(*it);
+				++it;
+			}
+		}
+		bool full;
+		do
+		{
+			if (used == _deflateBuffer.size()) _deflateBuffer.resize(2*_deflateBuffer.size());
+			std::size_t available = _deflateBuffer.size() - used;
+			std::size_t n = _deflater.deflate(_deflateBuffer.begin() + used, available, flush);
+			used += n;
+			full = n == available;
+		}
+		while (_deflater.inputAvailable() > 0 || (flush == Poco::Deflater::FLUSH_SYNC && full));
+		if (flush == Poco::Deflater::FLUSH_SYNC) break;
+	}
+	if (fin)
+	{
+		// RFC 7692, section 7.2.1: the tail of the last frame is removed
+		if (used >= 4 && std::memcmp(_deflateBuffer.begin() + used - 4, DEFLATE_TAIL, 4) == 0) used -= 4;
+		if (_deflateNoContextTakeover) _deflater.reset();
+	}
+	_deflateBuffer.resize(used);
+	_compressedBytesDeflated += used;
+	return _deflateBuffer;
+}
+
+
+char* PerMessageDeflate::inflateBuffer(int length)
+{
+	poco_assert (length >= 0);
+
+	_inflateBuffer.resize(length > 0 ? length : 1, false);
+	return _inflateBuffer.begin();
+}
+
+
+int PerMessageDeflate::inflate(const char* data, int length, bool fin, char* buffer, int bufferLength)
+{
+	std::size_t used = 0;
+	std::size_t size = static_cast<std::size_t>(bufferLength);
+	inflateInput(data, length, buffer, size, used);
+	if (fin) inflateInput(DEFLATE_TAIL, 4, buffer, size, used);
+	if (used == size)
+	{
+		// make sure there is no more output pending
+		char c;
+		std::size_t n;
+		_inflater.inflate(&c, 1, n);
+		if (n > 0)
+			throw WebSocketException("Insufficient buffer for decompressed payload", WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	}
+	if (fin && _inflateNoContextTakeover) _inflater.reset();
+	_compressedBytesInflated += length;
+	_bytesInflated += used;
+	return static_cast<int>(used);
+}
+
+
+void PerMessageDeflate::inflateInput(const char* data, int length, char* buffer, std::size_t bufferLength, std::size_t& used)
+{
+	_inflater.setInput(data, length);
+	while (_inflater.inputAvailable() > 0)
+	{
+		std::size_t n;
+		Poco::Inflater::Status status;
+		try
+		{
+			status = _inflater.inflate(buffer + used, bufferLength - used, n);
+		}
+		catch (Poco::DataFormatException&)
+		{
+			throw WebSocketException("Invalid compressed payload received", WebSocket::WS_ERR_COMPRESSION);
+		}
+		used += n;
+		if (status == Poco::Inflater::INFLATE_NO_PROGRESS)
+		{
+			// no progress possible, as the output buffer is full
+			throw WebSocketException("Insufficient buffer for decompressed payload", WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+		}
+		else if (status == Poco::Inflater::INFLATE_STREAM_END)
+		{
+			// the peer has finished the deflate stream with a final
+			// block; a new stream may follow within the same message
+			_inflater.reset();
+		}
+	}
+}
+
+
+std::string PerMessageDeflate::offer(const WebSocket::DeflateConfig& config)
+{
+	std::string result(EXTENSION_NAME);
+	if (config.serverNoContextTakeover) result += "; server_no_context_takeover";
+	if (config.clientNoContextTakeover) result += "; client_no_context_takeover";
+	if (config.serverMaxWindowBits < MAX_WINDOW_BITS) appendWindowBits(result, "server_max_window_bits", config.serverMaxWindowBits);
+	if (config.clientMaxWindowBits < MAX_WINDOW_BITS)
+		appendWindowBits(result, "client_max_window_bits", config.clientMaxWindowBits);
+	else
+		result += "; client_max_window_bits";
+	return result;
+}
+
+
+PerMessageDeflate* PerMessageDeflate::accept(const MessageHeader& request, const WebSocket::DeflateConfig& config, std::string& response)
+{
+	poco_assert (config.serverMaxWindowBits >= MIN_WINDOW_BITS && config.serverMaxWindowBits <= MAX_WINDOW_BITS);
+	poco_assert (config.clientMaxWindowBits >= MIN_WINDOW_BITS && config.clientMaxWindowBits <= MAX_WINDOW_BITS);
+
+	for (NameValueCollection::ConstIterator it = request.begin(); it != request.end(); ++it)
+	{
+		if (Poco::icompare(it->first, "Sec-WebSocket-Extensions") != 0) continue;
+
+		std::vector<std::string> offers;
+		MessageHeader::splitElements(it->second, offers);
+		for (std::vector<std::string>::const_iterator itOffer = offers.begin(); itOffer != offers.end(); ++itOffer)
+		{
+			ExtensionParams params;
+			if (!parseExtension(*itOffer, true, params)) continue;
+
+			int serverWindowBits = config.serverMaxWindowBits;
+			if (params.serverMaxWindowBits > 0 && params.serverMaxWindowBits < serverWindowBits)
+				serverWindowBits = params.serverMaxWindowBits;
+			// zlib does not support a window size of 256 bytes
+			if (serverWindowBits < MIN_WINDOW_BITS) continue;
+
+			int clientWindowBits = config.clientMaxWindowBits;
+			if (params.clientMaxWindowBits > 0 && params.clientMaxWindowBits < clientWindowBits)
+				clientWindowBits = params.clientMaxWindowBits;
+			// the client window size can only be restricted if the client supports it
+			if (params.clientMaxWindowBits == 0 && clientWindowBits < MAX_WINDOW_BITS)
+				clientWindowBits = MAX_WINDOW_BITS;
+
+			bool serverNoContextTakeover = params.serverNoContextTakeover || config.serverNoContextTakeover;
+			bool clientNoContextTakeover = params.clientNoContextTakeover || config.clientNoContextTakeover;
+
+			response = EXTENSION_NAME;
+			if (serverNoContextTakeover) response += "; server_no_context_takeover";
+			if (clientNoContextTakeover) response += "; client_no_context_takeover";
+			if (params.serverMaxWindowBits > 0 || serverWindowBits < MAX_WINDOW_BITS)
+				appendWindowBits(response, "server_max_window_bits", serverWindowBits);
+			if (params.clientMaxWindowBits != 0 && clientWindowBits < MAX_WINDOW_BITS)
+				appendWindowBits(response, "client_max_window_bits", clientWindowBits);
+
+			return new PerMessageDeflate(config.compressionLevel, serverWindowBits, serverNoContextTakeover, clientNoContextTakeover);
+		}
+	}
+	return 0;
+}
+
+
+PerMessageDeflate* PerMessageDeflate::complete(const MessageHeader& response, const WebSocket::DeflateConfig& config)
+{
+	PerMessageDeflate* pDeflate = 0;
+	for (NameValueCollection::ConstIterator it = response.begin(); it != response.end(); ++it)
+	{
+		if (Poco::icompare(it->first, "Sec-WebSocket-Extensions") != 0) continue;
+
+		std::vector<std::string> extensions;
+		MessageHeader::splitElements(it->second, extensions);
+		for (std::vector<std::string>::const_iterator itExt = extensions.begin(); itExt != extensions.end(); ++itExt)
+		{
+			ExtensionParams params;
+			if (!parseExtension(*itExt, false, params) || pDeflate)
+			{
+				delete pDeflate;
+				throw WebSocketException("Invalid Sec-WebSocket-Extensions header in handshake response", *itExt, WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+			}
+			int clientWindowBits = config.clientMaxWindowBits;
+			if (params.clientMaxWindowBits > 0 && params.clientMaxWindowBits < clientWindowBits)
+				clientWindowBits = params.clientMaxWindowBits;
+			if (clientWindowBits < MIN_WINDOW_BITS || params.serverMaxWindowBits > config.serverMaxWindowBits)
+				throw WebSocketException("Unsupported window size in Sec-WebSocket-Extensions header in handshake response", *itExt, WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+			if (params.serverNoContextTakeover == false && config.serverNoContextTakeover)
+				throw WebSocketException("Missing server_no_context_takeover in Sec-WebSocket-Extensions header in handshake response", *itExt, WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+
+			bool clientNoContextTakeover = params.clientNoContextTakeover || config.clientNoContextTakeover;
+			pDeflate = new PerMessageDeflate(config.compressionLevel, clientWindowBits, clientNoContextTakeover, params.serverNoContextTakeover);
+		}
+	}
+	return pDeflate;
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,367 @@
+//
+// PollSet.cpp
+//
+// $Id: //poco/1.4/Net/src/PollSet.cpp#1 $
+//
+// Library: Net
+// Package: Sockets
+// Module:  PollSet
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/PollSet.h"
+#include "Poco/Net/SocketImpl.h"
+#include "Poco/Mutex.h"
+#include "Poco/Timestamp.h"
+#include <vector>
+#if defined(POCO_HAVE_FD_EPOLL)
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+
+namespace Poco {
+namespace Net {
+
+
+#if defined(POCO_HAVE_FD_EPOLL)
+
+
+//
+// Linux implementation using epoll
+//
+class PollSetImpl
+{
+public:
+	PollSetImpl():
+		_epollfd(-1),
+		_events(MAX_EVENTS)
+	{
+		_epollfd = epoll_create(MAX_EVENTS);
+		if (_epollfd < 0) SocketImpl::error();
+	}
+
+	~PollSetImpl()
+	{
+		if (_epollfd >= 0) ::close(_epollfd);
+	}
+
+	void add(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		SocketImpl* pImpl = socket.impl();
+		SocketMap::iterator it = _socketMap.find(pImpl);
+		if (it == _socketMap.end())
+		{
+			control(pImpl, mode, EPOLL_CTL_ADD);
+			_socketMap[pImpl] = socket;
+		}
+		else control(pImpl, mode, EPOLL_CTL_MOD);
+	}
+
+	void remove(const Socket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		SocketImpl* pImpl = socket.impl();
+		SocketMap::iterator it = _socketMap.find(pImpl);
+		if (it != _socketMap.end())
+		{
+			poco_socket_t fd = pImpl->sockfd();
+			if (fd != POCO_INVALID_SOCKET)
+			{
+				// The socket may have been closed already, in which case
+				// the kernel has removed it from the epoll set on its own.
+				struct epoll_event ev;
+				ev.events = 0;
+				ev.data.ptr = 0;
+				epoll_ctl(_epollfd, EPOLL_CTL_DEL, fd, &ev);
+			}
+			_socketMap.erase(it);
+		}
+	}
+
+	bool has(const Socket& socket) const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _socketMap.find(socket.impl()) != _socketMap.end();
+	}
+
+	std::size_t count() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _socketMap.size();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		for (SocketMap::iterator it = _socketMap.begin(); it != _socketMap.end(); ++it)
+		{
+			poco_socket_t fd = it->second.impl()->sockfd();
+			if (fd != POCO_INVALID_SOCKET)
+			{
+				struct epoll_event ev;
+				ev.events = 0;
+				ev.data.ptr = 0;
+				epoll_ctl(_epollfd, EPOLL_CTL_DEL, fd, &ev);
+			}
+		}
+		_socketMap.clear();
+	}
+
+	PollSet::SocketModeMap poll(const Poco::Timespan& timeout)
+	{
+		PollSet::SocketModeMap result;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_socketMap.empty()) return result;
+		}
+
+		Poco::Timespan remainingTime(timeout);
+		int rc;
+		do
+		{
+			Poco::Timestamp start;
+			rc = epoll_wait(_epollfd, &_events[0], static_cast<int>(_events.size()), static_cast<int>(remainingTime.totalMilliseconds()));
+			if (rc < 0 && SocketImpl::lastError() == POCO_EINTR)
+			{
+				Poco::Timestamp end;
+				Poco::Timespan waited = end - start;
+				if (waited < remainingTime)
+					remainingTime -= waited;
+				else
+					remainingTime = 0;
+			}
+		}
+		while (rc < 0 && SocketImpl::lastError() == POCO_EINTR);
+		if (rc < 0) SocketImpl::error();
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		for (int i = 0; i < rc; ++i)
+		{
+			// The socket may have been removed while we were waiting,
+			// so data.ptr must not be dereferenced before looking it up.
+			SocketMap::iterator it = _socketMap.find(_events[i].data.ptr);
+			if (it != _socketMap.end())
+			{
+				int mode = 0;
+				if (_events[i].events & EPOLLIN)
+					mode |= PollSet::POLL_READ;
+				if (_events[i].events & EPOLLOUT)
+					mode |= PollSet::POLL_WRITE;
+				if (_events[i].events & EPOLLERR)
+					mode |= PollSet::POLL_ERROR;
+				// EPOLLHUP is reported even if not requested. As epoll is
+				// level-triggered, a hung-up socket must be reported, or
+				// the caller would be woken up again and again without
+				// ever learning about it.
+				if (_events[i].events & EPOLLHUP)
+					mode |= PollSet::POLL_READ | PollSet::POLL_ERROR;
+				if (mode) result[it->second] |= mode;
+			}
+		}
+		return result;
+	}
+
+private:
+	typedef std::map<void*, Socket> SocketMap;
+
+	enum
+	{
+		MAX_EVENTS = 1024
+	};
+
+	void control(SocketImpl* pImpl, int mode, int op)
+	{
+		poco_socket_t fd = pImpl->sockfd();
+		if (fd == POCO_INVALID_SOCKET) return;
+
+		struct epoll_event ev;
+		ev.events = 0;
+		if (mode & PollSet::POLL_READ)
+			ev.events |= EPOLLIN;
+		if (mode & PollSet::POLL_WRITE)
+			ev.events |= EPOLLOUT;
+		if (mode & PollSet::POLL_ERROR)
+			ev.events |= EPOLLERR;
+		ev.data.ptr = pImpl;
+		int rc = epoll_ctl(_epollfd, op, fd, &ev);
+		if (rc < 0 && op == EPOLL_CTL_ADD && errno == EEXIST)
+			rc = epoll_ctl(_epollfd, EPOLL_CTL_MOD, fd, &ev);
+		else if (rc < 0 && op == EPOLL_CTL_MOD && errno == ENOENT)
+			rc = epoll_ctl(_epollfd, EPOLL_CTL_ADD, fd, &ev);
+		if (rc < 0) SocketImpl::error();
+	}
+
+	mutable Poco::FastMutex _mutex;
+	int _epollfd;
+	SocketMap _socketMap;
+	std::vector<struct epoll_event> _events;
+};
+
+
+#else
+
+
+//
+// Platform-independent implementation based on Socket::select()
+//
+class PollSetImpl
+{
+public:
+	void add(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_socketMap[socket] = mode;
+	}
+
+	void remove(const Socket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_socketMap.erase(socket);
+	}
+
+	bool has(const Socket& socket) const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _socketMap.find(socket) != _socketMap.end();
+	}
+
+	std::size_t count() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _socketMap.size();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_socketMap.clear();
+	}
+
+	PollSet::SocketModeMap poll(const Poco::Timespan& timeout)
+	{
+		Socket::SocketList readList;
+		Socket::SocketList writeList;
+		Socket::SocketList exceptList;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			for (PollSet::SocketModeMap::const_iterator it = _socketMap.begin(); it != _socketMap.end(); ++it)
+			{
+				if (it->second & PollSet::POLL_READ)
+					readList.push_back(it->first);
+				if (it->second & PollSet::POLL_WRITE)
+					writeList.push_back(it->first);
+				if (it->second & PollSet::POLL_ERROR)
+					exceptList.push_back(it->first);
+			}
+		}
+
+		PollSet::SocketModeMap result;
+		if (readList.empty() && writeList.empty() && exceptList.empty()) return result;
+
+		Socket::select(readList, writeList, exceptList, timeout);
+		for (Socket::SocketList::iterator it = readList.begin(); it != readList.end(); ++it)
+			result[*it] |= PollSet::POLL_READ;
+		for (Socket::SocketList::iterator it = writeList.begin(); it != writeList.end(); ++it)
+			result[*it] |= PollSet::POLL_WRITE;
+		for (Socket::SocketList::iterator it = exceptList.begin(); it != exceptList.end(); ++it)
+			result[*it] |= PollSet::POLL_ERROR;
+		return result;
+	}
+
+private:
+	mutable Poco::FastMutex _mutex;
+	PollSet::SocketModeMap  _socketMap;
+};
+
+
+#endif // POCO_HAVE_FD_EPOLL
+
+
+//
+// PollSet
+//
+
+
+PollSet::PollSet():
+	_pImpl(new PollSetImpl)
+{
+}
+
+
+PollSet::~PollSet()
+{
+	delete _pImpl;
+}
+
+
+void PollSet::add(const Socket& socket, int mode)
+{
+	_pImpl->add(socket, mode);
+}
+
+
+void PollSet::remove(const Socket& socket)
+{
+	_pImpl->remove(socket);
+}
+
+
+void PollSet::update(const Socket& socket, int mode)
+{
+	if (mode)
+		_pImpl->add(socket, mode);
+	else
+		_pImpl->remove(socket);
+}
+
+
+bool PollSet::has(const Socket& socket) const
+{
+	return _pImpl->has(socket);
+}
+
+
+bool PollSet::empty() const
+{
+	return _pImpl->count() == 0;
+}
+
+
+std::size_t PollSet::count() const
+{
+	return _pImpl->count();
+}
+
+
+void PollSet::clear()
+{
+	_pImpl->clear();
+}
+
+
+PollSet::SocketModeMap PollSet::poll(const Poco::Timespan& timeout)
+{
+	return _pImpl->poll(timeout);
+}
+
+
+} } // namespace Poco::Net
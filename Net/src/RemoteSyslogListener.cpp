@@ -89,21 +89,21 @@ public:
 		BUFFER_SIZE = 65536
 	};
 	
-	RemoteUDPListener(Poco::NotificationQueue& queue, Poco::UInt16 port);
+	RemoteUDPListener(RemoteSyslogListener* pOwner, Poco::UInt16 port);
 	~RemoteUDPListener();
 
 	void run();
 	void safeStop();
 
 private:
-	Poco::NotificationQueue& _queue;
-	DatagramSocket           _socket;
-	bool                     _stopped;
+	RemoteSyslogListener* _pOwner;
+	DatagramSocket        _socket;
+	bool                  _stopped;
 };
 
 
-RemoteUDPListener::RemoteUDPListener(Poco::NotificationQueue& queue, Poco::UInt16 port):
-	_queue(queue),
+RemoteUDPListener::RemoteUDPListener(RemoteSyslogListener* pOwner, Poco::UInt16 port):
+	_pOwner(pOwner),
 	_socket(Poco::Net::SocketAddress(Poco::Net::IPAddress(), port)),
 	_stopped(false)
 {
@@ -129,7 +129,8 @@ void RemoteUDPListener::run()
 				int n = _socket.receiveFrom(buffer.begin(), BUFFER_SIZE, sourceAddress);
 				if (n > 0)
 				{
-					_queue.enqueueNotification(new MessageNotification(buffer.begin(), n, sourceAddress));
+					// with a bounded queue, messages are dropped if the parser threads cannot keep up
+					_pOwner->tryEnqueue(new MessageNotification(buffer.begin(), n, sourceAddress));
 				}
 			}
 		}
@@ -162,7 +163,7 @@ public:
 		WAITTIME_MILLISEC = 1000
 	};
 
-	SyslogParser(Poco::NotificationQueue& queue, RemoteSyslogListener* pListener);
+	SyslogParser(RemoteSyslogListener* pListener);
 	~SyslogParser();
 
 	void parse(const std::string& line, Poco::Message& message);
@@ -181,17 +182,15 @@ private:
 		/// pos will point past the space char
 
 private:
-	Poco::NotificationQueue& _queue;
-	bool                     _stopped;
-	RemoteSyslogListener*    _pListener;
+	bool                  _stopped;
+	RemoteSyslogListener* _pListener;
 };
 
 
 const std::string SyslogParser::NILVALUE("-");
 
 
-SyslogParser::SyslogParser(Poco::NotificationQueue& queue, RemoteSyslogListener* pListener):
-	_queue(queue),
+SyslogParser::SyslogParser(RemoteSyslogListener* pListener):
 	_stopped(false),
 	_pListener(pListener)
 {
@@ -210,7 +209,7 @@ void SyslogParser::run()
 	{
 		try
 		{
-			Poco::AutoPtr<Poco::Notification> pNf(_queue.waitDequeueNotification(WAITTIME_MILLISEC));
+			Poco::AutoPtr<Poco::Notification> pNf(_pListener->waitDequeue(WAITTIME_MILLISEC));
 			if (pNf)
 			{
 				Poco::AutoPtr<MessageNotification> pMsgNf = pNf.cast<MessageNotification>();
@@ -427,6 +426,7 @@ Poco::Message::Priority SyslogParser::convert(RemoteSyslogChannel::Severity seve
 
 const std::string RemoteSyslogListener::PROP_PORT("port");
 const std::string RemoteSyslogListener::PROP_THREADS("threads");
+const std::string RemoteSyslogListener::PROP_QUEUE_SIZE("queueSize");
 
 const std::string RemoteSyslogListener::LOG_PROP_APP("app");
 const std::string RemoteSyslogListener::LOG_PROP_HOST("host");
@@ -435,6 +435,7 @@ const std::string RemoteSyslogListener::LOG_PROP_HOST("host");
 RemoteSyslogListener::RemoteSyslogListener():
 	_pListener(0),
 	_pParser(0),
+	_pBoundedQueue(0),
 	_port(RemoteSyslogChannel::SYSLOG_PORT),
 	_threads(1)
 {
@@ -444,6 +445,7 @@ RemoteSyslogListener::RemoteSyslogListener():
 RemoteSyslogListener::RemoteSyslogListener(Poco::UInt16 port):
 	_pListener(0),
 	_pParser(0),
+	_pBoundedQueue(0),
 	_port(port),
 	_threads(1)
 {
@@ -453,6 +455,7 @@ RemoteSyslogListener::RemoteSyslogListener(Poco::UInt16 port):
 RemoteSyslogListener::RemoteSyslogListener(Poco::UInt16 port, int threads):
 	_pListener(0),
 	_pParser(0),
+	_pBoundedQueue(0),
 	_port(port),
 	_threads(threads)
 {
@@ -461,6 +464,7 @@ RemoteSyslogListener::RemoteSyslogListener(Poco::UInt16 port, int threads):
 
 RemoteSyslogListener::~RemoteSyslogListener()
 {
+	delete _pBoundedQueue;
 }
 
 
@@ -474,7 +478,39 @@ void RemoteSyslogListener::processMessage(const std::string& messageText)
 
 void RemoteSyslogListener::enqueueMessage(const std::string& messageText, const Poco::Net::SocketAddress& senderAddress)
 {
-	_queue.enqueueNotification(new MessageNotification(messageText, senderAddress));
+	if (_pBoundedQueue)
+		_pBoundedQueue->enqueueNotification(new MessageNotification(messageText, senderAddress));
+	else
+		_queue.enqueueNotification(new MessageNotification(messageText, senderAddress));
+}
+
+
+int RemoteSyslogListener::droppedMessages() const
+{
+	return _droppedMessages.value();
+}
+
+
+bool RemoteSyslogListener::tryEnqueue(Poco::Notification* pNotification)
+{
+	Poco::Notification::Ptr pNf(pNotification);
+	if (!_pBoundedQueue)
+	{
+		_queue.enqueueNotification(pNf);
+		return true;
+	}
+	else if (_pBoundedQueue->tryEnqueueNotification(pNf))
+	{
+		return true;
+	}
+	++_droppedMessages;
+	return false;
+}
+
+
+Poco::Notification* RemoteSyslogListener::waitDequeue(long milliseconds)
+{
+	return _pBoundedQueue ? _pBoundedQueue->waitDequeueNotification(milliseconds) : _queue.waitDequeueNotification(milliseconds);
 }
 
 
@@ -496,6 +532,10 @@ void RemoteSyslogListener::setProperty(const std::string& name, const std::strin
 		else
 			throw Poco::InvalidArgumentException("Invalid number of threads", value);
 	}
+	else if (name == PROP_QUEUE_SIZE)
+	{
+		setQueueSize(value);
+	}
 	else 
 	{
 		SplitterChannel::setProperty(name, value);
@@ -509,6 +549,8 @@ std::string RemoteSyslogListener::getProperty(const std::string& name) const
 		return Poco::NumberFormatter::format(_port);
 	else if (name == PROP_THREADS)
 		return Poco::NumberFormatter::format(_threads);
+	else if (name == PROP_QUEUE_SIZE)
+		return _pBoundedQueue ? Poco::NumberFormatter::format(_pBoundedQueue->capacity()) : std::string("none");
 	else	
 		return SplitterChannel::getProperty(name);
 }
@@ -517,10 +559,10 @@ std::string RemoteSyslogListener::getProperty(const std::string& name) const
 void RemoteSyslogListener::open()
 {
 	SplitterChannel::open();
-	_pParser = new SyslogParser(_queue, this);
+	_pParser = new SyslogParser(this);
 	if (_port > 0)
 	{
-		_pListener = new RemoteUDPListener(_queue, _port);
+		_pListener = new RemoteUDPListener(this, _port);
 	}
 	for (int i = 0; i < _threads; i++)
 	{
@@ -544,6 +586,7 @@ void RemoteSyslogListener::close()
 		_pParser->safeStop();
 	}
 	_queue.clear();
+	if (_pBoundedQueue) _pBoundedQueue->clear();
 	_threadPool.joinAll();
 	delete _pListener;
 	delete _pParser;
@@ -553,6 +596,18 @@ void RemoteSyslogListener::close()
 }
 
 
+void RemoteSyslogListener::setQueueSize(const std::string& value)
+{
+	int queueSize = 0;
+	if (value != "none" && !Poco::NumberParser::tryParse(value, queueSize))
+		throw Poco::InvalidArgumentException("queue size", value);
+
+	if (_pParser) throw Poco::IllegalStateException("Cannot change the queue size of an open RemoteSyslogListener");
+	delete _pBoundedQueue;
+	_pBoundedQueue = queueSize > 0 ? new Poco::BoundedNotificationQueue(queueSize) : 0;
+}
+
+
 void RemoteSyslogListener::registerChannel()
 {
 	Poco::LoggingFactory::defaultFactory().registerChannelClass("RemoteSyslogListener", new Poco::Instantiator<RemoteSyslogListener, Poco::Channel>);
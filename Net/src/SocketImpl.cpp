@@ -19,12 +19,17 @@
 #include "Poco/Net/StreamSocketImpl.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Timestamp.h"
+#include "Poco/FileStream.h"
+#include "Poco/Buffer.h"
 #include <string.h> // FD_SET needs memset on some platforms, so we can't use <cstring>
 #if defined(POCO_HAVE_FD_EPOLL)
 #include <sys/epoll.h>
 #elif defined(POCO_HAVE_FD_POLL)
 #include <poll.h>
 #endif
+#if POCO_OS == POCO_OS_LINUX
+#include <sys/sendfile.h>
+#endif
 
 
 #if defined(sun) || defined(__sun) || defined(__sun__)
@@ -282,6 +287,102 @@ int SocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int SocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	if (buffers.empty()) return 0;
+
+#if defined(POCO_OS_FAMILY_WINDOWS) || defined(POCO_OS_FAMILY_UNIX) || defined(POCO_OS_FAMILY_VMS)
+	if (!secure())
+	{
+#if defined(POCO_BROKEN_TIMEOUTS)
+		if (_sndTimeout.totalMicroseconds() != 0)
+		{
+			if (!poll(_sndTimeout, SELECT_WRITE))
+				throw TimeoutException();
+		}
+#endif
+		int rc;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		DWORD sent = 0;
+		if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+		rc = WSASend(_sockfd, const_cast<LPWSABUF>(&buffers[0]), static_cast<DWORD>(buffers.size()), &sent, static_cast<DWORD>(flags), 0, 0);
+		if (rc == SOCKET_ERROR) error();
+		rc = static_cast<int>(sent);
+#else
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov    = const_cast<SocketBuf*>(&buffers[0]);
+		msg.msg_iovlen = buffers.size();
+		do
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			rc = static_cast<int>(::sendmsg(_sockfd, &msg, flags));
+		}
+		while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0) error();
+#endif
+		return rc;
+	}
+#endif
+	int sent = 0;
+	for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+	{
+		int length = static_cast<int>(socketBufLength(*it));
+		int rc = sendBytes(socketBufData(*it), length, flags);
+		if (rc < 0 && sent == 0) return rc;
+		if (rc > 0) sent += rc;
+		if (rc < length) break;
+	}
+	return sent;
+}
+
+
+Poco::UInt64 SocketImpl::sendFile(Poco::FileInputStream& stream, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	Poco::UInt64 sent = 0;
+#if POCO_OS == POCO_OS_LINUX
+	if (!secure())
+	{
+		// sendfile() transfers at most 0x7ffff000 bytes at once
+		const Poco::UInt64 MAX_CHUNK = 0x40000000;
+		off_t off = static_cast<off_t>(offset);
+		while (sent < count)
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			Poco::UInt64 chunk = count - sent < MAX_CHUNK ? count - sent : MAX_CHUNK;
+			ssize_t rc = ::sendfile(_sockfd, stream.nativeHandle(), &off, static_cast<std::size_t>(chunk));
+			if (rc < 0)
+			{
+				if (lastError() == POCO_EINTR) continue;
+				error();
+			}
+			if (rc == 0) break;
+			sent += rc;
+		}
+		return sent;
+	}
+#endif
+	const int BUFFER_SIZE = 8192;
+	Poco::Buffer<char> buffer(BUFFER_SIZE);
+	stream.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	while (sent < count && stream.good())
+	{
+		int n = count - sent < BUFFER_SIZE ? static_cast<int>(count - sent) : BUFFER_SIZE;
+		stream.read(buffer.begin(), n);
+		n = static_cast<int>(stream.gcount());
+		int written = 0;
+		while (written < n)
+		{
+			int rc = sendBytes(buffer.begin() + written, n - written);
+			if (rc <= 0) return sent + written;
+			written += rc;
+		}
+		sent += n;
+	}
+	return sent;
+}
+
+
 int SocketImpl::receiveBytes(void* buffer, int length, int flags)
 {
 #if defined(POCO_BROKEN_TIMEOUTS)
@@ -68,56 +68,34 @@ void SocketReactor::run()
 {
 	_pThread = Thread::current();
 
-	Socket::SocketList readable;
-	Socket::SocketList writable;
-	Socket::SocketList except;
-	
 	while (!_stop)
 	{
 		try
 		{
-			readable.clear();
-			writable.clear();
-			except.clear();
-			int nSockets = 0;
-			{
-				FastMutex::ScopedLock lock(_mutex);
-				for (EventHandlerMap::iterator it = _handlers.begin(); it != _handlers.end(); ++it)
-				{
-					if (it->second->accepts(_pReadableNotification))
-					{
-						readable.push_back(it->first);
-						nSockets++;
-					}
-					if (it->second->accepts(_pWritableNotification))
-					{
-						writable.push_back(it->first);
-						nSockets++;
-					}
-					if (it->second->accepts(_pErrorNotification))
-					{
-						except.push_back(it->first);
-						nSockets++;
-					}
-				}
-			}
-			if (nSockets == 0)
+			if (_pollSet.empty())
 			{
 				onIdle();
 				Thread::trySleep(_timeout.milliseconds());
 			}
-			else if (Socket::select(readable, writable, except, _timeout))
+			else
 			{
-				onBusy();
-
-				for (Socket::SocketList::iterator it = readable.begin(); it != readable.end(); ++it)
-					dispatch(*it, _pReadableNotification);
-				for (Socket::SocketList::iterator it = writable.begin(); it != writable.end(); ++it)
-					dispatch(*it, _pWritableNotification);
-				for (Socket::SocketList::iterator it = except.begin(); it != except.end(); ++it)
-					dispatch(*it, _pErrorNotification);
+				PollSet::SocketModeMap sm = _pollSet.poll(_timeout);
+				if (!sm.empty())
+				{
+					onBusy();
+
+					for (PollSet::SocketModeMap::iterator it = sm.begin(); it != sm.end(); ++it)
+					{
+						if (it->second & PollSet::POLL_READ)
+							dispatch(it->first, _pReadableNotification);
+						if (it->second & PollSet::POLL_WRITE)
+							dispatch(it->first, _pWritableNotification);
+						if (it->second & PollSet::POLL_ERROR)
+							dispatch(it->first, _pErrorNotification);
+					}
+				}
+				else onTimeout();
 			}
-			else onTimeout();
 		}
 		catch (Exception& exc)
 		{
@@ -162,20 +140,22 @@ const Poco::Timespan& SocketReactor::getTimeout() const
 
 void SocketReactor::addEventHandler(const Socket& socket, const Poco::AbstractObserver& observer)
 {
+	FastMutex::ScopedLock lock(_mutex);
+
 	NotifierPtr pNotifier;
+	EventHandlerMap::iterator it = _handlers.find(socket);
+	if (it == _handlers.end())
 	{
-		FastMutex::ScopedLock lock(_mutex);
-		
-		EventHandlerMap::iterator it = _handlers.find(socket);
-		if (it == _handlers.end())
-		{
-			pNotifier = new SocketNotifier(socket);
-			_handlers[socket] = pNotifier;
-		}
-		else pNotifier = it->second;
+		pNotifier = new SocketNotifier(socket);
+		_handlers[socket] = pNotifier;
 	}
+	else pNotifier = it->second;
+
 	if (!pNotifier->hasObserver(observer))
+	{
 		pNotifier->addObserver(this, observer);
+		_pollSet.update(socket, socketMode(pNotifier));
+	}
 }
 
 
@@ -202,22 +182,23 @@ void SocketReactor::removeEventHandler(const Socket& socket, const Poco::Abstrac
 	NotifierPtr pNotifier;
 	{
 		FastMutex::ScopedLock lock(_mutex);
-	
+
 		EventHandlerMap::iterator it = _handlers.find(socket);
 		if (it != _handlers.end())
 		{
 			pNotifier = it->second;
-			if (pNotifier->hasObserver(observer) && pNotifier->countObservers() == 1)
+			if (pNotifier->hasObserver(observer))
 			{
-				_handlers.erase(it);
+				pNotifier->removeObserver(this, observer);
+				if (!pNotifier->hasObservers())
+				{
+					_handlers.erase(it);
+					_pollSet.remove(socket);
+				}
+				else _pollSet.update(socket, socketMode(pNotifier));
 			}
 		}
 	}
-	if (pNotifier && pNotifier->hasObserver(observer))
-	{
-		pNotifier->removeObserver(this, observer);
-	}
-
 }
 
 
@@ -296,4 +277,17 @@ void SocketReactor::dispatch(NotifierPtr& pNotifier, SocketNotification* pNotifi
 }
 
 
+int SocketReactor::socketMode(NotifierPtr& pNotifier)
+{
+	int mode = 0;
+	if (pNotifier->accepts(_pReadableNotification))
+		mode |= PollSet::POLL_READ;
+	if (pNotifier->accepts(_pWritableNotification))
+		mode |= PollSet::POLL_WRITE;
+	if (pNotifier->accepts(_pErrorNotification))
+		mode |= PollSet::POLL_ERROR;
+	return mode;
+}
+
+
 } } // namespace Poco::Net
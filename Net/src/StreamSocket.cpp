@@ -133,6 +133,18 @@ int StreamSocket::receiveBytes(void* buffer, int length, int flags)
 }
 
 
+int StreamSocket::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return impl()->sendBytes(buffers, flags);
+}
+
+
+Poco::UInt64 StreamSocket::sendFile(Poco::FileInputStream& stream, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return impl()->sendFile(stream, offset, count);
+}
+
+
 int StreamSocket::receiveBytes(FIFOBuffer& fifoBuf)
 {
 	ScopedLock<Mutex> l(fifoBuf.mutex());
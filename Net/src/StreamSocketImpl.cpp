@@ -72,4 +72,36 @@ int StreamSocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int StreamSocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	SocketBufVec remaining(buffers);
+	int sent = 0;
+	bool blocking = getBlocking();
+	while (!remaining.empty())
+	{
+		int n = SocketImpl::sendBytes(remaining, flags);
+		poco_assert_dbg (n >= 0);
+		sent += n;
+		std::size_t skip = n;
+		SocketBufVec::iterator it = remaining.begin();
+		while (it != remaining.end() && skip >= socketBufLength(*it))
+		{
+			skip -= socketBufLength(*it);
+			++it;
+		}
+		remaining.erase(remaining.begin(), it);
+		if (!remaining.empty())
+		{
+			if (skip > 0)
+				remaining.front() = makeSocketBuf(socketBufData(remaining.front()) + skip, socketBufLength(remaining.front()) - skip);
+			if (blocking)
+				Poco::Thread::yield();
+			else
+				break;
+		}
+	}
+	return sent;
+}
+
+
 } } // namespace Poco::Net
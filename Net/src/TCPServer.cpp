@@ -30,19 +30,29 @@ namespace Poco {
 namespace Net {
 
 
+TCPServer::Acceptor::Acceptor(TCPServer* pServer, const ServerSocket& socket, TCPServerDispatcher* pDispatcher):
+	pServer(pServer),
+	socket(socket),
+	pDispatcher(pDispatcher),
+	thread(TCPServer::threadName(socket))
+{
+}
+
+
 TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::UInt16 portNumber, TCPServerParams::Ptr pParams):
 	_socket(ServerSocket(portNumber)),
 	_thread(threadName(_socket)),
 	_stopped(true)
 {	
 	Poco::ThreadPool& pool = Poco::ThreadPool::defaultPool();
+	int count = acceptorsFor(pParams, _socket);
 	if (pParams)
 	{
-		int toAdd = pParams->getMaxThreads() - pool.capacity();
+		int toAdd = pParams->getMaxThreads()*count - pool.capacity();
 		if (toAdd > 0) pool.addCapacity(toAdd);
 	}
 	_pDispatcher = new TCPServerDispatcher(pFactory, pool, pParams);
-	
+	createAcceptors(pFactory, &pool, 0, pParams, count);
 }
 
 
@@ -52,12 +62,14 @@ TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, const ServerSocke
 	_stopped(true)
 {
 	Poco::ThreadPool& pool = Poco::ThreadPool::defaultPool();
+	int count = acceptorsFor(pParams, _socket);
 	if (pParams)
 	{
-		int toAdd = pParams->getMaxThreads() - pool.capacity();
+		int toAdd = pParams->getMaxThreads()*count - pool.capacity();
 		if (toAdd > 0) pool.addCapacity(toAdd);
 	}
 	_pDispatcher = new TCPServerDispatcher(pFactory, pool, pParams);
+	createAcceptors(pFactory, &pool, 0, pParams, count);
 }
 
 
@@ -67,6 +79,17 @@ TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool&
 	_thread(threadName(socket)),
 	_stopped(true)
 {
+	createAcceptors(pFactory, &threadPool, 0, pParams, acceptorsFor(pParams, _socket));
+}
+
+
+TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::TaskExecutor& executor, const ServerSocket& socket, TCPServerParams::Ptr pParams):
+	_socket(socket),
+	_pDispatcher(new TCPServerDispatcher(pFactory, executor, pParams)),
+	_thread(threadName(socket)),
+	_stopped(true)
+{
+	createAcceptors(pFactory, 0, &executor, pParams, acceptorsFor(pParams, _socket));
 }
 
 
@@ -75,6 +98,7 @@ TCPServer::~TCPServer()
 	try
 	{
 		stop();
+		releaseAcceptors();
 		_pDispatcher->release();
 	}
 	catch (...)
@@ -96,6 +120,10 @@ void TCPServer::start()
 
 	_stopped = false;
 	_thread.start(*this);
+	for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		(*it)->thread.start(runAcceptor, *it);
+	}
 }
 
 	
@@ -105,24 +133,45 @@ void TCPServer::stop()
 	{
 		_stopped = true;
 		_thread.join();
+		for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		{
+			(*it)->thread.join();
+		}
 		_pDispatcher->stop();
+		for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		{
+			(*it)->pDispatcher->stop();
+		}
 	}
 }
 
 
 void TCPServer::run()
+{
+	acceptConnections(_socket, _pDispatcher);
+}
+
+
+void TCPServer::runAcceptor(void* pAcceptor)
+{
+	Acceptor* pAcc = reinterpret_cast<Acceptor*>(pAcceptor);
+	pAcc->pServer->acceptConnections(pAcc->socket, pAcc->pDispatcher);
+}
+
+
+void TCPServer::acceptConnections(ServerSocket& socket, TCPServerDispatcher* pDispatcher)
 {
 	while (!_stopped)
 	{
 		Poco::Timespan timeout(250000);
-		if (_socket.poll(timeout, Socket::SELECT_READ))
+		if (socket.poll(timeout, Socket::SELECT_READ))
 		{
 			try
 			{
-				StreamSocket ss = _socket.acceptConnection();
+				StreamSocket ss = socket.acceptConnection();
 				// enabe nodelay per default: OSX really needs that
 				ss.setNoDelay(true);
-				_pDispatcher->enqueue(ss);
+				pDispatcher->enqueue(ss);
 			}
 			catch (Poco::Exception& exc)
 			{
@@ -141,44 +190,160 @@ void TCPServer::run()
 }
 
 
+int TCPServer::acceptorsFor(TCPServerParams::Ptr pParams, const ServerSocket& socket)
+{
+	if (pParams && pParams->getAcceptors() > 1 && socket.getReusePort())
+		return pParams->getAcceptors();
+	else
+		return 1;
+}
+
+
+void TCPServer::createAcceptors(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool* pThreadPool, Poco::TaskExecutor* pExecutor, TCPServerParams::Ptr pParams, int count)
+{
+	try
+	{
+		SocketAddress address = _socket.address();
+		for (int i = 1; i < count; ++i)
+		{
+			ServerSocket socket;
+			socket.bind(address, true);
+			socket.listen();
+			TCPServerDispatcher* pDispatcher = pThreadPool ? new TCPServerDispatcher(pFactory, *pThreadPool, pParams) : new TCPServerDispatcher(pFactory, *pExecutor, pParams);
+			_acceptors.push_back(new Acceptor(this, socket, pDispatcher));
+		}
+	}
+	catch (...)
+	{
+		releaseAcceptors();
+		_pDispatcher->release();
+		throw;
+	}
+}
+
+
+void TCPServer::releaseAcceptors()
+{
+	for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		(*it)->pDispatcher->release();
+		delete *it;
+	}
+	_acceptors.clear();
+}
+
+
+TCPServerDispatcher* TCPServer::dispatcher(int acceptor) const
+{
+	poco_assert (acceptor >= 0 && acceptor < acceptors());
+
+	if (acceptor == 0)
+		return _pDispatcher;
+	else
+		return _acceptors[acceptor - 1]->pDispatcher;
+}
+
+
+const ServerSocket& TCPServer::socket(int acceptor) const
+{
+	poco_assert (acceptor >= 0 && acceptor < acceptors());
+
+	if (acceptor == 0)
+		return _socket;
+	else
+		return _acceptors[acceptor - 1]->socket;
+}
+
+
 int TCPServer::currentThreads() const
 {
-	return _pDispatcher->currentThreads();
+	int n = _pDispatcher->currentThreads();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		n += (*it)->pDispatcher->currentThreads();
+	return n;
 }
 
 int TCPServer::maxThreads() const
 {
-	return _pDispatcher->maxThreads();
+	int n = _pDispatcher->maxThreads();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		n += (*it)->pDispatcher->maxThreads();
+	return n;
 }
 
 	
 int TCPServer::totalConnections() const
 {
-	return _pDispatcher->totalConnections();
+	int n = _pDispatcher->totalConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		n += (*it)->pDispatcher->totalConnections();
+	return n;
 }
 
 
 int TCPServer::currentConnections() const
 {
-	return _pDispatcher->currentConnections();
+	int n = _pDispatcher->currentConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		n += (*it)->pDispatcher->currentConnections();
+	return n;
 }
 
 
 int TCPServer::maxConcurrentConnections() const
 {
-	return _pDispatcher->maxConcurrentConnections();
+	int n = _pDispatcher->maxConcurrentConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		n += (*it)->pDispatcher->maxConcurrentConnections();
+	return n;
 }
 
 	
 int TCPServer::queuedConnections() const
 {
-	return _pDispatcher->queuedConnections();
+	int n = _pDispatcher->queuedConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		n += (*it)->pDispatcher->queuedConnections();
+	return n;
 }
 
 
 int TCPServer::refusedConnections() const
 {
-	return _pDispatcher->refusedConnections();
+	int n = _pDispatcher->refusedConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		n += (*it)->pDispatcher->refusedConnections();
+	return n;
+}
+
+
+int TCPServer::totalConnections(int acceptor) const
+{
+	return dispatcher(acceptor)->totalConnections();
+}
+
+
+int TCPServer::currentConnections(int acceptor) const
+{
+	return dispatcher(acceptor)->currentConnections();
+}
+
+
+int TCPServer::queuedConnections(int acceptor) const
+{
+	return dispatcher(acceptor)->queuedConnections();
+}
+
+
+int TCPServer::refusedConnections(int acceptor) const
+{
+	return dispatcher(acceptor)->refusedConnections();
+}
+
+
+int TCPServer::maxConcurrentConnections(int acceptor) const
+{
+	return dispatcher(acceptor)->maxConcurrentConnections();
 }
 
 
@@ -33,8 +33,9 @@ namespace Net {
 class TCPConnectionNotification: public Notification
 {
 public:
-	TCPConnectionNotification(const StreamSocket& socket):
-		_socket(socket)
+	TCPConnectionNotification(const StreamSocket& socket, bool resumed):
+		_socket(socket),
+		_resumed(resumed)
 	{
 	}
 	
@@ -47,8 +48,14 @@ public:
 		return _socket;
 	}
 
+	bool resumed() const
+	{
+		return _resumed;
+	}
+
 private:
 	StreamSocket _socket;
+	bool         _resumed;
 };
 
 
@@ -62,15 +69,39 @@ TCPServerDispatcher::TCPServerDispatcher(TCPServerConnectionFactory::Ptr pFactor
 	_refusedConnections(0),
 	_stopped(false),
 	_pConnectionFactory(pFactory),
-	_threadPool(threadPool)
+	_pThreadPool(&threadPool),
+	_pExecutor(0)
+{
+	init();
+}
+
+
+TCPServerDispatcher::TCPServerDispatcher(TCPServerConnectionFactory::Ptr pFactory, Poco::TaskExecutor& executor, TCPServerParams::Ptr pParams):
+	_rc(1),
+	_pParams(pParams),
+	_currentThreads(0),
+	_totalConnections(0),
+	_currentConnections(0),
+	_maxConcurrentConnections(0),
+	_refusedConnections(0),
+	_stopped(false),
+	_pConnectionFactory(pFactory),
+	_pThreadPool(0),
+	_pExecutor(&executor)
+{
+	init();
+}
+
+
+void TCPServerDispatcher::init()
 {
-	poco_check_ptr (pFactory);
+	poco_check_ptr (_pConnectionFactory);
 
 	if (!_pParams)
 		_pParams = new TCPServerParams;
 	
 	if (_pParams->getMaxThreads() == 0)
-		_pParams->setMaxThreads(threadPool.capacity());
+		_pParams->setMaxThreads(_pThreadPool ? _pThreadPool->capacity() : _pExecutor->workers());
 }
 
 
@@ -98,13 +129,15 @@ void TCPServerDispatcher::release()
 
 void TCPServerDispatcher::run()
 {
-	AutoPtr<TCPServerDispatcher> guard(this, true); // ensure object stays alive
+	// ensure object stays alive; when started by the TaskExecutor,
+	// enqueue() has already taken the reference
+	AutoPtr<TCPServerDispatcher> guard(this, _pThreadPool != 0);
 
 	int idleTime = (int) _pParams->getThreadIdleTime().totalMilliseconds();
 
 	for (;;)
 	{
-		AutoPtr<Notification> pNf = _queue.waitDequeueNotification(idleTime);
+		AutoPtr<Notification> pNf = _pExecutor ? _queue.dequeueNotification() : _queue.waitDequeueNotification(idleTime);
 		if (pNf)
 		{
 			TCPConnectionNotification* pCNf = dynamic_cast<TCPConnectionNotification*>(pNf.get());
@@ -112,14 +145,14 @@ void TCPServerDispatcher::run()
 			{
 				std::auto_ptr<TCPServerConnection> pConnection(_pConnectionFactory->createConnection(pCNf->socket()));
 				poco_check_ptr(pConnection.get());
-				beginConnection();
+				beginConnection(pCNf->resumed());
 				pConnection->start();
 				endConnection();
 			}
 		}
 	
 		FastMutex::ScopedLock lock(_mutex);
-		if (_stopped || (_currentThreads > 1 && _queue.empty()))
+		if (_stopped || ((_currentThreads > 1 || _pExecutor) && _queue.empty()))
 		{
 			--_currentThreads;
 			break;
@@ -136,16 +169,46 @@ namespace
 	
 void TCPServerDispatcher::enqueue(const StreamSocket& socket)
 {
-	FastMutex::ScopedLock lock(_mutex);
+	enqueue(socket, false);
+}
+
+
+void TCPServerDispatcher::resume(const StreamSocket& socket)
+{
+	enqueue(socket, true);
+}
 
-	if (_queue.size() < _pParams->getMaxQueued())
+
+void TCPServerDispatcher::enqueue(const StreamSocket& socket, bool resumed)
+{
+	bool startTask = false;
 	{
-		_queue.enqueueNotification(new TCPConnectionNotification(socket));
-		if (!_queue.hasIdleThreads() && _currentThreads < _pParams->getMaxThreads())
+		FastMutex::ScopedLock lock(_mutex);
+
+		if (_queue.size() >= _pParams->getMaxQueued())
+		{
+			if (!resumed) ++_refusedConnections;
+			return;
+		}
+		_queue.enqueueNotification(new TCPConnectionNotification(socket, resumed));
+		if (_pExecutor)
+		{
+			// Dispatcher tasks never wait for the queue, so there are no
+			// idle threads to hand the connection to. The task is counted
+			// before it is scheduled, so that a task finishing concurrently
+			// in run() cannot miss the connection just queued.
+			if (_currentThreads < _pParams->getMaxThreads())
+			{
+				++_currentThreads;
+				++_rc; // released by run()
+				startTask = true;
+			}
+		}
+		else if (!_queue.hasIdleThreads() && _currentThreads < _pParams->getMaxThreads())
 		{
 			try
 			{
-				_threadPool.startWithPriority(_pParams->getThreadPriority(), *this, threadName);
+				_pThreadPool->startWithPriority(_pParams->getThreadPriority(), *this, threadName);
 				++_currentThreads;
 			}
 			catch (Poco::Exception&)
@@ -155,9 +218,39 @@ void TCPServerDispatcher::enqueue(const StreamSocket& socket)
 			}
 		}
 	}
-	else
+	// The TaskExecutor may run the task immediately in this thread,
+	// so it must be scheduled without holding the mutex.
+	if (startTask) startExecutorTask();
+}
+
+
+void TCPServerDispatcher::startExecutorTask()
+{
+	bool started = false;
+	try
+	{
+		started = _pExecutor->tryExecute(*this);
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	if (started) return;
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	--_rc;
+	--_currentThreads;
+	if (_currentThreads == 0)
 	{
-		++_refusedConnections;
+		// No dispatcher task is left that would take the queued
+		// connections, so they are refused (and closed).
+		for (;;)
+		{
+			AutoPtr<Notification> pNf = _queue.dequeueNotification();
+			if (!pNf) break;
+			TCPConnectionNotification* pCNf = dynamic_cast<TCPConnectionNotification*>(pNf.get());
+			if (pCNf && !pCNf->resumed()) ++_refusedConnections;
+		}
 	}
 }
 
@@ -181,7 +274,7 @@ int TCPServerDispatcher::maxThreads() const
 {
 	FastMutex::ScopedLock lock(_mutex);
 	
-	return _threadPool.capacity();
+	return _pThreadPool ? _pThreadPool->capacity() : _pExecutor->workers();
 }
 
 
@@ -223,11 +316,11 @@ int TCPServerDispatcher::refusedConnections() const
 }
 
 
-void TCPServerDispatcher::beginConnection()
+void TCPServerDispatcher::beginConnection(bool resumed)
 {
 	FastMutex::ScopedLock lock(_mutex);
 	
-	++_totalConnections;
+	if (!resumed) ++_totalConnections;
 	++_currentConnections;
 	if (_currentConnections > _maxConcurrentConnections)
 		_maxConcurrentConnections = _currentConnections;
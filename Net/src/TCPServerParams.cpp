@@ -25,7 +25,8 @@ TCPServerParams::TCPServerParams():
 	_threadIdleTime(10000000),
 	_maxThreads(0),
 	_maxQueued(64),
-	_threadPriority(Poco::Thread::PRIO_NORMAL)
+	_threadPriority(Poco::Thread::PRIO_NORMAL),
+	_acceptors(1)
 {
 }
 
@@ -63,4 +64,12 @@ void TCPServerParams::setThreadPriority(Poco::Thread::Priority prio)
 }
 
 
+void TCPServerParams::setAcceptors(int count)
+{
+	poco_assert (count > 0);
+
+	_acceptors = count;
+}
+
+
 } } // namespace Poco::Net
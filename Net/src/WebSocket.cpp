@@ -16,6 +16,7 @@
 
 #include "Poco/Net/WebSocket.h"
 #include "Poco/Net/WebSocketImpl.h"
+#include "Poco/Net/PerMessageDeflate.h"
 #include "Poco/Net/HTTPServerRequestImpl.h"
 #include "Poco/Net/HTTPServerResponse.h"
 #include "Poco/Net/HTTPClientSession.h"
@@ -46,6 +47,12 @@ WebSocket::WebSocket(HTTPServerRequest& request, HTTPServerResponse& response):
 {
 }
 
+
+WebSocket::WebSocket(HTTPServerRequest& request, HTTPServerResponse& response, const DeflateConfig& deflateConfig):
+	StreamSocket(accept(request, response, &deflateConfig))
+{
+}
+
 	
 WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response):
 	StreamSocket(connect(cs, request, response, _defaultCreds))
@@ -59,6 +66,12 @@ WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse&
 }
 
 
+WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, const DeflateConfig& deflateConfig):
+	StreamSocket(connect(cs, request, response, _defaultCreds, &deflateConfig))
+{
+}
+
+
 WebSocket::WebSocket(const Socket& socket): 
 	StreamSocket(socket)
 {
@@ -106,6 +119,13 @@ int WebSocket::sendFrame(const void* buffer, int length, int flags)
 }
 
 
+int WebSocket::sendFrame(const SocketBufVec& buffers, int flags)
+{
+	flags |= FRAME_OP_SETRAW;
+	return static_cast<WebSocketImpl*>(impl())->sendBytes(buffers, flags);
+}
+
+
 int WebSocket::receiveFrame(void* buffer, int length, int& flags)
 {
 	int n = static_cast<WebSocketImpl*>(impl())->receiveBytes(buffer, length, 0);
@@ -120,7 +140,28 @@ WebSocket::Mode WebSocket::mode() const
 }
 
 
-WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse& response)
+bool WebSocket::deflateEnabled() const
+{
+	return static_cast<WebSocketImpl*>(impl())->perMessageDeflate() != 0;
+}
+
+
+WebSocket::DeflateStatistics WebSocket::deflateStatistics() const
+{
+	DeflateStatistics stats;
+	const PerMessageDeflate* pDeflate = static_cast<WebSocketImpl*>(impl())->perMessageDeflate();
+	if (pDeflate)
+	{
+		stats.bytesSent               = pDeflate->bytesDeflated();
+		stats.compressedBytesSent     = pDeflate->compressedBytesDeflated();
+		stats.bytesReceived           = pDeflate->bytesInflated();
+		stats.compressedBytesReceived = pDeflate->compressedBytesInflated();
+	}
+	return stats;
+}
+
+
+WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse& response, const DeflateConfig* pDeflateConfig)
 {
 	if (request.hasToken("Connection", "upgrade") && icompare(request.get("Upgrade", ""), "websocket") == 0)
 	{
@@ -131,19 +172,31 @@ WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse&
 		Poco::trimInPlace(key);
 		if (key.empty()) throw WebSocketException("Missing Sec-WebSocket-Key in handshake request", WS_ERR_HANDSHAKE_NO_KEY);
 		
-		response.setStatusAndReason(HTTPResponse::HTTP_SWITCHING_PROTOCOLS);
-		response.set("Upgrade", "websocket");
-		response.set("Connection", "Upgrade");
-		response.set("Sec-WebSocket-Accept", computeAccept(key));
-		response.setContentLength(0);
-		response.send().flush();
-		return new WebSocketImpl(static_cast<StreamSocketImpl*>(static_cast<HTTPServerRequestImpl&>(request).detachSocket().impl()), false);
+		PerMessageDeflate* pDeflate = 0;
+		std::string extension;
+		if (pDeflateConfig) pDeflate = PerMessageDeflate::accept(request, *pDeflateConfig, extension);
+		try
+		{
+			response.setStatusAndReason(HTTPResponse::HTTP_SWITCHING_PROTOCOLS);
+			response.set("Upgrade", "websocket");
+			response.set("Connection", "Upgrade");
+			response.set("Sec-WebSocket-Accept", computeAccept(key));
+			if (pDeflate) response.set("Sec-WebSocket-Extensions", extension);
+			response.setContentLength(0);
+			response.send().flush();
+			return new WebSocketImpl(static_cast<StreamSocketImpl*>(static_cast<HTTPServerRequestImpl&>(request).detachSocket().impl()), false, pDeflate);
+		}
+		catch (...)
+		{
+			delete pDeflate;
+			throw;
+		}
 	}
 	else throw WebSocketException("No WebSocket handshake", WS_ERR_NO_HANDSHAKE);
 }
 
 
-WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials)
+WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const DeflateConfig* pDeflateConfig)
 {
 	if (!cs.getProxyHost().empty() && !cs.secure())
 	{
@@ -154,13 +207,14 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 	request.set("Upgrade", "websocket");
 	request.set("Sec-WebSocket-Version", WEBSOCKET_VERSION);
 	request.set("Sec-WebSocket-Key", key);
+	if (pDeflateConfig) request.set("Sec-WebSocket-Extensions", PerMessageDeflate::offer(*pDeflateConfig));
 	request.setChunkedTransferEncoding(false);
 	cs.setKeepAlive(true);
 	cs.sendRequest(request);
 	std::istream& istr = cs.receiveResponse(response);
 	if (response.getStatus() == HTTPResponse::HTTP_SWITCHING_PROTOCOLS)
 	{
-		return completeHandshake(cs, response, key);
+		return completeHandshake(cs, response, key, pDeflateConfig);
 	}
 	else if (response.getStatus() == HTTPResponse::HTTP_UNAUTHORIZED)
 	{
@@ -176,7 +230,7 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 		cs.receiveResponse(response);
 		if (response.getStatus() == HTTPResponse::HTTP_SWITCHING_PROTOCOLS)
 		{
-			return completeHandshake(cs, response, key);
+			return completeHandshake(cs, response, key, pDeflateConfig);
 		}
 		else if (response.getStatus() == HTTPResponse::HTTP_UNAUTHORIZED)
 		{
@@ -194,7 +248,7 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 }
 
 
-WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key)
+WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key, const DeflateConfig* pDeflateConfig)
 {
 	std::string connection = response.get("Connection", "");
 	if (Poco::icompare(connection, "Upgrade") != 0) 
@@ -205,7 +259,12 @@ WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse&
 	std::string accept = response.get("Sec-WebSocket-Accept", "");
 	if (accept != computeAccept(key))
 		throw WebSocketException("Invalid or missing Sec-WebSocket-Accept header in handshake response", WS_ERR_NO_HANDSHAKE);
-	return new WebSocketImpl(static_cast<StreamSocketImpl*>(cs.detachSocket().impl()), true);
+	PerMessageDeflate* pDeflate = 0;
+	if (pDeflateConfig)
+		pDeflate = PerMessageDeflate::complete(response, *pDeflateConfig);
+	else if (response.has("Sec-WebSocket-Extensions"))
+		throw WebSocketException("Unexpected Sec-WebSocket-Extensions header in handshake response", WS_ERR_HANDSHAKE_EXTENSION);
+	return new WebSocketImpl(static_cast<StreamSocketImpl*>(cs.detachSocket().impl()), true, pDeflate);
 }
 
 
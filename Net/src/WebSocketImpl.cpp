@@ -17,23 +17,105 @@
 #include "Poco/Net/WebSocketImpl.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/Net/WebSocket.h"
+#include "Poco/Net/PerMessageDeflate.h"
 #include "Poco/Buffer.h"
 #include "Poco/BinaryWriter.h"
 #include "Poco/BinaryReader.h"
 #include "Poco/MemoryStream.h"
 #include "Poco/Format.h"
 #include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POCO_WEBSOCKET_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define POCO_WEBSOCKET_HAVE_AVX2
+#include <immintrin.h>
+#endif
 
 
 namespace Poco {
 namespace Net {
 
 
-WebSocketImpl::WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, bool mustMaskPayload):
+namespace
+{
+	typedef void (*MaskFunc)(const char* src, char* dst, std::size_t length, Poco::UInt32 mask);
+	
+	void maskWords(const char* src, char* dst, std::size_t length, Poco::UInt32 mask)
+	{
+		// Every word starts at a multiple of 4 bytes, so the
+		// same masking key applies to every word.
+		const Poco::UInt64 mask64 = (static_cast<Poco::UInt64>(mask) << 32) | mask;
+		std::size_t i = 0;
+		for (; i + 8 <= length; i += 8)
+		{
+			Poco::UInt64 w;
+			std::memcpy(&w, src + i, 8);
+			w ^= mask64;
+			std::memcpy(dst + i, &w, 8);
+		}
+		const char* m = reinterpret_cast<const char*>(&mask);
+		for (; i < length; i++)
+		{
+			dst[i] = src[i] ^ m[i % 4];
+		}
+	}
+
+#if defined(POCO_WEBSOCKET_HAVE_SSE2)
+	void maskSSE2(const char* src, char* dst, std::size_t length, Poco::UInt32 mask)
+	{
+		const __m128i m = _mm_set1_epi32(static_cast<int>(mask));
+		std::size_t i = 0;
+		for (; i + 16 <= length; i += 16)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(v, m));
+		}
+		maskWords(src + i, dst + i, length - i, mask);
+	}
+#endif
+
+#if defined(POCO_WEBSOCKET_HAVE_AVX2)
+	__attribute__((target("avx2")))
+	void maskAVX2(const char* src, char* dst, std::size_t length, Poco::UInt32 mask)
+	{
+		const __m256i m = _mm256_set1_epi32(static_cast<int>(mask));
+		std::size_t i = 0;
+		for (; i + 32 <= length; i += 32)
+		{
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(v, m));
+		}
+		maskWords(src + i, dst + i, length - i, mask);
+	}
+#endif
+
+	MaskFunc selectMaskFunc()
+	{
+#if defined(POCO_WEBSOCKET_HAVE_AVX2)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) return maskAVX2;
+#endif
+#if defined(POCO_WEBSOCKET_HAVE_SSE2)
+		return maskSSE2;
+#else
+		return maskWords;
+#endif
+	}
+
+	MaskFunc pMaskFunc = selectMaskFunc();
+}
+
+
+WebSocketImpl::WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, bool mustMaskPayload, PerMessageDeflate* pDeflate):
 	StreamSocketImpl(pStreamSocketImpl->sockfd()),
 	_pStreamSocketImpl(pStreamSocketImpl),
 	_frameFlags(0),
-	_mustMaskPayload(mustMaskPayload)
+	_mustMaskPayload(mustMaskPayload),
+	_pDeflate(pDeflate),
+	_deflateSending(false),
+	_deflateReceiving(false)
 {
 	poco_check_ptr(pStreamSocketImpl);
 	_pStreamSocketImpl->duplicate();
@@ -45,6 +127,7 @@ WebSocketImpl::~WebSocketImpl()
 	try
 	{
 		_pStreamSocketImpl->release();
+		delete _pDeflate;
 		reset();
 	}
 	catch (...)
@@ -56,12 +139,50 @@ WebSocketImpl::~WebSocketImpl()
 	
 int WebSocketImpl::sendBytes(const void* buffer, int length, int flags)
 {
-	Poco::Buffer<char> frame(length + MAX_HEADER_LENGTH);
-	Poco::MemoryOutputStream ostr(frame.begin(), frame.size());
-	Poco::BinaryWriter writer(ostr, Poco::BinaryWriter::NETWORK_BYTE_ORDER);
-	
+	SocketBufVec buffers(1, makeSocketBuf(buffer, length));
+	return sendBytes(buffers, flags);
+}
+
+
+int WebSocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	std::size_t length = 0;
+	for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+	{
+		length += socketBufLength(*it);
+	}
+
 	if (flags == 0) flags = WebSocket::FRAME_BINARY;
 	flags &= 0xff;
+	if (_pDeflate && !(flags & WebSocket::FRAME_FLAG_RSV1))
+	{
+		// Data frames are compressed; control frames never are. A
+		// continuation frame is compressed if its message is.
+		int opcode = flags & WebSocket::FRAME_OP_BITMASK;
+		bool deflate = (opcode == WebSocket::FRAME_OP_TEXT || opcode == WebSocket::FRAME_OP_BINARY || (opcode == WebSocket::FRAME_OP_CONT && _deflateSending));
+		if (deflate)
+		{
+			bool fin = (flags & WebSocket::FRAME_FLAG_FIN) != 0;
+			const Poco::Buffer<char>& payload = _pDeflate->deflate(buffers, fin);
+			// RSV1 is set on the first frame of a compressed message only
+			if (opcode != WebSocket::FRAME_OP_CONT) flags |= WebSocket::FRAME_FLAG_RSV1;
+			_deflateSending = !fin;
+			SocketBufVec compressed(1, makeSocketBuf(payload.begin(), payload.size()));
+			sendFrame(compressed, payload.size(), flags);
+			return static_cast<int>(length);
+		}
+	}
+	sendFrame(buffers, length, flags);
+	return static_cast<int>(length);
+}
+
+
+void WebSocketImpl::sendFrame(const SocketBufVec& buffers, std::size_t length, int flags)
+{
+	char header[MAX_HEADER_LENGTH];
+	Poco::MemoryOutputStream ostr(header, sizeof(header));
+	Poco::BinaryWriter writer(ostr, Poco::BinaryWriter::NETWORK_BYTE_ORDER);
+	
 	writer << static_cast<Poco::UInt8>(flags);
 	Poco::UInt8 lengthByte(0);
 	if (_mustMaskPayload)
@@ -87,20 +208,34 @@ int WebSocketImpl::sendBytes(const void* buffer, int length, int flags)
 	{
 		const Poco::UInt32 mask = _rnd.next();
 		const char* m = reinterpret_cast<const char*>(&mask);
-		const char* b = reinterpret_cast<const char*>(buffer);
 		writer.writeRaw(m, 4);
-		char* p = frame.begin() + ostr.charsWritten();
-		for (int i = 0; i < length; i++)
+		std::size_t headerLength = ostr.charsWritten();
+		Poco::Buffer<char> frame(headerLength + length);
+		std::memcpy(frame.begin(), header, headerLength);
+		char* p = frame.begin() + headerLength;
+		std::size_t offset = 0;
+		for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
 		{
-			p[i] = b[i] ^ m[i % 4];
+			// each buffer continues with the masking key byte
+			// following the last byte of the previous buffer
+			char rotated[4];
+			for (int i = 0; i < 4; i++)
+			{
+				rotated[i] = m[(offset + i) % 4];
+			}
+			maskPayload(socketBufData(*it), p + offset, socketBufLength(*it), rotated);
+			offset += socketBufLength(*it);
 		}
+		_pStreamSocketImpl->sendBytes(frame.begin(), static_cast<int>(frame.size()));
 	}
 	else
 	{
-		std::memcpy(frame.begin() + ostr.charsWritten(), buffer, length);
+		SocketBufVec frame;
+		frame.reserve(buffers.size() + 1);
+		frame.push_back(makeSocketBuf(header, ostr.charsWritten()));
+		frame.insert(frame.end(), buffers.begin(), buffers.end());
+		_pStreamSocketImpl->sendBytes(frame);
 	}
-	_pStreamSocketImpl->sendBytes(frame.begin(), length + static_cast<int>(ostr.charsWritten()));
-	return length;
 }
 
 	
@@ -137,13 +272,30 @@ int WebSocketImpl::receiveBytes(void* buffer, int length, int)
 	char mask[4];
 	reader >> flags >> lengthByte;
 	_frameFlags = flags;
+	bool inflate = false;
+	if (_pDeflate)
+	{
+		int opcode = flags & WebSocket::FRAME_OP_BITMASK;
+		if (opcode == WebSocket::FRAME_OP_TEXT || opcode == WebSocket::FRAME_OP_BINARY)
+			_deflateReceiving = (flags & WebSocket::FRAME_FLAG_RSV1) != 0;
+		if (opcode == WebSocket::FRAME_OP_TEXT || opcode == WebSocket::FRAME_OP_BINARY || opcode == WebSocket::FRAME_OP_CONT)
+		{
+			inflate = _deflateReceiving;
+			if (flags & WebSocket::FRAME_FLAG_FIN) _deflateReceiving = false;
+		}
+		_frameFlags &= ~WebSocket::FRAME_FLAG_RSV1;
+	}
+	// A compressed payload may be slightly larger than the uncompressed
+	// payload if the data cannot be compressed.
+	Poco::UInt64 maxPayloadLength = length;
+	if (inflate) maxPayloadLength += length/8 + 1024;
 	int payloadLength = 0;
 	int payloadOffset = 2;
 	if ((lengthByte & 0x7f) == 127)
 	{
 		Poco::UInt64 l;
 		reader >> l;
-		if (l > length) throw WebSocketException(Poco::format("Insufficient buffer for payload size %Lu", l), WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+		if (l > maxPayloadLength) throw WebSocketException(Poco::format("Insufficient buffer for payload size %Lu", l), WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
 		payloadLength = static_cast<int>(l);
 		payloadOffset += 8;
 	}
@@ -151,14 +303,14 @@ int WebSocketImpl::receiveBytes(void* buffer, int length, int)
 	{
 		Poco::UInt16 l;
 		reader >> l;
-		if (l > length) throw WebSocketException(Poco::format("Insufficient buffer for payload size %hu", l), WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+		if (l > maxPayloadLength) throw WebSocketException(Poco::format("Insufficient buffer for payload size %hu", l), WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
 		payloadLength = static_cast<int>(l);
 		payloadOffset += 2;
 	}
 	else
 	{
 		Poco::UInt8 l = lengthByte & 0x7f;
-		if (l > length) throw WebSocketException(Poco::format("Insufficient buffer for payload size %u", unsigned(l)), WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+		if (l > maxPayloadLength) throw WebSocketException(Poco::format("Insufficient buffer for payload size %u", unsigned(l)), WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
 		payloadLength = static_cast<int>(l);
 	}
 	if (lengthByte & FRAME_FLAG_MASK)
@@ -166,30 +318,40 @@ int WebSocketImpl::receiveBytes(void* buffer, int length, int)
 		reader.readRaw(mask, 4);
 		payloadOffset += 4;
 	}
+	char* payload = inflate ? _pDeflate->inflateBuffer(payloadLength) : reinterpret_cast<char*>(buffer);
 	int received = 0;
 	if (payloadOffset < n)
 	{
-		std::memcpy(buffer, header + payloadOffset, n - payloadOffset);
+		std::memcpy(payload, header + payloadOffset, n - payloadOffset);
 		received = n - payloadOffset;
 	}
 	if (received < payloadLength)
 	{
-		n = receiveNBytes(reinterpret_cast<char*>(buffer) + received, payloadLength - received);
+		n = receiveNBytes(payload + received, payloadLength - received);
 		if (n <= 0) throw WebSocketException("Incomplete frame received", WebSocket::WS_ERR_INCOMPLETE_FRAME);
 		received += n;
 	}
 	if (lengthByte & FRAME_FLAG_MASK)
 	{
-		char* p = reinterpret_cast<char*>(buffer);
-		for (int i = 0; i < received; i++)
-		{
-			p[i] ^= mask[i % 4];
-		}
+		maskPayload(payload, payload, received, mask);
+	}
+	if (inflate)
+	{
+		received = _pDeflate->inflate(payload, received, (flags & WebSocket::FRAME_FLAG_FIN) != 0, reinterpret_cast<char*>(buffer), length);
 	}
 	return received;
 }
 
 
+void WebSocketImpl::maskPayload(const char* src, char* dst, std::size_t length, const char* mask)
+{
+	Poco::UInt32 m;
+	std::memcpy(&m, mask, 4);
+	if (!pMaskFunc) pMaskFunc = selectMaskFunc();
+	pMaskFunc(src, dst, length, m);
+}
+
+
 int WebSocketImpl::receiveNBytes(void* buffer, int bytes)
 {
 	int received = _pStreamSocketImpl->receiveBytes(reinterpret_cast<char*>(buffer), bytes);
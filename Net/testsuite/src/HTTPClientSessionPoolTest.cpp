@@ -0,0 +1,304 @@
+//
+// HTTPClientSessionPoolTest.cpp
+//
+// $Id: //poco/1.4/Net/testsuite/src/HTTPClientSessionPoolTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPClientSessionPoolTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPClientSessionPool.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPSessionInstantiator.h"
+#include "Poco/Net/HTTPStreamFactory.h"
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/URI.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Thread.h"
+#include <sstream>
+#include <memory>
+
+
+using Poco::Net::HTTPClientSessionPool;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPSessionInstantiator;
+using Poco::Net::HTTPStreamFactory;
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::HTTPException;
+using Poco::Net::ServerSocket;
+using Poco::URI;
+using Poco::StreamCopier;
+using Poco::NumberFormatter;
+
+
+namespace
+{
+	class PathRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			if (request.getURI() == "/close")
+				response.setKeepAlive(false);
+			response.setContentType("text/plain");
+			response.setContentLength(static_cast<int>(request.getURI().size()));
+			response.send() << request.getURI();
+		}
+	};
+
+	class RequestHandlerFactory: public HTTPRequestHandlerFactory
+	{
+	public:
+		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest&)
+		{
+			return new PathRequestHandler;
+		}
+	};
+
+	std::string sendRequest(HTTPClientSession& session, const std::string& path)
+	{
+		HTTPRequest request(HTTPRequest::HTTP_GET, path, HTTPMessage::HTTP_1_1);
+		session.sendRequest(request);
+		HTTPResponse response;
+		std::istream& rs = session.receiveResponse(response);
+		std::ostringstream ostr;
+		StreamCopier::copyStream(rs, ostr);
+		return ostr.str();
+	}
+
+	std::string uriFor(const ServerSocket& svs, const std::string& path, const std::string& host = "localhost")
+	{
+		return "http://" + host + ":" + NumberFormatter::format(svs.address().port()) + path;
+	}
+}
+
+
+HTTPClientSessionPoolTest::HTTPClientSessionPoolTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPClientSessionPoolTest::~HTTPClientSessionPoolTest()
+{
+}
+
+
+void HTTPClientSessionPoolTest::testReuse()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, new HTTPServerParams);
+	srv.start();
+
+	HTTPClientSessionPool::Ptr pPool = new HTTPClientSessionPool;
+	URI uri(uriFor(svs, "/first"));
+	HTTPClientSession* pSession = pPool->get(uri);
+	assert (pPool->used() == 1);
+	assert (sendRequest(*pSession, "/first") == "/first");
+	pPool->putBack(pSession);
+	assert (pPool->used() == 0);
+	assert (pPool->idle() == 1);
+
+	HTTPClientSession* pSession2 = pPool->get(uri);
+	assert (pSession2 == pSession);
+	assert (sendRequest(*pSession2, "/second") == "/second");
+	pPool->putBack(pSession2);
+
+	assert (pPool->hits() == 1);
+	assert (pPool->misses() == 1);
+	assert (pPool->idle() == 1);
+	assert (srv.totalConnections() == 1);
+
+	pPool->shutdown();
+	assert (pPool->idle() == 0);
+	try
+	{
+		pPool->get(uri);
+		fail("pool has been shut down - must throw");
+	}
+	catch (HTTPException&)
+	{
+	}
+}
+
+
+void HTTPClientSessionPoolTest::testMaxSessions()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, new HTTPServerParams);
+	srv.start();
+
+	HTTPClientSessionPool::Ptr pPool = new HTTPClientSessionPool(2);
+	URI uri(uriFor(svs, "/"));
+	HTTPClientSession* pSession1 = pPool->get(uri);
+	HTTPClientSession* pSession2 = pPool->get(uri);
+	assert (pSession1 != pSession2);
+	assert (pPool->used() == 2);
+
+	// the pool is exhausted, so an unpooled session is handed out
+	HTTPClientSession* pOverflow = pPool->get(uri);
+	assert (pOverflow != pSession1 && pOverflow != pSession2);
+	assert (pPool->overflows() == 1);
+	assert (pPool->misses() == 2);
+	assert (pPool->used() == 3);
+	assert (sendRequest(*pOverflow, "/overflow") == "/overflow");
+
+	// sessions for other hosts are not affected
+	HTTPClientSession* pSession3 = pPool->get(URI(uriFor(svs, "/", "127.0.0.1")));
+	assert (pPool->used() == 4);
+	assert (pPool->overflows() == 1);
+
+	pPool->putBack(pOverflow);
+	assert (pPool->used() == 3);
+	assert (pPool->idle() == 0);
+	pPool->putBack(pSession1);
+	pPool->putBack(pSession2);
+	pPool->putBack(pSession3);
+	assert (pPool->used() == 0);
+}
+
+
+void HTTPClientSessionPoolTest::testClosedByServer()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, new HTTPServerParams);
+	srv.start();
+
+	HTTPClientSessionPool::Ptr pPool = new HTTPClientSessionPool;
+	URI uri(uriFor(svs, "/close"));
+	HTTPClientSession* pSession = pPool->get(uri);
+	assert (sendRequest(*pSession, "/close") == "/close");
+	pPool->putBack(pSession);
+	assert (pPool->idle() == 1);
+
+	Poco::Thread::sleep(200);
+
+	pSession = pPool->get(uri);
+	assert (pPool->evictions() == 1);
+	assert (pPool->hits() == 0);
+	assert (pPool->misses() == 2);
+	assert (sendRequest(*pSession, "/ok") == "/ok");
+	pPool->putBack(pSession);
+}
+
+
+void HTTPClientSessionPoolTest::testIdleTimeout()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, new HTTPServerParams);
+	srv.start();
+
+	HTTPClientSessionPool::Ptr pPool = new HTTPClientSessionPool(HTTPClientSessionPool::DEFAULT_MAX_SESSIONS_PER_HOST, 1);
+	HTTPClientSession* pSession = pPool->get(URI(uriFor(svs, "/")));
+	assert (sendRequest(*pSession, "/") == "/");
+	pPool->putBack(pSession);
+	assert (pPool->idle() == 1);
+
+	Poco::Thread::sleep(2000);
+
+	assert (pPool->idle() == 0);
+	assert (pPool->evictions() == 1);
+}
+
+
+void HTTPClientSessionPoolTest::testStreamFactory()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, new HTTPServerParams);
+	srv.start();
+
+	HTTPClientSessionPool::Ptr pPool = new HTTPClientSessionPool;
+	HTTPStreamFactory factory;
+	factory.setSessionPool(pPool);
+	for (int i = 0; i < 3; ++i)
+	{
+		std::auto_ptr<std::istream> pStr(factory.open(URI(uriFor(svs, "/stream"))));
+		std::ostringstream ostr;
+		StreamCopier::copyStream(*pStr.get(), ostr);
+		assert (ostr.str() == "/stream");
+	}
+	assert (pPool->misses() == 1);
+	assert (pPool->hits() == 2);
+	assert (pPool->idle() == 1);
+	assert (srv.totalConnections() == 1);
+
+	{
+		std::auto_ptr<std::istream> pStr(factory.open(URI(uriFor(svs, "/unread"))));
+		assert (pPool->used() == 1);
+	}
+	assert (pPool->used() == 0);
+}
+
+
+void HTTPClientSessionPoolTest::testNoInstantiator()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, new HTTPServerParams);
+	srv.start();
+
+	HTTPSessionInstantiator::unregisterInstantiator();
+	try
+	{
+		HTTPClientSessionPool::Ptr pPool = new HTTPClientSessionPool;
+		HTTPClientSession* pSession = pPool->get(URI(uriFor(svs, "/plain")));
+		assert (sendRequest(*pSession, "/plain") == "/plain");
+		pPool->putBack(pSession);
+		assert (pPool->misses() == 1);
+	}
+	catch (...)
+	{
+		HTTPSessionInstantiator::registerInstantiator();
+		throw;
+	}
+	HTTPSessionInstantiator::registerInstantiator();
+}
+
+
+void HTTPClientSessionPoolTest::setUp()
+{
+	HTTPSessionInstantiator::registerInstantiator();
+}
+
+
+void HTTPClientSessionPoolTest::tearDown()
+{
+	HTTPSessionInstantiator::unregisterInstantiator();
+}
+
+
+CppUnit::Test* HTTPClientSessionPoolTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPClientSessionPoolTest");
+
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testReuse);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testMaxSessions);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testClosedByServer);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testIdleTimeout);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testStreamFactory);
+	CppUnit_addTest(pSuite, HTTPClientSessionPoolTest, testNoInstantiator);
+
+	return pSuite;
+}
@@ -0,0 +1,45 @@
+//
+// HTTPClientSessionPoolTest.h
+//
+// $Id: //poco/1.4/Net/testsuite/src/HTTPClientSessionPoolTest.h#1 $
+//
+// Definition of the HTTPClientSessionPoolTest class.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HTTPClientSessionPoolTest_INCLUDED
+#define HTTPClientSessionPoolTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "CppUnit/TestCase.h"
+
+
+class HTTPClientSessionPoolTest: public CppUnit::TestCase
+{
+public:
+	HTTPClientSessionPoolTest(const std::string& name);
+	~HTTPClientSessionPoolTest();
+
+	void testReuse();
+	void testMaxSessions();
+	void testClosedByServer();
+	void testIdleTimeout();
+	void testStreamFactory();
+	void testNoInstantiator();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HTTPClientSessionPoolTest_INCLUDED
@@ -24,6 +24,11 @@
 #include "Poco/Net/HTTPServerResponse.h"
 #include "Poco/Net/ServerSocket.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/Thread.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Net/NetException.h"
 #include <sstream>
 
 
@@ -40,6 +45,7 @@ using Poco::Net::HTTPServerResponse;
 using Poco::Net::HTTPMessage;
 using Poco::Net::ServerSocket;
 using Poco::StreamCopier;
+using Poco::TemporaryFile;
 
 
 namespace
@@ -106,9 +112,40 @@ namespace
 		}
 	};
 	
+	class FileRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		FileRequestHandler(const std::string& path, bool ranged):
+			_path(path),
+			_ranged(ranged)
+		{
+		}
+		
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			if (_ranged)
+				response.sendFileRange(_path, "text/plain");
+			else
+				response.sendFile(_path, "text/plain");
+		}
+		
+	private:
+		std::string _path;
+		bool _ranged;
+	};
+	
 	class RequestHandlerFactory: public HTTPRequestHandlerFactory
 	{
 	public:
+		RequestHandlerFactory()
+		{
+		}
+		
+		RequestHandlerFactory(const std::string& path):
+			_path(path)
+		{
+		}
+		
 		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
 		{
 			if (request.getURI() == "/echoBody")
@@ -121,9 +158,16 @@ namespace
 				return new AuthRequestHandler();
 			else if (request.getURI() == "/buffer")
 				return new BufferRequestHandler();
+			else if (request.getURI() == "/file")
+				return new FileRequestHandler(_path, false);
+			else if (request.getURI() == "/fileRange")
+				return new FileRequestHandler(_path, true);
 			else
 				return 0;
 		}
+		
+	private:
+		std::string _path;
 	};
 }
 
@@ -518,6 +562,428 @@ void HTTPServerTest::testBuffer()
 }
 
 
+void HTTPServerTest::testFile()
+{
+	TemporaryFile tf;
+	std::string data;
+	for (int i = 0; i < 20000; ++i) data += static_cast<char>('a' + i % 26);
+	{
+		Poco::FileOutputStream ostr(tf.path());
+		ostr << data;
+	}
+
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory(tf.path()), svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	for (int i = 0; i < 2; ++i)
+	{
+		HTTPRequest request("GET", "/file", HTTPMessage::HTTP_1_1);
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (response.getContentLength() == data.size());
+		assert (response.getContentType() == "text/plain");
+		assert (response.has("Last-Modified"));
+		assert (rbody == data);
+	}
+	
+	HTTPRequest request("HEAD", "/file", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getContentLength() == data.size());
+	assert (rbody.empty());
+}
+
+
+void HTTPServerTest::testFileRange()
+{
+	TemporaryFile tf;
+	std::string data("0123456789abcdefghij");
+	{
+		Poco::FileOutputStream ostr(tf.path());
+		ostr << data;
+	}
+
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory(tf.path()), svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	
+	{
+		HTTPRequest request("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (response.get("Accept-Ranges") == "bytes");
+		assert (rbody == data);
+	}
+	{
+		HTTPRequest request("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+		request.set("Range", "bytes=2-5");
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+		assert (response.get("Content-Range") == "bytes 2-5/20");
+		assert (response.getContentLength() == 4);
+		assert (rbody == "2345");
+	}
+	{
+		HTTPRequest request("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+		request.set("Range", "bytes=15-");
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+		assert (response.get("Content-Range") == "bytes 15-19/20");
+		assert (rbody == "fghij");
+	}
+	{
+		HTTPRequest request("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+		request.set("Range", "bytes=-3");
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+		assert (response.get("Content-Range") == "bytes 17-19/20");
+		assert (rbody == "hij");
+	}
+	{
+		HTTPRequest request("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+		request.set("Range", "bytes=10-100");
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+		assert (response.get("Content-Range") == "bytes 10-19/20");
+		assert (rbody == "abcdefghij");
+	}
+	{
+		HTTPRequest request("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+		request.set("Range", "bytes=20-30");
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+		assert (response.get("Content-Range") == "bytes */20");
+		assert (rbody.empty());
+	}
+	{
+		HTTPRequest request("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+		request.set("Range", "bytes=0-1,4-5");
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (rbody == data);
+	}
+	{
+		HTTPRequest request("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+		request.set("Range", "bytes=2-5");
+		request.set("If-Range", "Thu, 01 Jan 1970 00:00:00 GMT");
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (rbody == data);
+	}
+}
+
+
+void HTTPServerTest::testReactorKeepAlive()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setMaxKeepAliveRequests(4);
+	pParams->setReactorMode(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+	request.setContentType("text/plain");
+	request.setChunkedTransferEncoding(true);
+	std::string body(5000, 'x');
+	for (int i = 0; i < 3; ++i)
+	{
+		cs.sendRequest(request) << body;
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(response) >> rbody;
+		assert (response.getContentLength() == HTTPMessage::UNKNOWN_CONTENT_LENGTH);
+		assert (response.getContentType() == "text/plain");
+		assert (response.getChunkedTransferEncoding());
+		assert (response.getKeepAlive());
+		assert (rbody == body);
+
+		Poco::Thread::sleep(200);
+		assert (srv.currentConnections() == 0);
+		assert (srv.parkedConnections() == 1);
+	}
+
+	{
+		cs.sendRequest(request) << body;
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(response) >> rbody;
+		assert (response.getContentLength() == HTTPMessage::UNKNOWN_CONTENT_LENGTH);
+		assert (response.getContentType() == "text/plain");
+		assert (response.getChunkedTransferEncoding());
+		assert (!response.getKeepAlive());
+		assert (rbody == body);
+
+		Poco::Thread::sleep(200);
+		assert (srv.parkedConnections() == 0);
+	}
+	// resumed connections are not counted again
+	assert (srv.totalConnections() == 1);
+	assert (srv.refusedConnections() == 0);
+}
+
+
+void HTTPServerTest::testReactorKeepAliveTimeout()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setKeepAliveTimeout(Poco::Timespan(1, 0));
+	pParams->setReactorMode(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/buffer", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getKeepAlive());
+	assert (rbody == "xxxxxxxxxx");
+
+	Poco::Thread::sleep(200);
+	assert (srv.parkedConnections() == 1);
+
+	Poco::Thread::sleep(2000);
+	assert (srv.parkedConnections() == 0);
+}
+
+
+void HTTPServerTest::testPipelining()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	for (int i = 0; i < 10; ++i)
+	{
+		HTTPRequest request(i % 2 ? "GET" : "HEAD", "/echoHeader", HTTPMessage::HTTP_1_1);
+		request.set("X-Sequence", Poco::NumberFormatter::format(i));
+		cs.sendPipelinedRequest(request);
+	}
+	assert (cs.pipelinedRequests() == 10);
+	for (int i = 0; i < 10; ++i)
+	{
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receivePipelinedResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		if (i % 2)
+			assert (rbody.find("X-Sequence: " + Poco::NumberFormatter::format(i) + "\r\n") != std::string::npos);
+		else
+			assert (rbody.empty());
+	}
+	assert (cs.pipelinedRequests() == 0);
+	assert (srv.totalConnections() == 1);
+
+	HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+	request.setChunkedTransferEncoding(true);
+	try
+	{
+		cs.sendPipelinedRequest(request);
+		fail("request with body - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	// regular requests can be sent once all responses have been received
+	HTTPRequest bufRequest("GET", "/buffer", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(bufRequest);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (rbody == "xxxxxxxxxx");
+}
+
+
+void HTTPServerTest::testPipeliningDepth()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setMaxKeepAliveRequests(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	// The requests and echoed responses are far larger than the socket
+	// buffers, so sending all of them at once would block both sides.
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	cs.setPipelineDepth(4);
+	assert (cs.getPipelineDepth() == 4);
+	std::string padding(4000, 'x');
+	const int count = 5000;
+	for (int i = 0; i < count; ++i)
+	{
+		HTTPRequest request("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+		request.set("X-Sequence", Poco::NumberFormatter::format(i));
+		request.set("X-Padding", padding);
+		cs.sendPipelinedRequest(request);
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receivePipelinedResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (rbody.find("X-Sequence: " + Poco::NumberFormatter::format(i) + "\r\n") != std::string::npos);
+		assert (cs.pipelinedRequests() == static_cast<std::size_t>(count - i - 1));
+	}
+	assert (srv.totalConnections() == 1);
+}
+
+
+void HTTPServerTest::testPipeliningReplay()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setMaxKeepAliveRequests(3);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	for (int i = 0; i < 10; ++i)
+	{
+		HTTPRequest request("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+		request.set("X-Sequence", Poco::NumberFormatter::format(i));
+		cs.sendPipelinedRequest(request);
+	}
+	for (int i = 0; i < 10; ++i)
+	{
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receivePipelinedResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (rbody.find("X-Sequence: " + Poco::NumberFormatter::format(i) + "\r\n") != std::string::npos);
+	}
+	assert (srv.totalConnections() == 4);
+
+	// non-idempotent requests are not sent again
+	ServerSocket svs2(0);
+	HTTPServerParams* pParams2 = new HTTPServerParams;
+	pParams2->setKeepAlive(true);
+	pParams2->setMaxKeepAliveRequests(1);
+	HTTPServer srv2(new RequestHandlerFactory, svs2, pParams2);
+	srv2.start();
+
+	cs.reset();
+	cs.setPort(svs2.address().port());
+	HTTPRequest getRequest("GET", "/buffer", HTTPMessage::HTTP_1_1);
+	cs.sendPipelinedRequest(getRequest);
+	HTTPRequest postRequest("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+	postRequest.setContentLength(0);
+	cs.sendPipelinedRequest(postRequest);
+
+	HTTPResponse response;
+	std::string rbody;
+	cs.receivePipelinedResponse(response) >> rbody;
+	assert (rbody == "xxxxxxxxxx");
+	assert (!response.getKeepAlive());
+	try
+	{
+		cs.receivePipelinedResponse(response);
+		fail("non-idempotent request cannot be replayed - must throw");
+	}
+	catch (Poco::Net::HTTPException&)
+	{
+	}
+	assert (cs.pipelinedRequests() == 0);
+}
+
+
+void HTTPServerTest::testRequestArena()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	// The body streams of all requests on the connection
+	// are created in the same, reused arena.
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	for (int i = 0; i < 30; ++i)
+	{
+		std::string body(100*i, 'x');
+		HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+		switch (i % 3)
+		{
+		case 0:
+			request.setContentLength((int) body.length());
+			break;
+		case 1:
+			request.setChunkedTransferEncoding(true);
+			break;
+		default:
+			request.setMethod("GET");
+			request.setContentLength(0);
+			body.clear();
+			break;
+		}
+		request.setContentType("text/plain");
+		cs.sendRequest(request) << body;
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (response.getKeepAlive());
+		assert (rbody == body);
+	}
+}
+
+
 void HTTPServerTest::setUp()
 {
 }
@@ -546,6 +1012,14 @@ CppUnit::Test* HTTPServerTest::suite()
 	CppUnit_addTest(pSuite, HTTPServerTest, testAuth);
 	CppUnit_addTest(pSuite, HTTPServerTest, testNotImpl);
 	CppUnit_addTest(pSuite, HTTPServerTest, testBuffer);
+	CppUnit_addTest(pSuite, HTTPServerTest, testFile);
+	CppUnit_addTest(pSuite, HTTPServerTest, testFileRange);
+	CppUnit_addTest(pSuite, HTTPServerTest, testReactorKeepAlive);
+	CppUnit_addTest(pSuite, HTTPServerTest, testReactorKeepAliveTimeout);
+	CppUnit_addTest(pSuite, HTTPServerTest, testPipelining);
+	CppUnit_addTest(pSuite, HTTPServerTest, testPipeliningDepth);
+	CppUnit_addTest(pSuite, HTTPServerTest, testPipeliningReplay);
+	CppUnit_addTest(pSuite, HTTPServerTest, testRequestArena);
 
 	return pSuite;
 }
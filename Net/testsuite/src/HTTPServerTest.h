@@ -40,6 +40,14 @@ public:
 	void testAuth();
 	void testNotImpl();
 	void testBuffer();
+	void testFile();
+	void testFileRange();
+	void testReactorKeepAlive();
+	void testReactorKeepAliveTimeout();
+	void testPipelining();
+	void testPipeliningDepth();
+	void testPipeliningReplay();
+	void testRequestArena();
 
 	void setUp();
 	void tearDown();
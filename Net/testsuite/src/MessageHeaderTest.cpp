@@ -23,6 +23,39 @@ using Poco::Net::NameValueCollection;
 using Poco::Net::MessageException;
 
 
+namespace
+{
+	class ChunkedStreamBuf: public std::streambuf
+		/// Delivers the string in small chunks, so that header
+		/// fields span several get areas.
+	{
+	public:
+		ChunkedStreamBuf(const std::string& s, std::size_t chunk):
+			_s(s),
+			_pos(0),
+			_chunk(chunk)
+		{
+		}
+
+	protected:
+		int_type underflow()
+		{
+			if (_pos >= _s.size()) return traits_type::eof();
+			std::size_t n = _s.size() - _pos < _chunk ? _s.size() - _pos : _chunk;
+			char* p = const_cast<char*>(_s.data()) + _pos;
+			setg(p, p, p + n);
+			_pos += n;
+			return traits_type::to_int_type(*p);
+		}
+
+	private:
+		std::string _s;
+		std::size_t _pos;
+		std::size_t _chunk;
+	};
+}
+
+
 MessageHeaderTest::MessageHeaderTest(const std::string& name): CppUnit::TestCase(name)
 {
 }
@@ -213,6 +246,66 @@ void MessageHeaderTest::testReadInvalid2()
 }
 
 
+void MessageHeaderTest::testReadInvalid3()
+{
+	std::string s("name1: value1\r\n");
+	s.append(300, 'x');
+	s.append(": value2\r\n");
+	std::istringstream istr(s);
+	MessageHeader mh;
+	try
+	{
+		mh.read(istr);
+		fail("field name too long - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+}
+
+
+void MessageHeaderTest::testReadLong()
+{
+	std::string name(255, 'n');
+	std::string value(8000, 'v');
+	std::string s(name);
+	s.append(": ");
+	s.append(value);
+	s.append("  \r\nname2: value2\r\n\r\n");
+	std::istringstream istr(s);
+	MessageHeader mh;
+	mh.read(istr);
+	assert (mh.size() == 2);
+	assert (mh[name] == value);
+	assert (mh["name2"] == "value2");
+}
+
+
+void MessageHeaderTest::testReadChunked()
+{
+	std::string value(300, 'v');
+	std::string s("name1: value1\r\nname2:  ");
+	s.append(value);
+	s.append("\r\n folded\r\ninvalid\nname3: value3\r\n\r\nbody");
+	for (std::size_t chunk = 1; chunk <= 8; ++chunk)
+	{
+		ChunkedStreamBuf buf(s, chunk);
+		std::istream istr(&buf);
+		MessageHeader mh;
+		mh.read(istr);
+		assert (mh.size() == 3);
+		assert (mh["name1"] == "value1");
+		assert (mh["name2"] == value + " folded");
+		assert (mh["name3"] == "value3");
+		std::string rest;
+		std::getline(istr, rest);
+		assert (rest == "\r");
+		std::getline(istr, rest);
+		assert (rest == "body");
+	}
+}
+
+
 void MessageHeaderTest::testSplitElements()
 {
 	std::string s;
@@ -389,6 +482,9 @@ CppUnit::Test* MessageHeaderTest::suite()
 	CppUnit_addTest(pSuite, MessageHeaderTest, testReadFolding5);
 	CppUnit_addTest(pSuite, MessageHeaderTest, testReadInvalid1);
 	CppUnit_addTest(pSuite, MessageHeaderTest, testReadInvalid2);
+	CppUnit_addTest(pSuite, MessageHeaderTest, testReadInvalid3);
+	CppUnit_addTest(pSuite, MessageHeaderTest, testReadLong);
+	CppUnit_addTest(pSuite, MessageHeaderTest, testReadChunked);
 	CppUnit_addTest(pSuite, MessageHeaderTest, testSplitElements);
 	CppUnit_addTest(pSuite, MessageHeaderTest, testSplitParameters);
 	CppUnit_addTest(pSuite, MessageHeaderTest, testFieldLimit);
@@ -39,6 +39,9 @@ public:
 	void testReadFolding5();
 	void testReadInvalid1();
 	void testReadInvalid2();
+	void testReadInvalid3();
+	void testReadLong();
+	void testReadChunked();
 	void testSplitElements();
 	void testSplitParameters();
 	void testFieldLimit();
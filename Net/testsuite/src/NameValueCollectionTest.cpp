@@ -14,11 +14,14 @@
 #include "CppUnit/TestCaller.h"
 #include "CppUnit/TestSuite.h"
 #include "Poco/Net/NameValueCollection.h"
+#include "Poco/ListMap.h"
+#include "Poco/NumberFormatter.h"
 #include "Poco/Exception.h"
 
 
 using Poco::Net::NameValueCollection;
 using Poco::NotFoundException;
+using Poco::NumberFormatter;
 
 
 NameValueCollectionTest::NameValueCollectionTest(const std::string& name): CppUnit::TestCase(name)
@@ -108,6 +111,85 @@ void NameValueCollectionTest::testNameValueCollection()
 }
 
 
+void NameValueCollectionTest::testIndexed()
+{
+	// compare a collection large enough to be indexed
+	// against a plain ListMap
+	typedef Poco::ListMap<std::string, std::string> RefMap;
+	NameValueCollection nvc;
+	RefMap ref;
+	
+	for (int i = 0; i < 200; ++i)
+	{
+		std::string name("Name");
+		name += NumberFormatter::format(i % 37);
+		if (i % 3 == 0) name = Poco::toUpper(name);
+		std::string value = NumberFormatter::format(i);
+		if (i % 5 == 0)
+		{
+			nvc.set(name, value);
+			RefMap::Iterator it = ref.find(name);
+			if (it != ref.end())
+				it->second = value;
+			else
+				ref.insert(RefMap::ValueType(name, value));
+		}
+		else
+		{
+			nvc.add(name, value);
+			ref.insert(RefMap::ValueType(name, value));
+		}
+		if (i % 50 == 49)
+		{
+			std::string erased("name");
+			erased += NumberFormatter::format(i % 7);
+			nvc.erase(erased);
+			ref.erase(erased);
+		}
+	}
+	
+	assert (nvc.size() == ref.size());
+	NameValueCollection::ConstIterator it = nvc.begin();
+	RefMap::ConstIterator itRef = ref.begin();
+	for (; it != nvc.end(); ++it, ++itRef)
+	{
+		assert (it->first == itRef->first);
+		assert (it->second == itRef->second);
+	}
+	for (int i = 0; i < 40; ++i)
+	{
+		std::string name("nAmE");
+		name += NumberFormatter::format(i);
+		assert (nvc.has(name) == (ref.find(name) != ref.end()));
+		if (nvc.has(name))
+		{
+			assert (nvc.get(name) == ref[name]);
+			assert (nvc.find(name) != nvc.end());
+		}
+	}
+	
+	NameValueCollection copy(nvc);
+	assert (copy.size() == nvc.size());
+	assert (copy.get("name36") == nvc.get("name36"));
+	copy.set("name36", "changed");
+	assert (copy.get("NAME36") == "changed");
+	assert (nvc.get("NAME36") != "changed");
+	
+	NameValueCollection other;
+	other.add("a", "b");
+	other.swap(copy);
+	assert (other.get("name36") == "changed");
+	assert (copy.get("A") == "b");
+	assert (!copy.has("name36"));
+	
+	other.clear();
+	assert (other.empty());
+	assert (!other.has("name36"));
+	other.add("name36", "new");
+	assert (other.get("name36") == "new");
+}
+
+
 void NameValueCollectionTest::setUp()
 {
 }
@@ -123,6 +205,7 @@ CppUnit::Test* NameValueCollectionTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("NameValueCollectionTest");
 
 	CppUnit_addTest(pSuite, NameValueCollectionTest, testNameValueCollection);
+	CppUnit_addTest(pSuite, NameValueCollectionTest, testIndexed);
 
 	return pSuite;
 }
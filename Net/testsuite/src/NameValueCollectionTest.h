@@ -27,6 +27,7 @@ public:
 	~NameValueCollectionTest();
 
 	void testNameValueCollection();
+	void testIndexed();
 
 	void setUp();
 	void tearDown();
@@ -0,0 +1,209 @@
+//
+// PollSetTest.cpp
+//
+// $Id: //poco/1.4/Net/testsuite/src/PollSetTest.cpp#1 $
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "PollSetTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Net/PollSet.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Timespan.h"
+#include "Poco/Stopwatch.h"
+
+
+using Poco::Net::Socket;
+using Poco::Net::PollSet;
+using Poco::Net::StreamSocket;
+using Poco::Net::ServerSocket;
+using Poco::Net::SocketAddress;
+using Poco::Timespan;
+using Poco::Stopwatch;
+
+
+PollSetTest::PollSetTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+PollSetTest::~PollSetTest()
+{
+}
+
+
+void PollSetTest::testPoll()
+{
+	Timespan timeout(250000);
+
+	ServerSocket srv(SocketAddress("localhost", 0));
+	StreamSocket ss1(SocketAddress("localhost", srv.address().port()));
+	StreamSocket sc1 = srv.acceptConnection();
+	StreamSocket ss2(SocketAddress("localhost", srv.address().port()));
+	StreamSocket sc2 = srv.acceptConnection();
+
+	PollSet ps;
+	ps.add(ss1, PollSet::POLL_READ);
+	ps.add(ss2, PollSet::POLL_READ);
+	assert (ps.has(ss1));
+	assert (ps.has(ss2));
+	assert (!ps.has(sc1));
+	assert (ps.count() == 2);
+
+	Stopwatch sw;
+	sw.start();
+	PollSet::SocketModeMap sm = ps.poll(timeout);
+	assert (sm.empty());
+	assert (sw.elapsed() >= 200000);
+
+	sc1.sendBytes("hello", 5);
+	sm = ps.poll(timeout);
+	assert (sm.size() == 1);
+	assert (sm.begin()->first == ss1);
+	assert (sm.begin()->second == PollSet::POLL_READ);
+
+	sc2.sendBytes("hello", 5);
+	sm = ps.poll(timeout);
+	assert (sm.size() == 2);
+	assert (sm[ss1] == PollSet::POLL_READ);
+	assert (sm[ss2] == PollSet::POLL_READ);
+
+	char buffer[256];
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 5);
+	assert (std::string(buffer, n) == "hello");
+
+	sm = ps.poll(timeout);
+	assert (sm.size() == 1);
+	assert (sm.begin()->first == ss2);
+
+	ps.remove(ss2);
+	assert (!ps.has(ss2));
+	assert (ps.count() == 1);
+	sm = ps.poll(timeout);
+	assert (sm.empty());
+
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 5);
+
+	ss1.close();
+	ss2.close();
+	sc1.close();
+	sc2.close();
+}
+
+
+void PollSetTest::testUpdate()
+{
+	Timespan timeout(250000);
+
+	ServerSocket srv(SocketAddress("localhost", 0));
+	StreamSocket ss(SocketAddress("localhost", srv.address().port()));
+	StreamSocket sc = srv.acceptConnection();
+
+	PollSet ps;
+	ps.add(ss, PollSet::POLL_READ);
+	PollSet::SocketModeMap sm = ps.poll(timeout);
+	assert (sm.empty());
+
+	ps.update(ss, PollSet::POLL_READ | PollSet::POLL_WRITE);
+	sm = ps.poll(timeout);
+	assert (sm.size() == 1);
+	assert (sm[ss] == PollSet::POLL_WRITE);
+
+	sc.sendBytes("hello", 5);
+	ps.add(ss, PollSet::POLL_READ);
+	sm = ps.poll(timeout);
+	assert (sm.size() == 1);
+	assert (sm[ss] == PollSet::POLL_READ);
+
+	ps.update(ss, 0);
+	assert (!ps.has(ss));
+	assert (ps.empty());
+
+	ss.close();
+	sc.close();
+}
+
+
+void PollSetTest::testHangUp()
+{
+	Timespan timeout(250000);
+
+	ServerSocket srv(SocketAddress("localhost", 0));
+	StreamSocket ss(SocketAddress("localhost", srv.address().port()));
+	StreamSocket sc = srv.acceptConnection();
+
+	PollSet ps;
+	ps.add(ss, PollSet::POLL_READ);
+	sc.close();
+	PollSet::SocketModeMap sm = ps.poll(timeout);
+	assert (sm.size() == 1);
+	assert (sm[ss] & PollSet::POLL_READ);
+	char buffer[16];
+	assert (ss.receiveBytes(buffer, sizeof(buffer)) == 0);
+
+#if defined(POCO_HAVE_FD_EPOLL)
+	// Both directions are closed now, so epoll reports only EPOLLHUP
+	// for a socket registered for errors.
+	ss.shutdownSend();
+	ps.update(ss, PollSet::POLL_ERROR);
+	sm = ps.poll(timeout);
+	assert (sm.size() == 1);
+	assert (sm[ss] == (PollSet::POLL_READ | PollSet::POLL_ERROR));
+#endif
+
+	ps.remove(ss);
+	ss.close();
+}
+
+
+void PollSetTest::testEmpty()
+{
+	PollSet ps;
+	assert (ps.empty());
+
+	Stopwatch sw;
+	sw.start();
+	PollSet::SocketModeMap sm = ps.poll(Timespan(1, 0));
+	assert (sm.empty());
+	assert (sw.elapsed() < 500000);
+
+	ServerSocket srv(SocketAddress("localhost", 0));
+	ps.add(srv, PollSet::POLL_READ);
+	assert (!ps.empty());
+	ps.clear();
+	assert (ps.empty());
+	assert (!ps.has(srv));
+}
+
+
+void PollSetTest::setUp()
+{
+}
+
+
+void PollSetTest::tearDown()
+{
+}
+
+
+CppUnit::Test* PollSetTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PollSetTest");
+
+	CppUnit_addTest(pSuite, PollSetTest, testPoll);
+	CppUnit_addTest(pSuite, PollSetTest, testUpdate);
+	CppUnit_addTest(pSuite, PollSetTest, testHangUp);
+	CppUnit_addTest(pSuite, PollSetTest, testEmpty);
+
+	return pSuite;
+}
@@ -19,6 +19,8 @@
 #include "Poco/Thread.h"
 #include "Poco/Message.h"
 #include "Poco/AutoPtr.h"
+#include "Poco/Event.h"
+#include "Poco/Exception.h"
 #include <list>
 
 
@@ -112,6 +114,26 @@ void CachingChannel::getMessages(std::vector<Poco::Message>& msg, int offset, in
 }
 
 
+class BlockingChannel: public Poco::Channel
+	/// Blocks in log() until released.
+{
+public:
+	BlockingChannel():
+		release(false)
+	{
+	}
+
+	void log(const Poco::Message&)
+	{
+		logging.set();
+		release.wait();
+	}
+
+	Poco::Event logging;
+	Poco::Event release;
+};
+
+
 SyslogTest::SyslogTest(const std::string& name): CppUnit::TestCase(name)
 {
 }
@@ -213,6 +235,47 @@ void SyslogTest::testOldBSD()
 }
 
 
+void SyslogTest::testQueueSize()
+{
+	Poco::AutoPtr<RemoteSyslogListener> listener = new RemoteSyslogListener(51400);
+	assert (listener->getProperty("queueSize") == "none");
+	listener->setProperty("queueSize", "2");
+	assert (listener->getProperty("queueSize") == "2");
+	BlockingChannel bc;
+	listener->addChannel(&bc);
+	listener->open();
+	try
+	{
+		listener->setProperty("queueSize", "none");
+		fail("listener is open - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+
+	Poco::AutoPtr<RemoteSyslogChannel> channel = new RemoteSyslogChannel();
+	channel->setProperty("loghost", "localhost:51400");
+	channel->open();
+	Poco::Message msg("asource", "amessage", Poco::Message::PRIO_CRITICAL);
+	channel->log(msg);
+	bc.logging.wait();
+	// the only parser thread is blocked, so all but two messages are dropped
+	for (int i = 0; i < 10; ++i)
+	{
+		channel->log(msg);
+	}
+	Poco::Thread::sleep(500);
+	int dropped = listener->droppedMessages();
+	bc.release.set();
+	channel->close();
+	listener->close();
+	assert (dropped == 8);
+
+	listener->setProperty("queueSize", "none");
+	assert (listener->getProperty("queueSize") == "none");
+}
+
+
 void SyslogTest::setUp()
 {
 }
@@ -230,6 +293,7 @@ CppUnit::Test* SyslogTest::suite()
 	CppUnit_addTest(pSuite, SyslogTest, testListener);
 	CppUnit_addTest(pSuite, SyslogTest, testChannelOpenClose);
 	CppUnit_addTest(pSuite, SyslogTest, testOldBSD);
+	CppUnit_addTest(pSuite, SyslogTest, testQueueSize);
 
 	return pSuite;
 }
@@ -29,6 +29,7 @@ public:
 	void testListener();
 	void testChannelOpenClose();
 	void testOldBSD();
+	void testQueueSize();
 
 	void setUp();
 	void tearDown();
@@ -20,6 +20,9 @@
 #include "Poco/Net/StreamSocket.h"
 #include "Poco/Net/ServerSocket.h"
 #include "Poco/Thread.h"
+#include "Poco/TaskExecutor.h"
+#include "Poco/Runnable.h"
+#include "Poco/Event.h"
 #include <iostream>
 
 
@@ -32,6 +35,9 @@ using Poco::Net::StreamSocket;
 using Poco::Net::ServerSocket;
 using Poco::Net::SocketAddress;
 using Poco::Thread;
+using Poco::TaskExecutor;
+using Poco::Runnable;
+using Poco::Event;
 
 
 namespace
@@ -62,6 +68,27 @@ namespace
 			}
 		}
 	};
+	
+	class BlockingTask: public Runnable
+	{
+	public:
+		void run()
+		{
+			started.set();
+			release.wait();
+		}
+		
+		Event started;
+		Event release;
+	};
+	
+	class NullTask: public Runnable
+	{
+	public:
+		void run()
+		{
+		}
+	};
 }
 
 
@@ -243,6 +270,126 @@ void TCPServerTest::testThreadCapacity(){
 }
 
 
+void TCPServerTest::testMultiAcceptors()
+{
+	ServerSocket svs(0);
+	TCPServerParams* pParams = new TCPServerParams;
+	pParams->setMaxThreads(4);
+	pParams->setAcceptors(4);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs, pParams);
+	srv.start();
+	if (!svs.getReusePort())
+	{
+		assert (srv.acceptors() == 1);
+		return;
+	}
+	assert (srv.acceptors() == 4);
+	for (int i = 0; i < srv.acceptors(); ++i)
+	{
+		assert (srv.socket(i).address().port() == svs.address().port());
+	}
+	assert (srv.maxThreads() >= 16);
+
+	SocketAddress sa("localhost", svs.address().port());
+	std::string data("hello, world");
+	for (int i = 0; i < 16; ++i)
+	{
+		StreamSocket ss(sa);
+		ss.sendBytes(data.data(), (int) data.size());
+		char buffer[256];
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (n > 0);
+		assert (std::string(buffer, n) == data);
+		ss.close();
+	}
+	Thread::sleep(1000);
+	assert (srv.currentConnections() == 0);
+	assert (srv.totalConnections() == 16);
+	
+	int total = 0;
+	int maxConcurrent = 0;
+	for (int i = 0; i < srv.acceptors(); ++i)
+	{
+		assert (srv.currentConnections(i) == 0);
+		assert (srv.queuedConnections(i) == 0);
+		assert (srv.refusedConnections(i) == 0);
+		total += srv.totalConnections(i);
+		maxConcurrent += srv.maxConcurrentConnections(i);
+	}
+	assert (total == 16);
+	assert (srv.maxConcurrentConnections() == maxConcurrent);
+}
+
+
+void TCPServerTest::testTaskExecutor()
+{
+	TaskExecutor executor(2);
+	ServerSocket svs(0);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), executor, svs);
+	srv.start();
+	assert (srv.maxThreads() == 2);
+
+	SocketAddress sa("localhost", svs.address().port());
+	std::string data("hello, world");
+	for (int i = 0; i < 8; ++i)
+	{
+		StreamSocket ss(sa);
+		ss.sendBytes(data.data(), (int) data.size());
+		char buffer[256];
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (n > 0);
+		assert (std::string(buffer, n) == data);
+		ss.close();
+	}
+	Thread::sleep(1000);
+	assert (srv.currentConnections() == 0);
+	assert (srv.totalConnections() == 8);
+	srv.stop();
+	executor.joinAll();
+}
+
+
+void TCPServerTest::testTaskExecutorBusy()
+{
+	TaskExecutor executor(1, 1);
+	ServerSocket svs(0);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), executor, svs);
+	srv.start();
+
+	// occupy the only worker and fill its submission queue
+	BlockingTask blocker;
+	NullTask filler;
+	executor.execute(blocker);
+	blocker.started.wait();
+	while (executor.tryExecute(filler));
+
+	// no dispatcher task can be started, so the connection is refused
+	SocketAddress sa("localhost", svs.address().port());
+	StreamSocket ss1(sa);
+	char buffer[256];
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 0);
+	assert (srv.refusedConnections() == 1);
+	assert (srv.queuedConnections() == 0);
+	assert (srv.currentThreads() == 0);
+	ss1.close();
+
+	blocker.release.set();
+	executor.joinAll();
+
+	std::string data("hello, world");
+	StreamSocket ss2(sa);
+	ss2.sendBytes(data.data(), (int) data.size());
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss2.close();
+	Thread::sleep(300);
+	assert (srv.totalConnections() == 1);
+	srv.stop();
+	executor.joinAll();
+}
+
 
 void TCPServerTest::setUp()
 {
@@ -262,6 +409,9 @@ CppUnit::Test* TCPServerTest::suite()
 	CppUnit_addTest(pSuite, TCPServerTest, testTwoConnections);
 	CppUnit_addTest(pSuite, TCPServerTest, testMultiConnections);
 	CppUnit_addTest(pSuite, TCPServerTest, testThreadCapacity);
+	CppUnit_addTest(pSuite, TCPServerTest, testMultiAcceptors);
+	CppUnit_addTest(pSuite, TCPServerTest, testTaskExecutor);
+	CppUnit_addTest(pSuite, TCPServerTest, testTaskExecutorBusy);
 
 	return pSuite;
 }
@@ -30,6 +30,9 @@ public:
 	void testTwoConnections();
 	void testMultiConnections();
 	void testThreadCapacity();
+	void testMultiAcceptors();
+	void testTaskExecutor();
+	void testTaskExecutorBusy();
 
 	void setUp();
 	void tearDown();
@@ -14,6 +14,7 @@
 #include "CppUnit/TestCaller.h"
 #include "CppUnit/TestSuite.h"
 #include "Poco/Net/WebSocket.h"
+#include "Poco/Net/WebSocketImpl.h"
 #include "Poco/Net/SocketStream.h"
 #include "Poco/Net/HTTPClientSession.h"
 #include "Poco/Net/HTTPServer.h"
@@ -25,6 +26,9 @@
 #include "Poco/Net/ServerSocket.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/Thread.h"
+#include "Poco/Random.h"
+#include <algorithm>
+#include <vector>
 
 
 using Poco::Net::HTTPClientSession;
@@ -42,22 +46,36 @@ namespace
 	class WebSocketRequestHandler: public Poco::Net::HTTPRequestHandler
 	{
 	public:
-		WebSocketRequestHandler(std::size_t bufSize = 1024): _bufSize(bufSize)
+		WebSocketRequestHandler(std::size_t bufSize = 1024, bool gather = false, const WebSocket::DeflateConfig* pDeflateConfig = 0): 
+			_bufSize(bufSize),
+			_gather(gather),
+			_deflate(pDeflateConfig != 0)
 		{
+			if (pDeflateConfig) _deflateConfig = *pDeflateConfig;
 		}
 
 		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
 		{
 			try
 			{
-				WebSocket ws(request, response);
+				std::auto_ptr<WebSocket> pWS(_deflate ? new WebSocket(request, response, _deflateConfig) : new WebSocket(request, response));
+				WebSocket& ws = *pWS;
 				std::auto_ptr<char> pBuffer(new char[_bufSize]);
 				int flags;
 				int n;
 				do
 				{
 					n = ws.receiveFrame(pBuffer.get(), _bufSize, flags);
-					ws.sendFrame(pBuffer.get(), n, flags);
+					if (_gather)
+					{
+						// echo the payload in three parts
+						Poco::Net::SocketBufVec buffers;
+						buffers.push_back(Poco::Net::makeSocketBuf(pBuffer.get(), n/3));
+						buffers.push_back(Poco::Net::makeSocketBuf(pBuffer.get() + n/3, n/3));
+						buffers.push_back(Poco::Net::makeSocketBuf(pBuffer.get() + 2*(n/3), n - 2*(n/3)));
+						ws.sendFrame(buffers, flags);
+					}
+					else ws.sendFrame(pBuffer.get(), n, flags);
 				}
 				while (n > 0 || (flags & WebSocket::FRAME_OP_BITMASK) != WebSocket::FRAME_OP_CLOSE);
 			}
@@ -81,23 +99,41 @@ namespace
 
 	private:
 		std::size_t _bufSize;
+		bool _gather;
+		bool _deflate;
+		WebSocket::DeflateConfig _deflateConfig;
 	};
 	
 	class WebSocketRequestHandlerFactory: public Poco::Net::HTTPRequestHandlerFactory
 	{
 	public:
-		WebSocketRequestHandlerFactory(std::size_t bufSize = 1024): _bufSize(bufSize)
+		WebSocketRequestHandlerFactory(std::size_t bufSize = 1024, bool gather = false, const WebSocket::DeflateConfig* pDeflateConfig = 0): 
+			_bufSize(bufSize),
+			_gather(gather),
+			_deflate(pDeflateConfig != 0)
 		{
+			if (pDeflateConfig) _deflateConfig = *pDeflateConfig;
 		}
 
 		Poco::Net::HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
 		{
-			return new WebSocketRequestHandler(_bufSize);
+			return new WebSocketRequestHandler(_bufSize, _gather, _deflate ? &_deflateConfig : 0);
 		}
 
 	private:
 		std::size_t _bufSize;
+		bool _gather;
+		bool _deflate;
+		WebSocket::DeflateConfig _deflateConfig;
 	};
+
+	std::string jsonMessage(int i)
+	{
+		std::string msg("{\"type\":\"quote\",\"symbol\":\"ACME\",\"exchange\":\"NASDAQ\",\"sequence\":");
+		msg += std::string(1, static_cast<char>('0' + i % 10));
+		msg += ",\"bid\":101.25,\"ask\":101.27,\"currency\":\"USD\"}";
+		return msg;
+	}
 }
 
 
@@ -210,6 +246,275 @@ void WebSocketTest::testWebSocketLarge()
 }
 
 
+void WebSocketTest::testSendFrameBuffers()
+{
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory(70000, true), ss, new Poco::Net::HTTPServerParams);
+	server.start();
+	
+	Poco::Thread::sleep(200);
+	
+	HTTPClientSession cs("localhost", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/ws");
+	HTTPResponse response;
+	WebSocket ws(cs, request, response);
+
+	std::vector<char> buffer(70000);
+	const int sizes[] = {1, 2, 5, 125, 126, 1000, 65535, 65536, 70000};
+	for (int i = 0; i < sizeof(sizes)/sizeof(int); i++)
+	{
+		std::string payload;
+		for (int k = 0; k < sizes[i]; k++) payload += static_cast<char>('a' + k % 26);
+
+		// odd-sized parts, so that the masking key must be
+		// continued across buffers
+		Poco::Net::SocketBufVec buffers;
+		std::size_t pos = 0;
+		std::size_t part = 3;
+		while (pos < payload.size())
+		{
+			std::size_t n = std::min(part, payload.size() - pos);
+			buffers.push_back(Poco::Net::makeSocketBuf(payload.data() + pos, n));
+			pos += n;
+			part = part*2 + 1;
+		}
+		int n = ws.sendFrame(buffers, WebSocket::FRAME_BINARY);
+		assert (n == payload.size());
+
+		int flags;
+		n = 0;
+		do
+		{
+			n += ws.receiveFrame(&buffer[0] + n, static_cast<int>(buffer.size()) - n, flags);
+		}
+		while (n > 0 && n < payload.size());
+		assert (n == payload.size());
+		assert (payload.compare(0, payload.size(), &buffer[0], n) == 0);
+		assert (flags == WebSocket::FRAME_BINARY);
+	}
+	ws.shutdown();
+	server.stop();
+}
+
+
+void WebSocketTest::testMaskPayload()
+{
+	const char mask[4] = {'\x12', '\x34', '\x56', '\x78'};
+	std::vector<char> data(300);
+	for (std::size_t i = 0; i < data.size(); i++)
+		data[i] = static_cast<char>(i*7);
+
+	for (std::size_t offset = 0; offset < 4; offset++)
+	{
+		for (std::size_t length = 0; length + offset <= data.size(); length++)
+		{
+			std::vector<char> masked(data.size());
+			Poco::Net::WebSocketImpl::maskPayload(&data[offset], &masked[offset], length, mask);
+			for (std::size_t i = 0; i < length; i++)
+				assert (masked[offset + i] == static_cast<char>(data[offset + i] ^ mask[i % 4]));
+
+			// unmasking in place restores the original data
+			Poco::Net::WebSocketImpl::maskPayload(&masked[offset], &masked[offset], length, mask);
+			assert (std::equal(data.begin() + offset, data.begin() + offset + length, masked.begin() + offset));
+		}
+	}
+}
+
+
+void WebSocketTest::testDeflate()
+{
+	WebSocket::DeflateConfig config;
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory(70000, false, &config), ss, new Poco::Net::HTTPServerParams);
+	server.start();
+	
+	Poco::Thread::sleep(200);
+	
+	HTTPClientSession cs("localhost", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/ws");
+	HTTPResponse response;
+	WebSocket ws(cs, request, response, config);
+	assert (ws.deflateEnabled());
+	assert (request.get("Sec-WebSocket-Extensions") == "permessage-deflate; client_max_window_bits");
+	assert (response.get("Sec-WebSocket-Extensions") == "permessage-deflate");
+
+	std::vector<char> buffer(70000);
+	int flags;
+	int n;
+	std::size_t total = 0;
+	for (int i = 0; i < 100; i++)
+	{
+		std::string payload = jsonMessage(i);
+		n = ws.sendFrame(payload.data(), (int) payload.size());
+		assert (n == payload.size());
+		n = ws.receiveFrame(&buffer[0], (int) buffer.size(), flags);
+		assert (n == payload.size());
+		assert (payload.compare(0, payload.size(), &buffer[0], n) == 0);
+		assert (flags == WebSocket::FRAME_TEXT);
+		total += payload.size();
+	}
+	WebSocket::DeflateStatistics stats = ws.deflateStatistics();
+	assert (stats.bytesSent == total);
+	assert (stats.bytesReceived == total);
+	// with context takeover, repeated messages compress very well
+	assert (stats.sendRatio() < 0.2);
+	assert (stats.receiveRatio() < 0.2);
+
+	// incompressible data, empty and gathered payloads
+	Poco::Random rnd;
+	std::string random;
+	for (int i = 0; i < 65536; i++) random += static_cast<char>(rnd.next(256));
+	n = ws.sendFrame(random.data(), (int) random.size(), WebSocket::FRAME_BINARY);
+	assert (n == random.size());
+	n = ws.receiveFrame(&buffer[0], (int) buffer.size(), flags);
+	assert (n == random.size());
+	assert (random.compare(0, random.size(), &buffer[0], n) == 0);
+	assert (flags == WebSocket::FRAME_BINARY);
+
+	n = ws.sendFrame("", 0);
+	assert (n == 0);
+	n = ws.receiveFrame(&buffer[0], (int) buffer.size(), flags);
+	assert (n == 0);
+	assert (flags == WebSocket::FRAME_TEXT);
+
+	std::string payload = jsonMessage(0) + jsonMessage(1);
+	Poco::Net::SocketBufVec buffers;
+	buffers.push_back(Poco::Net::makeSocketBuf(payload.data(), 17));
+	buffers.push_back(Poco::Net::makeSocketBuf(payload.data() + 17, payload.size() - 17));
+	n = ws.sendFrame(buffers, WebSocket::FRAME_TEXT);
+	assert (n == payload.size());
+	n = ws.receiveFrame(&buffer[0], (int) buffer.size(), flags);
+	assert (n == payload.size());
+	assert (payload.compare(0, payload.size(), &buffer[0], n) == 0);
+
+	// fragmented message, echoed frame by frame
+	std::string part1 = jsonMessage(1);
+	std::string part2 = jsonMessage(2);
+	ws.sendFrame(part1.data(), (int) part1.size(), WebSocket::FRAME_OP_TEXT);
+	ws.sendFrame(part2.data(), (int) part2.size(), WebSocket::FRAME_FLAG_FIN | WebSocket::FRAME_OP_CONT);
+	n = ws.receiveFrame(&buffer[0], (int) buffer.size(), flags);
+	assert (n == part1.size());
+	assert (part1.compare(0, part1.size(), &buffer[0], n) == 0);
+	assert (flags == WebSocket::FRAME_OP_TEXT);
+	n = ws.receiveFrame(&buffer[0], (int) buffer.size(), flags);
+	assert (n == part2.size());
+	assert (part2.compare(0, part2.size(), &buffer[0], n) == 0);
+	assert (flags == (WebSocket::FRAME_FLAG_FIN | WebSocket::FRAME_OP_CONT));
+
+	// the decompressed payload must fit into the buffer
+	std::string large(1000, 'x');
+	ws.sendFrame(large.data(), (int) large.size());
+	try
+	{
+		ws.receiveFrame(&buffer[0], 100, flags);
+		fail("payload too big - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assert (exc.code() == WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	}
+	server.stop();
+}
+
+
+void WebSocketTest::testDeflateNoContextTakeover()
+{
+	WebSocket::DeflateConfig serverConfig;
+	serverConfig.serverMaxWindowBits = 12;
+	serverConfig.clientNoContextTakeover = true;
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory(1024, false, &serverConfig), ss, new Poco::Net::HTTPServerParams);
+	server.start();
+	
+	Poco::Thread::sleep(200);
+	
+	WebSocket::DeflateConfig clientConfig;
+	clientConfig.compressionLevel = 9;
+	clientConfig.clientMaxWindowBits = 10;
+	clientConfig.serverNoContextTakeover = true;
+	HTTPClientSession cs("localhost", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/ws");
+	HTTPResponse response;
+	WebSocket ws(cs, request, response, clientConfig);
+	assert (ws.deflateEnabled());
+	assert (request.get("Sec-WebSocket-Extensions") == "permessage-deflate; server_no_context_takeover; client_max_window_bits=10");
+	assert (response.get("Sec-WebSocket-Extensions") == "permessage-deflate; server_no_context_takeover; client_no_context_takeover; server_max_window_bits=12; client_max_window_bits=10");
+
+	char buffer[1024];
+	int flags;
+	std::size_t total = 0;
+	for (int i = 0; i < 100; i++)
+	{
+		std::string payload = jsonMessage(i);
+		int n = ws.sendFrame(payload.data(), (int) payload.size());
+		assert (n == payload.size());
+		n = ws.receiveFrame(buffer, sizeof(buffer), flags);
+		assert (n == payload.size());
+		assert (payload.compare(0, payload.size(), buffer, n) == 0);
+		total += payload.size();
+	}
+	// every message is compressed on its own
+	WebSocket::DeflateStatistics stats = ws.deflateStatistics();
+	assert (stats.bytesSent == total);
+	assert (stats.sendRatio() > 0.5 && stats.sendRatio() < 1);
+	assert (stats.receiveRatio() > 0.5 && stats.receiveRatio() < 1);
+
+	ws.shutdown();
+	server.stop();
+}
+
+
+void WebSocketTest::testDeflateDeclined()
+{
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory, ss, new Poco::Net::HTTPServerParams);
+	server.start();
+	
+	Poco::Thread::sleep(200);
+	
+	WebSocket::DeflateConfig config;
+	HTTPClientSession cs("localhost", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/ws");
+	HTTPResponse response;
+	WebSocket ws(cs, request, response, config);
+	assert (!ws.deflateEnabled());
+	assert (!response.has("Sec-WebSocket-Extensions"));
+
+	std::string payload = jsonMessage(0);
+	ws.sendFrame(payload.data(), (int) payload.size());
+	char buffer[1024];
+	int flags;
+	int n = ws.receiveFrame(buffer, sizeof(buffer), flags);
+	assert (n == payload.size());
+	assert (payload.compare(0, payload.size(), buffer, n) == 0);
+	assert (flags == WebSocket::FRAME_TEXT);
+	assert (ws.deflateStatistics().bytesSent == 0);
+
+	// server supports the extension, but the client does not offer it
+	Poco::Net::ServerSocket ss2(0);
+	Poco::Net::HTTPServer server2(new WebSocketRequestHandlerFactory(1024, false, &config), ss2, new Poco::Net::HTTPServerParams);
+	server2.start();
+	
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs2("localhost", ss2.address().port());
+	HTTPRequest request2(HTTPRequest::HTTP_GET, "/ws");
+	HTTPResponse response2;
+	WebSocket ws2(cs2, request2, response2);
+	assert (!ws2.deflateEnabled());
+	assert (!response2.has("Sec-WebSocket-Extensions"));
+	ws2.sendFrame(payload.data(), (int) payload.size());
+	n = ws2.receiveFrame(buffer, sizeof(buffer), flags);
+	assert (n == payload.size());
+	assert (payload.compare(0, payload.size(), buffer, n) == 0);
+
+	ws.shutdown();
+	ws2.shutdown();
+	server.stop();
+	server2.stop();
+}
+
+
 void WebSocketTest::setUp()
 {
 }
@@ -226,6 +531,11 @@ CppUnit::Test* WebSocketTest::suite()
 
 	CppUnit_addTest(pSuite, WebSocketTest, testWebSocket);
 	CppUnit_addTest(pSuite, WebSocketTest, testWebSocketLarge);
+	CppUnit_addTest(pSuite, WebSocketTest, testSendFrameBuffers);
+	CppUnit_addTest(pSuite, WebSocketTest, testMaskPayload);
+	CppUnit_addTest(pSuite, WebSocketTest, testDeflate);
+	CppUnit_addTest(pSuite, WebSocketTest, testDeflateNoContextTakeover);
+	CppUnit_addTest(pSuite, WebSocketTest, testDeflateDeclined);
 
 	return pSuite;
 }
@@ -28,6 +28,11 @@ public:
 
 	void testWebSocket();
 	void testWebSocketLarge();
+	void testSendFrameBuffers();
+	void testMaskPayload();
+	void testDeflate();
+	void testDeflateNoContextTakeover();
+	void testDeflateDeclined();
 
 	void setUp();
 	void tearDown();
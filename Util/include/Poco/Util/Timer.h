@@ -23,14 +23,19 @@
 #include "Poco/Util/Util.h"
 #include "Poco/Util/TimerTask.h"
 #include "Poco/TimedNotificationQueue.h"
+#include "Poco/TimingWheel.h"
 #include "Poco/Thread.h"
 #include "Poco/Runnable.h"
+#include "Poco/Mutex.h"
 
 
 namespace Poco {
 namespace Util {
 
 
+class TaskNotification;
+
+
 class Util_API Timer: protected Poco::Runnable
 	/// A Timer allows to schedule tasks (TimerTask objects) for future execution 
 	/// in a background thread. Tasks may be scheduled for one-time execution, 
@@ -43,16 +48,41 @@ class Util_API Timer: protected Poco::Runnable
 	/// Timer is save for multithreaded use - multiple threads can schedule
 	/// new tasks simultaneously.
 	///
+	/// By default, scheduled tasks are kept in a TimedNotificationQueue,
+	/// which takes O(log n) time and a memory allocation per scheduled
+	/// task. A Timer created with the TIMER_WHEEL scheduler keeps its tasks
+	/// in a TimingWheel with millisecond resolution instead, which takes
+	/// constant time for scheduling a task, and expires all tasks due in
+	/// the same millisecond at once. This is preferable if many tasks are
+	/// scheduled and most of them are cancelled before they run (e.g.,
+	/// timeouts).
+	///
 	/// Acknowledgement: The interface of this class has been inspired by
 	/// the java.util.Timer class from Java 1.3.
 {
 public:
+	enum Scheduler
+	{
+		TIMER_QUEUE, /// Tasks are kept in a TimedNotificationQueue.
+		TIMER_WHEEL  /// Tasks are kept in a TimingWheel.
+	};
+
 	Timer();
 		/// Creates the Timer.
 	
 	explicit Timer(Poco::Thread::Priority priority);
 		/// Creates the Timer, using a timer thread with
 		/// the given priority.
+
+	explicit Timer(Scheduler scheduler);
+		/// Creates the Timer, using the given scheduler.
+
+	Timer(Poco::Thread::Priority priority, Scheduler scheduler);
+		/// Creates the Timer, using a timer thread with
+		/// the given priority and the given scheduler.
+
+	Scheduler scheduler() const;
+		/// Returns the scheduler used by the Timer.
 	
 	~Timer();
 		/// Destroys the Timer, cancelling all pending tasks.
@@ -154,6 +184,9 @@ public:
 
 protected:
 	void run();
+	void runWheel();
+	void enqueue(Poco::AutoPtr<TaskNotification> pNf, const Poco::Clock& clock);
+	void clear();
 	static void validateTask(const TimerTask::Ptr& pTask);
 	
 private:
@@ -161,10 +194,24 @@ private:
 	Timer& operator = (const Timer&);
 	
 	Poco::TimedNotificationQueue _queue;
+	Poco::TimingWheel* _pWheel;
+	Poco::Clock _wheelWakeUp;
+	Poco::FastMutex _wheelMutex;
 	Poco::Thread _thread;
+
+	friend class TimerNotification;
 };
 
 
+//
+// inlines
+//
+inline Timer::Scheduler Timer::scheduler() const
+{
+	return _pWheel ? TIMER_WHEEL : TIMER_QUEUE;
+}
+
+
 } } // namespace Poco::Util
 
 
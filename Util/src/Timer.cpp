@@ -18,6 +18,7 @@
 #include "Poco/Notification.h"
 #include "Poco/ErrorHandler.h"
 #include "Poco/Event.h"
+#include <limits>
 
 
 using Poco::ErrorHandler;
@@ -30,8 +31,8 @@ namespace Util {
 class TimerNotification: public Poco::Notification
 {
 public:
-	TimerNotification(Poco::TimedNotificationQueue& queue):
-		_queue(queue)
+	TimerNotification(Timer& timer):
+		_timer(timer)
 	{
 	}
 	
@@ -41,21 +42,29 @@ public:
 	
 	virtual bool execute() = 0;
 	
-	Poco::TimedNotificationQueue& queue()
+protected:
+	void enqueue(Poco::AutoPtr<TaskNotification> pNf, const Poco::Clock& clock);
+
+	void clear()
 	{
-		return _queue;
+		_timer.clear();
 	}
 	
+	Timer& timer()
+	{
+		return _timer;
+	}
+
 private:
-	Poco::TimedNotificationQueue& _queue;
+	Timer& _timer;
 };
 
 
 class StopNotification: public TimerNotification
 {
 public:
-	StopNotification(Poco::TimedNotificationQueue& queue):
-		TimerNotification(queue)
+	StopNotification(Timer& timer):
+		TimerNotification(timer)
 	{
 	}
 	
@@ -65,7 +74,7 @@ public:
 	
 	bool execute()
 	{
-		queue().clear();
+		clear();
 		return false;
 	}
 };
@@ -74,8 +83,8 @@ public:
 class CancelNotification: public TimerNotification
 {
 public:
-	CancelNotification(Poco::TimedNotificationQueue& queue):
-		TimerNotification(queue)
+	CancelNotification(Timer& timer):
+		TimerNotification(timer)
 	{
 	}
 	
@@ -85,7 +94,7 @@ public:
 	
 	bool execute()
 	{
-		queue().clear();
+		clear();
 		_finished.set();
 		return true;
 	}
@@ -100,11 +109,33 @@ private:
 };
 
 
-class TaskNotification: public TimerNotification
+class WakeUpNotification: public TimerNotification
+	/// Wakes up the timer thread if a task has been scheduled
+	/// on the TimingWheel that must run before the thread
+	/// would have woken up.
 {
 public:
-	TaskNotification(Poco::TimedNotificationQueue& queue, TimerTask::Ptr pTask):
-		TimerNotification(queue),
+	WakeUpNotification(Timer& timer):
+		TimerNotification(timer)
+	{
+	}
+	
+	~WakeUpNotification()
+	{
+	}
+	
+	bool execute()
+	{
+		return true;
+	}
+};
+
+
+class TaskNotification: public TimerNotification, public Poco::TimingWheel::Entry
+{
+public:
+	TaskNotification(Timer& timer, TimerTask::Ptr pTask):
+		TimerNotification(timer),
 		_pTask(pTask)
 	{
 	}
@@ -148,11 +179,17 @@ private:
 };
 
 
+void TimerNotification::enqueue(Poco::AutoPtr<TaskNotification> pNf, const Poco::Clock& clock)
+{
+	_timer.enqueue(pNf, clock);
+}
+
+
 class PeriodicTaskNotification: public TaskNotification
 {
 public:
-	PeriodicTaskNotification(Poco::TimedNotificationQueue& queue, TimerTask::Ptr pTask, long interval):
-		TaskNotification(queue, pTask),
+	PeriodicTaskNotification(Timer& timer, TimerTask::Ptr pTask, long interval):
+		TaskNotification(timer, pTask),
 		_interval(interval)
 	{
 	}
@@ -171,8 +208,7 @@ public:
 			Poco::Clock nextExecution;
 			nextExecution += static_cast<Poco::Clock::ClockDiff>(_interval)*1000;
 			if (nextExecution < now) nextExecution = now;
-			queue().enqueueNotification(this, nextExecution);
-			duplicate();
+			enqueue(Poco::AutoPtr<TaskNotification>(this, true), nextExecution);
 		}
 		return true;		
 	}
@@ -185,8 +221,8 @@ private:
 class FixedRateTaskNotification: public TaskNotification
 {
 public:
-	FixedRateTaskNotification(Poco::TimedNotificationQueue& queue, TimerTask::Ptr pTask, long interval, Poco::Clock clock):
-		TaskNotification(queue, pTask),
+	FixedRateTaskNotification(Timer& timer, TimerTask::Ptr pTask, long interval, Poco::Clock clock):
+		TaskNotification(timer, pTask),
 		_interval(interval),
 		_nextExecution(clock)
 	{
@@ -205,8 +241,7 @@ public:
 			Poco::Clock now;
 			_nextExecution += static_cast<Poco::Clock::ClockDiff>(_interval)*1000;
 			if (_nextExecution < now) _nextExecution = now;
-			queue().enqueueNotification(this, _nextExecution);
-			duplicate();
+			enqueue(Poco::AutoPtr<TaskNotification>(this, true), _nextExecution);
 		}
 		return true;			
 	}
@@ -217,13 +252,47 @@ private:
 };
 
 
-Timer::Timer()
+namespace
+{
+	Poco::Clock toClock(const Poco::Timestamp& time)
+	{
+		Poco::Timestamp tsNow;
+		Poco::Clock clock;
+		Poco::Timestamp::TimeDiff diff = time - tsNow;
+		clock += diff;
+		return clock;
+	}
+}
+
+
+Timer::Timer():
+	_pWheel(0),
+	_wheelWakeUp(0)
 {
 	_thread.start(*this);
 }
 
 
-Timer::Timer(Poco::Thread::Priority priority)
+Timer::Timer(Poco::Thread::Priority priority):
+	_pWheel(0),
+	_wheelWakeUp(0)
+{
+	_thread.setPriority(priority);
+	_thread.start(*this);
+}
+
+
+Timer::Timer(Scheduler scheduler):
+	_pWheel(scheduler == TIMER_WHEEL ? new Poco::TimingWheel : 0),
+	_wheelWakeUp(0)
+{
+	_thread.start(*this);
+}
+
+
+Timer::Timer(Poco::Thread::Priority priority, Scheduler scheduler):
+	_pWheel(scheduler == TIMER_WHEEL ? new Poco::TimingWheel : 0),
+	_wheelWakeUp(0)
 {
 	_thread.setPriority(priority);
 	_thread.start(*this);
@@ -234,19 +303,21 @@ Timer::~Timer()
 {
 	try
 	{
-		_queue.enqueueNotification(new StopNotification(_queue), Poco::Clock(0));
+		_queue.enqueueNotification(new StopNotification(*this), Poco::Clock(0));
 		_thread.join();
+		clear();
 	}
 	catch (...)
 	{
 		poco_unexpected();
 	}
+	delete _pWheel;
 }
 
 	
 void Timer::cancel(bool wait)
 {
-	Poco::AutoPtr<CancelNotification> pNf = new CancelNotification(_queue);
+	Poco::AutoPtr<CancelNotification> pNf = new CancelNotification(*this);
 	_queue.enqueueNotification(pNf, Poco::Clock(0));
 	if (wait)
 	{
@@ -258,14 +329,14 @@ void Timer::cancel(bool wait)
 void Timer::schedule(TimerTask::Ptr pTask, Poco::Timestamp time)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new TaskNotification(_queue, pTask), time);
+	enqueue(new TaskNotification(*this, pTask), toClock(time));
 }
 
 
 void Timer::schedule(TimerTask::Ptr pTask, Poco::Clock clock)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new TaskNotification(_queue, pTask), clock);
+	enqueue(new TaskNotification(*this, pTask), clock);
 }
 
 	
@@ -280,14 +351,14 @@ void Timer::schedule(TimerTask::Ptr pTask, long delay, long interval)
 void Timer::schedule(TimerTask::Ptr pTask, Poco::Timestamp time, long interval)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new PeriodicTaskNotification(_queue, pTask, interval), time);
+	enqueue(new PeriodicTaskNotification(*this, pTask, interval), toClock(time));
 }
 
 
 void Timer::schedule(TimerTask::Ptr pTask, Poco::Clock clock, long interval)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new PeriodicTaskNotification(_queue, pTask, interval), clock);
+	enqueue(new PeriodicTaskNotification(*this, pTask, interval), clock);
 }
 
 	
@@ -302,23 +373,26 @@ void Timer::scheduleAtFixedRate(TimerTask::Ptr pTask, long delay, long interval)
 void Timer::scheduleAtFixedRate(TimerTask::Ptr pTask, Poco::Timestamp time, long interval)
 {
 	validateTask(pTask);
-	Poco::Timestamp tsNow;
-	Poco::Clock clock;
-	Poco::Timestamp::TimeDiff diff = time - tsNow;
-	clock += diff;
-	_queue.enqueueNotification(new FixedRateTaskNotification(_queue, pTask, interval, clock), clock);
+	Poco::Clock clock = toClock(time);
+	enqueue(new FixedRateTaskNotification(*this, pTask, interval, clock), clock);
 }
 
 
 void Timer::scheduleAtFixedRate(TimerTask::Ptr pTask, Poco::Clock clock, long interval)
 {
 	validateTask(pTask);
-	_queue.enqueueNotification(new FixedRateTaskNotification(_queue, pTask, interval, clock), clock);
+	enqueue(new FixedRateTaskNotification(*this, pTask, interval, clock), clock);
 }
 
 
 void Timer::run()
 {
+	if (_pWheel)
+	{
+		runWheel();
+		return;
+	}
+
 	bool cont = true;
 	while (cont)
 	{
@@ -328,6 +402,96 @@ void Timer::run()
 }
 
 
+void Timer::runWheel()
+{
+	const Poco::Clock never(std::numeric_limits<Poco::Clock::ClockVal>::max());
+	Poco::TimingWheel::EntryVec expired;
+	bool cont = true;
+	while (cont)
+	{
+		Poco::Clock next;
+		bool hasNext;
+		{
+			Poco::FastMutex::ScopedLock lock(_wheelMutex);
+
+			_pWheel->advance(Poco::Clock(), expired);
+			hasNext = _pWheel->nextExpiration(next);
+			// while the thread is busy, scheduling a task
+			// does not have to wake it up
+			if (!expired.empty())
+				_wheelWakeUp = Poco::Clock(0);
+			else
+				_wheelWakeUp = hasNext ? next : never;
+		}
+		bool busy = !expired.empty();
+		for (Poco::TimingWheel::EntryVec::iterator it = expired.begin(); it != expired.end(); ++it)
+		{
+			// takes over the reference held by the wheel
+			Poco::AutoPtr<TaskNotification> pTaskNf(static_cast<TaskNotification*>(*it));
+			pTaskNf->execute();
+		}
+		expired.clear();
+
+		Poco::AutoPtr<TimerNotification> pNf;
+		if (busy)
+		{
+			pNf = static_cast<TimerNotification*>(_queue.dequeueNotification());
+		}
+		else if (hasNext)
+		{
+			Poco::Clock::ClockDiff wait = next - Poco::Clock();
+			if (wait > 0)
+				pNf = static_cast<TimerNotification*>(_queue.waitDequeueNotification(static_cast<long>((wait + 999)/1000)));
+			else
+				pNf = static_cast<TimerNotification*>(_queue.dequeueNotification());
+		}
+		else
+		{
+			pNf = static_cast<TimerNotification*>(_queue.waitDequeueNotification());
+		}
+		if (pNf) cont = pNf->execute();
+	}
+}
+
+
+void Timer::enqueue(Poco::AutoPtr<TaskNotification> pNf, const Poco::Clock& clock)
+{
+	if (_pWheel)
+	{
+		bool wakeUp;
+		{
+			Poco::FastMutex::ScopedLock lock(_wheelMutex);
+
+			_pWheel->schedule(*pNf, clock);
+			pNf.duplicate(); // the wheel holds a reference
+			wakeUp = clock < _wheelWakeUp;
+			if (wakeUp) _wheelWakeUp = clock;
+		}
+		if (wakeUp) _queue.enqueueNotification(new WakeUpNotification(*this), Poco::Clock(0));
+	}
+	else _queue.enqueueNotification(pNf, clock);
+}
+
+
+void Timer::clear()
+{
+	_queue.clear();
+	if (_pWheel)
+	{
+		Poco::TimingWheel::EntryVec cancelled;
+		{
+			Poco::FastMutex::ScopedLock lock(_wheelMutex);
+
+			_pWheel->clear(cancelled);
+		}
+		for (Poco::TimingWheel::EntryVec::iterator it = cancelled.begin(); it != cancelled.end(); ++it)
+		{
+			static_cast<TaskNotification*>(*it)->release();
+		}
+	}
+}
+
+
 void Timer::validateTask(const TimerTask::Ptr& pTask)
 {
 	if (pTask->isCancelled())
@@ -15,6 +15,7 @@
 #include "CppUnit/TestSuite.h"
 #include "Poco/Util/Timer.h"
 #include "Poco/Util/TimerTaskAdapter.h"
+#include "Poco/AtomicCounter.h"
 
 
 using Poco::Util::Timer;
@@ -22,6 +23,28 @@ using Poco::Util::TimerTask;
 using Poco::Util::TimerTaskAdapter;
 using Poco::Timestamp;
 using Poco::Clock;
+using Poco::AtomicCounter;
+
+
+namespace
+{
+	class CountingTask: public TimerTask
+	{
+	public:
+		CountingTask(AtomicCounter& counter):
+			_counter(counter)
+		{
+		}
+
+		void run()
+		{
+			++_counter;
+		}
+
+	private:
+		AtomicCounter& _counter;
+	};
+}
 
 
 TimerTest::TimerTest(const std::string& name): CppUnit::TestCase(name)
@@ -226,6 +249,100 @@ void TimerTest::testCancel()
 }
 
 
+void TimerTest::testWheelSchedule()
+{
+	Timer timer(Timer::TIMER_WHEEL);
+	assert (timer.scheduler() == Timer::TIMER_WHEEL);
+
+	Timestamp time;
+	time += 500000;
+
+	TimerTask::Ptr pTask = new TimerTaskAdapter<TimerTest>(*this, &TimerTest::onTimer);
+	timer.schedule(pTask, time);
+	_event.wait();
+	assert (pTask->lastExecution() >= time);
+
+	// a task scheduled to run before the timer thread wakes up
+	Clock clock;
+	clock += 200000;
+	TimerTask::Ptr pLateTask = new TimerTaskAdapter<TimerTest>(*this, &TimerTest::onTimer);
+	timer.schedule(pLateTask, 5000, 5000);
+	timer.schedule(pTask, clock);
+	_event.wait();
+	assert (pLateTask->lastExecution() == 0);
+	assert (clock.isElapsed(0));
+	pLateTask->cancel();
+}
+
+
+void TimerTest::testWheelScheduleAtFixedRate()
+{
+	Timer timer(Timer::TIMER_WHEEL);
+
+	Timestamp time;
+
+	TimerTask::Ptr pTask = new TimerTaskAdapter<TimerTest>(*this, &TimerTest::onTimer);
+
+	timer.scheduleAtFixedRate(pTask, 500, 500);
+
+	_event.wait();
+	assert (time.elapsed() >= 500000);
+	assert (pTask->lastExecution().elapsed() < 130000);
+
+	_event.wait();
+	assert (time.elapsed() >= 1000000);
+	assert (pTask->lastExecution().elapsed() < 130000);
+
+	pTask->cancel();
+	assert (pTask->isCancelled());
+}
+
+
+void TimerTest::testWheelMany()
+{
+	Timer timer(Timer::TIMER_WHEEL);
+	AtomicCounter counter;
+
+	const int TASK_COUNT = 10000;
+	std::vector<TimerTask::Ptr> tasks;
+	for (int i = 0; i < TASK_COUNT; ++i)
+	{
+		TimerTask::Ptr pTask = new CountingTask(counter);
+		timer.schedule(pTask, Timestamp() + (100 + i % 400)*1000);
+		tasks.push_back(pTask);
+	}
+	for (int i = 0; i < TASK_COUNT; i += 2)
+	{
+		tasks[i]->cancel();
+	}
+	Poco::Thread::sleep(1000);
+	assert (counter.value() == TASK_COUNT/2);
+	for (int i = 1; i < TASK_COUNT; i += 2)
+	{
+		assert (tasks[i]->lastExecution() != 0);
+	}
+}
+
+
+void TimerTest::testWheelCancelAll()
+{
+	Timer timer(Timer::TIMER_WHEEL);
+	AtomicCounter counter;
+
+	TimerTask::Ptr pTask = new CountingTask(counter);
+	for (int i = 0; i < 100; ++i)
+	{
+		timer.schedule(new CountingTask(counter), 200, 0);
+	}
+	timer.schedule(pTask, Clock() + 300000);
+	assert (pTask->referenceCount() == 2);
+	timer.cancel(true);
+	assert (pTask->referenceCount() == 1);
+	Poco::Thread::sleep(500);
+	assert (counter.value() == 0);
+}
+
+
 void TimerTest::setUp()
 {
 }
@@ -254,6 +371,10 @@ CppUnit::Test* TimerTest::suite()
 	CppUnit_addTest(pSuite, TimerTest, testScheduleIntervalClock);
 	CppUnit_addTest(pSuite, TimerTest, testScheduleAtFixedRate);
 	CppUnit_addTest(pSuite, TimerTest, testCancel);
+	CppUnit_addTest(pSuite, TimerTest, testWheelSchedule);
+	CppUnit_addTest(pSuite, TimerTest, testWheelScheduleAtFixedRate);
+	CppUnit_addTest(pSuite, TimerTest, testWheelMany);
+	CppUnit_addTest(pSuite, TimerTest, testWheelCancelAll);
 
 	return pSuite;
 }
@@ -35,6 +35,10 @@ public:
 	void testScheduleIntervalTimestamp();
 	void testScheduleIntervalClock();
 	void testCancel();
+	void testWheelSchedule();
+	void testWheelScheduleAtFixedRate();
+	void testWheelMany();
+	void testWheelCancelAll();
 
 	void setUp();
 	void tearDown();